@@ -2,19 +2,36 @@
 #define APPLICATION_HPP
 
 #include <array>
+#include <atomic>
 #include "Config.hpp"
+#include "db/MetadataStore.hpp"
 #include "db/SyncDatabase.hpp"
+#include <chrono>
 #include <future>
+#include <mutex>
 #include <stack>
 #include "Sysmodule.hpp"
 #include "ui/Theme.hpp"
 
+class LibraryScanner;
+
 // Forward declaration because cyclic dependency /shrug
 namespace Screen {
     class Screen;
 };
 
 namespace Main {
+    // Stages in a library scan
+    enum class ScanStage {
+        None,           // Not scanning
+        Files,          // Searching for file changes
+        Metadata,       // Extracting metadata from files (and adding to the database)
+        Database,       // Updating database to match filesystem
+        Art,            // Extracting album art from needed files
+        Done,           // Everything is done
+        Error           // An error occurred during the scan
+    };
+
     // Enumeration for screens (allows for easy switching)
     enum class ScreenID {
         Fullscreen = 0,
@@ -42,6 +59,8 @@ namespace Main {
 
             // Config object (used to interact with config files)
             Config * config_;
+            // Write any config changes, asking the sysmodule to reload its config if it changed
+            void saveConfig();
 
             // Database object (all calls are wrapped with a mutex)
             SyncDatabase database_;
@@ -59,6 +78,53 @@ namespace Main {
             // Thread which handles sysmodule communication
             std::future<void> sysThread;
 
+            // Held while writing to the database
+            std::mutex databaseMutex;
+
+            // Thread which writes the snapshot after the database changes (see Snapshot.hpp)
+            std::future<void> snapshotThread;
+            std::mutex snapshotMutex;
+            bool snapshotQueued;
+            bool snapshotRunning;
+            // Start writing the snapshot on another thread, or write it again once finished if already writing
+            void queueSnapshot();
+            // Function run on another thread to write the snapshot until no more are queued
+            void writeSnapshots();
+            // Set when the scan has written to the database since the snapshot was last queued
+            // (the scan writes in batches, so the snapshot is only written as each stage ends)
+            bool scanSnapshotDue;
+            // Queue the snapshot if the scan has written to the database
+            void queueScanSnapshot();
+
+            // Thread which scans the library in the background
+            std::future<void> scanThread;
+            // Stage and progress of scan
+            std::atomic<ScanStage> scanStage_;
+            std::atomic<size_t> scanCurrent;
+            std::atomic<size_t> scanTotal;
+            std::atomic<size_t> scanRemaining;
+            // Scanner used by the current scan (nullptr when not scanning)
+            LibraryScanner * scanner;
+            bool scanCancelled;
+            // Whether the current scan checks every file
+            bool scanFull;
+            std::mutex scannerMutex;
+            // Incremented each time the scan writes to the database
+            std::atomic<unsigned int> libraryVersion_;
+            // Incremented each time anything writes to the database
+            std::atomic<unsigned int> databaseVersion_;
+            // Song metadata shared by frames (replaced once the database changes)
+            std::shared_ptr<MetadataStore> metadata_;
+            // Metadata being loaded on another thread, and when it was started
+            std::future< std::shared_ptr<MetadataStore> > metadataThread;
+            std::chrono::steady_clock::time_point metadataLoadTime;
+            // Load the metadata for the given version, sorting the given orders so the UI thread doesn't have to
+            std::shared_ptr<MetadataStore> loadMetadata(const unsigned int, const std::vector<Database::SortBy>);
+            // Function run on another thread to control library scan
+            void scanLibrary();
+            // Runs each stage of the scan, returning the stage to finish on
+            ScanStage runScan(LibraryScanner &);
+
         public:
             // Constructor inits Aether, screens + other objects
             Application();
@@ -78,9 +144,28 @@ namespace Main {
             void dropScreen();
             void updateScreenTheme();
 
-            // Helper functions for database
+            // Helper functions for database (calls through database() on other threads wait until unlocked)
+            // The sysmodule only reads the snapshot, so it's only asked to release it while that's written
+            // Unlocking writes the snapshot unless false is passed, in which case queue it later
             void lockDatabase();
-            void unlockDatabase();
+            void unlockDatabase(const bool = true);
+
+            // Start scanning the library in the background (does nothing if already scanning)
+            // Set true to check every file, rather than only those in changed directories
+            void startLibraryScan(const bool = false);
+            // Stop the current scan at the next opportunity (progress is kept for next time)
+            void stopLibraryScan();
+            // Returns the current stage of the library scan
+            ScanStage scanStage();
+            // Returns progress within the current stage (current item, total items, est. seconds remaining)
+            // (the total is only known during the metadata stage)
+            void scanProgress(size_t &, size_t &, size_t &);
+            // Returns a value which changes each time the library scan writes to the database
+            unsigned int libraryVersion();
+            // Returns the song metadata shared by all frames (frames keep the version they were given). If the
+            // database has been written to since it was loaded, it's loaded again on another thread and the
+            // previous one is returned until that's done (at most every few seconds while scanning)
+            std::shared_ptr<const MetadataStore> metadata();
 
             // Returns whether an update is available
             bool hasUpdate();
@@ -8,17 +8,20 @@
 
 // Forward declarations as we only need the types here
 enum class Language;
-class minIni;
+namespace Utils {
+    class Ini;
+};
 
 // The config class interacts with the config file stored on
 // the SD Card to read/write both the application's and the
 // sysmodule's configuration. Each option can be queried/set
-// through this object.
+// through this object. Changes are only kept in memory until
+// save() is called.
 class Config {
     private:
-        // minIni interacts with .ini file
-        minIni * ini;
-        minIni * sysIni;
+        // Copies of each .ini file
+        Utils::Ini * ini;
+        Utils::Ini * sysIni;
 
         // Cache of each key/value (read in on construction)
         int version_;
@@ -45,6 +48,7 @@ class Config {
         int setQueueMax_;
         int searchMaxPhrases_;
         int searchMaxScore_;
+        int imageCacheSize_;
 
         // Read all values from app .ini
         void readConfig();
@@ -55,8 +59,18 @@ class Config {
         Config(const std::string &);
         // Prepare object to interact with sysmodule config
         // Returns true if file exists and is successful, false otherwise
+        // (keeps the existing copy if it has unsaved changes)
         bool prepareSys(const std::string &);
 
+        // Returns whether there are unsaved changes to either config, ignoring
+        // them if one was made within the given number of milliseconds
+        bool hasUnsavedChanges(const unsigned int = 0);
+        // Returns whether the sysmodule config has unsaved changes
+        bool hasUnsavedSysChanges();
+        // Write any changes to the files
+        // Returns true if successful, false otherwise
+        bool save();
+
         // Version of the .ini (-1 by default)
         int version();
         bool setVersion(const int);
@@ -128,6 +142,10 @@ class Config {
         int searchMaxPhrases();
         bool setSearchMaxPhrases(const int);
 
+        // Memory budget for cached images (MB)
+        int imageCacheSize();
+        bool setImageCacheSize(const int);
+
         // === Sysmodule Config === //
         // All methods start with sys*
 
@@ -163,7 +181,7 @@ class Config {
         std::array<float, 32> sysMP3Equalizer();
         bool setSysMP3Equalizer(const std::array<float, 32> &);
 
-        // Deletes minIni object
+        // Deletes Ini objects (without saving)
         ~Config();
 };
 
@@ -1,77 +1,134 @@
-#ifndef LIBRARYSCANNER_HPP
-#define LIBRARYSCANNER_HPP
-
-#include "db/SyncDatabase.hpp"
-#include <mutex>
-#include <string>
-#include "Types.hpp"
-#include <vector>
-
-// The LibraryScanner class searches for audio files in the given path and updates
-// the database where necessary.
-class LibraryScanner {
-    public:
-        // Statuses returned by class' methods
-        enum class Status {
-            Ok,                 // No error occurred
-            ErrDatabase,        // The database object had an error
-            ErrUnknown,         // Something unexpected went wrong
-            DoneRemove,         // Returned when there are only songs to remove
-            Done                // Returned when no action needs to be taken
-        };
-
-    private:
-        // File pair containing path and modified time
-        struct FileTuple {
-            std::string path;           // File path
-            unsigned int modifiedTime;  // Last modified timestamp
-            AudioFormat format;         // Audio format of file
-        };
-        static bool FileTupleComparator(const FileTuple &, const FileTuple &);
-
-        // Reference to Database object
-        const SyncDatabase & database;
-        // Path to search
-        const std::string searchPath;
-
-        // Vectors of files to add to database
-        std::vector<FileTuple> addFiles;
-        std::vector<Metadata::Song> addMeta;
-        std::mutex addMutex;
-
-        // Vectors of files to update within database
-        std::vector<FileTuple> updateFiles;
-        std::vector<Metadata::Song> updateMeta;
-        std::mutex updateMutex;
-
-        // Vector of files to remove
-        std::vector<FileTuple> removeFiles;
-
-        // Functions to actually process files on another thread
-        std::string parseAlbumArt(const Metadata::Song &);
-        Status parseFileAdd(const FileTuple &);
-        Status parseFileUpdate(const FileTuple &);
-
-    public:
-        // Constructor accepts Database object and path to search
-        // Doesn't actually do anything yet
-        LibraryScanner(const SyncDatabase &, const std::string &);
-
-        // Prepare lists of files to add/edit/remove from database
-        Status processFiles();
-
-        // Process metadata for each required file
-        // Accepts references to variables to update status
-        // (current file, total files, estimated remaining time (secs))
-        Status processMetadata(std::atomic<size_t> &, std::atomic<size_t> &, std::atomic<size_t> &);
-
-        // Update the database with new data
-        // !! Assumes that the database is locked for writing before calling !!
-        Status updateDatabase();
-
-        // Extract album art and write path to database
-        // !! Assumes that the database is locked for writing before calling !!
-        Status processArt(std::atomic<size_t> &);
-};
-
+#ifndef LIBRARYSCANNER_HPP
+#define LIBRARYSCANNER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include "db/SyncDatabase.hpp"
+#include <functional>
+#include <mutex>
+#include "ScanJournal.hpp"
+#include <string>
+#include "Types.hpp"
+#include <unordered_set>
+#include "utils/WorkPool.hpp"
+#include <vector>
+
+// The LibraryScanner class searches for audio files in the given path and updates
+// the database where necessary.
+class LibraryScanner {
+    public:
+        // Statuses returned by class' methods
+        enum class Status {
+            Ok,                 // No error occurred
+            ErrDatabase,        // The database object had an error
+            ErrUnknown,         // Something unexpected went wrong
+            DoneRemove,         // Returned when there are only songs to remove
+            Done,               // Returned when no action needs to be taken
+            Stopped             // The scan was stopped before it finished
+        };
+
+    private:
+        // File pair containing path and modified time
+        struct FileTuple {
+            std::string path;           // File path
+            unsigned int modifiedTime;  // Last modified timestamp
+            AudioFormat format;         // Audio format of file
+        };
+        static bool FileTupleComparator(const FileTuple &, const FileTuple &);
+
+        // Reference to Database object
+        const SyncDatabase & database;
+        // Path to search
+        const std::string searchPath;
+        // Whether to check every file, even those in unchanged directories
+        const bool fullScan;
+
+        // Functions called to lock/unlock the database for writing
+        std::function<void()> lockDatabase;
+        std::function<void()> unlockDatabase;
+
+        // Vectors of files to add to database
+        std::vector<FileTuple> addFiles;
+        std::vector<Metadata::Song> addMeta;
+        std::mutex addMutex;
+
+        // Vectors of files to update within database
+        std::vector<FileTuple> updateFiles;
+        std::vector<Metadata::Song> updateMeta;
+        std::mutex updateMutex;
+
+        // Songs which have been written to the database
+        std::vector<Metadata::Song> committedMeta;
+
+        // Vector of files to remove
+        std::vector<FileTuple> removeFiles;
+
+        // Songs still needing album art from an interrupted scan
+        std::vector<Metadata::Song> pendingArt;
+
+        // Journal used to resume an interrupted scan
+        ScanJournal journal;
+
+        // Directories found while searching for files (sorted by path)
+        std::vector<Metadata::Directory> directories;
+        bool directoriesChanged;
+
+        // Pool of threads used to process metadata and art
+        Utils::WorkPool pool;
+
+        // Paths of images being written by a worker (so identical art is only processed once)
+        // Each is removed once written or if it failed, notifying workers waiting on the same image
+        std::unordered_set<std::string> artClaimed;
+        std::condition_variable artCondition;
+        std::mutex artMutex;
+
+        // Set true to stop the scan as soon as possible
+        std::atomic<bool> stopped;
+
+        // Functions to actually process files on another thread
+        std::string parseAlbumArt(const Metadata::Song &);
+        Status parseFile(const FileTuple &, Metadata::Song &);
+        Status parseFileAdd(const FileTuple &);
+        Status parseFileUpdate(const FileTuple &);
+
+        // Write metadata read so far to the database (assumes it's locked)
+        Status commitMetadata();
+
+        // Write directories to the database (assumes it's locked)
+        Status writeDirectories();
+
+    public:
+        // Constructor accepts Database object, path to search, functions to lock/unlock the database
+        // for writing and whether to check every file (a full scan, see processFiles()). Doesn't actually
+        // do anything yet
+        LibraryScanner(const SyncDatabase &, const std::string &, std::function<void()>, std::function<void()>, const bool = false);
+
+        // Stop the scan at the next opportunity (can be called from any thread)
+        // Anything not yet written to the database is kept in the journal
+        void stop();
+
+        // Prepare lists of files to add/edit/remove from database
+        Status processFiles();
+
+        // Process metadata for each required file
+        // Songs are written to the database in batches as they're read
+        // Accepts references to variables to update status
+        // (current file, total files, estimated remaining time (secs))
+        Status processMetadata(std::atomic<size_t> &, std::atomic<size_t> &, std::atomic<size_t> &);
+
+        // Returns whether any songs need to be removed from the database
+        bool hasRemovals();
+
+        // Finish updating the database (removes songs and stores directories)
+        Status updateDatabase();
+
+        // Store the directories found by processFiles() so unchanged ones can be skipped next time
+        // Only needs to be called if updateDatabase() isn't
+        Status updateDirectories();
+
+        // Extract album art and write path to database
+        // Also includes songs left over from an interrupted scan
+        Status processArt(std::atomic<size_t> &);
+};
+
 #endif
\ No newline at end of file
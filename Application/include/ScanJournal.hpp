@@ -0,0 +1,65 @@
+#ifndef SCANJOURNAL_HPP
+#define SCANJOURNAL_HPP
+
+#include <mutex>
+#include <string>
+#include "Types.hpp"
+#include <unordered_map>
+#include <vector>
+
+// The ScanJournal records the progress of a library scan on the SD card. Parsed metadata
+// is written to the journal in batches, allowing a scan which was interrupted to continue
+// without having to parse every file again. Once the database has been updated the journal
+// instead holds the songs which still need to be checked for album art.
+class ScanJournal {
+    private:
+        // Path to journal file
+        const std::string path;
+
+        // Metadata read from the journal (path -> metadata)
+        std::unordered_map<std::string, Metadata::Song> entries;
+        // Set true if the journal was written after the database was updated
+        bool dbUpdated;
+
+        // Metadata waiting to be written
+        std::vector<Metadata::Song> batch;
+        std::mutex batchMutex;
+
+        // Write the given songs to the end of the journal
+        bool appendSongs(const std::vector<Metadata::Song> &);
+
+    public:
+        // Constructor accepts path to journal file
+        // Doesn't actually read anything yet
+        ScanJournal(const std::string &);
+
+        // Read an existing journal (if there is one)
+        // Returns false if there is no journal or it couldn't be read
+        bool load();
+
+        // Copies metadata for the file into the passed struct if it was recorded in the
+        // journal and the file hasn't been modified since (returns true if found)
+        bool getMetadata(const std::string &, const unsigned int, Metadata::Song &);
+
+        // Returns whether the database was updated before the journal was last written
+        bool databaseUpdated();
+
+        // Returns all songs stored in the journal (i.e. those needing art if the database was updated)
+        std::vector<Metadata::Song> songs();
+
+        // Add metadata to the journal, which is written once enough has been added
+        // This is thread-safe
+        void addMetadata(const Metadata::Song &);
+
+        // Writes any metadata that hasn't been written yet
+        bool flush();
+
+        // Replace the journal with one indicating the database has been updated,
+        // and that the given songs still need to be checked for album art
+        bool markDatabaseUpdated(const std::vector<Metadata::Song> &);
+
+        // Delete the journal from the SD card
+        void remove();
+};
+
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef TYPES_HPP
 #define TYPES_HPP
 
+#include <cstdint>
 #include <string>
 
 // All IDs are integers
@@ -46,6 +47,15 @@ namespace Metadata {
         int tadbID;                 // TheAudioDB ID of album (negative if not set)
         std::string imagePath;      // Path to album's image (can be blank)
         unsigned int songCount;     // Number of songs on album
+        unsigned int duration;      // Combined duration of songs (in seconds)
+    };
+
+    // Colours picked from an album's image (each is packed as 0xRRGGBBAA)
+    struct Palette {
+        bool light;                 // Is the background colour light?
+        uint32_t background;        // Colour to use for background
+        uint32_t primary;           // Colour to use for primary text
+        uint32_t secondary;         // Colour to use for secondary text
     };
 
     struct Artist {
@@ -55,6 +65,7 @@ namespace Metadata {
         std::string imagePath;      // Path to artist's image (can be blank)
         unsigned int albumCount;    // Number of albums
         unsigned int songCount;     // Number of songs
+        unsigned int duration;      // Combined duration of songs (in seconds)
     };
 
     struct Playlist {
@@ -84,6 +95,13 @@ namespace Metadata {
         PlaylistSongID ID;          // Unique ID for this song entry
         Song song;                  // Song struct seen above
     };
+
+    struct Directory {
+        std::string path;           // Path of directory
+        unsigned int modified;      // Timestamp directory was last modified
+        unsigned int entries;       // Number of entries (files and folders) within the directory
+        unsigned int hash;          // Hash of the names of all entries
+    };
 };
 
 #endif
\ No newline at end of file
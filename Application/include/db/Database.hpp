@@ -1,8 +1,11 @@
 #ifndef DATABASE_HPP
 #define DATABASE_HPP
 
+#include <functional>
+#include "Snapshot.hpp"
 #include "SQLite.hpp"
 #include "Types.hpp"
+#include <utility>
 #include <vector>
 
 // The Database class interacts with the database stored on the sd card
@@ -28,6 +31,20 @@ class Database {
             SongsDsc        // Song count (most first)
         };
 
+        // Position within a sorted listing, which is passed to a *Page() method to get the page
+        // after it. Pages are found by seeking past the sort keys and ID of the previous page's
+        // last row (rather than with OFFSET), so each page costs the same to fetch.
+        struct Cursor {
+            SortBy sort;                        // Order of the listing (don't change once started)
+            bool started;                       // Whether a page has been returned
+            bool done;                          // Whether the last page has been returned
+            std::vector<std::string> keys;      // Sort key values of the last returned row
+            int lastID;                         // ID of the last returned row
+
+            // Constructor creates a cursor at the start of a listing
+            Cursor(const SortBy = SortBy::TitleAsc);
+        };
+
     private:
         // Interface to database
         SQLite * db;
@@ -76,9 +93,26 @@ class Database {
         // ===== Album Metadata ===== //
         // Update an album's metadata (grabs ID from struct)
         bool updateAlbum(Metadata::Album);
+        // Set the image of the album containing the song with the given path (only if it has none)
+        // Returns true if successful, false otherwise
+        bool setAlbumImageForSong(const std::string &, const std::string &);
+        // Set the palette of every album using the given image (the palette is cleared when the image changes)
+        // Returns true if successful, false otherwise
+        bool setAlbumPaletteForImage(const std::string &, const Metadata::Palette &);
+        // Get the palette picked from the given album's image
+        // Returns false if it doesn't have one or an error occurred
+        bool getAlbumPalette(AlbumID, Metadata::Palette &);
+        // Returns the images of albums which don't have a palette
+        // Empty if there are none or an error occurred
+        std::vector<std::string> getAlbumImagesWithoutPalette();
         // Returns metadata for all stored albums
         // Empty if no albums or an error occurred
         std::vector<Metadata::Album> getAllAlbumMetadata(SortBy);
+        // Returns the next page (of at most the given size) of all albums, advancing the cursor
+        // Empty once all have been returned or if an error occurred (the cursor isn't advanced)
+        std::vector<Metadata::Album> getAlbumMetadataPage(Cursor &, const size_t);
+        // Returns the number of albums (negative if an error occurred)
+        int getAlbumCount();
         // Return metadata for the given AlbumID
         // ID will be negative if not found
         Metadata::Album getAlbumMetadataForID(AlbumID);
@@ -92,6 +126,11 @@ class Database {
         // Returns metadata for all stored artists
         // Empty if no artists or an error occurred
         std::vector<Metadata::Artist> getAllArtistMetadata(SortBy);
+        // Returns the next page (of at most the given size) of all artists, advancing the cursor
+        // Empty once all have been returned or if an error occurred (the cursor isn't advanced)
+        std::vector<Metadata::Artist> getArtistMetadataPage(Cursor &, const size_t);
+        // Returns the number of artists (negative if an error occurred)
+        int getArtistCount();
         // Returns a list of artists for a given AlbumID
         // Empty if no artists or an error occurred
         std::vector<Metadata::Artist> getArtistMetadataForAlbum(AlbumID);
@@ -117,6 +156,12 @@ class Database {
         // Returns a playlist's songs
         // Empty if there are none or an error occurred
         std::vector<Metadata::PlaylistSong> getSongMetadataForPlaylist(PlaylistID, SortBy);
+        // Returns the next page (of at most the given size) of a playlist's songs, advancing the cursor
+        // Empty once all have been returned or if an error occurred (the cursor isn't advanced)
+        std::vector<Metadata::PlaylistSong> getSongMetadataForPlaylistPage(PlaylistID, Cursor &, const size_t);
+        // Returns the entry ID and song ID of a playlist's songs (look up the rest in the MetadataStore)
+        // Empty if there are none or an error occurred
+        std::vector<std::pair<PlaylistSongID, SongID>> getSongIDsForPlaylist(PlaylistID, SortBy);
         // Add a song to a playlist
         // Return true if successful, false otherwise
         bool addSongToPlaylist(PlaylistID, SongID);
@@ -137,6 +182,9 @@ class Database {
         // Returns metadata for all stored songs
         // Empty if no songs or an error occurred
         std::vector<Metadata::Song> getAllSongMetadata(SortBy);
+        // Returns the next page (of at most the given size) of all songs, advancing the cursor
+        // Empty once all have been returned or if an error occurred (the cursor isn't advanced)
+        std::vector<Metadata::Song> getSongMetadataPage(Cursor &, const size_t);
         // Returns an album's songs
         // Empty if there are none or an error occurred
         std::vector<Metadata::Song> getSongMetadataForAlbum(AlbumID);
@@ -145,6 +193,13 @@ class Database {
         std::vector<Metadata::Song> getSongMetadataForArtist(ArtistID);
         // Returns SongInfo for given ID (id will be -1 if not found!)
         Metadata::Song getSongMetadataForID(SongID);
+        // Calls the given function with the ID, title, artist ID, artist, album ID, album and duration
+        // of every song (the strings may be moved from), in order of ID
+        // Returns true if successful, false otherwise
+        bool getAllSongColumns(const std::function<void(SongID, std::string &, ArtistID, std::string &, AlbumID, std::string &, unsigned int)> &);
+        // Returns the entries to write to the snapshot for every song, in order of ID
+        // Returns true if successful, false otherwise
+        bool getSnapshotEntries(std::vector<Snapshot::Entry> &);
 
         // ===== Search Queries ===== //
         // Returns if the database needs to be updated before searching
@@ -163,9 +218,18 @@ class Database {
         // Returns a vector of strings containing all referenced images
         // Empty if no image paths stored or an error occurred (bool set false on error, true on success)
         std::vector<std::string> getAllImagePaths(bool &);
+        // Returns whether the given image is used by any album, artist or playlist
+        // (images are shared between albums with the same art). Returns true on an error
+        bool imagePathInUse(const std::string &);
         // Returns a vector of pairs (file path, modified time) for all songs
         // Empty if no songs or error occurred (bool set false on error, true on success)
         std::vector< std::pair<std::string, unsigned int> > getAllSongFileInfo(bool &);
+        // Returns info about each directory seen during the last scan
+        // Empty if none stored or error occurred (bool set false on error, true on success)
+        std::vector<Metadata::Directory> getAllDirectories(bool &);
+        // Replaces all stored directory info with the given directories
+        // Returns true if successful, false otherwise
+        bool setDirectories(const std::vector<Metadata::Directory> &);
         // Returns the id of the artist with the given name (-1 if not found)
         ArtistID getArtistIDForName(const std::string &);
         // Return the id of a song's album
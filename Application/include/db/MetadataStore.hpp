@@ -0,0 +1,85 @@
+#ifndef METADATASTORE_HPP
+#define METADATASTORE_HPP
+
+#include <cstdint>
+#include "db/Database.hpp"
+#include <unordered_map>
+#include <vector>
+
+// Forward declaration as only a reference is needed
+class SyncDatabase;
+
+// The MetadataStore holds the metadata needed to show every song in a list (title, artist, album
+// and duration) in memory, so frames don't each need to load and hold their own copy. Each value is
+// stored in its own column indexed by row, and artist/album names are only stored once. A store is
+// read-only once loaded; the Application replaces it with a new one when the database changes.
+// Note that sort orders are created when first requested, so it should only be used on one thread at a
+// time (it's loaded on another thread, which sorts the orders in use before handing it to the UI thread).
+class MetadataStore {
+    public:
+        // Index of a song's values in each column
+        typedef uint32_t Row;
+        // Returned when a song isn't in the store
+        static constexpr Row NoRow = UINT32_MAX;
+
+    private:
+        // Columns (one entry per song)
+        std::vector<SongID> ids;
+        std::vector<std::string> titles;
+        std::vector<uint32_t> artists;
+        std::vector<uint32_t> albums;
+        std::vector<unsigned int> durations;
+
+        // Position of each title when sorted
+        std::vector<uint32_t> titleRanks;
+
+        // Interned names referenced by the above columns, and their position when sorted
+        std::vector<std::string> artistNames;
+        std::vector<uint32_t> artistRanks;
+        std::vector<std::string> albumNames;
+        std::vector<uint32_t> albumRanks;
+
+        // Row of each song
+        std::unordered_map<SongID, Row> rows;
+        // Sum of all durations (seconds)
+        unsigned long totalDuration_;
+        // Database version the store was loaded from
+        unsigned int version_;
+
+        // Rows sorted for each requested order (created when first requested)
+        mutable std::unordered_map<int, std::vector<Row>> orders;
+
+        // Compares two rows using the given order, matching the database's ORDER BY
+        bool compare(const Row, const Row, const Database::SortBy) const;
+
+    public:
+        // Constructor creates an empty store
+        MetadataStore();
+
+        // Load all songs from the database, remembering the passed version
+        // Returns false if an error occurred (the store will be empty)
+        bool load(const SyncDatabase &, const unsigned int);
+
+        // Returns the database version the store was loaded from
+        unsigned int version() const;
+        // Returns the number of songs
+        size_t size() const;
+        // Returns the combined duration of all songs (seconds)
+        unsigned long totalDuration() const;
+
+        // Returns the row for the given song (NoRow if not found)
+        Row row(const SongID) const;
+        // Returns every row in the given order (songs use a default order for unsupported types)
+        const std::vector<Row> & order(const Database::SortBy) const;
+        // Returns each order that has been requested so far
+        std::vector<Database::SortBy> sortedOrders() const;
+
+        // Returns the values for the given row (which must be valid)
+        SongID id(const Row) const;
+        const std::string & title(const Row) const;
+        const std::string & artist(const Row) const;
+        const std::string & album(const Row) const;
+        unsigned int duration(const Row) const;
+};
+
+#endif
\ No newline at end of file
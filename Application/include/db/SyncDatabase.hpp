@@ -36,8 +36,8 @@ class SyncDatabase {
 
         // Database pointer to pass to proxy
         std::shared_ptr<Database> ptr;
-        // Mutex to lock
-        mutable std::mutex mutex;
+        // Mutex to lock (recursive so it can be held across several calls, see lock())
+        mutable std::recursive_mutex mutex;
 
     public:
         // Constructor simply stores the pointer to invoke methods on
@@ -48,6 +48,11 @@ class SyncDatabase {
 
         // Override -> operator to invoke the before/after methods
         SyncDatabaseProxy operator->() const;
+
+        // Hold the mutex across several calls (i.e. while the connection is reopened for writing),
+        // blocking calls made from other threads until unlock() is called
+        void lock() const;
+        void unlock() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,14 @@
+#ifndef MIGRATION_10_HPP
+#define MIGRATION_10_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 10
+// Store album/artist song counts, album counts and durations (kept up to date by triggers on Songs)
+// Requires the sortKey() function to be registered on the connection
+namespace Migration {
+    std::string migrateTo10(SQLite *);
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,13 @@
+#ifndef MIGRATION_8_HPP
+#define MIGRATION_8_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 8
+// Add Directories table used to skip unchanged folders when scanning
+namespace Migration {
+    std::string migrateTo8(SQLite *);
+};
+
+#endif
\ No newline at end of file
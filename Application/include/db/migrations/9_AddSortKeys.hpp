@@ -0,0 +1,14 @@
+#ifndef MIGRATION_9_HPP
+#define MIGRATION_9_HPP
+
+#include "SQLite.hpp"
+#include <string>
+
+// Migration 9
+// Add normalized sort keys (kept up to date by triggers) and indexes matching each sort order
+// Requires the sortKey() function to be registered on the connection
+namespace Migration {
+    std::string migrateTo9(SQLite *);
+};
+
+#endif
\ No newline at end of file
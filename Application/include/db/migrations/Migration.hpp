@@ -9,5 +9,9 @@
 #include "db/migrations/5_UpdateSearch.hpp"
 #include "db/migrations/6_RemoveImages.hpp"
 #include "db/migrations/7_AddAudioFormat.hpp"
+#include "db/migrations/8_AddDirectories.hpp"
+#include "db/migrations/9_AddSortKeys.hpp"
+#include "db/migrations/10_AddAggregates.hpp"
+#include "db/migrations/11_AddAlbumPalettes.hpp"
 
 #endif
\ No newline at end of file
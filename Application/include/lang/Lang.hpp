@@ -1,26 +1,42 @@
 #ifndef UTILS_LANG_HPP
 #define UTILS_LANG_HPP
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 
 // Forward declare enum (reduce compile time on additions)
 enum class Language;
 
 namespace Utils::Lang {
+    // Return the hash of the given key (FNV-1a), which strings are stored under
+    constexpr uint64_t hashKey(const std::string_view key) {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char c : key) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+        }
+        return hash;
+    }
+
     // Return string representing language in native text
     std::string languageToString(const Language);
 
     // Set the language to use for future queries
     bool setLanguage(const Language);
 
+    // Return the string matching the given key hash (the key is returned if there is no string)
+    // The reference stays valid until the language is changed
+    const std::string & string(const uint64_t, const std::string_view);
+
     // Return the string matching given key
-    // Defaults to English if current language does not have a string
-    std::string string(const std::string &);
+    inline const std::string & string(const std::string_view key) {
+        return string(hashKey(key), key);
+    }
 };
 
-// Inline operator for string()
-inline std::string operator ""_lang(const char * key, const size_t size) {
-    return Utils::Lang::string(std::string(key, size));
+// Inline operator for string() (the hash of a literal is folded in by the compiler)
+inline const std::string & operator ""_lang(const char * key, const size_t size) {
+    return Utils::Lang::string(std::string_view(key, size));
 }
 
 #endif
\ No newline at end of file
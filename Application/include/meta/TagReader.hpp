@@ -0,0 +1,68 @@
+#ifndef METADATA_TAGREADER_HPP
+#define METADATA_TAGREADER_HPP
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include "Types.hpp"
+#include <vector>
+
+namespace Metadata {
+    // A TagReader reads the metadata that is stored in the database (title, artist, album,
+    // track/disc number and duration) by only touching the parts of a file which hold it:
+    // the ID3v2 header region, ID3v1 trailer, FLAC metadata blocks and RIFF chunk headers.
+    // Reads are done in large blocks into a buffer which is kept between files, so an object
+    // should be reused (one per thread). Strings are only copied when converted to UTF-8.
+    class TagReader {
+        public:
+            // Result of reading a file
+            enum class Result {
+                Ok,             // The file was read (missing tags are left empty)
+                Malformed,      // The file isn't laid out as expected (try TagLib)
+                Error           // The file couldn't be read
+            };
+
+        private:
+            // Currently open file
+            std::FILE * file;
+            size_t fileSize;
+
+            // Buffered region of the file
+            std::vector<unsigned char> buffer;
+            size_t bufferOffset;
+            size_t bufferSize;
+
+            // Returns a pointer to the requested bytes, reading them if they aren't buffered
+            // Returns nullptr if they can't be read. Any previously returned pointer is invalidated!
+            const unsigned char * fetch(const size_t, const size_t);
+
+            // Read the ID3v1 tag at the end of the file (returns true if one was present)
+            bool readID3v1(Song &);
+            // Read the ID3v2 tag at the given offset, setting its size if present
+            Result readID3v2(const size_t, Song &, size_t &);
+            // Parse a single ID3v2 frame
+            void parseID3v2Frame(const std::string_view &, const unsigned char *, const size_t, Song &);
+            // Parse the fields in a Vorbis comment block
+            void parseXiphComment(const unsigned char *, const size_t, Song &);
+            // Parse the fields in a RIFF INFO list
+            void parseRIFFInfo(const unsigned char *, const size_t, Song &);
+
+            // Handle each format
+            Result readFLAC(Song &);
+            Result readMP3(Song &);
+            Result readWAV(Song &);
+
+        public:
+            // Constructor allocates the buffer
+            TagReader();
+
+            // Read the tags and duration of the given file into the passed Song,
+            // only filling values which are empty/negative
+            Result read(const std::string &, const AudioFormat, Song &);
+
+            // Closes the file if one is open
+            ~TagReader();
+    };
+};
+
+#endif
\ No newline at end of file
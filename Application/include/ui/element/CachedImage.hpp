@@ -0,0 +1,34 @@
+#ifndef ELEMENT_CACHEDIMAGE_HPP
+#define ELEMENT_CACHEDIMAGE_HPP
+
+#include "utils/TextureCache.hpp"
+
+namespace CustomElm {
+    // Draws an image from the shared texture cache, so the same image shown
+    // in multiple places (or created again) isn't decoded each time
+    class CachedImage : public Aether::Element {
+        private:
+            // Shared texture
+            Utils::TextureCache::Handle handle;
+            // Colour to tint with
+            Aether::Colour colour;
+
+        public:
+            // Constructor takes x, y, w, h and path to image
+            // The image is fetched for the larger of w and h
+            CachedImage(int, int, int, int, const std::string &);
+            // Constructor takes x, y, w, h and an already fetched texture
+            CachedImage(int, int, int, int, const Utils::TextureCache::Handle &);
+
+            // Change the texture that is drawn
+            void setHandle(const Utils::TextureCache::Handle &);
+
+            // Set colour to tint with
+            void setColour(const Aether::Colour &);
+
+            // Draws the texture stretched to the element's size
+            void render();
+    };
+};
+
+#endif
\ No newline at end of file
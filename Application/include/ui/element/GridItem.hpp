@@ -1,7 +1,8 @@
 #ifndef ELEMENT_GRIDITEM_HPP
 #define ELEMENT_GRIDITEM_HPP
 
-#include "Aether/Aether.hpp"
+#include "ui/element/CachedImage.hpp"
+#include "utils/ImageLoader.hpp"
 
 namespace CustomElm {
     class GridItem : public Aether::Element {
@@ -12,8 +13,15 @@ namespace CustomElm {
         };
 
         private:
-            // Artist image
-            Aether::Image * image;
+            // Image (shows the placeholder until it has been decoded in the background)
+            std::string path;
+            CustomElm::CachedImage * image;
+            Utils::TextureCache::Handle placeholder;
+            Utils::ImageLoader::Ticket ticket;
+
+            // Position during the last update (used to determine scroll direction)
+            int lastX;
+            int lastY;
 
             // Texts
             Aether::Text * main;
@@ -30,6 +38,18 @@ namespace CustomElm {
             // Positions items after rendering
             void positionItems();
 
+            // Returns the priority to decode the image with (the distance from the screen,
+            // halved if the item is moving towards it)
+            int imagePriority();
+            // Use the cached image or queue it to be decoded
+            void requestImage();
+            // Upload the image once decoded, otherwise update the request's priority
+            void checkImage();
+            // Cancel any request and show the placeholder again
+            void releaseImage();
+            // Destroy and hide all textures (they're rendered again when needed)
+            void destroyTextures();
+
         public:
             // Constructor sets up elements and takes path to image
             GridItem(std::string);
@@ -48,14 +68,21 @@ namespace CustomElm {
             // Set callback for "more" button
             void setMoreCallback(std::function<void()>);
 
-            // Set strings
+            // Set strings/image (call refresh() afterwards if the item has already been shown)
+            void setImagePath(const std::string &);
             void setMainString(std::string);
             void setSubString(std::string);
 
+            // Render and position everything again (i.e. when recycled by a grid)
+            void refresh();
+
             // Set colours
             void setDotsColour(Aether::Colour);
             void setTextColour(Aether::Colour);
             void setMutedTextColour(Aether::Colour);
+
+            // Cancels any pending request
+            ~GridItem();
     };
 };
 
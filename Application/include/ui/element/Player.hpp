@@ -13,7 +13,7 @@ namespace CustomElm {
             Aether::Rectangle * playerBg;
 
             // Album art and track metadata
-            Aether::Image * albumCover;
+            Aether::Element * albumCover;
             Aether::Text * trackName;
             Aether::Text * trackArtist;
             Aether::Text * trackArtistDots;
@@ -65,7 +65,9 @@ namespace CustomElm {
             Player();
 
             // Set element values (some will only take effect if not selected)
-            void setAlbumCover(Aether::Image *);
+            void setAlbumCover(Aether::Element *);
+            // Set the album cover by path (shared through the texture cache)
+            void setAlbumCover(const std::string &);
             void setTrackName(std::string);
             void setTrackArtist(std::string);
             void setShuffle(bool);
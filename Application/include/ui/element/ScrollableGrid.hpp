@@ -5,13 +5,27 @@
 
 namespace CustomElm {
     // This is a copy of Aether's Scrollable/List classes but instead of expecting rows
-    // it expects and handles everything in a grid
+    // it expects and handles everything in a grid.
+    // Items can either be added up front, or provided by a data source (see setCount) in which
+    // case only the items in and around the visible rows are created, and are recycled by
+    // binding them to another index as the grid scrolls. Focus is then tracked by index.
     class ScrollableGrid : public Aether::Container {
         private:
             // Grid dimensions
             unsigned int rowHeight;
             unsigned int cols;
 
+            // Data source functions to create an item and bind it to an index
+            std::function<Aether::Element *()> createItem;
+            std::function<void(Aether::Element *, size_t)> bindItem;
+            // Whether items come from the above functions
+            bool dataSource;
+            // Number of items and focused index (data source only)
+            size_t count_;
+            size_t focusedIndex_;
+            // Index bound to each child, where the child for an index is at (index % children.size())
+            std::vector<size_t> itemIndex;
+
             // Scrollable vars
             bool isScrolling;
             bool isTouched;
@@ -26,6 +40,17 @@ namespace CustomElm {
             // Positions given child (x and y) based on index
             void positionChild(Aether::Element *, size_t);
 
+            // Returns the number of items in the grid
+            size_t itemCount();
+            // Create enough items to fill the grid plus a margin (data source only)
+            void createItems();
+            // Bind and position the items around the current scroll position (data source only)
+            void bindItems();
+            // Focus the item for the focused index if it's bound (data source only)
+            void focusItem();
+            // Move focus by the given number of items, returning false if it can't move
+            bool moveFocus(int);
+
             // Scrollable methods
             void setScrollPos(int);
             void stopScrolling();
@@ -42,6 +67,19 @@ namespace CustomElm {
             void addElement(Aether::Element *);
             void removeAllElements();
 
+            // Set the functions used to create an item and bind it to an index
+            void setCreateItemFunc(std::function<Aether::Element *()>);
+            void setBindItemFunc(std::function<void(Aether::Element *, size_t)>);
+            // Set the number of items (switching to data source mode), resetting the scroll position
+            void setCount(const size_t);
+            // Change the number of items, keeping the scroll position and focus where possible (i.e. as more are loaded)
+            void updateCount(const size_t);
+            // Rebind all bound items (call if the underlying data changes; data source only)
+            void refresh();
+            // Returns/sets the index of the focused item (data source only)
+            size_t focusedIndex();
+            void setFocusedIndex(const size_t);
+
             // Implements required behaviour
             bool handleEvent(Aether::InputEvent *);
             void update(uint32_t);
@@ -0,0 +1,90 @@
+#ifndef ELEMENT_VIRTUALLIST_HPP
+#define ELEMENT_VIRTUALLIST_HPP
+
+#include "Aether/Aether.hpp"
+
+namespace CustomElm {
+    // A vertical list of fixed height rows which only creates elements for the rows in and
+    // around the visible area. As the list scrolls these elements are recycled by binding
+    // them to another index, so memory and creation time don't depend on the number of rows.
+    // Focus is tracked by index rather than by element. Scrolling behaves like Aether::List.
+    class VirtualList : public Aether::Container {
+        private:
+            // Functions to create a row element and bind it to an index
+            std::function<Aether::Element *()> createRow;
+            std::function<void(Aether::Element *, size_t)> bindRow;
+
+            // Row elements, where the element for an index is at (index % rows.size())
+            std::vector<Aether::Element *> rows;
+            std::vector<size_t> rowIndex;
+
+            // Number of rows, height of each row and focused index
+            size_t count_;
+            unsigned int rowHeight;
+            size_t focusedIndex_;
+
+            // Scrollable vars
+            bool isScrolling;
+            bool isTouched;
+            int scrollVelocity;
+            int scrollPos;
+            int maxScrollPos;
+            SDL_Texture * scrollBar;
+            Aether::Colour scrollBarColour;
+            bool showScrollBar_;
+            int touchY;
+
+            // Create enough row elements to fill the list (plus a margin)
+            void createRows();
+            // Bind and position the rows around the current scroll position
+            void bindRows();
+            // Focus the element for the focused index (if it's bound)
+            void focusRow();
+
+            // Scrollable methods
+            void stopScrolling();
+            void updateMaxScrollPos();
+
+        public:
+            // Constructor accepts x, y, w, h and height of each row
+            VirtualList(int, int, int, int, unsigned int);
+
+            // Set the function called to create a row element (must be set before setCount)
+            void setCreateRowFunc(std::function<Aether::Element *()>);
+            // Set the function called to show the data at the given index in a row element
+            void setBindRowFunc(std::function<void(Aether::Element *, size_t)>);
+
+            // Set the number of rows, rebinding all elements and resetting the scroll position
+            void setCount(const size_t);
+            // Change the number of rows and rebind all elements, keeping the scroll position and focus (where possible)
+            void updateCount(const size_t);
+            size_t count();
+            // Rebind all bound rows (call if the underlying data changes)
+            void refresh();
+
+            // Jump to the given scroll position (px) or index
+            void setScrollPos(int);
+            void scrollToIndex(const size_t);
+
+            // Returns/sets the index of the focused row
+            size_t focusedIndex();
+            void setFocusedIndex(const size_t);
+
+            // Implements required behaviour
+            bool handleEvent(Aether::InputEvent *);
+            void update(uint32_t);
+            void render();
+
+            // Need to reposition rows
+            void setW(int);
+            void setH(int);
+
+            // Scrollable methods
+            void setShowScrollBar(bool);
+            void setScrollBarColour(Aether::Colour);
+
+            ~VirtualList();
+    };
+};
+
+#endif
\ No newline at end of file
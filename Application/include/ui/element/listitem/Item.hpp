@@ -40,6 +40,9 @@ namespace CustomElm::ListItem {
             // Set colour to tint line with
             void setLineColour(Aether::Colour);
 
+            // Render and position the textures again (call after changing them, i.e. when recycled)
+            void refresh();
+
             // Check and update texture rendering things
             void update(uint32_t);
 
@@ -3,6 +3,7 @@
 
 #include "db/Database.hpp"
 #include "ui/frame/Frame.hpp"
+#include "utils/Pager.hpp"
 #include "ui/overlay/ArtistList.hpp"
 #include "ui/overlay/ItemMenu.hpp"
 
@@ -19,6 +20,15 @@ namespace Frame {
         private:
             // Grid of items
             CustomElm::ScrollableGrid * grid;
+            // Metadata of each item in the grid, loaded a page at a time (items are only created for those visible)
+            Utils::Pager<Metadata::Album> * albums;
+
+            // Sort order of current list
+            Database::SortBy sortType;
+            // Library version the list was loaded from (reloaded if it changes)
+            unsigned int libraryVersion;
+            // Message shown when the library is empty
+            Aether::Text * emptyMsg;
 
             // Menu displayed when the dots are pressed
             CustomOvl::ArtistList * artistsList;
@@ -29,11 +39,16 @@ namespace Frame {
             void createArtistsList(AlbumID);
             void createList(Database::SortBy);
             void createMenu(AlbumID);
+            // Show the number of albums, or a message if there are none
+            void updateTotal();
 
         public:
             // Constructor sets strings and forms list using database
             Albums(Main::Application *);
 
+            // Reloads the list if the library has changed (i.e. while scanning)
+            void update(uint32_t);
+
             // Delete menu if there is one
             ~Albums();
     };
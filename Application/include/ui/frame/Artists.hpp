@@ -3,6 +3,7 @@
 
 #include "db/Database.hpp"
 #include "ui/frame/Frame.hpp"
+#include "utils/Pager.hpp"
 #include "ui/overlay/ItemMenu.hpp"
 
 // Forward declarations
@@ -18,6 +19,15 @@ namespace Frame {
         private:
             // Grid of items
             CustomElm::ScrollableGrid * grid;
+            // Metadata of each item in the grid, loaded a page at a time (items are only created for those visible)
+            Utils::Pager<Metadata::Artist> * artists;
+
+            // Sort order of current list
+            Database::SortBy sortType;
+            // Library version the list was loaded from (reloaded if it changes)
+            unsigned int libraryVersion;
+            // Message shown when the library is empty
+            Aether::Text * emptyMsg;
 
             // Menu displayed when the dots are pressed
             CustomOvl::ItemMenu * menu;
@@ -30,11 +40,16 @@ namespace Frame {
 
             // (Re)create main list
             void createList(Database::SortBy);
+            // Show the number of artists, or a message if there are none
+            void updateTotal();
 
         public:
             // Constructor sets strings and forms list using database
             Artists(Main::Application *);
 
+            // Reloads the list if the library has changed (i.e. while scanning)
+            void update(uint32_t);
+
             // Delete menu if there is one
             ~Artists();
     };
@@ -1,13 +1,14 @@
 #ifndef FRAME_PLAYLIST_HPP
 #define FRAME_PLAYLIST_HPP
 
-#include "db/Database.hpp"
+#include "db/MetadataStore.hpp"
+#include <memory>
 #include "Types.hpp"
 #include "ui/frame/Frame.hpp"
 
 // Forward declarations cause only pointers are needed here
-namespace CustomElm::ListItem {
-    class Song;
+namespace CustomElm {
+    class VirtualList;
 };
 
 namespace CustomOvl {
@@ -34,12 +35,13 @@ namespace Frame {
             // UI elements
             Aether::FilledButton * playButton;
             Aether::Text * emptyMsg;
-            Aether::Image * image;
+            Aether::Element * image;
+            CustomElm::VirtualList * songList;
 
-            // Cached data
-            std::vector<CustomElm::ListItem::Song *> elms;
+            // Cached data (songs are stored as playlist entry ID and song ID)
             Metadata::Playlist metadata;
-            std::vector<Metadata::PlaylistSong> songs;
+            std::shared_ptr<const MetadataStore> store;
+            std::vector<std::pair<PlaylistSongID, SongID>> songs;
 
             // Functions to create menus
             void createDeleteMenu();
@@ -55,6 +57,8 @@ namespace Frame {
             // Repopulates list
             void calculateStats();
             void refreshList(Database::SortBy);
+            // Show the song at the given index in a recycled row
+            void bindRow(Aether::Element *, size_t);
 
         public:
             // The constructor takes the ID of the playlist to show
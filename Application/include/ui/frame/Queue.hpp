@@ -1,7 +1,9 @@
 #ifndef FRAME_QUEUE_HPP
 #define FRAME_QUEUE_HPP
 
+#include "db/MetadataStore.hpp"
 #include <list>
+#include <memory>
 #include "ui/frame/Frame.hpp"
 
 // Forward declarations as these are used within the frame
@@ -31,8 +33,8 @@ namespace Frame {
             Aether::Text * upnextStr;
             std::list<CustomElm::ListItem::Song *> upnextEls;
 
-            // Temporary vector of song metadata
-            std::vector<Metadata::Song> songMeta;
+            // Shared song metadata
+            std::shared_ptr<const MetadataStore> songMeta;
 
             // Empty message
             Aether::Text * emptyMsg;
@@ -1,6 +1,8 @@
 #ifndef FRAME_SEARCH_HPP
 #define FRAME_SEARCH_HPP
 
+#include <atomic>
+#include <mutex>
 #include "ui/frame/Frame.hpp"
 #include "ui/overlay/ArtistList.hpp"
 #include "ui/overlay/Overlay.hpp"
@@ -8,7 +10,26 @@
 
 namespace Frame {
     class Search : public Frame {
+        public:
+            // Results for a single query
+            struct Results {
+                std::vector<Metadata::Song> songs;
+                std::vector<Metadata::Album> albums;
+                std::vector<Metadata::Artist> artists;
+                std::vector<Metadata::Playlist> playlists;
+            };
+
         private:
+            // Each stage of the search (performed in this order)
+            enum class Stage {
+                Songs,          // Songs have been found
+                Albums,         // Albums have been found
+                Artists,        // Artists have been found
+                Playlists,      // Playlists have been found
+                Done,           // All categories have been searched
+                Error           // An error occurred (search was stopped)
+            };
+
             // Cached songIDs (used to set play queue)
             std::vector<SongID> songIDs;
 
@@ -16,7 +37,8 @@ namespace Frame {
             bool listEmpty;
 
             // Functions that setup/add relevant entries to the list
-            void addEntries();
+            void prepareList();
+            void showNoResults();
             void addPlaylists();
             void addArtists();
             void addAlbums();
@@ -30,7 +52,14 @@ namespace Frame {
             void showSearching();
 
             // Function run by other thread to actually search the database
-            bool searchDatabase(const std::string &);
+            // Each category is published as soon as it's ready
+            void searchDatabase(const std::string);
+
+            // Returns true if this search has been cancelled or superseded by a newer one
+            bool isStale();
+
+            // Called by the search thread to pass a finished stage to the UI thread
+            void publishStage(const Stage);
 
             // Functions to create appropriate menus
             CustomOvl::ItemMenu * menu;
@@ -50,8 +79,19 @@ namespace Frame {
             std::vector<Metadata::Album> albums;
             std::vector<Metadata::Song> songs;
 
-            // Future returning true if search appeared to succeed
-            std::future<bool> searchThread;
+            // Results written by the search thread which haven't been shown yet
+            // (both protected by the mutex)
+            Results pending;
+            std::vector<Stage> pendingStages;
+            std::mutex pendingMutex;
+
+            // Set true to stop the search thread at the next stage
+            std::atomic<bool> cancelled;
+            // Number identifying this search (a newer search cancels older ones)
+            unsigned int generation;
+
+            // Future for the search thread
+            std::future<void> searchThread;
 
             // Set true after the thread is done to avoid accessing an invalid future
             bool threadDone;
@@ -60,10 +100,10 @@ namespace Frame {
             // Constructor sets up elements and invokes keyboard
             Search(Main::Application *);
 
-            // Checks if the thread is finished
+            // Adds results to the list as each category is found
             void update(uint32_t);
 
-            // Delete created menu
+            // Cancels the search and deletes created menu
             ~Search();
     };
 };
@@ -1,10 +1,14 @@
 #ifndef FRAME_SONGS_HPP
 #define FRAME_SONGS_HPP
 
-#include "db/Database.hpp"
+#include "db/MetadataStore.hpp"
+#include <memory>
 #include "ui/frame/Frame.hpp"
 
 // Forward declaration as the class is used within the frame
+namespace CustomElm {
+    class VirtualList;
+}
 namespace CustomOvl {
     class ItemMenu;
     class SortBy;
@@ -13,17 +17,30 @@ namespace CustomOvl {
 namespace Frame {
     class Songs : public Frame {
         private:
-            // Cached songIDs (used to set play queue)
+            // Shared metadata, the row shown at each index and cached songIDs (used to set play queue)
+            std::shared_ptr<const MetadataStore> store;
+            std::vector<MetadataStore::Row> rows;
             std::vector<SongID> songIDs;
 
+            // List which only creates the visible rows (used instead of Frame's list)
+            CustomElm::VirtualList * songList;
+
+            // Sort order of current list
+            Database::SortBy sortType;
+            // Message shown when the library is empty
+            Aether::Text * emptyMsg;
+
             // Sort by menu
             CustomOvl::SortBy * sortMenu;
 
             // Menu displayed when a song's "dots" are pressed
             CustomOvl::ItemMenu * menu;
 
-            // (Re)create list with given sorting order
-            void createList(Database::SortBy);
+            // (Re)create list with given sorting order (optionally keeping the scroll position and focus)
+            void createList(Database::SortBy, const bool = false);
+
+            // Show the song at the given index in a recycled row
+            void bindRow(Aether::Element *, size_t);
 
             // Create the above menu
             void createMenu(SongID);
@@ -32,6 +49,9 @@ namespace Frame {
             // Constructor sets strings and forms list using database
             Songs(Main::Application *);
 
+            // Recreates the list if the library has changed (i.e. while scanning)
+            void update(uint32_t);
+
             // Delete created menu
             ~Songs();
     };
@@ -9,6 +9,8 @@ namespace Frame::Settings {
         private:
             // Helper called by 'Remove Images' to clean up database and folder
             void removeImages();
+            // Returns a string summarising the image cache's counters
+            std::string imageCacheStats();
 
         public:
             // Constructor creates needed elements
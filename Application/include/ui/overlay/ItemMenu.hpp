@@ -10,7 +10,7 @@ namespace CustomOvl {
         private:
             // Elements
             Aether::Element * top;
-            Aether::Image * image;
+            Aether::Element * image;
             Aether::Text * mainText;
             Aether::Text * subText;
 
@@ -19,7 +19,9 @@ namespace CustomOvl {
             ItemMenu();
 
             // Set each of the elements (positioned automatically)
-            void setImage(Aether::Image *);
+            void setImage(Aether::Element *);
+            // Set the image by path (shared through the texture cache)
+            void setImage(const std::string &);
             void setMainText(const std::string &);
             void setSubText(const std::string &);
 
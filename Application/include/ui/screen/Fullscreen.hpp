@@ -1,6 +1,7 @@
 #ifndef SCREEN_FULLSCREEN_HPP
 #define SCREEN_FULLSCREEN_HPP
 
+#include "Types.hpp"
 #include "ui/element/Image.hpp"
 #include "ui/element/RoundButton.hpp"
 #include "ui/element/Slider.hpp"
@@ -78,8 +79,8 @@ namespace Screen {
             // Set all element colours based on primary/secondary colours
             void setColours();
 
-            // Updates the image and extracts/sets colours based on image
-            void updateImage(const std::string &);
+            // Updates the image and sets colours using the album's palette (picked from the image if it has none)
+            void updateImage(const std::string &, const AlbumID);
 
         public:
             Fullscreen(Main::Application *);
@@ -10,6 +10,7 @@
 
 namespace Main {
     class Application;
+    enum class ScanStage;
 };
 
 namespace Screen {
@@ -51,6 +52,9 @@ namespace Screen {
             Aether::Rectangle * sideSeparator3;
             CustomElm::SideButton * sideSettings;
             Aether::Ellipse * updateDot;
+            Aether::Text * scanText;
+            Aether::RoundProgressBar * scanProgress;
+            Aether::BorderButton * scanRetry;
 
             // Player
             CustomElm::Player * player;
@@ -65,6 +69,11 @@ namespace Screen {
 
             // Cached vars to avoid updating every frame
             SongID playingID;
+            Main::ScanStage scanStage;
+            size_t scanFile;
+
+            // Updates the indicator showing the progress of a library scan
+            void updateScanProgress();
 
             // Function called to go 'back'
             void backCallback();
@@ -12,19 +12,16 @@ namespace Main {
 
 namespace Screen {
     // The 'Splash' screen is shown when the application is launched.
-    // It is displayed while the library is scanned and the database
-    // is updated. It portrays the progress of the update.
+    // It checks the sysmodule is running and ensures the database is up
+    // to date before starting a library scan (which runs in the background).
     class Splash : public Screen {
         private:
-            // Stages in the library scan
-            enum class ScanStage {
-                Launch,         // Not scanning yet
-                Files,          // Searching for file changes
-                Metadata,       // Extracting metadata from files
-                Database,       // Updating database to match filesystem
-                Art,            // Extracting album art from needd files
+            // Stages in preparing to launch
+            enum class Stage {
+                Launch,         // Not doing anything yet
+                Migrate,        // Updating the database's structure
                 Done,           // Everything is done
-                Error           // An error occurred during the scan
+                Error           // An error occurred while preparing
             };
 
             // Set true when an error has occurred (allows exit)
@@ -35,41 +32,27 @@ namespace Screen {
             Aether::Text * version;
             Aether::Text * heading;
             Aether::Text * subheading;
-            Aether::RoundProgressBar * progress;
-            Aether::Text * percent;
             Aether::Animation * animation;
             std::array<Aether::Image *, 50> animFrames;
-            Aether::Text * hint;
             Aether::BorderButton * launch;
             Aether::BorderButton * quit;
 
             // Helper functions to update UI
             void setErrorConnect();
             void setErrorVersion();
-            void setScanLaunch();
-            void setScanFiles();
-            void setScanMetadata();
-            void setScanDatabase();
-            void setScanArt();
-            void setScanError();
+            void setLaunch();
+            void setMigrate();
+            void setError();
 
             // === Variables to communicate status between threads === //
             // Future for thread
             std::future<void> future;
-            // Stage in scan
-            std::atomic<ScanStage> currentStage;
-            ScanStage lastStage;
-            // Number of scanned (completed) files
-            std::atomic<size_t> currentFile;
-            // Total number of files to scan/update
-            std::atomic<size_t> totalFiles;
-            // Used to detect change
-            size_t lastFile;
-            // Number of estimated seconds remaining
-            std::atomic<size_t> estRemaining;
+            // Current stage
+            std::atomic<Stage> currentStage;
+            Stage lastStage;
 
-            // Function run on another thread to control library scan
-            void scanLibrary();
+            // Function run on another thread to prepare the database and start scanning
+            void prepareDatabase();
 
         public:
             Splash(Main::Application *);
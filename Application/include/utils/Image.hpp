@@ -1,14 +1,45 @@
 #ifndef UTILS_IMAGE_HPP
 #define UTILS_IMAGE_HPP
 
+#include <string>
 #include <vector>
 
 namespace Utils::Image {
+    // Filter used when resizing
+    enum class Filter {
+        Fast,       // Bilinear/area filter (quick and good enough for downscaling)
+        Quality     // AVIR (slower but sharper)
+    };
+
     // Resizes the given image to the provided dimensions
     // The buffer will be replaced with the resized image as a PNG
-    // Accepts raw PNG/JPEG file, resized width, resized height
+    // Accepts raw PNG/JPEG file, resized width, resized height and filter
+    // Returns true on success, false on an error
+    bool resize(std::vector<unsigned char> &, size_t, size_t, const Filter = Filter::Fast);
+
+    // Decodes an image into RGBA pixels, shrinking it (keeping the aspect ratio) if either side is larger than the given size
+    // Accepts raw PNG/JPEG file, max size, and the pixels, width and height to fill in
+    // Returns true on success, false on an error
+    bool getPixels(const std::vector<unsigned char> &, size_t, std::vector<unsigned char> &, size_t &, size_t &);
+
+    // Writes smaller copies (200px and 96px) of an image next to it, which are drawn
+    // instead of the full image when it is shown at a smaller size
+    // Accepts raw PNG/JPEG file (usually already resized) and path of the full image
     // Returns true on success, false on an error
-    bool resize(std::vector<unsigned char> &, size_t, size_t);
+    bool writeThumbnails(const std::vector<unsigned char> &, const std::string &);
+
+    // Returns the path to the smallest copy of an image that is at least the given size
+    // The original path is returned if there is no suitable copy
+    std::string thumbnailPath(const std::string &, const size_t);
+
+    // Returns whether the smaller copies of an image exist
+    bool hasThumbnails(const std::string &);
+
+    // Returns the paths to the smaller copies of an image (which may not exist)
+    std::vector<std::string> thumbnailPaths(const std::string &);
+
+    // Delete an image and any smaller copies of it
+    void deleteImage(const std::string &);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,53 @@
+#ifndef UTILS_IMAGELOADER_HPP
+#define UTILS_IMAGELOADER_HPP
+
+#include "Aether/Aether.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+
+// Decodes images on background threads so elements can show a placeholder
+// instead of blocking the UI thread. Queued requests are decoded in order of
+// priority (lowest value first), which can be changed at any time, and the
+// decoded surface is handed back to the UI thread to be uploaded as a texture.
+namespace Utils::ImageLoader {
+    // State of a request
+    enum class Status {
+        Queued,         // Waiting for a worker
+        Decoding,       // Being decoded by a worker
+        Done,           // Finished (surface is nullptr if the image couldn't be decoded)
+        Cancelled       // No longer wanted
+    };
+
+    // A request to decode an image, shared between the requester and the workers
+    struct Request {
+        std::string path;               // Path to image that was requested
+        size_t size;                    // Size it will be drawn at (a smaller copy is used if there is one)
+        std::atomic<int> priority;      // Lower values are decoded first
+        std::atomic<Status> status;     // Current state
+        SDL_Surface * surface;          // Decoded surface (only valid once Done)
+
+        // Frees the surface if it wasn't taken
+        ~Request();
+    };
+    typedef std::shared_ptr<Request> Ticket;
+
+    // Start the given number of worker threads
+    void start(const size_t);
+
+    // Stop and join all workers (any queued requests are cancelled)
+    void stop();
+
+    // Queue an image to be decoded
+    // Accepts path to image, size it will be drawn at and initial priority
+    Ticket request(const std::string &, const size_t, const int);
+
+    // Cancel a request (the surface is freed if it was already decoded)
+    void cancel(const Ticket &);
+
+    // Returns the decoded surface once a request is done, transferring ownership to the caller
+    // Returns nullptr if it isn't done yet (or couldn't be decoded)
+    SDL_Surface * take(const Ticket &);
+};
+
+#endif
\ No newline at end of file
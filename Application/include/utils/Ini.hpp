@@ -0,0 +1,56 @@
+#ifndef UTILS_INI_HPP
+#define UTILS_INI_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace Utils {
+    // Holds a copy of an .ini file in memory, so values can be read and changed any number
+    // of times without touching the SD card until write() is called. Comments and the
+    // layout of the file are kept as they were read.
+    class Ini {
+        private:
+            // Path to file
+            std::string path;
+            // Each line of the file
+            std::vector<std::string> lines;
+            // Whether lines end with \r\n (kept when written)
+            bool crlf;
+            // Whether the lines have changed since being read/written, and the time of the last change
+            bool changed;
+            std::chrono::steady_clock::time_point changeTime;
+
+            // Returns the index of the line holding the key's value, or -1 if there isn't one
+            // 'insert' is set to the index a new key should be inserted at (-1 if the section doesn't exist)
+            int findKey(const std::string &, const std::string &, int &);
+
+        public:
+            // The constructor doesn't read the file
+            Ini(const std::string &);
+
+            // Read the file, discarding any unwritten changes
+            // Returns false if the file doesn't exist or couldn't be read
+            bool read();
+
+            // Returns whether there are unwritten changes, ignoring them if one was
+            // made within the given number of milliseconds
+            bool hasChanges(const unsigned int = 0);
+
+            // Write the file if it has changed, replacing it only once everything has been written
+            // Returns true if successful, false otherwise
+            bool write();
+
+            // Get the value of a key, returning the default if it isn't present
+            std::string gets(const std::string &, const std::string &, const std::string & = "");
+            long geti(const std::string &, const std::string &, const long = 0);
+            bool getbool(const std::string &, const std::string &, const bool = false);
+
+            // Set the value of a key, adding the key/section if needed
+            // Returns false if the section or key is blank
+            bool put(const std::string &, const std::string &, const std::string &);
+            bool put(const std::string &, const std::string &, const long);
+    };
+};
+
+#endif
\ No newline at end of file
@@ -54,9 +54,15 @@ namespace Utils::NX {
     // Does nothing if state matches
     void setCPUBoost(bool);
 
+    // Returns true if the application is in the foreground (i.e. has focus)
+    bool inFocus();
+
     // Enable/disable low fs priority
     void setLowFsPriority(bool);
 
+    // Enable/disable low priority for the calling thread (so it only runs when the UI is idle)
+    void setLowThreadPriority(bool);
+
     // Enable/disable 'media playing' flag
     // Does nothing if state matches
     void setPlayingMedia(bool);
@@ -0,0 +1,175 @@
+#ifndef UTILS_PAGER_HPP
+#define UTILS_PAGER_HPP
+
+#include <algorithm>
+#include "db/Database.hpp"
+#include <functional>
+#include <future>
+#include <vector>
+
+namespace Utils {
+    // Holds the items of a listing which is read from the database one page at a time. Call
+    // prefetch() with each index that is shown; once it's close to the end of the loaded items
+    // the next page is fetched on another thread, so it's usually ready before it's needed.
+    // When the library changes, refresh() reloads the items already loaded on another thread,
+    // and they're replaced once ready so the listing is kept without blocking.
+    // Note that this class is not thread-safe; all methods should be called on the UI thread.
+    template <typename T>
+    class Pager {
+        public:
+            // Function which returns the page after the cursor (see Database::Cursor)
+            typedef std::function<std::vector<T>(Database::Cursor &, const size_t)> FetchFunc;
+
+        private:
+            // Function used to fetch each page
+            FetchFunc fetch;
+            // Position of the next page (only used by the fetching thread while a fetch is pending,
+            // so check pending before reading it)
+            Database::Cursor cursor;
+            // Set once a fetch fails, after which no more are made (until refreshed)
+            bool failed;
+            // Number of items per page
+            size_t pageSize;
+            // Highest index passed to prefetch()
+            size_t wanted;
+
+            // Items loaded so far
+            std::vector<T> items;
+            // Page being fetched in the background
+            std::future< std::vector<T> > pending;
+
+            // Position after the reloaded items (only used by the refreshing thread while a refresh is pending)
+            Database::Cursor refreshCursor;
+            // Items being reloaded in the background
+            std::future< std::vector<T> > refreshing;
+            // Set true if refresh() is called while already refreshing (another is started once done)
+            bool refreshQueued;
+
+            // Fetch the next page on another thread if one isn't already being fetched
+            // (or the items are being reloaded, as the page would be replaced anyway)
+            void fetchNext() {
+                if (this->pending.valid() || this->refreshing.valid() || this->cursor.done || this->failed) {
+                    return;
+                }
+                this->pending = std::async(std::launch::async, [this]() {
+                    return this->fetch(this->cursor, this->pageSize);
+                });
+            }
+
+            // Reload the items loaded so far on another thread
+            void startRefresh() {
+                this->refreshCursor = Database::Cursor(this->cursor.sort);
+                size_t count = std::max(this->pageSize, this->items.size());
+                this->refreshing = std::async(std::launch::async, [this, count]() {
+                    return this->fetch(this->refreshCursor, count);
+                });
+            }
+
+        public:
+            // Constructor takes the fetch function, order and page size, and fetches the first page
+            // (this blocks, so only one small query is needed before anything can be shown)
+            Pager(const FetchFunc & func, const Database::SortBy sort, const size_t pageSize) : cursor(sort), refreshCursor(sort) {
+                this->fetch = func;
+                this->pageSize = pageSize;
+                this->wanted = 0;
+                this->refreshQueued = false;
+                this->items = this->fetch(this->cursor, pageSize);
+                this->failed = (this->items.empty() && !this->cursor.done);
+            }
+
+            // Returns the number of items loaded so far
+            size_t size() const {
+                return this->items.size();
+            }
+
+            // Returns whether every item has been loaded (or no more can be)
+            bool done() const {
+                return (!this->pending.valid() && !this->refreshing.valid() && (this->cursor.done || this->failed));
+            }
+
+            // Returns the item at the given index (which must be loaded)
+            const T & operator[](const size_t idx) const {
+                return this->items[idx];
+            }
+
+            // Hint that the item at the given index is about to be shown, which starts
+            // fetching the next page if within half a page of the end of the loaded items
+            void prefetch(const size_t idx) {
+                this->wanted = std::max(this->wanted, idx);
+                if (this->wanted + this->pageSize/2 >= this->items.size()) {
+                    this->fetchNext();
+                }
+            }
+
+            // Reload the items loaded so far in the background (see finishRefresh()). Calls made
+            // while already refreshing are combined into one more refresh once it finishes
+            void refresh() {
+                if (this->refreshing.valid()) {
+                    this->refreshQueued = true;
+                    return;
+                }
+                this->startRefresh();
+            }
+
+            // Replace the items with the reloaded ones if they're ready (discarding a fetched page, as it
+            // follows the old items). Call before update(). Returns true if the items were replaced
+            bool finishRefresh() {
+                if (!this->refreshing.valid() || this->refreshing.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    return false;
+                }
+                if (this->pending.valid()) {
+                    if (this->pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                        return false;
+                    }
+                    this->pending.get();
+                }
+
+                // Keep the old items if the query failed
+                std::vector<T> items = this->refreshing.get();
+                bool replaced = (!items.empty() || this->refreshCursor.done);
+                if (replaced) {
+                    this->items = items;
+                    this->cursor = this->refreshCursor;
+                    this->failed = false;
+                }
+
+                if (this->refreshQueued) {
+                    this->refreshQueued = false;
+                    this->startRefresh();
+                }
+                this->prefetch(this->wanted);
+                return replaced;
+            }
+
+            // Add the fetched page to the loaded items if it's ready, fetching another if
+            // the hinted index is still close to the end. An empty page before the end means
+            // the query failed, so no more are fetched rather than retrying every frame
+            // Returns true if items were added
+            bool update() {
+                if (!this->pending.valid() || this->pending.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                    return false;
+                }
+
+                std::vector<T> page = this->pending.get();
+                if (page.empty() && !this->cursor.done) {
+                    this->failed = true;
+                    return false;
+                }
+                this->items.insert(this->items.end(), page.begin(), page.end());
+                this->prefetch(this->wanted);
+                return !page.empty();
+            }
+
+            // Destructor waits for a pending fetch or refresh to finish (as they use this object)
+            ~Pager() {
+                if (this->pending.valid()) {
+                    this->pending.wait();
+                }
+                if (this->refreshing.valid()) {
+                    this->refreshing.wait();
+                }
+            }
+    };
+};
+
+#endif
\ No newline at end of file
@@ -15,6 +15,10 @@ namespace Utils::Search {
     // forming phrases where each 'string' is a word
     // Ordered best (lowest score) first
     std::vector<std::string> getPhrases(std::vector< std::vector<ScoredString> > &, size_t);
+
+    // Returns the key used to sort the given name: case-folded, with accents stripped from Latin
+    // letters and a leading "The " ignored (eg. "The Édith Band" -> "edith band")
+    std::string sortKey(const std::string &);
 };
 
 #endif
\ No newline at end of file
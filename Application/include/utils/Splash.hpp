@@ -2,6 +2,7 @@
 #define UTILS_SPLASH_HPP
 
 #include "Aether/Aether.hpp"
+#include "Types.hpp"
 
 // These helper functions use the 'splash' library to return prominent colours
 // in the given image
@@ -19,7 +20,15 @@ namespace Utils::Splash {
     Aether::Colour changeLightness(Aether::Colour, int);
 
     // Returns the above struct filled with colours for the given image
+    // (it's shrunk first, as the colours picked barely change)
     Palette getPaletteForSurface(SDL_Surface *);
+    // Returns the above struct filled with colours for the image at the given path
+    // (uses the smallest copy of the image, so it's quick enough to call when art is saved)
+    Palette getPaletteForImage(const std::string &);
+
+    // Convert a palette to/from the form stored in the database
+    Metadata::Palette packPalette(const Palette &);
+    Palette unpackPalette(const Metadata::Palette &);
 
     // Return a colour interpolated between the two provided colours at the given position (0 - 1)
     Aether::Colour interpolateColours(const Aether::Colour &, const Aether::Colour &, double);
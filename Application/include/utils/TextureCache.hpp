@@ -0,0 +1,59 @@
+#ifndef UTILS_TEXTURECACHE_HPP
+#define UTILS_TEXTURECACHE_HPP
+
+#include "Aether/Aether.hpp"
+#include <memory>
+#include <string>
+
+// App-wide cache of image textures keyed by path and requested size, so the same
+// image isn't decoded again each time a frame/overlay showing it is created.
+// Textures are shared through reference counted handles and the least recently
+// used textures which aren't referenced are destroyed once over the memory budget.
+// Note that this must only be used on the UI (rendering) thread.
+namespace Utils::TextureCache {
+    // A cached texture, destroyed once the cache and all handles have released it
+    struct Texture {
+        SDL_Texture * texture;      // The texture (nullptr if the image couldn't be loaded)
+        int width;                  // Width of texture (px)
+        int height;                 // Height of texture (px)
+        size_t bytes;               // Estimated memory used (bytes)
+
+        ~Texture();
+    };
+    typedef std::shared_ptr<Texture> Handle;
+
+    // Counters describing how well the cache is doing
+    struct Stats {
+        size_t hits;                // Number of requests served from the cache
+        size_t misses;              // Number of requests which loaded the image
+        size_t evictions;           // Number of textures destroyed to stay within budget
+        size_t entries;             // Number of textures currently held
+        size_t bytes;               // Estimated memory used by held textures (bytes)
+        size_t budget;              // Memory budget (bytes)
+    };
+
+    // Returns a handle to the texture for the given image, loading it if it isn't cached
+    // Accepts path to image and size it will be drawn at (a smaller copy is used if there is one)
+    Handle get(const std::string &, const size_t);
+
+    // Returns a handle to the texture for the given image only if it's cached (nullptr otherwise)
+    Handle find(const std::string &, const size_t);
+
+    // Upload a surface decoded elsewhere (see ImageLoader) and cache it, returning a handle
+    // Accepts path and size the surface was requested with, and the surface (which is freed)
+    Handle insert(const std::string &, const size_t, SDL_Surface *);
+
+    // Remove any textures for the given image (call after the file has been rewritten)
+    void invalidate(const std::string &);
+
+    // Set the memory budget in bytes (evicting if required)
+    void setBudget(const size_t);
+
+    // Returns the current counters
+    Stats stats();
+
+    // Drop all held textures (must be called before the renderer is destroyed)
+    void clear();
+};
+
+#endif
\ No newline at end of file
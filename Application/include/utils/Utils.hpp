@@ -17,6 +17,9 @@ namespace Utils {
     // Pass true to get in 24-hour format
     std::string getClockString(bool = false);
 
+    // Returns a 16 character hex string identifying the given bytes (FNV-1a hash)
+    std::string hashBytes(const std::vector<unsigned char> &);
+
     // Return a random alpha-numeric string with given length
     std::string randomString(size_t);
 
@@ -0,0 +1,64 @@
+#ifndef UTILS_WORKPOOL_HPP
+#define UTILS_WORKPOOL_HPP
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Utils {
+    // A pool of worker threads used to process a batch of tasks in parallel.
+    // Each worker has its own queue which it works through in order. Once it's
+    // empty the worker takes tasks from the back of other workers' queues, so no
+    // thread sits idle while there is still work to do.
+    class WorkPool {
+        public:
+            // A single unit of work
+            typedef std::function<void()> Task;
+
+        private:
+            // Queue of tasks belonging to one worker
+            struct Queue {
+                std::deque<Task> tasks;
+                std::mutex mutex;
+            };
+            std::vector< std::unique_ptr<Queue> > queues;
+
+            // Worker to give the next task to when not specified
+            size_t nextWorker;
+            // Whether the workers run with a low CPU and fs priority
+            bool lowPriority;
+
+            // Get the next task from the front of the worker's own queue
+            bool popTask(const size_t, Task &);
+
+            // Take a task from the back of another worker's queue
+            bool stealTask(const size_t, Task &);
+
+            // Run tasks until there are none left in any queue
+            void runWorker(const size_t);
+
+        public:
+            // Constructor takes the number of threads to use (including the calling thread), and
+            // whether the other threads should run with a low priority (the calling thread is unchanged)
+            WorkPool(const size_t, const bool = false);
+
+            // Returns the number of workers
+            size_t workers();
+
+            // Queue a task on the next worker (in a round-robin fashion)
+            void addTask(const Task &);
+
+            // Queue a task on the given worker
+            // Tasks given to a worker are started in the order they're added
+            void addTask(const size_t, const Task &);
+
+            // Run all queued tasks, blocking until they're all complete
+            // The calling thread is used as the first worker
+            // Note that tasks must not add new tasks to the pool
+            void run();
+    };
+};
+
+#endif
\ No newline at end of file
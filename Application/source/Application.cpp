@@ -1,7 +1,10 @@
 #include "Application.hpp"
 #include "lang/Lang.hpp"
 #include "lang/Language.hpp"
+#include "LibraryScanner.hpp"
 #include "Paths.hpp"
+#include "Snapshot.hpp"
+#include <thread>
 #include "ui/screen/Fullscreen.hpp"
 #include "ui/screen/Home.hpp"
 #include "ui/screen/Settings.hpp"
@@ -9,17 +12,43 @@
 #include "ui/screen/Update.hpp"
 #include "Updater.hpp"
 #include "utils/Curl.hpp"
+#include "utils/ImageLoader.hpp"
 #include "utils/NX.hpp"
+#include "utils/TextureCache.hpp"
 
 // Time in seconds to wait before checking for an update automatically
 constexpr size_t updateInterval = 21600;        // 6 hours
+// Time in milliseconds since the last change to wait before saving the config
+constexpr unsigned int configSaveDelay = 1000;
+// Time in milliseconds to wait between loading song metadata while scanning
+constexpr unsigned int metadataScanInterval = 5000;
+// Time in milliseconds to wait before writing the snapshot again if it fails (e.g. it's in use)
+constexpr unsigned int snapshotRetryDelay = 500;
+// Number of times to try writing the snapshot before waiting for the next change
+constexpr size_t snapshotAttempts = 5;
 
 namespace Main {
     Application::Application() : database_(SyncDatabase(new Database())) {
+        // Nothing is scanning yet
+        this->scanStage_ = ScanStage::None;
+        this->scanCurrent = 0;
+        this->scanTotal = 0;
+        this->scanRemaining = 0;
+        this->scanner = nullptr;
+        this->scanCancelled = false;
+        this->scanFull = false;
+        this->libraryVersion_ = 0;
+        this->databaseVersion_ = 0;
+        this->metadata_ = nullptr;
+        this->snapshotQueued = false;
+        this->snapshotRunning = false;
+        this->scanSnapshotDue = false;
+
         // Load config
         this->config_ = new Config(Path::App::ConfigFile);
         this->database_->setSpellfixScore(this->config_->searchMaxScore());
         this->database_->setSearchPhraseCount(this->config_->searchMaxPhrases());
+        Utils::TextureCache::setBudget(this->config_->imageCacheSize() * 1024 * 1024);
 
         // Start logging
         Log::openFile(Path::App::LogFile, this->config_->logLevel());
@@ -41,6 +70,7 @@ namespace Main {
         // Create Aether instance
         Aether::ThreadPool::setMaxThreads(8);
         this->display = new Aether::Display();
+        Utils::ImageLoader::start(2);
         this->display->setBackgroundColour(0, 0, 0);
         this->display->setFont("romfs:/Quicksand.ttf");
         this->display->setFontSpacing(0.9);
@@ -140,15 +170,224 @@ namespace Main {
     }
 
     void Application::lockDatabase() {
+        // Only one thread can write at a time (the library may be scanning in the background), and
+        // other threads must wait until the connection is read-only again
+        this->databaseMutex.lock();
+        this->database_.lock();
         this->database_->close();
-        this->sysmodule_->waitRequestDBLock();
         this->database_->openReadWrite();
     }
 
-    void Application::unlockDatabase() {
+    void Application::unlockDatabase(const bool snapshot) {
         this->database_->close();
-        this->sysmodule_->sendReleaseDBLock();
         this->database_->openReadOnly();
+        this->databaseVersion_++;
+        this->database_.unlock();
+        this->databaseMutex.unlock();
+        if (snapshot) {
+            this->queueSnapshot();
+        }
+    }
+
+    void Application::queueSnapshot() {
+        std::scoped_lock<std::mutex> mtx(this->snapshotMutex);
+        this->snapshotQueued = true;
+        if (!this->snapshotRunning) {
+            this->snapshotRunning = true;
+            this->snapshotThread = std::async(std::launch::async, &Application::writeSnapshots, this);
+        }
+    }
+
+    void Application::queueScanSnapshot() {
+        if (this->scanSnapshotDue) {
+            this->scanSnapshotDue = false;
+            this->queueSnapshot();
+        }
+    }
+
+    void Application::writeSnapshots() {
+        // Changes made while writing are covered by writing again
+        std::unique_lock<std::mutex> mtx(this->snapshotMutex);
+        size_t failures = 0;
+        while (this->snapshotQueued) {
+            this->snapshotQueued = false;
+            mtx.unlock();
+
+            bool ok = false;
+            std::vector<Snapshot::Entry> entries;
+            if (this->database_->getSnapshotEntries(entries)) {
+                // The sysmodule keeps the snapshot open until it's asked to release the database
+                this->sysmodule_->waitRequestDBLock();
+                ok = Snapshot::write(Path::Common::SnapshotFile, entries);
+                this->sysmodule_->sendReleaseDBLock();
+            } else {
+                Log::writeError("[SNAPSHOT] Failed to read songs: " + this->database_->error());
+            }
+
+            // Try again shortly if it failed (something else may have had the file open)
+            failures = (ok ? 0 : failures + 1);
+            bool retry = (!ok && failures < snapshotAttempts);
+            if (retry) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(snapshotRetryDelay));
+            }
+
+            mtx.lock();
+            if (retry) {
+                this->snapshotQueued = true;
+            }
+        }
+        this->snapshotRunning = false;
+    }
+
+    void Application::scanLibrary() {
+        // Scan in the background without slowing down the UI or other file accesses
+        // (this thread only exists for the scan, so the priority doesn't need restoring)
+        Utils::NX::setLowThreadPriority(true);
+        Utils::NX::setLowFsPriority(true);
+
+        // Create the LibraryScanner object (the UI is told when the database has been written to)
+        LibraryScanner scanner = LibraryScanner(this->database_, "/music", [this]() {
+            this->lockDatabase();
+        }, [this]() {
+            this->unlockDatabase(false);
+            this->scanSnapshotDue = true;
+            this->libraryVersion_++;
+        }, this->scanFull);
+        std::unique_lock<std::mutex> mtx(this->scannerMutex);
+        this->scanner = &scanner;
+        if (this->scanCancelled) {
+            scanner.stop();
+        }
+        mtx.unlock();
+
+        this->scanStage_ = this->runScan(scanner);
+        this->queueScanSnapshot();
+
+        mtx.lock();
+        this->scanner = nullptr;
+    }
+
+    ScanStage Application::runScan(LibraryScanner & scanner) {
+        // Get files on SD card and analyze what actions need to be taken
+        this->scanStage_ = ScanStage::Files;
+        LibraryScanner::Status result = scanner.processFiles();
+
+        // Everything is up to date! (but remember any changed directories)
+        if (result == LibraryScanner::Status::Done) {
+            scanner.updateDirectories();
+            return ScanStage::Done;
+
+        // Something went wrong...
+        } else if (result != LibraryScanner::Status::Ok && result != LibraryScanner::Status::DoneRemove) {
+            return (result == LibraryScanner::Status::Stopped ? ScanStage::None : ScanStage::Error);
+        }
+
+        // Parse all required files and add them to the database
+        if (result != LibraryScanner::Status::DoneRemove) {
+            this->scanStage_ = ScanStage::Metadata;
+            LibraryScanner::Status metaResult = scanner.processMetadata(this->scanCurrent, this->scanTotal, this->scanRemaining);
+            this->queueScanSnapshot();
+            if (metaResult != LibraryScanner::Status::Ok) {
+                return (metaResult == LibraryScanner::Status::Stopped ? ScanStage::None : ScanStage::Error);
+            }
+        }
+
+        // Finish updating the database (the sysmodule only needs resetting if songs are removed)
+        this->scanStage_ = ScanStage::Database;
+        if (scanner.hasRemovals()) {
+            this->sysmodule_->waitReset();
+        }
+        LibraryScanner::Status dbResult = scanner.updateDatabase();
+        this->queueScanSnapshot();
+        if (dbResult != LibraryScanner::Status::Ok) {
+            return ScanStage::Error;
+        }
+
+        // Finally search for album art
+        if (result != LibraryScanner::Status::DoneRemove) {
+            this->scanStage_ = ScanStage::Art;
+            this->scanCurrent = 0;
+            LibraryScanner::Status artResult = scanner.processArt(this->scanCurrent);
+            if (artResult != LibraryScanner::Status::Ok) {
+                return (artResult == LibraryScanner::Status::Stopped ? ScanStage::None : ScanStage::Error);
+            }
+        }
+
+        return ScanStage::Done;
+    }
+
+    void Application::startLibraryScan(const bool full) {
+        // Don't start another scan if one is running
+        if (this->scanThread.valid()) {
+            if (this->scanThread.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return;
+            }
+            this->scanThread.get();
+        }
+
+        this->scanCurrent = 0;
+        this->scanTotal = 0;
+        this->scanRemaining = 0;
+        this->scanCancelled = false;
+        this->scanFull = full;
+        this->scanStage_ = ScanStage::Files;
+        this->scanThread = std::async(std::launch::async, &Application::scanLibrary, this);
+    }
+
+    void Application::stopLibraryScan() {
+        std::scoped_lock<std::mutex> mtx(this->scannerMutex);
+        this->scanCancelled = true;
+        if (this->scanner != nullptr) {
+            this->scanner->stop();
+        }
+    }
+
+    ScanStage Application::scanStage() {
+        return this->scanStage_;
+    }
+
+    void Application::scanProgress(size_t & current, size_t & total, size_t & remaining) {
+        current = this->scanCurrent;
+        total = this->scanTotal;
+        remaining = this->scanRemaining;
+    }
+
+    unsigned int Application::libraryVersion() {
+        return this->libraryVersion_;
+    }
+
+    std::shared_ptr<MetadataStore> Application::loadMetadata(const unsigned int version, const std::vector<Database::SortBy> sorts) {
+        std::shared_ptr<MetadataStore> store = std::make_shared<MetadataStore>();
+        store->load(this->database_, version);
+        for (const Database::SortBy sort : sorts) {
+            store->order(sort);
+        }
+        return store;
+    }
+
+    std::shared_ptr<const MetadataStore> Application::metadata() {
+        // Nothing can be shown without any metadata, so the first load blocks
+        unsigned int version = this->databaseVersion_;
+        if (this->metadata_ == nullptr) {
+            this->metadata_ = this->loadMetadata(version, {});
+            return this->metadata_;
+        }
+
+        // Swap in the new store once loaded (frames still using the old one keep it alive until they're done)
+        if (this->metadataThread.valid() && this->metadataThread.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+            this->metadata_ = this->metadataThread.get();
+        }
+
+        // Otherwise load again if the database has changed, waiting a while between loads if scanning
+        // as each batch changes it
+        ScanStage stage = this->scanStage_;
+        bool scanning = (stage != ScanStage::None && stage != ScanStage::Done && stage != ScanStage::Error);
+        bool due = (!scanning || std::chrono::steady_clock::now() - this->metadataLoadTime >= std::chrono::milliseconds(metadataScanInterval));
+        if (this->metadata_->version() != version && !this->metadataThread.valid() && due) {
+            this->metadataLoadTime = std::chrono::steady_clock::now();
+            this->metadataThread = std::async(std::launch::async, &Application::loadMetadata, this, version, this->metadata_->sortedOrders());
+        }
+        return this->metadata_;
     }
 
     bool Application::hasUpdate() {
@@ -177,7 +416,37 @@ namespace Main {
 
     void Application::run() {
         // Do main loop
+        bool scanning = false;
         while (this->display->loop()) {
+            // Save the config once changes have stopped being made (e.g. a slider is released)
+            if (this->config_->hasUnsavedChanges(configSaveDelay)) {
+                this->saveConfig();
+            }
+
+            // Only boost the CPU for a scan while we're in the foreground
+            ScanStage stage = this->scanStage_;
+            if (stage != ScanStage::None && stage != ScanStage::Done && stage != ScanStage::Error) {
+                Utils::NX::setCPUBoost(Utils::NX::inFocus());
+                scanning = true;
+
+            } else if (scanning) {
+                Utils::NX::setCPUBoost(false);
+                scanning = false;
+            }
+        }
+        Utils::NX::setCPUBoost(false);
+
+        // Save changes made just before exiting (the sysmodule is reloaded while the app is cleaned up)
+        this->saveConfig();
+    }
+
+    void Application::saveConfig() {
+        bool sysChanged = this->config_->hasUnsavedSysChanges();
+        if (!this->config_->save()) {
+            Log::writeError("[APP] Unable to save config");
+        }
+        if (sysChanged) {
+            this->sysmodule_->sendReloadConfig();
         }
     }
 
@@ -198,6 +467,22 @@ namespace Main {
         // Wait for update thread to terminate
         this->updateThread.get();
 
+        // Stop scanning (progress is kept in the journal)
+        if (this->scanThread.valid()) {
+            this->stopLibraryScan();
+            this->scanThread.get();
+        }
+
+        // Wait for metadata to finish loading
+        if (this->metadataThread.valid()) {
+            this->metadataThread.wait();
+        }
+
+        // Finish writing the snapshot (the scan may have queued one) while the sysmodule is still connected
+        if (this->snapshotThread.valid()) {
+            this->snapshotThread.wait();
+        }
+
         // Mark that we're no longer playing media
         Utils::NX::setPlayingMedia(false);
 
@@ -220,6 +505,10 @@ namespace Main {
         // Delete overlay
         delete this->exitPrompt;
 
+        // Release cached images while the renderer still exists
+        Utils::ImageLoader::stop();
+        Utils::TextureCache::clear();
+
         // Cleanup Aether after screens are deleted
         delete this->display;
 
@@ -234,6 +523,9 @@ namespace Main {
         // Stop services
         Utils::Curl::exit();
 
+        // Write any queued log messages
+        Log::closeFile();
+
         // The database will be closed here as the wrapper goes out of scope
     }
 };
\ No newline at end of file
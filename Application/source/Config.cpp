@@ -1,18 +1,19 @@
 #include "Config.hpp"
+#include <cstring>
 #include "lang/Language.hpp"
-#include "minIni.h"
 #include "utils/FS.hpp"
+#include "utils/Ini.hpp"
 #include "utils/Utils.hpp"
 
 Config::Config(const std::string & path) {
-    // Check the file exists and copy template if it doesn't
-    if (!Utils::Fs::fileExists(path)) {
+    // Read the file, copying the template first if it doesn't exist
+    this->ini = new Utils::Ini(path);
+    if (!this->ini->read()) {
         if (!Utils::Fs::copyFile("romfs:/config/app_config.ini", path)) {
             Log::writeError("[CONFIG] Unable to copy template, bad things may happen");
         }
+        this->ini->read();
     }
-
-    this->ini = new minIni(path);
     this->readConfig();
 
     this->sysIni = nullptr;
@@ -161,19 +162,49 @@ void Config::readConfig() {
         Log::writeError("[CONFIG] Failed to get (Advanced) search_max_phrases");
         this->searchMaxPhrases_ = 8;
     }
+
+    // Advanced::image_cache_size
+    this->imageCacheSize_ = this->ini->geti("Advanced", "image_cache_size", -42069);
+    if (this->imageCacheSize_ < 0) {
+        Log::writeError("[CONFIG] Failed to get (Advanced) image_cache_size");
+        this->imageCacheSize_ = 48;
+    }
 }
 
 bool Config::prepareSys(const std::string & sysPath) {
-    if (!Utils::Fs::fileExists(sysPath)) {
+    // Changes not yet saved are newer than the file
+    if (this->sysIni != nullptr && this->sysIni->hasChanges()) {
+        return true;
+    }
+
+    Utils::Ini * tmp = new Utils::Ini(sysPath);
+    if (!tmp->read()) {
         Log::writeError("[CONFIG] An .ini does not exist at the specified sysPath");
+        delete tmp;
         return false;
     }
 
     delete this->sysIni;
-    this->sysIni = new minIni(sysPath);
+    this->sysIni = tmp;
     return true;
 }
 
+bool Config::hasUnsavedChanges(const unsigned int idle) {
+    return (this->ini->hasChanges(idle) || (this->sysIni != nullptr && this->sysIni->hasChanges(idle)));
+}
+
+bool Config::hasUnsavedSysChanges() {
+    return (this->sysIni != nullptr && this->sysIni->hasChanges());
+}
+
+bool Config::save() {
+    bool ok = this->ini->write();
+    if (this->sysIni != nullptr) {
+        ok = this->sysIni->write() && ok;
+    }
+    return ok;
+}
+
 int Config::version() {
     return this->version_;
 }
@@ -498,6 +529,20 @@ bool Config::setSearchMaxPhrases(const int i) {
     return ok;
 }
 
+int Config::imageCacheSize() {
+    return this->imageCacheSize_;
+}
+
+bool Config::setImageCacheSize(const int i) {
+    bool ok = this->ini->put("Advanced", "image_cache_size", i);
+    if (!ok) {
+        Log::writeError("[CONFIG] Failed to set (Advanced) image_cache_size");
+    } else {
+        this->imageCacheSize_ = i;
+    }
+    return ok;
+}
+
 bool Config::sysKeyComboEnabled() {
     if (!this->sysIni) {
         Log::writeError("[CONFIG] Can't access sysmodule config as object was not prepared");
@@ -1,366 +1,700 @@
-#include <algorithm>
-#include <filesystem>
-#include <future>
-#include "LibraryScanner.hpp"
-#include "Log.hpp"
-#include "meta/Metadata.hpp"
-#include "Paths.hpp"
-#include "utils/FS.hpp"
-#include "utils/Image.hpp"
-#include "utils/NX.hpp"
-#include "utils/Timer.hpp"
-#include "utils/Utils.hpp"
-
-// List of accepted extensions (case insensitive, but these must be lowercase)
-static const std::vector< std::pair<std::string, AudioFormat> > allowedTypes = {
-    {".flac", AudioFormat::FLAC},
-    {".mp3" , AudioFormat::MP3},
-    {".wav",  AudioFormat::WAV},
-    {".wave", AudioFormat::WAV}
-};
-
-// Comparator for FileTuples returning true if the lhs is before the rhs
-// (this only comapres the path as we don't care about the modified time or type)
-bool LibraryScanner::FileTupleComparator(const FileTuple & lhs, const FileTuple & rhs) {
-    return lhs.path < rhs.path;
-}
-
-LibraryScanner::LibraryScanner(const SyncDatabase & db, const std::string & path) : database(db), searchPath(path) {
-
-}
-
-std::string LibraryScanner::parseAlbumArt(const Metadata::Song & meta) {
-    // First attempt to extract image from file
-    std::vector<unsigned char> image = Metadata::readArtFromFile(meta.path, meta.format);
-    if (image.empty()) {
-        return "";
-    }
-
-    // If we extracted an image resize it
-    bool resized = Utils::Image::resize(image, 400, 400);
-    if (!resized) {
-        Log::writeError("[SCAN] [ART] Unable to resize image found in: " + meta.path);
-        return "";
-    }
-
-    // Write the image to disk
-    std::string filename;
-    do {
-        filename = Utils::randomString(10);
-    } while (Utils::Fs::fileExists(Path::App::AlbumImageFolder + filename + ".png"));
-
-    filename = Path::App::AlbumImageFolder + filename + ".png";
-    bool ok = Utils::Fs::writeFile(filename, image);
-    if (!ok) {
-        Log::writeError("[SCAN] [ART] Unable to write image to file: " + filename);
-        return "";
-    }
-
-    return filename;
-}
-
-LibraryScanner::Status LibraryScanner::parseFileAdd(const FileTuple & file) {
-    // Read tags and data from file
-    Metadata::Song meta = Metadata::readFromFile(file.path, file.format);
-    if (meta.ID == -3) {
-        Log::writeError("[SCAN] [ADD] Failed to parse file: " + file.path);
-        return Status::ErrUnknown;
-    }
-    meta.path = file.path;
-    meta.modified = file.modifiedTime;
-
-    // Append to metadata vector
-    std::scoped_lock<std::mutex> mtx(this->addMutex);
-    this->addMeta.push_back(meta);
-    return Status::Ok;
-}
-
-LibraryScanner::Status LibraryScanner::parseFileUpdate(const FileTuple & file) {
-    // Read new tags and data from file
-    Metadata::Song newMeta = Metadata::readFromFile(file.path, file.format);
-    if (newMeta.ID == -3) {
-        Log::writeError("[SCAN] [UPDATE] Failed to parse file: " + file.path);
-        return Status::ErrUnknown;
-    }
-
-    // Read old data from database (also thread-safe due to wrapper) and merge
-    std::string tmp = file.path;
-    SongID id = this->database->getSongIDForPath(tmp);
-    Metadata::Song meta = this->database->getSongMetadataForID(id);
-    if (meta.ID < 0) {
-        Log::writeError("[SCAN] [UPDATE] Failed to get metadata for: " + file.path);
-        return Status::ErrDatabase;
-    }
-    meta.title = newMeta.title;
-    meta.artist = newMeta.artist;
-    meta.album = newMeta.album;
-    meta.duration = newMeta.duration;
-    meta.trackNumber = newMeta.trackNumber;
-    meta.discNumber = newMeta.discNumber;
-    meta.modified = file.modifiedTime;
-
-    // Append to metadata vector
-    std::scoped_lock<std::mutex> mtx(this->updateMutex);
-    this->updateMeta.push_back(meta);
-    return Status::Ok;
-}
-
-LibraryScanner::Status LibraryScanner::processFiles() {
-    // First get all paths within folder along with modified timestamp
-    Utils::NX::setLowFsPriority(true);
-    std::vector<FileTuple> files;
-
-    if (Utils::Fs::fileExists(this->searchPath)) {
-        for (auto & entry: std::filesystem::recursive_directory_iterator(this->searchPath)) {
-            // Check if file's extension is whitelisted
-            AudioFormat audioType = AudioFormat::None;
-            for (const std::pair<std::string, AudioFormat> & type : allowedTypes) {
-                if (Utils::toLowercase(entry.path().extension()) == type.first) {
-                    audioType = type.second;
-                    break;
-                }
-            }
-
-            // Continue if not whitelisted
-            if (audioType == AudioFormat::None) {
-                continue;
-            }
-
-            // Otherwise get modified time and create FileTuple
-            // Why is this conversion so hard?
-            auto time = entry.last_write_time();
-            auto clock = std::chrono::file_clock::to_sys(time);
-            unsigned int timestamp = (unsigned int)std::chrono::system_clock::to_time_t(clock);
-
-            files.push_back(FileTuple{entry.path().string(), timestamp, audioType});
-        }
-    }
-
-    // Sort returned paths
-    Log::writeInfo("[SCAN] Found " + std::to_string(files.size()) + " files");
-    std::sort(files.begin(), files.end(), FileTupleComparator);
-
-    // Next get all paths and modified times from database
-    // (the database returns paths in sorted order)
-    bool dbOK;
-    std::vector<FileTuple> dbFiles;
-    std::vector< std::pair<std::string, unsigned int> > tmp = this->database->getAllSongFileInfo(dbOK);
-    if (!dbOK) {
-        Log::writeError("[SCAN] Couldn't read filesystem info from database");
-        Utils::NX::setLowFsPriority(false);
-        return Status::ErrDatabase;
-    }
-
-    for (size_t i = 0; i < tmp.size(); i++) {
-        dbFiles.push_back(FileTuple{tmp[i].first, tmp[i].second, AudioFormat::None});
-    }
-
-    // Use a thread to work out what files to add
-    std::future<void> addThread = std::async(std::launch::async, [this, &files, &dbFiles]() {
-        // Check if each file has an entry in the database
-        // If not, it needs to be added
-        for (size_t i = 0; i < files.size(); i++) {
-            bool inDB = std::binary_search(dbFiles.begin(), dbFiles.end(), files[i], FileTupleComparator);
-            if (!inDB) {
-                this->addFiles.push_back(files[i]);
-            }
-        }
-    });
-
-    // Use another thread to work out what files need updating
-    std::future<void> updateThread = std::async(std::launch::async, [this, &files, &dbFiles]() {
-        // Check if each file is in the database
-        // If it is and the DB's modified time is smaller, it needs to be updated
-        for (size_t i = 0; i < files.size(); i++) {
-            std::vector<FileTuple>::iterator it = std::lower_bound(dbFiles.begin(), dbFiles.end(), files[i], FileTupleComparator);
-            if (it != dbFiles.end() && (*it).path == files[i].path) {
-                if ((*it).modifiedTime < files[i].modifiedTime) {
-                    this->updateFiles.push_back(files[i]);
-                }
-            }
-        }
-    });
-
-    // This thread is responsible for determining which files to remove
-    for (size_t i = 0; i < dbFiles.size(); i++) {
-        bool onSD = std::binary_search(files.begin(), files.end(), dbFiles[i], FileTupleComparator);
-        if (!onSD) {
-            this->removeFiles.push_back(dbFiles[i]);
-        }
-    }
-
-    // Wait for threads to finish
-    addThread.get();
-    updateThread.get();
-    Utils::NX::setLowFsPriority(false);
-
-    // Log status
-    Log::writeInfo("[SCAN] Adding " + std::to_string(this->addFiles.size()) + " files");
-    Log::writeInfo("[SCAN] Updating " + std::to_string(this->updateFiles.size()) + " files");
-    Log::writeInfo("[SCAN] Removing " + std::to_string(this->removeFiles.size()) + " files");
-    Log::writeSuccess("[SCAN] Initial processing completed");
-
-    // Return appropriate status
-    if (this->addFiles.empty() && this->updateFiles.empty()) {
-        return (this->removeFiles.empty() ? Status::Done : Status::DoneRemove);
-    }
-    return Status::Ok;
-}
-
-LibraryScanner::Status LibraryScanner::processMetadata(std::atomic<size_t> & currentFile, std::atomic<size_t> & totalFiles, std::atomic<size_t> & estRemaining) {
-    // Set initial status values
-    estRemaining = 0;
-    currentFile = 1;
-    totalFiles = this->addFiles.size() + this->updateFiles.size();
-    Status status = Status::Ok;
-
-    // Timer used to estimate remaining time
-    Utils::Timer timer = Utils::Timer();
-    timer.start();
-
-    // Parse files that need to be added first, then updated
-    std::vector<FileTuple> dummy;
-    std::vector<FileTuple> & vec = dummy;
-    for (size_t v = 0; v < 2; v++) {
-        // Get reference to appropriate vector
-        switch (v) {
-            case 0:
-                vec = this->addFiles;
-                break;
-
-            case 1:
-                vec = this->updateFiles;
-                break;
-
-            default:
-                return Status::ErrUnknown;
-                break;
-        }
-
-        // Iterate over each vector
-        for (size_t i = 0; i < vec.size(); i++) {
-            status = (v == 0 ? this->parseFileAdd(vec[i]) : this->parseFileUpdate(vec[i]));
-
-            // Increment counter and adjust remaining time
-            estRemaining = (timer.elapsedSeconds() / (double)currentFile) * (totalFiles - currentFile);
-            currentFile++;
-
-            // Return if an error occurred
-            if (status != Status::Ok) {
-                Log::writeError("[SCAN] Error occurred during metadata scan");
-                return status;
-            }
-        }
-    }
-
-    // We get here once all are completed and no error occurred
-    Log::writeSuccess("[SCAN] Song metadata processed successfully");
-    return Status::Ok;
-}
-
-LibraryScanner::Status LibraryScanner::updateDatabase() {
-    // Add songs first
-    for (size_t i = 0; i < this->addMeta.size(); i++) {
-        bool ok = this->database->addSong(this->addMeta[i]);
-        if (!ok) {
-            Log::writeError("[SCAN] Error adding song: " + this->addMeta[i].path);
-            return Status::ErrDatabase;
-        }
-    }
-
-    // Then update songs
-    for (size_t i = 0; i < this->updateMeta.size(); i++) {
-        bool ok = this->database->updateSong(this->updateMeta[i]);
-        if (!ok) {
-            Log::writeError("[SCAN] Error updating song: " + this->updateMeta[i].path);
-            return Status::ErrDatabase;
-        }
-    }
-
-    // And finally remove songs
-    bool ok = true;
-    for (size_t i = 0; i < this->removeFiles.size(); i++) {
-        std::string tmp = this->removeFiles[i].path;
-        SongID id = this->database->getSongIDForPath(tmp);
-        (id >= 0 ? ok = this->database->removeSong(id) : ok = false);
-        if (!ok) {
-            Log::writeError("[SCAN] Error removing song: " + this->removeFiles[i].path);
-            return Status::ErrDatabase;
-        }
-    }
-
-    Log::writeSuccess("[SCAN] Database successfully updated");
-    return Status::Ok;
-}
-
-LibraryScanner::Status LibraryScanner::processArt(std::atomic<size_t> & currentFile) {
-    // Initialize variables
-    currentFile = 0;
-
-    // Map used to mark when an album has an image
-    // Album name -> bool
-    std::unordered_map<std::string, bool> hasImage;
-
-    // First get all the albums in the database and mark
-    std::vector<Metadata::Album> albums = this->database->getAllAlbumMetadata(Database::SortBy::AlbumAsc);
-    for (size_t i = 0; i < albums.size(); i++) {
-        hasImage[albums[i].name] = (!albums[i].imagePath.empty());
-    }
-
-    // Iterate over each song added/updated and search for an image if the album doesn't have one
-    std::vector<Metadata::Song> dummy;
-    for (size_t v = 0; v < 2; v++) {
-        // Pick vector based on 'v' (used to avoid repeating code)
-        std::vector<Metadata::Song> & vec = dummy;
-        switch (v) {
-            case 0:
-                vec = this->addMeta;
-                break;
-
-            case 1:
-                vec = this->updateMeta;
-                break;
-
-            default:
-                return Status::ErrUnknown;
-        }
-
-        for (size_t i = 0; i < vec.size(); i++) {
-            Metadata::Song meta = vec[i];
-
-            // Check this song for album art if the album does not yet have any
-            if (hasImage[meta.album]) {
-                continue;
-            }
-            std::string path = this->parseAlbumArt(meta);
-
-            // If the image was written to the SD Card update database
-            if (path.empty()) {
-                continue;
-            }
-            SongID songID = this->database->getSongIDForPath(meta.path);
-            AlbumID albumID = this->database->getAlbumIDForSong(songID);
-            Status status = (songID >= 0 && albumID >= 0 ? Status::Ok : Status::ErrDatabase);
-            if (status == Status::Ok) {
-                Metadata::Album album = this->database->getAlbumMetadataForID(albumID);
-                status = (album.ID >= 0 ? Status::Ok : Status::ErrDatabase);
-                if (status == Status::Ok) {
-                    album.imagePath = path;
-                    status = (this->database->updateAlbum(album) ? Status::Ok : Status::ErrDatabase);
-                }
-            }
-
-            // Remove the image file if an error occurred and return
-            if (status != Status::Ok) {
-                Utils::Fs::deleteFile(path);
-                return status;
-            }
-
-            // Otherwise mark that the album has an image
-            currentFile++;
-            hasImage[meta.album] = true;
-        }
-    }
-
-    return Status::Ok;
+#include <algorithm>
+#include <filesystem>
+#include <future>
+#include "LibraryScanner.hpp"
+#include "Log.hpp"
+#include "meta/Metadata.hpp"
+#include "Paths.hpp"
+#include <unordered_set>
+#include "utils/FS.hpp"
+#include "utils/Image.hpp"
+#include "utils/Splash.hpp"
+#include "utils/Timer.hpp"
+#include "utils/Utils.hpp"
+
+// Number of threads used to read metadata/art (the application is given three cores)
+#define SCAN_THREADS 3
+
+// Number of files to read metadata for before writing them to the database
+#define METADATA_BATCH 250
+// Number of albums to search for art before writing them to the database
+#define ART_BATCH 20
+
+// List of accepted extensions (case insensitive, but these must be lowercase)
+static const std::vector< std::pair<std::string, AudioFormat> > allowedTypes = {
+    {".flac", AudioFormat::FLAC},
+    {".mp3" , AudioFormat::MP3},
+    {".wav",  AudioFormat::WAV},
+    {".wave", AudioFormat::WAV}
+};
+
+// Convert a filesystem timestamp into a UNIX timestamp
+static unsigned int toTimestamp(const std::filesystem::file_time_type & time) {
+    // Why is this conversion so hard?
+    auto clock = std::chrono::file_clock::to_sys(time);
+    return (unsigned int)std::chrono::system_clock::to_time_t(clock);
+}
+
+// Returns the directory part of a file's path
+static std::string parentPath(const std::string & path) {
+    return path.substr(0, path.find_last_of('/'));
+}
+
+// Comparator for FileTuples returning true if the lhs is before the rhs
+// (this only comapres the path as we don't care about the modified time or type)
+bool LibraryScanner::FileTupleComparator(const FileTuple & lhs, const FileTuple & rhs) {
+    return lhs.path < rhs.path;
+}
+
+LibraryScanner::LibraryScanner(const SyncDatabase & db, const std::string & path, std::function<void()> lock, std::function<void()> unlock, const bool full) : database(db), searchPath(path), fullScan(full), lockDatabase(lock), unlockDatabase(unlock), journal(Path::App::ScanJournalFile), pool(SCAN_THREADS, true) {
+    this->directoriesChanged = false;
+    this->stopped = false;
+}
+
+std::string LibraryScanner::parseAlbumArt(const Metadata::Song & meta) {
+    // First attempt to extract image from file
+    std::vector<unsigned char> image = Metadata::readArtFromFile(meta.path, meta.format);
+    if (image.empty()) {
+        return "";
+    }
+
+    // Images are named after a hash of the embedded image, so albums with the same art share a file
+    // and art which has already been processed doesn't need to be decoded again
+    std::string filename = Path::App::AlbumImageFolder + Utils::hashBytes(image) + ".png";
+    if (Utils::Fs::fileExists(filename)) {
+        return filename;
+    }
+
+    // If another worker is processing the same image wait for it to finish and use its result,
+    // or return nothing if it failed so the caller tries its next song
+    std::unique_lock<std::mutex> mtx(this->artMutex);
+    if (this->artClaimed.count(filename) > 0) {
+        this->artCondition.wait(mtx, [this, &filename]() {
+            return this->artClaimed.count(filename) == 0;
+        });
+        return (Utils::Fs::fileExists(filename) ? filename : "");
+    }
+
+    // Check again as it may have been written since (claims are only released once written)
+    if (Utils::Fs::fileExists(filename)) {
+        return filename;
+    }
+    this->artClaimed.insert(filename);
+    mtx.unlock();
+
+    // Otherwise resize and write the image to disk
+    bool ok = Utils::Image::resize(image, 400, 400);
+    if (!ok) {
+        Log::writeError("[SCAN] [ART] Unable to resize image found in: " + meta.path);
+    } else {
+        ok = Utils::Fs::writeFile(filename, image);
+        if (!ok) {
+            Log::writeError("[SCAN] [ART] Unable to write image to file: " + filename);
+            Utils::Fs::deleteFile(filename);
+        } else {
+            // Also write smaller copies for when it's shown at a smaller size (the full image is used without them)
+            Utils::Image::writeThumbnails(image, filename);
+        }
+    }
+
+    // Release the claim, waking any workers waiting on this image
+    mtx.lock();
+    this->artClaimed.erase(filename);
+    mtx.unlock();
+    this->artCondition.notify_all();
+    return (ok ? filename : "");
+}
+
+LibraryScanner::Status LibraryScanner::parseFile(const FileTuple & file, Metadata::Song & meta) {
+    // Use the journal's copy if this file was parsed during an interrupted scan
+    if (this->journal.getMetadata(file.path, file.modifiedTime, meta)) {
+        return Status::Ok;
+    }
+
+    // Otherwise read tags and data from file
+    meta = Metadata::readFromFile(file.path, file.format);
+    if (meta.ID == -3) {
+        return Status::ErrUnknown;
+    }
+    meta.path = file.path;
+    meta.modified = file.modifiedTime;
+
+    // Record in the journal so it doesn't need to be read again
+    this->journal.addMetadata(meta);
+    return Status::Ok;
+}
+
+LibraryScanner::Status LibraryScanner::parseFileAdd(const FileTuple & file) {
+    // Read tags and data from file
+    Metadata::Song meta;
+    if (this->parseFile(file, meta) != Status::Ok) {
+        Log::writeError("[SCAN] [ADD] Failed to parse file: " + file.path);
+        return Status::ErrUnknown;
+    }
+
+    // Append to metadata vector
+    std::scoped_lock<std::mutex> mtx(this->addMutex);
+    this->addMeta.push_back(meta);
+    return Status::Ok;
+}
+
+LibraryScanner::Status LibraryScanner::parseFileUpdate(const FileTuple & file) {
+    // Read new tags and data from file
+    Metadata::Song newMeta;
+    if (this->parseFile(file, newMeta) != Status::Ok) {
+        Log::writeError("[SCAN] [UPDATE] Failed to parse file: " + file.path);
+        return Status::ErrUnknown;
+    }
+
+    // Read old data from database (also thread-safe due to wrapper) and merge
+    std::string tmp = file.path;
+    SongID id = this->database->getSongIDForPath(tmp);
+    Metadata::Song meta = this->database->getSongMetadataForID(id);
+    if (meta.ID < 0) {
+        Log::writeError("[SCAN] [UPDATE] Failed to get metadata for: " + file.path);
+        return Status::ErrDatabase;
+    }
+    meta.title = newMeta.title;
+    meta.artist = newMeta.artist;
+    meta.album = newMeta.album;
+    meta.duration = newMeta.duration;
+    meta.trackNumber = newMeta.trackNumber;
+    meta.discNumber = newMeta.discNumber;
+    meta.modified = file.modifiedTime;
+
+    // Append to metadata vector
+    std::scoped_lock<std::mutex> mtx(this->updateMutex);
+    this->updateMeta.push_back(meta);
+    return Status::Ok;
+}
+
+void LibraryScanner::stop() {
+    this->stopped = true;
+}
+
+LibraryScanner::Status LibraryScanner::processFiles() {
+    // Check if a previous scan was interrupted
+    // Any songs in the journal which made it into the database still need checking for art
+    if (this->journal.load()) {
+        this->pendingArt = this->journal.songs();
+        Log::writeInfo("[SCAN] Resuming interrupted scan" + std::string(this->journal.databaseUpdated() ? " (album art)" : ""));
+    }
+
+    // Get all paths and modified times from the database
+    bool dbOK;
+    std::vector<FileTuple> dbFiles;
+    std::vector< std::pair<std::string, unsigned int> > tmp = this->database->getAllSongFileInfo(dbOK);
+    bool dirsOK;
+    std::vector<Metadata::Directory> dbDirs = this->database->getAllDirectories(dirsOK);
+    if (!dbOK || !dirsOK) {
+        Log::writeError("[SCAN] Couldn't read filesystem info from database");
+        return Status::ErrDatabase;
+    }
+
+    // Group the known files by directory so they can be reused if the directory is unchanged
+    std::unordered_map<std::string, std::vector<size_t> > dbFilesInDir;
+    for (size_t i = 0; i < tmp.size(); i++) {
+        dbFiles.push_back(FileTuple{tmp[i].first, tmp[i].second, AudioFormat::None});
+        dbFilesInDir[parentPath(tmp[i].first)].push_back(i);
+    }
+    std::unordered_map<std::string, size_t> dbDirIdx;
+    for (size_t i = 0; i < dbDirs.size(); i++) {
+        dbDirIdx[dbDirs[i].path] = i;
+    }
+
+    // Walk through each directory, noting its modified time, number of entries and a hash of
+    // their names. If these all match the last scan the directory's files are taken from the
+    // database, otherwise each file is checked individually (which is much slower).
+    // Note that each directory still needs to be listed as a change to a subdirectory isn't
+    // reflected in its parent, and files which are modified in place (i.e. tags edited) aren't
+    // detected, so a full scan checks every file.
+    std::vector<FileTuple> files;
+    std::vector<std::string> toVisit;
+    size_t skipped = 0;
+    if (Utils::Fs::fileExists(this->searchPath)) {
+        toVisit.push_back(this->searchPath);
+    }
+    while (!toVisit.empty()) {
+        if (this->stopped) {
+            return Status::Stopped;
+        }
+
+        std::string path = toVisit.back();
+        toVisit.pop_back();
+
+        // List all entries, queueing any subdirectories to visit
+        std::vector<std::filesystem::directory_entry> entries;
+        std::vector<std::string> names;
+        for (auto & entry: std::filesystem::directory_iterator(path)) {
+            if (entry.is_directory()) {
+                toVisit.push_back(entry.path().string());
+            }
+            names.push_back(entry.path().filename().string() + (entry.is_directory() ? "/" : ""));
+            entries.push_back(entry);
+        }
+
+        // FNV-1a hash of all names (sorted as listing order isn't guaranteed)
+        std::sort(names.begin(), names.end());
+        unsigned int hash = 2166136261u;
+        for (const std::string & name : names) {
+            for (const char c : name) {
+                hash = (hash ^ (unsigned char)c) * 16777619u;
+            }
+            hash = (hash ^ '\0') * 16777619u;
+        }
+        Metadata::Directory dir = {path, toTimestamp(std::filesystem::last_write_time(path)), (unsigned int)entries.size(), hash};
+        this->directories.push_back(dir);
+
+        // Use the database's files if nothing has changed
+        std::unordered_map<std::string, size_t>::iterator it = dbDirIdx.find(path);
+        if (!this->fullScan && it != dbDirIdx.end()) {
+            const Metadata::Directory & old = dbDirs[it->second];
+            if (old.modified == dir.modified && old.entries == dir.entries && old.hash == dir.hash) {
+                for (const size_t idx : dbFilesInDir[path]) {
+                    files.push_back(dbFiles[idx]);
+                }
+                skipped++;
+                continue;
+            }
+        }
+
+        for (const std::filesystem::directory_entry & entry : entries) {
+            if (entry.is_directory()) {
+                continue;
+            }
+
+            // Check if file's extension is whitelisted
+            AudioFormat audioType = AudioFormat::None;
+            for (const std::pair<std::string, AudioFormat> & type : allowedTypes) {
+                if (Utils::toLowercase(entry.path().extension()) == type.first) {
+                    audioType = type.second;
+                    break;
+                }
+            }
+
+            // Continue if not whitelisted
+            if (audioType == AudioFormat::None) {
+                continue;
+            }
+
+            // Otherwise get modified time and create FileTuple
+            files.push_back(FileTuple{entry.path().string(), toTimestamp(entry.last_write_time()), audioType});
+        }
+    }
+
+    // Check if the directories differ from what's stored
+    std::sort(this->directories.begin(), this->directories.end(), [](const Metadata::Directory & lhs, const Metadata::Directory & rhs) {
+        return lhs.path < rhs.path;
+    });
+    this->directoriesChanged = (this->directories.size() != dbDirs.size());
+    for (size_t i = 0; i < this->directories.size() && !this->directoriesChanged; i++) {
+        const Metadata::Directory & a = this->directories[i];
+        const Metadata::Directory & b = dbDirs[i];
+        this->directoriesChanged = (a.path != b.path || a.modified != b.modified || a.entries != b.entries || a.hash != b.hash);
+    }
+
+    // Sort returned paths (the database returns paths in sorted order, but sorting both here
+    // guarantees the same ordering is used)
+    Log::writeInfo("[SCAN] Found " + std::to_string(files.size()) + " files (" + std::to_string(skipped) + " of " + std::to_string(this->directories.size()) + " directories unchanged)");
+    std::sort(files.begin(), files.end(), FileTupleComparator);
+    std::sort(dbFiles.begin(), dbFiles.end(), FileTupleComparator);
+
+    // Walk through both lists at once to work out what needs to change:
+    // - files only on the SD card need to be added
+    // - files only in the database need to be removed
+    // - files in both need updating if the database's modified time is older
+    std::unordered_set<std::string> unchanged;
+    size_t i = 0;
+    size_t j = 0;
+    while (i < files.size() || j < dbFiles.size()) {
+        if (j == dbFiles.size() || (i < files.size() && FileTupleComparator(files[i], dbFiles[j]))) {
+            this->addFiles.push_back(files[i]);
+            i++;
+
+        } else if (i == files.size() || FileTupleComparator(dbFiles[j], files[i])) {
+            this->removeFiles.push_back(dbFiles[j]);
+            j++;
+
+        } else {
+            if (dbFiles[j].modifiedTime < files[i].modifiedTime) {
+                this->updateFiles.push_back(files[i]);
+            } else {
+                unchanged.insert(files[i].path);
+            }
+            i++;
+            j++;
+        }
+    }
+
+    // Only look for art for songs left from an earlier scan that haven't changed since
+    this->pendingArt.erase(std::remove_if(this->pendingArt.begin(), this->pendingArt.end(), [&unchanged](const Metadata::Song & song) {
+        return (unchanged.count(song.path) == 0);
+    }), this->pendingArt.end());
+
+    // Log status
+    Log::writeInfo("[SCAN] Adding " + std::to_string(this->addFiles.size()) + " files");
+    Log::writeInfo("[SCAN] Updating " + std::to_string(this->updateFiles.size()) + " files");
+    Log::writeInfo("[SCAN] Removing " + std::to_string(this->removeFiles.size()) + " files");
+    Log::writeSuccess("[SCAN] Initial processing completed");
+
+    // Return appropriate status (art may still be needed from an earlier scan)
+    if (this->addFiles.empty() && this->updateFiles.empty() && this->pendingArt.empty()) {
+        if (this->removeFiles.empty()) {
+            this->journal.remove();
+            return Status::Done;
+        }
+        return Status::DoneRemove;
+    }
+    return Status::Ok;
+}
+
+LibraryScanner::Status LibraryScanner::processMetadata(std::atomic<size_t> & currentFile, std::atomic<size_t> & totalFiles, std::atomic<size_t> & estRemaining) {
+    // Set initial status values
+    estRemaining = 0;
+    currentFile = 1;
+    totalFiles = this->addFiles.size() + this->updateFiles.size();
+    std::atomic<size_t> processed = 0;
+    std::atomic<Status> status = Status::Ok;
+
+    // Timer used to estimate remaining time
+    Utils::Timer timer = Utils::Timer();
+    timer.start();
+
+    // Order all files by their directory (and then path) so that each worker reads
+    // from as few directories as possible, in order
+    // (the bool indicates whether the file is being added or updated)
+    std::vector< std::pair<const FileTuple *, bool> > files;
+    for (const FileTuple & file : this->addFiles) {
+        files.push_back(std::make_pair(&file, true));
+    }
+    for (const FileTuple & file : this->updateFiles) {
+        files.push_back(std::make_pair(&file, false));
+    }
+    std::sort(files.begin(), files.end(), [](const std::pair<const FileTuple *, bool> & lhs, const std::pair<const FileTuple *, bool> & rhs) {
+        std::string lhsDir = lhs.first->path.substr(0, lhs.first->path.find_last_of('/'));
+        std::string rhsDir = rhs.first->path.substr(0, rhs.first->path.find_last_of('/'));
+        if (lhsDir != rhsDir) {
+            return lhsDir < rhsDir;
+        }
+        return lhs.first->path < rhs.first->path;
+    });
+
+    // Files are processed in batches, with each batch written to the database once read
+    for (size_t start = 0; start < files.size(); start += METADATA_BATCH) {
+        size_t end = std::min(start + METADATA_BATCH, files.size());
+
+        // Give each worker a contiguous block of files, any idle workers will take files
+        // from the end of another worker's block
+        for (size_t i = start; i < end; i++) {
+            const FileTuple * file = files[i].first;
+            bool add = files[i].second;
+            this->pool.addTask(((i - start) * this->pool.workers()) / (end - start), [this, file, add, &processed, &status, &timer, &currentFile, &totalFiles, &estRemaining]() {
+                // Skip remaining files once an error has occurred (or we're stopping)
+                if (status != Status::Ok || this->stopped) {
+                    return;
+                }
+
+                Status result = (add ? this->parseFileAdd(*file) : this->parseFileUpdate(*file));
+                if (result != Status::Ok) {
+                    status = result;
+                    return;
+                }
+
+                // Increment counter and adjust remaining time
+                size_t done = ++processed;
+                estRemaining = (timer.elapsedSeconds() / (double)done) * (totalFiles - done);
+                currentFile = std::min(done + 1, totalFiles.load());
+            });
+        }
+        this->pool.run();
+
+        // Write any remaining metadata so it's kept if an error occurred
+        if (!this->journal.flush()) {
+            Log::writeWarning("[SCAN] Unable to write to journal");
+        }
+
+        // Return if an error occurred
+        if (status != Status::Ok) {
+            Log::writeError("[SCAN] Error occurred during metadata scan");
+            return status;
+        }
+        if (this->stopped) {
+            return Status::Stopped;
+        }
+
+        // Otherwise write this batch to the database so the songs can be seen
+        this->lockDatabase();
+        Status result = this->commitMetadata();
+        this->unlockDatabase();
+        if (result != Status::Ok) {
+            return result;
+        }
+    }
+
+    // We get here once all are completed and no error occurred
+    timer.stop();
+    Log::writeSuccess("[SCAN] Song metadata processed successfully (" + std::to_string(files.size()) + " files in " + std::to_string(timer.elapsedSeconds()) + "s)");
+    return Status::Ok;
+}
+
+LibraryScanner::Status LibraryScanner::commitMetadata() {
+    // Files finish in any order, so sort to keep the database insertion order consistent
+    auto pathComparator = [](const Metadata::Song & lhs, const Metadata::Song & rhs) {
+        return lhs.path < rhs.path;
+    };
+    std::sort(this->addMeta.begin(), this->addMeta.end(), pathComparator);
+    std::sort(this->updateMeta.begin(), this->updateMeta.end(), pathComparator);
+
+    // Add songs first
+    for (size_t i = 0; i < this->addMeta.size(); i++) {
+        bool ok = this->database->addSong(this->addMeta[i]);
+        if (!ok) {
+            Log::writeError("[SCAN] Error adding song: " + this->addMeta[i].path);
+            return Status::ErrDatabase;
+        }
+    }
+
+    // Then update songs
+    for (size_t i = 0; i < this->updateMeta.size(); i++) {
+        bool ok = this->database->updateSong(this->updateMeta[i]);
+        if (!ok) {
+            Log::writeError("[SCAN] Error updating song: " + this->updateMeta[i].path);
+            return Status::ErrDatabase;
+        }
+    }
+
+    // Keep the written songs as they still need to be checked for art
+    this->committedMeta.insert(this->committedMeta.end(), this->addMeta.begin(), this->addMeta.end());
+    this->committedMeta.insert(this->committedMeta.end(), this->updateMeta.begin(), this->updateMeta.end());
+    this->addMeta.clear();
+    this->updateMeta.clear();
+    return Status::Ok;
+}
+
+bool LibraryScanner::hasRemovals() {
+    return !this->removeFiles.empty();
+}
+
+LibraryScanner::Status LibraryScanner::updateDatabase() {
+    // Write any songs which haven't been written yet
+    this->lockDatabase();
+    Status status = this->commitMetadata();
+    if (status != Status::Ok) {
+        this->unlockDatabase();
+        return status;
+    }
+
+    // And remove songs
+    bool ok = true;
+    for (size_t i = 0; i < this->removeFiles.size(); i++) {
+        std::string tmp = this->removeFiles[i].path;
+        SongID id = this->database->getSongIDForPath(tmp);
+        (id >= 0 ? ok = this->database->removeSong(id) : ok = false);
+        if (!ok) {
+            Log::writeError("[SCAN] Error removing song: " + this->removeFiles[i].path);
+            this->unlockDatabase();
+            return Status::ErrDatabase;
+        }
+    }
+
+    // Only store directories once all their files are in the database
+    status = this->writeDirectories();
+    this->unlockDatabase();
+    if (status != Status::Ok) {
+        return status;
+    }
+
+    // Metadata is no longer needed, only the songs which need checking for art
+    std::vector<Metadata::Song> artSongs = this->pendingArt;
+    artSongs.insert(artSongs.end(), this->committedMeta.begin(), this->committedMeta.end());
+    if (!this->journal.markDatabaseUpdated(artSongs)) {
+        Log::writeWarning("[SCAN] Unable to write to journal");
+    }
+
+    Log::writeSuccess("[SCAN] Database successfully updated");
+    return Status::Ok;
+}
+
+LibraryScanner::Status LibraryScanner::writeDirectories() {
+    if (!this->directoriesChanged) {
+        return Status::Ok;
+    }
+
+    bool ok = this->database->setDirectories(this->directories);
+    if (!ok) {
+        Log::writeError("[SCAN] Error updating directories");
+        return Status::ErrDatabase;
+    }
+
+    this->directoriesChanged = false;
+    return Status::Ok;
+}
+
+LibraryScanner::Status LibraryScanner::updateDirectories() {
+    // Avoid locking the database if there's nothing to do
+    if (!this->directoriesChanged) {
+        return Status::Ok;
+    }
+
+    this->lockDatabase();
+    Status status = this->writeDirectories();
+    this->unlockDatabase();
+    return status;
+}
+
+LibraryScanner::Status LibraryScanner::processArt(std::atomic<size_t> & currentFile) {
+    // Initialize variables
+    currentFile = 0;
+
+    // Map used to mark when an album has an image
+    // Album name -> bool
+    std::unordered_map<std::string, bool> hasImage;
+
+    // First get all the albums in the database and mark
+    // Images stored before smaller copies were made are also noted so they can be created
+    std::vector<Metadata::Album> albums = this->database->getAllAlbumMetadata(Database::SortBy::AlbumAsc);
+    std::vector<std::string> needThumbnails;
+    for (size_t i = 0; i < albums.size(); i++) {
+        hasImage[albums[i].name] = (!albums[i].imagePath.empty());
+        if (hasImage[albums[i].name] && !Utils::Image::hasThumbnails(albums[i].imagePath)) {
+            needThumbnails.push_back(albums[i].imagePath);
+        }
+    }
+    needThumbnails = Utils::removeDuplicates(needThumbnails);
+
+    // Images stored before palettes were picked also need one
+    std::vector<std::string> needPalettes = this->database->getAlbumImagesWithoutPalette();
+
+    // Group each song added/updated by album if the album doesn't have an image
+    // Songs within each group are checked in order until one with an image is found
+    std::unordered_map<std::string, size_t> groupIdx;
+    std::vector< std::vector<const Metadata::Song *> > groups;
+    for (size_t v = 0; v < 2; v++) {
+        const std::vector<Metadata::Song> & vec = (v == 0 ? this->committedMeta : this->pendingArt);
+        for (const Metadata::Song & meta : vec) {
+            if (hasImage[meta.album]) {
+                continue;
+            }
+
+            std::unordered_map<std::string, size_t>::iterator it = groupIdx.find(meta.album);
+            if (it == groupIdx.end()) {
+                groupIdx[meta.album] = groups.size();
+                groups.push_back(std::vector<const Metadata::Song *>{&meta});
+            } else {
+                groups[it->second].push_back(&meta);
+            }
+        }
+    }
+
+    // Search for images in batches, writing each batch to the database once done
+    for (size_t start = 0; start < groups.size(); start += ART_BATCH) {
+        if (this->stopped) {
+            return Status::Stopped;
+        }
+        size_t end = std::min(start + ART_BATCH, groups.size());
+
+        // Search for an image for each album using the pool
+        // Pairs of the song the image was found in and the path to the image
+        std::vector< std::pair<const Metadata::Song *, std::string> > found;
+        std::mutex foundMutex;
+        for (size_t i = start; i < end; i++) {
+            const std::vector<const Metadata::Song *> * songs = &groups[i];
+            this->pool.addTask(((i - start) * this->pool.workers()) / (end - start), [this, songs, &found, &foundMutex]() {
+                for (const Metadata::Song * meta : *songs) {
+                    // If the image couldn't be written to the SD Card try the next song
+                    std::string path = this->parseAlbumArt(*meta);
+                    if (!path.empty()) {
+                        std::scoped_lock<std::mutex> mtx(foundMutex);
+                        found.push_back(std::make_pair(meta, path));
+                        return;
+                    }
+                }
+            });
+        }
+        this->pool.run();
+
+        if (found.empty()) {
+            continue;
+        }
+
+        // Pick a palette for each image now so the player doesn't need to
+        std::vector<Utils::Splash::Palette> palettes(found.size());
+        for (size_t i = 0; i < found.size(); i++) {
+            this->pool.addTask([&found, &palettes, i]() {
+                palettes[i] = Utils::Splash::getPaletteForImage(found[i].second);
+            });
+        }
+        this->pool.run();
+
+        // Update each album in the database
+        // Images are left on an error as they may be shared, and will be reused by the next scan
+        Status status = Status::Ok;
+        this->lockDatabase();
+        for (size_t i = 0; i < found.size(); i++) {
+            if (!this->database->setAlbumImageForSong(found[i].first->path, found[i].second)) {
+                status = Status::ErrDatabase;
+                break;
+            }
+            if (!palettes[i].invalid && !this->database->setAlbumPaletteForImage(found[i].second, Utils::Splash::packPalette(palettes[i]))) {
+                status = Status::ErrDatabase;
+                break;
+            }
+            currentFile++;
+        }
+        this->unlockDatabase();
+
+        if (status != Status::Ok) {
+            return status;
+        }
+    }
+
+    // Create any missing smaller copies
+    for (size_t i = 0; i < needThumbnails.size(); i++) {
+        const std::string * path = &needThumbnails[i];
+        this->pool.addTask([this, path]() {
+            std::vector<unsigned char> image;
+            if (!this->stopped && Utils::Fs::readFile(*path, image)) {
+                Utils::Image::writeThumbnails(image, *path);
+            }
+        });
+    }
+    this->pool.run();
+    if (this->stopped) {
+        return Status::Stopped;
+    }
+
+    // Pick any missing palettes
+    if (!needPalettes.empty()) {
+        std::vector<Utils::Splash::Palette> palettes(needPalettes.size());
+        for (size_t i = 0; i < needPalettes.size(); i++) {
+            this->pool.addTask([this, &needPalettes, &palettes, i]() {
+                palettes[i].invalid = true;
+                if (!this->stopped) {
+                    palettes[i] = Utils::Splash::getPaletteForImage(needPalettes[i]);
+                }
+            });
+        }
+        this->pool.run();
+        if (this->stopped) {
+            return Status::Stopped;
+        }
+
+        Status status = Status::Ok;
+        this->lockDatabase();
+        for (size_t i = 0; i < needPalettes.size(); i++) {
+            if (!palettes[i].invalid && !this->database->setAlbumPaletteForImage(needPalettes[i], Utils::Splash::packPalette(palettes[i]))) {
+                status = Status::ErrDatabase;
+                break;
+            }
+        }
+        this->unlockDatabase();
+
+        if (status != Status::Ok) {
+            return status;
+        }
+    }
+
+    // The scan is complete once all art has been found
+    this->journal.remove();
+    return Status::Ok;
 }
\ No newline at end of file
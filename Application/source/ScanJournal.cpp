@@ -0,0 +1,234 @@
+#include <cstdio>
+#include <cstring>
+#include "Log.hpp"
+#include "ScanJournal.hpp"
+#include "utils/FS.hpp"
+
+// Number of songs to write to the journal at once
+#define BATCH_SIZE 50
+
+// Identifies a journal file (and its version)
+static const char journalMagic[4] = {'T', 'P', 'J', '1'};
+
+// Record types
+static const unsigned char metadataRecord = 'M';
+static const unsigned char dbUpdatedRecord = 'D';
+
+// Helpers to serialize values
+static void appendInt(std::vector<unsigned char> & buf, const uint32_t val) {
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+        buf.push_back((val >> (8 * i)) & 0xFF);
+    }
+}
+
+static void appendString(std::vector<unsigned char> & buf, const std::string & str) {
+    appendInt(buf, str.length());
+    buf.insert(buf.end(), str.begin(), str.end());
+}
+
+// Helpers to deserialize values (return false if there isn't enough data)
+static bool readInt(const std::vector<unsigned char> & buf, size_t & pos, uint32_t & val) {
+    if (pos + sizeof(uint32_t) > buf.size()) {
+        return false;
+    }
+
+    val = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); i++) {
+        val |= (uint32_t)buf[pos + i] << (8 * i);
+    }
+    pos += sizeof(uint32_t);
+    return true;
+}
+
+static bool readString(const std::vector<unsigned char> & buf, size_t & pos, std::string & str) {
+    uint32_t len;
+    if (!readInt(buf, pos, len) || pos + len > buf.size()) {
+        return false;
+    }
+
+    str = std::string(buf.begin() + pos, buf.begin() + pos + len);
+    pos += len;
+    return true;
+}
+
+// Serializes a metadata record for each song
+static void appendSongRecords(std::vector<unsigned char> & buf, const std::vector<Metadata::Song> & songs) {
+    for (const Metadata::Song & song : songs) {
+        buf.push_back(metadataRecord);
+        appendString(buf, song.path);
+        appendInt(buf, song.modified);
+        appendInt(buf, static_cast<uint32_t>(song.format));
+        appendString(buf, song.title);
+        appendString(buf, song.artist);
+        appendString(buf, song.album);
+        appendInt(buf, song.duration);
+        appendInt(buf, song.trackNumber);
+        appendInt(buf, song.discNumber);
+    }
+}
+
+ScanJournal::ScanJournal(const std::string & file) : path(file) {
+    this->dbUpdated = false;
+}
+
+bool ScanJournal::appendSongs(const std::vector<Metadata::Song> & songs) {
+    // Start the journal with the header if it doesn't exist yet
+    std::vector<unsigned char> buf;
+    if (!Utils::Fs::fileExists(this->path)) {
+        buf.insert(buf.end(), journalMagic, journalMagic + sizeof(journalMagic));
+    }
+
+    appendSongRecords(buf, songs);
+    return Utils::Fs::appendFile(this->path, buf);
+}
+
+bool ScanJournal::load() {
+    this->entries.clear();
+    this->dbUpdated = false;
+
+    // A missing journal may have been left as the temporary file if replacing it was interrupted
+    std::string tmpPath = this->path + ".tmp";
+    if (!Utils::Fs::fileExists(this->path) && Utils::Fs::fileExists(tmpPath)) {
+        Log::writeWarning("[SCAN] Recovering journal from an interrupted write");
+        std::rename(tmpPath.c_str(), this->path.c_str());
+    }
+
+    std::vector<unsigned char> buf;
+    if (!Utils::Fs::fileExists(this->path) || !Utils::Fs::readFile(this->path, buf)) {
+        return false;
+    }
+
+    // Ignore the journal if it's not one we recognise
+    if (buf.size() < sizeof(journalMagic) || std::memcmp(buf.data(), journalMagic, sizeof(journalMagic)) != 0) {
+        Log::writeWarning("[SCAN] Ignoring invalid journal");
+        return false;
+    }
+
+    // Read each record, stopping at the first incomplete one (the app may have been closed while writing)
+    size_t pos = sizeof(journalMagic);
+    while (pos < buf.size()) {
+        unsigned char type = buf[pos++];
+        if (type == dbUpdatedRecord) {
+            this->dbUpdated = true;
+            continue;
+
+        } else if (type != metadataRecord) {
+            break;
+        }
+
+        Metadata::Song m;
+        uint32_t modified, format, duration, track, disc;
+        bool ok = readString(buf, pos, m.path);
+        ok = ok && readInt(buf, pos, modified);
+        ok = ok && readInt(buf, pos, format);
+        ok = ok && readString(buf, pos, m.title);
+        ok = ok && readString(buf, pos, m.artist);
+        ok = ok && readString(buf, pos, m.album);
+        ok = ok && readInt(buf, pos, duration);
+        ok = ok && readInt(buf, pos, track);
+        ok = ok && readInt(buf, pos, disc);
+        if (!ok) {
+            break;
+        }
+
+        m.ID = -1;
+        m.modified = modified;
+        m.format = static_cast<AudioFormat>(format);
+        m.duration = duration;
+        m.trackNumber = static_cast<int>(track);
+        m.discNumber = static_cast<int>(disc);
+        m.plays = 0;
+        m.favourite = false;
+        this->entries[m.path] = m;
+    }
+
+    Log::writeInfo("[SCAN] Read " + std::to_string(this->entries.size()) + " entries from journal");
+    return true;
+}
+
+bool ScanJournal::getMetadata(const std::string & file, const unsigned int modified, Metadata::Song & meta) {
+    std::unordered_map<std::string, Metadata::Song>::iterator it = this->entries.find(file);
+    if (it == this->entries.end() || it->second.modified != modified) {
+        return false;
+    }
+
+    meta = it->second;
+    return true;
+}
+
+bool ScanJournal::databaseUpdated() {
+    return this->dbUpdated;
+}
+
+std::vector<Metadata::Song> ScanJournal::songs() {
+    std::vector<Metadata::Song> songs;
+    for (const std::pair<const std::string, Metadata::Song> & entry : this->entries) {
+        songs.push_back(entry.second);
+    }
+    return songs;
+}
+
+void ScanJournal::addMetadata(const Metadata::Song & meta) {
+    std::scoped_lock<std::mutex> mtx(this->batchMutex);
+    this->batch.push_back(meta);
+    if (this->batch.size() >= BATCH_SIZE) {
+        if (!this->appendSongs(this->batch)) {
+            Log::writeWarning("[SCAN] Unable to write to journal");
+        }
+        this->batch.clear();
+    }
+}
+
+bool ScanJournal::flush() {
+    std::scoped_lock<std::mutex> mtx(this->batchMutex);
+    if (this->batch.empty()) {
+        return true;
+    }
+
+    bool ok = this->appendSongs(this->batch);
+    this->batch.clear();
+    return ok;
+}
+
+bool ScanJournal::markDatabaseUpdated(const std::vector<Metadata::Song> & songs) {
+    // Nothing left to do if there are no songs
+    if (songs.empty()) {
+        this->remove();
+        return true;
+    }
+
+    // Any unwritten metadata has been added to the database
+    {
+        std::scoped_lock<std::mutex> mtx(this->batchMutex);
+        this->batch.clear();
+    }
+
+    std::vector<unsigned char> buf(journalMagic, journalMagic + sizeof(journalMagic));
+    buf.push_back(dbUpdatedRecord);
+    appendSongRecords(buf, songs);
+
+    // Write to a temporary file first so the old journal is kept if this one is only partially written
+    std::string tmpPath = this->path + ".tmp";
+    if (!Utils::Fs::writeFile(tmpPath, buf)) {
+        Log::writeError("[SCAN] Unable to write to " + tmpPath);
+        Utils::Fs::deleteFile(tmpPath);
+        return false;
+    }
+
+    // Rename doesn't replace existing files on the Switch, so the old one is removed first
+    Utils::Fs::deleteFile(this->path);
+    if (std::rename(tmpPath.c_str(), this->path.c_str()) != 0) {
+        Log::writeError("[SCAN] Unable to rename " + tmpPath + " to " + this->path);
+        return false;
+    }
+    return true;
+}
+
+void ScanJournal::remove() {
+    {
+        std::scoped_lock<std::mutex> mtx(this->batchMutex);
+        this->batch.clear();
+    }
+    Utils::Fs::deleteFile(this->path);
+    Utils::Fs::deleteFile(this->path + ".tmp");
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstdlib>
 #include "db/Database.hpp"
 #include "db/extensions/okapi_bm25.h"
 #include "db/extensions/Spellfix.h"
@@ -6,11 +7,12 @@
 #include "Log.hpp"
 #include "Paths.hpp"
 #include "utils/FS.hpp"
+#include "utils/Image.hpp"
 #include "utils/Search.hpp"
 #include "utils/Utils.hpp"
 
 // Version of the database (database begins with zero from 'template', so this started at 1)
-#define DB_VERSION 7
+#define DB_VERSION 11
 // Maximum number of spellfixed words to allow per word (i.e. pick the top x words)
 #define SPELLFIX_LIMIT 6
 // Location of template file
@@ -21,6 +23,177 @@ bool keepFalse(const bool & a, const bool & b) {
     return !(!a || !b);
 }
 
+// Query used to check if an image is still referenced by a row
+static const char * imageInUseQuery = "SELECT 1 FROM Albums WHERE image_path = ?1 UNION ALL SELECT 1 FROM Artists WHERE image_path = ?1 UNION ALL SELECT 1 FROM Playlists WHERE image_path = ?1 LIMIT 1;";
+
+// Returns the ORDER BY clause used to sort songs (each order has a matching index, see migration 9)
+static std::string songOrderBy(const Database::SortBy sort) {
+    switch (sort) {
+        case Database::SortBy::TitleAsc:
+        default:
+            return "Songs.sort_title ASC, Songs.sort_artist ASC, Songs.sort_album ASC";
+
+        case Database::SortBy::TitleDsc:
+            return "Songs.sort_title DESC, Songs.sort_artist ASC, Songs.sort_album ASC";
+
+        case Database::SortBy::ArtistAsc:
+            return "Songs.sort_artist ASC, Songs.sort_title ASC";
+
+        case Database::SortBy::ArtistDsc:
+            return "Songs.sort_artist DESC, Songs.sort_title ASC";
+
+        case Database::SortBy::AlbumAsc:
+            return "Songs.sort_album ASC, Songs.sort_title ASC";
+
+        case Database::SortBy::AlbumDsc:
+            return "Songs.sort_album DESC, Songs.sort_title ASC";
+
+        case Database::SortBy::LengthAsc:
+            return "Songs.duration ASC, Songs.sort_title ASC, Songs.sort_artist ASC, Songs.sort_album ASC";
+
+        case Database::SortBy::LengthDsc:
+            return "Songs.duration DESC, Songs.sort_title ASC, Songs.sort_artist ASC, Songs.sort_album ASC";
+    }
+}
+
+// Column (named in the query's results) that a listing is ordered by when paging with a Cursor
+struct SortColumn {
+    std::string name;       // Name of the column
+    bool desc;              // Whether sorted in descending order
+    bool integer;           // Whether the column holds integers (otherwise text)
+    int index = -1;         // Index of the column in each row (set by indexColumns())
+};
+
+// Set the index of each column to the position of the result with the same name in the query
+// (i.e. 'x', 'Table.x' or 'y AS x'). Returns false if a column isn't returned by the query
+static bool indexColumns(const std::string & query, std::vector<SortColumn> & cols) {
+    size_t start = query.find("SELECT ");
+    size_t end = query.find(" FROM ");
+    if (start == std::string::npos || end == std::string::npos) {
+        return false;
+    }
+
+    // Get the name of each result
+    std::vector<std::string> names;
+    start += 7;
+    while (start < end) {
+        size_t comma = std::min(query.find(',', start), end);
+        std::string result = query.substr(start, comma - start);
+        size_t as = result.rfind(" AS ");
+        if (as != std::string::npos) {
+            result = result.substr(as + 4);
+        } else if (result.rfind('.') != std::string::npos) {
+            result = result.substr(result.rfind('.') + 1);
+        }
+        result.erase(0, result.find_first_not_of(' '));
+        names.push_back(result);
+        start = comma + 1;
+    }
+
+    for (SortColumn & col : cols) {
+        std::vector<std::string>::iterator it = std::find(names.begin(), names.end(), col.name);
+        if (it == names.end()) {
+            return false;
+        }
+        col.index = it - names.begin();
+    }
+    return true;
+}
+
+// Returns the WHERE clause which skips the rows up to the cursor's last row, and the ORDER BY clause
+// for the given columns (with the ID column last to break ties). Keys are bound from the given parameter
+static std::string keysetClauses(const Database::Cursor & cursor, const std::vector<SortColumn> & cols, const std::string & id, const int param) {
+    // a >= ? AND ((a > ?) OR (a = ? AND b > ?) OR ... OR (a = ? AND b = ? AND ... AND id > ?))
+    // The range on the first column is redundant but lets SQLite seek in the index instead of scanning it
+    std::string where = "";
+    if (cursor.started) {
+        where = "WHERE " + cols[0].name + (cols[0].desc ? " <= ?" : " >= ?") + std::to_string(param) + " AND (";
+        for (size_t i = 0; i <= cols.size(); i++) {
+            std::string term = "";
+            for (size_t j = 0; j < i; j++) {
+                term += cols[j].name + " = ?" + std::to_string(param + j) + " AND ";
+            }
+            if (i < cols.size()) {
+                term += cols[i].name + (cols[i].desc ? " < ?" : " > ?") + std::to_string(param + i);
+            } else {
+                term += id + " > ?" + std::to_string(param + i);
+            }
+            where += (i == 0 ? "(" : " OR (") + term + ")";
+        }
+        where += ")";
+    }
+
+    std::string orderBy = " ORDER BY ";
+    for (const SortColumn & col : cols) {
+        orderBy += col.name + (col.desc ? " DESC, " : " ASC, ");
+    }
+    return where + orderBy + id + " ASC";
+}
+
+// Bind the cursor's keys to the parameters used in the above clauses
+static bool bindKeyset(SQLite * db, const Database::Cursor & cursor, const std::vector<SortColumn> & cols, const int param) {
+    if (!cursor.started) {
+        return true;
+    }
+
+    bool ok = (cursor.keys.size() == cols.size());
+    for (size_t i = 0; ok && i < cols.size(); i++) {
+        if (cols[i].integer) {
+            ok = db->bindInt(param + i - 1, std::strtol(cursor.keys[i].c_str(), nullptr, 10));
+        } else {
+            ok = db->bindString(param + i - 1, cursor.keys[i]);
+        }
+    }
+    return keepFalse(ok, db->bindInt(param + cols.size() - 1, cursor.lastID));
+}
+
+// Store the sort keys and ID of the current row in the cursor
+static bool readKeyset(SQLite * db, Database::Cursor & cursor, const std::vector<SortColumn> & cols, const int id) {
+    bool ok = true;
+    cursor.keys.resize(cols.size());
+    for (size_t i = 0; i < cols.size(); i++) {
+        ok = keepFalse(ok, db->getString(cols[i].index, cursor.keys[i]));
+    }
+    return keepFalse(ok, db->getInt(id, cursor.lastID));
+}
+
+// Columns used to page through songs (matches songOrderBy() using the names in songPageQuery)
+static std::vector<SortColumn> songSortColumns(const Database::SortBy sort) {
+    switch (sort) {
+        case Database::SortBy::TitleAsc:
+        default:
+            return {{"sort_title", false, false}, {"sort_artist", false, false}, {"sort_album", false, false}};
+
+        case Database::SortBy::TitleDsc:
+            return {{"sort_title", true, false}, {"sort_artist", false, false}, {"sort_album", false, false}};
+
+        case Database::SortBy::ArtistAsc:
+            return {{"sort_artist", false, false}, {"sort_title", false, false}};
+
+        case Database::SortBy::ArtistDsc:
+            return {{"sort_artist", true, false}, {"sort_title", false, false}};
+
+        case Database::SortBy::AlbumAsc:
+            return {{"sort_album", false, false}, {"sort_title", false, false}};
+
+        case Database::SortBy::AlbumDsc:
+            return {{"sort_album", true, false}, {"sort_title", false, false}};
+
+        case Database::SortBy::LengthAsc:
+            return {{"duration", false, true}, {"sort_title", false, false}, {"sort_artist", false, false}, {"sort_album", false, false}};
+
+        case Database::SortBy::LengthDsc:
+            return {{"duration", true, true}, {"sort_title", false, false}, {"sort_artist", false, false}, {"sort_album", false, false}};
+    }
+}
+
+// Query returning every song, with the columns named for paging
+static const char * songPageQuery = "SELECT Songs.id AS id, Songs.title AS title, Artists.name AS artist, Albums.name AS album, Songs.track, Songs.disc, Songs.duration AS duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified, Songs.sort_title AS sort_title, Songs.sort_artist AS sort_artist, Songs.sort_album AS sort_album FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id";
+
+// Queries returning every album/artist with songs (counts and durations are kept up to date by triggers)
+static const char * albumQuery = "SELECT id, name, artist_name, tadb_id, image_path, song_count, duration, sort_name, sort_artist FROM Albums WHERE song_count > 0";
+static const char * artistQuery = "SELECT id, name, tadb_id, image_path, album_count, song_count, duration, sort_name FROM Artists WHERE song_count > 0";
+
 // Helper function called by sqlite3 to remove an entry's image
 void removeImage(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
     // Get image_path string
@@ -35,8 +208,38 @@ void removeImage(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
         return;
     }
 
-    // Otherwise remove
-    Utils::Fs::deleteFile(string);
+    // Keep the image if another row still uses it (album art is shared)
+    sqlite3_stmt * stmt;
+    if (sqlite3_prepare_v2(sqlite3_context_db_handle(pCtx), imageInUseQuery, -1, &stmt, nullptr) != SQLITE_OK) {
+        return;
+    }
+    sqlite3_bind_text(stmt, 1, string.c_str(), -1, SQLITE_TRANSIENT);
+    int rc = sqlite3_step(stmt);
+    sqlite3_finalize(stmt);
+    if (rc != SQLITE_DONE) {
+        return;
+    }
+
+    // Otherwise remove (along with smaller copies)
+    Utils::Image::deleteImage(string);
+}
+
+// Helper function called by sqlite3 to get the key used to sort a name
+void sortKey(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
+    if (argc < 1 || sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(pCtx);
+        return;
+    }
+
+    std::string key = Utils::Search::sortKey(std::string((const char *)sqlite3_value_text(argv[0])));
+    sqlite3_result_text(pCtx, key.c_str(), key.length(), SQLITE_TRANSIENT);
+}
+
+Database::Cursor::Cursor(const Database::SortBy sort) {
+    this->sort = sort;
+    this->started = false;
+    this->done = false;
+    this->lastID = -1;
 }
 
 // ===== Housekeeping ===== //
@@ -167,6 +370,38 @@ bool Database::migrate() {
                     break;
                 }
                 Log::writeSuccess("[DB] Migrated to version 7");
+
+            case 7:
+                err = Migration::migrateTo8(this->db);
+                if (!err.empty()) {
+                    err = "Migration 8: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 8");
+
+            case 8:
+                err = Migration::migrateTo9(this->db);
+                if (!err.empty()) {
+                    err = "Migration 9: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 9");
+
+            case 9:
+                err = Migration::migrateTo10(this->db);
+                if (!err.empty()) {
+                    err = "Migration 10: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 10");
+
+            case 10:
+                err = Migration::migrateTo11(this->db);
+                if (!err.empty()) {
+                    err = "Migration 11: " + err;
+                    break;
+                }
+                Log::writeSuccess("[DB] Migrated to version 11");
         }
     }
 
@@ -334,6 +569,7 @@ bool Database::openReadWrite() {
     bool ok = this->db->openConnection(SQLite::Connection::ReadWrite);
     if (ok) {
         ok = keepFalse(ok, this->db->createFunction("removeImage", removeImage, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("sortKey", sortKey, nullptr));
     }
     return ok;
 }
@@ -342,6 +578,7 @@ bool Database::openReadOnly() {
     bool ok = this->db->openConnection(SQLite::Connection::ReadOnly);
     if (ok) {
         ok = keepFalse(ok, this->db->createFunction("removeImage", removeImage, nullptr));
+        ok = keepFalse(ok, this->db->createFunction("sortKey", sortKey, nullptr));
     }
     return ok;
 }
@@ -375,9 +612,7 @@ bool Database::updateAlbum(Metadata::Album m) {
     if (!ok) {
         this->setErrorMsg("[updateAlbum] An error occurred while updating the entry");
     } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [updateAlbum] '" + m.name + "' was updated");
-        }
+        Log::writeInfo("[DB] [updateAlbum] '", m.name, "' was updated");
     }
     this->db->ignoreConstraints(true);
 
@@ -389,6 +624,121 @@ bool Database::updateAlbum(Metadata::Album m) {
     return ok;
 }
 
+bool Database::setAlbumImageForSong(const std::string & path, const std::string & image) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setAlbumImageForSong] Can't update album as the database is unwritable");
+        return false;
+    }
+
+    // Find the album and update it in one statement
+    bool ok = this->db->prepareQuery("UPDATE Albums SET image_path = ? WHERE id = (SELECT album_id FROM Songs WHERE path = ?) AND image_path = '';");
+    ok = keepFalse(ok, this->db->bindString(0, image));
+    ok = keepFalse(ok, this->db->bindString(1, path));
+    if (!ok) {
+        this->setErrorMsg("[setAlbumImageForSong] An error occurred while preparing the statement");
+        return false;
+    }
+
+    ok = this->db->executeQuery();
+    if (!ok) {
+        this->setErrorMsg("[setAlbumImageForSong] An error occurred while updating the entry");
+    }
+    return ok;
+}
+
+bool Database::setAlbumPaletteForImage(const std::string & image, const Metadata::Palette & palette) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setAlbumPaletteForImage] Can't update album as the database is unwritable");
+        return false;
+    }
+
+    // Albums with the same art share the image, so they share the palette too
+    bool ok = this->db->prepareQuery("UPDATE Albums SET palette_light = ?, palette_background = ?, palette_primary = ?, palette_secondary = ? WHERE image_path = ?;");
+    ok = keepFalse(ok, this->db->bindBool(0, palette.light));
+    ok = keepFalse(ok, this->db->bindInt(1, palette.background));
+    ok = keepFalse(ok, this->db->bindInt(2, palette.primary));
+    ok = keepFalse(ok, this->db->bindInt(3, palette.secondary));
+    ok = keepFalse(ok, this->db->bindString(4, image));
+    if (!ok) {
+        this->setErrorMsg("[setAlbumPaletteForImage] An error occurred while preparing the statement");
+        return false;
+    }
+
+    ok = this->db->executeQuery();
+    if (!ok) {
+        this->setErrorMsg("[setAlbumPaletteForImage] An error occurred while updating the entries");
+    }
+    return ok;
+}
+
+bool Database::getAlbumPalette(AlbumID id, Metadata::Palette & palette) {
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAlbumPalette] No open connection");
+        return false;
+    }
+
+    // No row is returned if a palette hasn't been picked
+    bool ok = this->db->prepareQuery("SELECT palette_light, palette_background, palette_primary, palette_secondary FROM Albums WHERE id = ? AND palette_background IS NOT NULL;");
+    ok = keepFalse(ok, this->db->bindInt(0, id));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getAlbumPalette] An error occurred querying for the palette");
+        return false;
+    }
+    if (!this->db->hasRow()) {
+        return false;
+    }
+
+    int light, background, primary, secondary;
+    ok = this->db->getInt(0, light);
+    ok = keepFalse(ok, this->db->getInt(1, background));
+    ok = keepFalse(ok, this->db->getInt(2, primary));
+    ok = keepFalse(ok, this->db->getInt(3, secondary));
+    if (!ok) {
+        this->setErrorMsg("[getAlbumPalette] An error occurred reading from the query results");
+        return false;
+    }
+
+    palette.light = (light != 0);
+    palette.background = background;
+    palette.primary = primary;
+    palette.secondary = secondary;
+    return true;
+}
+
+std::vector<std::string> Database::getAlbumImagesWithoutPalette() {
+    std::vector<std::string> v;
+
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAlbumImagesWithoutPalette] No open connection");
+        return v;
+    }
+
+    bool ok = this->db->prepareAndExecuteQuery("SELECT DISTINCT image_path FROM Albums WHERE image_path != '' AND palette_background IS NULL;");
+    if (!ok) {
+        this->setErrorMsg("[getAlbumImagesWithoutPalette] Unable to query for images");
+        return v;
+    }
+
+    while (ok && this->db->hasRow()) {
+        std::string path;
+        ok = this->db->getString(0, path);
+        if (!ok) {
+            this->setErrorMsg("[getAlbumImagesWithoutPalette] An error occurred reading from the query results");
+            v.clear();
+            return v;
+        }
+        v.push_back(path);
+        ok = this->db->nextRow();
+    }
+
+    return v;
+}
+
 std::vector<Metadata::Album> Database::getAllAlbumMetadata(Database::SortBy sort) {
     std::vector<Metadata::Album> v;
     // Check we can read
@@ -402,32 +752,32 @@ std::vector<Metadata::Album> Database::getAllAlbumMetadata(Database::SortBy sort
     switch (sort) {
         case Database::SortBy::AlbumAsc:
         default:
-            orderBy = "Albums.name ASC";
+            orderBy = "Albums.sort_name ASC";
             break;
 
         case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC";
+            orderBy = "Albums.sort_name DESC";
             break;
 
         case Database::SortBy::ArtistAsc:
-            orderBy = "artist_name ASC, Albums.name ASC";
+            orderBy = "Albums.sort_artist ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::ArtistDsc:
-            orderBy = "artist_name DESC, Albums.name ASC";
+            orderBy = "Albums.sort_artist DESC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::SongsAsc:
-            orderBy = "song_count ASC, Albums.name ASC";
+            orderBy = "song_count ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::SongsDsc:
-            orderBy = "song_count DESC, Albums.name ASC";
+            orderBy = "song_count DESC, Albums.sort_name ASC";
             break;
     }
 
     // Create a Metadata::Album for each entry
-    bool ok = this->db->prepareAndExecuteQuery("SELECT album_id, Albums.name, CASE WHEN COUNT(DISTINCT artist_id) > 1 THEN 'Various Artists' ELSE Artists.name END AS artist_name, Albums.tadb_id, Albums.image_path, COUNT(*) AS song_count FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id GROUP BY album_id ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareAndExecuteQuery(std::string(albumQuery) + " ORDER BY " + orderBy + ";");
     if (!ok) {
         this->setErrorMsg("[getAllAlbumMetadata] Unable to query for all albums");
         return v;
@@ -442,6 +792,8 @@ std::vector<Metadata::Album> Database::getAllAlbumMetadata(Database::SortBy sort
         int tmp;
         ok = keepFalse(ok, this->db->getInt(5, tmp));
         m.songCount = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
 
         if (ok) {
             v.push_back(m);
@@ -452,6 +804,106 @@ std::vector<Metadata::Album> Database::getAllAlbumMetadata(Database::SortBy sort
     return v;
 }
 
+std::vector<Metadata::Album> Database::getAlbumMetadataPage(Database::Cursor & cursor, const size_t count) {
+    std::vector<Metadata::Album> v;
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAlbumMetadataPage] No open connection");
+        return v;
+    }
+    if (cursor.done) {
+        return v;
+    }
+
+    // Determine how we're sorting the results (matches getAllAlbumMetadata())
+    std::vector<SortColumn> cols;
+    switch (cursor.sort) {
+        case Database::SortBy::AlbumAsc:
+        default:
+            cols = {{"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::AlbumDsc:
+            cols = {{"sort_name", true, false}};
+            break;
+
+        case Database::SortBy::ArtistAsc:
+            cols = {{"sort_artist", false, false}, {"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::ArtistDsc:
+            cols = {{"sort_artist", true, false}, {"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::SongsAsc:
+            cols = {{"song_count", false, true}, {"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::SongsDsc:
+            cols = {{"song_count", true, true}, {"sort_name", false, false}};
+            break;
+    }
+
+    // Seek past the last row instead of skipping every previous row
+    bool ok = indexColumns(albumQuery, cols);
+    ok = keepFalse(ok, this->db->prepareQuery("SELECT * FROM (" + std::string(albumQuery) + ") " + keysetClauses(cursor, cols, "id", 1) + " LIMIT " + std::to_string(count) + ";"));
+    ok = keepFalse(ok, bindKeyset(this->db, cursor, cols, 1));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getAlbumMetadataPage] Unable to query for albums");
+        return v;
+    }
+
+    // Read each row, remembering the last one's keys in a copy of the cursor
+    Database::Cursor next = cursor;
+    while (ok && this->db->hasRow()) {
+        Metadata::Album m;
+        ok = this->db->getInt(0, m.ID);
+        ok = keepFalse(ok, this->db->getString(1, m.name));
+        ok = keepFalse(ok, this->db->getString(2, m.artist));
+        ok = keepFalse(ok, this->db->getInt(3, m.tadbID));
+        ok = keepFalse(ok, this->db->getString(4, m.imagePath));
+        int tmp;
+        ok = keepFalse(ok, this->db->getInt(5, tmp));
+        m.songCount = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
+        ok = keepFalse(ok, readKeyset(this->db, next, cols, 0));
+
+        if (!ok) {
+            this->setErrorMsg("[getAlbumMetadataPage] An error occurred reading from the query results");
+            return std::vector<Metadata::Album>();
+        }
+        v.push_back(m);
+        ok = this->db->nextRow();
+    }
+
+    // Only advance once the whole page has been read
+    next.started = true;
+    next.done = (v.size() < count);
+    cursor = next;
+    return v;
+}
+
+int Database::getAlbumCount() {
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAlbumCount] No open connection");
+        return -1;
+    }
+
+    // Only albums with songs are listed
+    int count = -1;
+    bool ok = this->db->prepareAndExecuteQuery("SELECT COUNT(*) FROM Albums WHERE song_count > 0;");
+    ok = keepFalse(ok, this->db->hasRow());
+    ok = keepFalse(ok, this->db->getInt(0, count));
+    if (!ok) {
+        this->setErrorMsg("[getAlbumCount] Unable to count albums");
+        return -1;
+    }
+    return count;
+}
+
 Metadata::Album Database::getAlbumMetadataForID(AlbumID id) {
     Metadata::Album m;
     m.ID = -1;
@@ -463,7 +915,7 @@ Metadata::Album Database::getAlbumMetadataForID(AlbumID id) {
     }
 
     // Create a Metadata::Album
-    bool ok = this->db->prepareQuery("SELECT album_id, Albums.name, CASE WHEN COUNT(DISTINCT artist_id) > 1 THEN 'Various Artists' ELSE Artists.name END, Albums.tadb_id, Albums.image_path, COUNT(*) FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.album_id = ? GROUP BY Songs.album_id;");
+    bool ok = this->db->prepareQuery(std::string(albumQuery) + " AND id = ?;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -478,6 +930,8 @@ Metadata::Album Database::getAlbumMetadataForID(AlbumID id) {
     ok = keepFalse(ok, this->db->getString(4, m.imagePath));
     ok = keepFalse(ok, this->db->getInt(5, tmp));
     m.songCount = tmp;
+    ok = keepFalse(ok, this->db->getInt(6, tmp));
+    m.duration = tmp;
 
     if (!ok) {
         this->setErrorMsg("[getAlbumMetadataForID] An error occurred reading from the query results");
@@ -501,24 +955,24 @@ std::vector<Metadata::Album> Database::getAlbumMetadataForArtist(ArtistID id, Da
     switch (sort) {
         case Database::SortBy::AlbumAsc:
         default:
-            orderBy = "Albums.name ASC";
+            orderBy = "Albums.sort_name ASC";
             break;
 
         case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC";
+            orderBy = "Albums.sort_name DESC";
             break;
 
         case Database::SortBy::SongsAsc:
-            orderBy = "song_count ASC, Albums.name ASC";
+            orderBy = "song_count ASC, Albums.sort_name ASC";
             break;
 
         case Database::SortBy::SongsDsc:
-            orderBy = "song_count DESC, Albums.name ASC";
+            orderBy = "song_count DESC, Albums.sort_name ASC";
             break;
     }
 
     // Create a Metadata::Album (note this query won't ever return 'Various Artists' as the artist but that's alright seeing how we're querying for an artist)
-    bool ok = this->db->prepareQuery("SELECT album_id, Albums.name, Artists.name, Albums.tadb_id, Albums.image_path, COUNT(*) AS song_count FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.artist_id = ? GROUP BY Songs.album_id ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareQuery("SELECT album_id, Albums.name, Artists.name, Albums.tadb_id, Albums.image_path, COUNT(*) AS song_count, SUM(Songs.duration) FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.artist_id = ? GROUP BY Songs.album_id ORDER BY " + orderBy + ";");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -535,6 +989,8 @@ std::vector<Metadata::Album> Database::getAlbumMetadataForArtist(ArtistID id, Da
         ok = keepFalse(ok, this->db->getString(4, m.imagePath));
         ok = keepFalse(ok, this->db->getInt(5, tmp));
         m.songCount = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
 
         if (ok) {
             v.push_back(m);
@@ -570,9 +1026,7 @@ bool Database::updateArtist(Metadata::Artist m) {
     if (!ok) {
         this->setErrorMsg("[updateArtist] An error occurred while updating the entry");
     } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [updateArtist] '" + m.name + "' was updated");
-        }
+        Log::writeInfo("[DB] [updateArtist] '", m.name, "' was updated");
     }
     this->db->ignoreConstraints(true);
 
@@ -597,32 +1051,32 @@ std::vector<Metadata::Artist> Database::getAllArtistMetadata(Database::SortBy so
     switch (sort) {
         case Database::SortBy::ArtistAsc:
         default:
-            orderBy = "Artists.name ASC";
+            orderBy = "Artists.sort_name ASC";
             break;
 
         case Database::SortBy::ArtistDsc:
-            orderBy = "Artists.name DESC";
+            orderBy = "Artists.sort_name DESC";
             break;
 
         case Database::SortBy::AlbumsAsc:
-            orderBy = "album_count ASC, Artists.name ASC";
+            orderBy = "album_count ASC, Artists.sort_name ASC";
             break;
 
         case Database::SortBy::AlbumsDsc:
-            orderBy = "album_count DESC, Artists.name ASC";
+            orderBy = "album_count DESC, Artists.sort_name ASC";
             break;
 
         case Database::SortBy::SongsAsc:
-            orderBy = "song_count ASC, Artists.name ASC";
+            orderBy = "song_count ASC, Artists.sort_name ASC";
             break;
 
         case Database::SortBy::SongsDsc:
-            orderBy = "song_count DESC, Artists.name ASC";
+            orderBy = "song_count DESC, Artists.sort_name ASC";
             break;
     }
 
     // Create a Metadata::Artist for each entry
-    bool ok = this->db->prepareAndExecuteQuery("SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id) AS album_count, COUNT(*) AS song_count FROM Songs JOIN Artists ON Songs.artist_id = Artists.id GROUP BY artist_id ORDER BY " + orderBy + ";");
+    bool ok = this->db->prepareAndExecuteQuery(std::string(artistQuery) + " ORDER BY " + orderBy + ";");
     if (!ok) {
         this->setErrorMsg("[getAllArtists] Unable to query for all artists");
         return v;
@@ -638,6 +1092,8 @@ std::vector<Metadata::Artist> Database::getAllArtistMetadata(Database::SortBy so
         m.albumCount = tmp;
         ok = keepFalse(ok, this->db->getInt(5, tmp));
         m.songCount = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
 
         if (ok) {
             v.push_back(m);
@@ -648,6 +1104,107 @@ std::vector<Metadata::Artist> Database::getAllArtistMetadata(Database::SortBy so
     return v;
 }
 
+std::vector<Metadata::Artist> Database::getArtistMetadataPage(Database::Cursor & cursor, const size_t count) {
+    std::vector<Metadata::Artist> v;
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getArtistMetadataPage] No open connection");
+        return v;
+    }
+    if (cursor.done) {
+        return v;
+    }
+
+    // Determine how to sort results (matches getAllArtistMetadata())
+    std::vector<SortColumn> cols;
+    switch (cursor.sort) {
+        case Database::SortBy::ArtistAsc:
+        default:
+            cols = {{"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::ArtistDsc:
+            cols = {{"sort_name", true, false}};
+            break;
+
+        case Database::SortBy::AlbumsAsc:
+            cols = {{"album_count", false, true}, {"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::AlbumsDsc:
+            cols = {{"album_count", true, true}, {"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::SongsAsc:
+            cols = {{"song_count", false, true}, {"sort_name", false, false}};
+            break;
+
+        case Database::SortBy::SongsDsc:
+            cols = {{"song_count", true, true}, {"sort_name", false, false}};
+            break;
+    }
+
+    // Seek past the last row instead of skipping every previous row
+    bool ok = indexColumns(artistQuery, cols);
+    ok = keepFalse(ok, this->db->prepareQuery("SELECT * FROM (" + std::string(artistQuery) + ") " + keysetClauses(cursor, cols, "id", 1) + " LIMIT " + std::to_string(count) + ";"));
+    ok = keepFalse(ok, bindKeyset(this->db, cursor, cols, 1));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getArtistMetadataPage] Unable to query for artists");
+        return v;
+    }
+
+    // Read each row, remembering the last one's keys in a copy of the cursor
+    Database::Cursor next = cursor;
+    while (ok && this->db->hasRow()) {
+        Metadata::Artist m;
+        ok = this->db->getInt(0, m.ID);
+        ok = keepFalse(ok, this->db->getString(1, m.name));
+        ok = keepFalse(ok, this->db->getInt(2, m.tadbID));
+        ok = keepFalse(ok, this->db->getString(3, m.imagePath));
+        int tmp;
+        ok = keepFalse(ok, this->db->getInt(4, tmp));
+        m.albumCount = tmp;
+        ok = keepFalse(ok, this->db->getInt(5, tmp));
+        m.songCount = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
+        ok = keepFalse(ok, readKeyset(this->db, next, cols, 0));
+
+        if (!ok) {
+            this->setErrorMsg("[getArtistMetadataPage] An error occurred reading from the query results");
+            return std::vector<Metadata::Artist>();
+        }
+        v.push_back(m);
+        ok = this->db->nextRow();
+    }
+
+    // Only advance once the whole page has been read
+    next.started = true;
+    next.done = (v.size() < count);
+    cursor = next;
+    return v;
+}
+
+int Database::getArtistCount() {
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getArtistCount] No open connection");
+        return -1;
+    }
+
+    // Only artists with songs are listed
+    int count = -1;
+    bool ok = this->db->prepareAndExecuteQuery("SELECT COUNT(*) FROM Artists WHERE song_count > 0;");
+    ok = keepFalse(ok, this->db->hasRow());
+    ok = keepFalse(ok, this->db->getInt(0, count));
+    if (!ok) {
+        this->setErrorMsg("[getArtistCount] Unable to count artists");
+        return -1;
+    }
+    return count;
+}
+
 std::vector<Metadata::Artist> Database::getArtistMetadataForAlbum(AlbumID id) {
     std::vector<Metadata::Artist> v;
     // Check we can read
@@ -657,7 +1214,7 @@ std::vector<Metadata::Artist> Database::getArtistMetadataForAlbum(AlbumID id) {
     }
 
     // Create a Metadata::Artist for each entry (note this query won't ever return more than '1' as the number of albums as we're querying for a single album)
-    bool ok = this->db->prepareQuery("SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id), COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.album_id = ? GROUP BY artist_id ORDER BY Artists.name;");
+    bool ok = this->db->prepareQuery("SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id), COUNT(*), SUM(Songs.duration) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.album_id = ? GROUP BY artist_id ORDER BY Artists.sort_name;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -675,6 +1232,8 @@ std::vector<Metadata::Artist> Database::getArtistMetadataForAlbum(AlbumID id) {
         m.albumCount = tmp;
         ok = keepFalse(ok, this->db->getInt(5, tmp));
         m.songCount = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
 
         if (ok) {
             v.push_back(m);
@@ -696,7 +1255,7 @@ Metadata::Artist Database::getArtistMetadataForID(ArtistID id) {
     }
 
     // Create a Metadata::Artist for each entry
-    bool ok = this->db->prepareQuery("SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id), COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id WHERE Songs.artist_id = ?;");
+    bool ok = this->db->prepareQuery(std::string(artistQuery) + " AND id = ?;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -712,6 +1271,8 @@ Metadata::Artist Database::getArtistMetadataForID(ArtistID id) {
     m.albumCount = tmp;
     ok = keepFalse(ok, this->db->getInt(5, tmp));
     m.songCount = tmp;
+    ok = keepFalse(ok, this->db->getInt(6, tmp));
+    m.duration = tmp;
     if (!ok) {
         this->setErrorMsg("[getArtistMetadataForID] An error occurred reading from the query results");
         m.ID = -1;
@@ -743,9 +1304,7 @@ bool Database::addPlaylist(Metadata::Playlist m) {
     if (!ok) {
         this->setErrorMsg("[addPlaylist] An error occurred while adding the entry");
     } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [addPlaylist] '" + m.name + "' added to the database");
-        }
+        Log::writeInfo("[DB] [addPlaylist] '", m.name, "' added to the database");
     }
 
     // Mark search tables as out of date
@@ -778,9 +1337,7 @@ bool Database::updatePlaylist(Metadata::Playlist m) {
     if (!ok) {
         this->setErrorMsg("[updatePlaylist] An error occurred while updating the entry");
     } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [updatePlaylist] '" + m.name + "' was updated");
-        }
+        Log::writeInfo("[DB] [updatePlaylist] '", m.name, "' was updated");
     }
 
     // Mark search tables as out of date
@@ -864,7 +1421,95 @@ std::vector<Metadata::Playlist> Database::getAllPlaylistMetadata(Database::SortB
         m.songCount = tmp;
 
         if (ok) {
-            v.push_back(m);
+            v.push_back(m);
+        }
+        ok = keepFalse(ok, this->db->nextRow());
+    }
+
+    v.shrink_to_fit();
+    return v;
+}
+
+Metadata::Playlist Database::getPlaylistMetadataForID(PlaylistID id) {
+    Metadata::Playlist m;
+    m.ID = -1;
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getPlaylistMetadataForID] No open connection");
+        return m;
+    }
+
+    // Query for playlist info
+    bool ok = this->db->prepareQuery("SELECT id, name, description, image_path, COUNT(PlaylistSongs.song_id) FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id WHERE id = ?;");
+    ok = keepFalse(ok, this->db->bindInt(0, id));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getPlaylistMetadataForID] An error occurred querying for info");
+        return m;
+    }
+    int tmp;
+    ok = this->db->getInt(0, m.ID);
+    ok = keepFalse(ok, this->db->getString(1, m.name));
+    ok = keepFalse(ok, this->db->getString(2, m.description));
+    ok = keepFalse(ok, this->db->getString(3, m.imagePath));
+    ok = keepFalse(ok, this->db->getInt(4, tmp));
+    m.songCount = tmp;
+
+    if (!ok) {
+        this->setErrorMsg("[getPlaylistMetadataForID] An error occurred reading from the query results");
+        m.ID = -1;
+    }
+
+    return m;
+}
+
+
+std::vector<Metadata::PlaylistSong> Database::getSongMetadataForPlaylist(PlaylistID id, Database::SortBy sort) {
+    std::vector<Metadata::PlaylistSong> v;
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getSongMetadataForPlaylist] No open connection");
+        return v;
+    }
+
+    // Determine how to sort results
+    std::string orderBy = songOrderBy(sort);
+
+    // Create a Metadata::Song for each entry given the playlist
+    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified, PlaylistSongs.rowid FROM PlaylistSongs JOIN Songs ON Songs.id = PlaylistSongs.song_id JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE PlaylistSongs.playlist_id = ? ORDER BY " + orderBy + ";");
+    ok = keepFalse(ok, this->db->bindInt(0, id));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getSongMetadataForPlaylist] Unable to query for matching songs");
+        return v;
+    }
+    while (ok && this->db->hasRow()) {
+        Metadata::Song m;
+        int tmp;
+        std::string tmpStr;
+        ok = this->db->getInt(0, m.ID);
+        ok = keepFalse(ok, this->db->getString(1, m.title));
+        ok = keepFalse(ok, this->db->getString(2, m.artist));
+        ok = keepFalse(ok, this->db->getString(3, m.album));
+        ok = keepFalse(ok, this->db->getInt(4, tmp));
+        m.trackNumber = tmp;
+        ok = keepFalse(ok, this->db->getInt(5, tmp));
+        m.discNumber = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
+        ok = keepFalse(ok, this->db->getInt(7, tmp));
+        m.plays = tmp;
+        ok = keepFalse(ok, this->db->getBool(8, m.favourite));
+        ok = keepFalse(ok, this->db->getString(9, m.path));
+        ok = keepFalse(ok, this->db->getString(10, tmpStr));
+        m.format = audioFormatFromString(tmpStr);
+        ok = keepFalse(ok, this->db->getInt(11, tmp));
+        m.modified = tmp;
+        ok = keepFalse(ok, this->db->getInt(12, tmp));
+
+        // Push back PlaylistSong struct if all successful
+        if (ok) {
+            v.push_back(Metadata::PlaylistSong{tmp, m});
         }
         ok = keepFalse(ok, this->db->nextRow());
     }
@@ -873,93 +1518,63 @@ std::vector<Metadata::Playlist> Database::getAllPlaylistMetadata(Database::SortB
     return v;
 }
 
-Metadata::Playlist Database::getPlaylistMetadataForID(PlaylistID id) {
-    Metadata::Playlist m;
-    m.ID = -1;
+std::vector<std::pair<PlaylistSongID, SongID>> Database::getSongIDsForPlaylist(PlaylistID id, Database::SortBy sort) {
+    std::vector<std::pair<PlaylistSongID, SongID>> v;
     // Check we can read
     if (this->db->connectionType() == SQLite::Connection::None) {
-        this->setErrorMsg("[getPlaylistMetadataForID] No open connection");
-        return m;
+        this->setErrorMsg("[getSongIDsForPlaylist] No open connection");
+        return v;
     }
 
-    // Query for playlist info
-    bool ok = this->db->prepareQuery("SELECT id, name, description, image_path, COUNT(PlaylistSongs.song_id) FROM Playlists LEFT JOIN PlaylistSongs ON playlist_id = Playlists.id WHERE id = ?;");
+    // Only the IDs are returned, but the joins are still needed to sort
+    bool ok = this->db->prepareQuery("SELECT PlaylistSongs.rowid, Songs.id FROM PlaylistSongs JOIN Songs ON Songs.id = PlaylistSongs.song_id WHERE PlaylistSongs.playlist_id = ? ORDER BY " + songOrderBy(sort) + ";");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
-        this->setErrorMsg("[getPlaylistMetadataForID] An error occurred querying for info");
-        return m;
+        this->setErrorMsg("[getSongIDsForPlaylist] Unable to query for matching songs");
+        return v;
     }
-    int tmp;
-    ok = this->db->getInt(0, m.ID);
-    ok = keepFalse(ok, this->db->getString(1, m.name));
-    ok = keepFalse(ok, this->db->getString(2, m.description));
-    ok = keepFalse(ok, this->db->getString(3, m.imagePath));
-    ok = keepFalse(ok, this->db->getInt(4, tmp));
-    m.songCount = tmp;
-
-    if (!ok) {
-        this->setErrorMsg("[getPlaylistMetadataForID] An error occurred reading from the query results");
-        m.ID = -1;
+    while (ok && this->db->hasRow()) {
+        PlaylistSongID psID;
+        SongID sID;
+        ok = this->db->getInt(0, psID);
+        ok = keepFalse(ok, this->db->getInt(1, sID));
+        if (ok) {
+            v.push_back(std::make_pair(psID, sID));
+        }
+        ok = keepFalse(ok, this->db->nextRow());
     }
 
-    return m;
+    v.shrink_to_fit();
+    return v;
 }
 
-
-std::vector<Metadata::PlaylistSong> Database::getSongMetadataForPlaylist(PlaylistID id, Database::SortBy sort) {
+std::vector<Metadata::PlaylistSong> Database::getSongMetadataForPlaylistPage(PlaylistID id, Database::Cursor & cursor, const size_t count) {
     std::vector<Metadata::PlaylistSong> v;
     // Check we can read
     if (this->db->connectionType() == SQLite::Connection::None) {
-        this->setErrorMsg("[getSongMetadataForPlaylist] No open connection");
+        this->setErrorMsg("[getSongMetadataForPlaylistPage] No open connection");
         return v;
     }
-
-    // Determine how to sort results
-    std::string orderBy = "";
-    switch (sort) {
-        case Database::SortBy::TitleAsc:
-        default:
-            orderBy = "Songs.title ASC, Artists.name ASC, Albums.name ASC";
-            break;
-
-        case Database::SortBy::TitleDsc:
-            orderBy = "Songs.title DESC, Artists.name ASC, Albums.name ASC";
-            break;
-
-        case Database::SortBy::ArtistAsc:
-            orderBy = "Artists.name ASC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::ArtistDsc:
-            orderBy = "Artists.name DESC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::AlbumAsc:
-            orderBy = "Albums.name ASC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::LengthAsc:
-            orderBy = "Songs.duration ASC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
-            break;
-
-        case Database::SortBy::LengthDsc:
-            orderBy = "Songs.duration DESC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
-            break;
+    if (cursor.done) {
+        return v;
     }
 
-    // Create a Metadata::Song for each entry given the playlist
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified, PlaylistSongs.rowid FROM PlaylistSongs JOIN Songs ON Songs.id = PlaylistSongs.song_id JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE PlaylistSongs.playlist_id = ? ORDER BY " + orderBy + ";");
+    // Songs are ordered the same as other lists of songs, using the entry's ID to break ties
+    std::vector<SortColumn> cols = songSortColumns(cursor.sort);
+    std::string query = "SELECT Songs.id AS id, Songs.title AS title, Artists.name AS artist, Albums.name AS album, Songs.track, Songs.disc, Songs.duration AS duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified, PlaylistSongs.rowid AS entry_id, Songs.sort_title AS sort_title, Songs.sort_artist AS sort_artist, Songs.sort_album AS sort_album FROM PlaylistSongs JOIN Songs ON Songs.id = PlaylistSongs.song_id JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE PlaylistSongs.playlist_id = ?1";
+    bool ok = indexColumns(query, cols);
+    ok = keepFalse(ok, this->db->prepareQuery("SELECT * FROM (" + query + ") " + keysetClauses(cursor, cols, "entry_id", 2) + " LIMIT " + std::to_string(count) + ";"));
     ok = keepFalse(ok, this->db->bindInt(0, id));
+    ok = keepFalse(ok, bindKeyset(this->db, cursor, cols, 2));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
-        this->setErrorMsg("[getSongMetadataForPlaylist] Unable to query for matching songs");
+        this->setErrorMsg("[getSongMetadataForPlaylistPage] Unable to query for matching songs");
         return v;
     }
+
+    // Read each row, remembering the last one's keys in a copy of the cursor
+    Database::Cursor next = cursor;
     while (ok && this->db->hasRow()) {
         Metadata::Song m;
         int tmp;
@@ -983,15 +1598,20 @@ std::vector<Metadata::PlaylistSong> Database::getSongMetadataForPlaylist(Playlis
         ok = keepFalse(ok, this->db->getInt(11, tmp));
         m.modified = tmp;
         ok = keepFalse(ok, this->db->getInt(12, tmp));
+        ok = keepFalse(ok, readKeyset(this->db, next, cols, 12));
 
-        // Push back PlaylistSong struct if all successful
-        if (ok) {
-            v.push_back(Metadata::PlaylistSong{tmp, m});
+        if (!ok) {
+            this->setErrorMsg("[getSongMetadataForPlaylistPage] An error occurred reading from the query results");
+            return std::vector<Metadata::PlaylistSong>();
         }
-        ok = keepFalse(ok, this->db->nextRow());
+        v.push_back(Metadata::PlaylistSong{tmp, m});
+        ok = this->db->nextRow();
     }
 
-    v.shrink_to_fit();
+    // Only advance once the whole page has been read
+    next.started = true;
+    next.done = (v.size() < count);
+    cursor = next;
     return v;
 }
 
@@ -1079,9 +1699,7 @@ bool Database::addSong(Metadata::Song m) {
     if (!ok) {
         this->setErrorMsg("[addSong] An error occurred while adding the entry");
     } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [addSong] '" + m.path + "' added to the database");
-        }
+        Log::writeInfo("[DB] [addSong] '", m.path, "' added to the database");
     }
 
     // Mark search tables as out of date
@@ -1129,9 +1747,7 @@ bool Database::updateSong(Metadata::Song m) {
     if (!ok) {
         this->setErrorMsg("[updateSong] An error occurred while adding the entry");
     } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [updateSong] '" + m.title + "' was updated");
-        }
+        Log::writeInfo("[DB] [updateSong] '", m.title, "' was updated");
     }
 
     // Mark search tables as out of date
@@ -1160,9 +1776,7 @@ bool Database::removeSong(SongID id) {
     if (!ok) {
         this->setErrorMsg("[removeSong] An error occurred while removing the entry");
     } else {
-        if (Log::loggingLevel() == Log::Level::Info) {
-            Log::writeInfo("[DB] [removeSong] '" + std::to_string(id) + "' was deleted");
-        }
+        Log::writeInfo("[DB] [removeSong] '", id, "' was deleted");
     }
 
     // Mark search tables as out of date
@@ -1182,41 +1796,7 @@ std::vector<Metadata::Song> Database::getAllSongMetadata(Database::SortBy sort)
     }
 
     // Determine how to sort results
-    std::string orderBy = "";
-    switch (sort) {
-        case Database::SortBy::TitleAsc:
-        default:
-            orderBy = "Songs.title ASC, Artists.name ASC, Albums.name ASC";
-            break;
-
-        case Database::SortBy::TitleDsc:
-            orderBy = "Songs.title DESC, Artists.name ASC, Albums.name ASC";
-            break;
-
-        case Database::SortBy::ArtistAsc:
-            orderBy = "Artists.name ASC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::ArtistDsc:
-            orderBy = "Artists.name DESC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::AlbumAsc:
-            orderBy = "Albums.name ASC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::AlbumDsc:
-            orderBy = "Albums.name DESC, Songs.title ASC";
-            break;
-
-        case Database::SortBy::LengthAsc:
-            orderBy = "duration ASC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
-            break;
-
-        case Database::SortBy::LengthDsc:
-            orderBy = "duration DESC, Songs.title ASC, Artists.name ASC, Albums.name ASC";
-            break;
-    }
+    std::string orderBy = songOrderBy(sort);
 
     // Create a Metadata::Song for each entry
     bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id ORDER BY " + orderBy + ";");
@@ -1258,6 +1838,69 @@ std::vector<Metadata::Song> Database::getAllSongMetadata(Database::SortBy sort)
     return v;
 }
 
+std::vector<Metadata::Song> Database::getSongMetadataPage(Database::Cursor & cursor, const size_t count) {
+    std::vector<Metadata::Song> v;
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getSongMetadataPage] No open connection");
+        return v;
+    }
+    if (cursor.done) {
+        return v;
+    }
+
+    // Seek past the last row instead of skipping every previous row
+    std::vector<SortColumn> cols = songSortColumns(cursor.sort);
+    bool ok = indexColumns(songPageQuery, cols);
+    ok = keepFalse(ok, this->db->prepareQuery("SELECT * FROM (" + std::string(songPageQuery) + ") " + keysetClauses(cursor, cols, "id", 1) + " LIMIT " + std::to_string(count) + ";"));
+    ok = keepFalse(ok, bindKeyset(this->db, cursor, cols, 1));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getSongMetadataPage] Unable to query for songs");
+        return v;
+    }
+
+    // Read each row, remembering the last one's keys in a copy of the cursor
+    Database::Cursor next = cursor;
+    while (ok && this->db->hasRow()) {
+        Metadata::Song m;
+        int tmp;
+        std::string tmpStr;
+        ok = this->db->getInt(0, m.ID);
+        ok = keepFalse(ok, this->db->getString(1, m.title));
+        ok = keepFalse(ok, this->db->getString(2, m.artist));
+        ok = keepFalse(ok, this->db->getString(3, m.album));
+        ok = keepFalse(ok, this->db->getInt(4, tmp));
+        m.trackNumber = tmp;
+        ok = keepFalse(ok, this->db->getInt(5, tmp));
+        m.discNumber = tmp;
+        ok = keepFalse(ok, this->db->getInt(6, tmp));
+        m.duration = tmp;
+        ok = keepFalse(ok, this->db->getInt(7, tmp));
+        m.plays = tmp;
+        ok = keepFalse(ok, this->db->getBool(8, m.favourite));
+        ok = keepFalse(ok, this->db->getString(9, m.path));
+        ok = keepFalse(ok, this->db->getString(10, tmpStr));
+        m.format = audioFormatFromString(tmpStr);
+        ok = keepFalse(ok, this->db->getInt(11, tmp));
+        m.modified = tmp;
+        ok = keepFalse(ok, readKeyset(this->db, next, cols, 0));
+
+        if (!ok) {
+            this->setErrorMsg("[getSongMetadataPage] An error occurred reading from the query results");
+            return std::vector<Metadata::Song>();
+        }
+        v.push_back(m);
+        ok = this->db->nextRow();
+    }
+
+    // Only advance once the whole page has been read
+    next.started = true;
+    next.done = (v.size() < count);
+    cursor = next;
+    return v;
+}
+
 std::vector<Metadata::Song> Database::getSongMetadataForAlbum(AlbumID id) {
     std::vector<Metadata::Song> v;
     // Check we can read
@@ -1268,7 +1911,7 @@ std::vector<Metadata::Song> Database::getSongMetadataForAlbum(AlbumID id) {
 
     // Create a Metadata::Song for each entry given the album (sorted)
     // Note that 0's are treated as 9999's so they are at the end (yes this means it won't always be at the end but no album has 9999 discs or 9999 tracks)
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.album_id = ? ORDER BY CASE disc WHEN 0 THEN 9999 ELSE disc END, CASE track WHEN 0 THEN 9999 ELSE track END, title;");
+    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.album_id = ? ORDER BY CASE disc WHEN 0 THEN 9999 ELSE disc END, CASE track WHEN 0 THEN 9999 ELSE track END, sort_title;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -1317,7 +1960,7 @@ std::vector<Metadata::Song> Database::getSongMetadataForArtist(ArtistID id) {
     }
 
     // Create a Metadata::Song for each entry given the artist
-    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.artist_id = ? ORDER BY Songs.title;");
+    bool ok = this->db->prepareQuery("SELECT Songs.ID, Songs.title, Artists.name, Albums.name, Songs.track, Songs.disc, Songs.duration, Songs.plays, Songs.favourite, Songs.path, Songs.format, Songs.modified FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.artist_id = ? ORDER BY Songs.sort_title;");
     ok = keepFalse(ok, this->db->bindInt(0, id));
     ok = keepFalse(ok, this->db->executeQuery());
     if (!ok) {
@@ -1403,6 +2046,85 @@ Metadata::Song Database::getSongMetadataForID(SongID id) {
     return m;
 }
 
+bool Database::getAllSongColumns(const std::function<void(SongID, std::string &, ArtistID, std::string &, AlbumID, std::string &, unsigned int)> & func) {
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAllSongColumns] No open connection");
+        return false;
+    }
+
+    // Only select what's needed to show a song in a list
+    bool ok = this->db->prepareQuery("SELECT Songs.id, Songs.title, Songs.artist_id, Artists.name, Songs.album_id, Albums.name, Songs.duration FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id ORDER BY Songs.id ASC;");
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getAllSongColumns] Unable to query for all songs");
+        return false;
+    }
+
+    // Strings are reused between rows to avoid reallocating
+    std::string title, artist, album;
+    while (ok && this->db->hasRow()) {
+        SongID id;
+        ArtistID artistID;
+        AlbumID albumID;
+        int duration;
+        ok = this->db->getInt(0, id);
+        ok = keepFalse(ok, this->db->getString(1, title));
+        ok = keepFalse(ok, this->db->getInt(2, artistID));
+        ok = keepFalse(ok, this->db->getString(3, artist));
+        ok = keepFalse(ok, this->db->getInt(4, albumID));
+        ok = keepFalse(ok, this->db->getString(5, album));
+        ok = keepFalse(ok, this->db->getInt(6, duration));
+        if (!ok) {
+            this->setErrorMsg("[getAllSongColumns] An error occurred reading from the query results");
+            return false;
+        }
+
+        func(id, title, artistID, artist, albumID, album, duration);
+        ok = this->db->nextRow();
+    }
+
+    return true;
+}
+
+bool Database::getSnapshotEntries(std::vector<Snapshot::Entry> & entries) {
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getSnapshotEntries] No open connection");
+        return false;
+    }
+
+    // The snapshot must be sorted by ID
+    bool ok = this->db->prepareQuery("SELECT Songs.id, Songs.title, Artists.name, Songs.duration, Albums.image_path, Songs.path FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id ORDER BY Songs.id ASC;");
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[getSnapshotEntries] Unable to query for all songs");
+        return false;
+    }
+
+    entries.clear();
+    while (ok && this->db->hasRow()) {
+        Snapshot::Entry e;
+        int duration;
+        ok = this->db->getInt(0, e.id);
+        ok = keepFalse(ok, this->db->getString(1, e.title));
+        ok = keepFalse(ok, this->db->getString(2, e.artist));
+        ok = keepFalse(ok, this->db->getInt(3, duration));
+        ok = keepFalse(ok, this->db->getString(4, e.imagePath));
+        ok = keepFalse(ok, this->db->getString(5, e.path));
+        if (!ok) {
+            this->setErrorMsg("[getSnapshotEntries] An error occurred reading from the query results");
+            return false;
+        }
+
+        e.duration = duration;
+        entries.push_back(std::move(e));
+        ok = this->db->nextRow();
+    }
+
+    return true;
+}
+
 // ===== Search Queries ===== //
 bool Database::needsSearchUpdate() {
     // Check if we have read permission
@@ -1568,7 +2290,7 @@ std::vector<Metadata::Album> Database::searchAlbums(std::string str, int limit)
     // Iterate over each phrase and store results
     for (size_t i = 0; i < phrases.size(); i++) {
         // Create query and optionally append LIMIT
-        std::string query = "SELECT Albums.id, Albums.name, CASE WHEN COUNT(DISTINCT Songs.artist_id) > 1 THEN 'Various Artists' ELSE Artists.name END, Albums.tadb_id, Albums.image_path, COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id JOIN Albums ON Songs.album_id = Albums.id LEFT JOIN (SELECT DISTINCT name AS content, okapi_bm25(matchinfo(FtsAlbums, 'pcxnal'), 0) AS score FROM FtsAlbums WHERE FtsAlbums MATCH ?) ON Albums.name = content WHERE score IS NOT NULL GROUP BY album_id ORDER BY score DESC, Albums.name";
+        std::string query = "SELECT Albums.id, Albums.name, Albums.artist_name, Albums.tadb_id, Albums.image_path, Albums.song_count, Albums.duration FROM Albums LEFT JOIN (SELECT DISTINCT name AS content, okapi_bm25(matchinfo(FtsAlbums, 'pcxnal'), 0) AS score FROM FtsAlbums WHERE FtsAlbums MATCH ?) ON Albums.name = content WHERE score IS NOT NULL AND Albums.song_count > 0 ORDER BY score DESC, Albums.sort_name";
         query += (limit >= 0 ? " LIMIT ?;" : ";");
         bool ok = this->db->prepareQuery(query);
         std::string str = phrases[i];
@@ -1604,6 +2326,8 @@ std::vector<Metadata::Album> Database::searchAlbums(std::string str, int limit)
             ok = keepFalse(ok, this->db->getString(4, m.imagePath));
             ok = keepFalse(ok, this->db->getInt(5, tmp));
             m.songCount = tmp;
+            ok = keepFalse(ok, this->db->getInt(6, tmp));
+            m.duration = tmp;
 
             if (ok) {
                 v.push_back(m);
@@ -1638,7 +2362,7 @@ std::vector<Metadata::Artist> Database::searchArtists(std::string str, int limit
         // Create query and optionally append LIMIT
         // A little note: "SELECT DISTINCT content AS text" has to be in the subquery otherwise SQLite says "matchinfo can't be used in this context"...
         // It works fine on Linux with "SELECT content" so who knows why it's disagreeing here
-        std::string query = "SELECT Artists.id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id), COUNT(*) FROM Songs JOIN Artists ON Songs.artist_id = Artists.id LEFT JOIN (SELECT DISTINCT content AS text, okapi_bm25(matchinfo(FtsArtists, 'pcxnal'), 0) AS score FROM FtsArtists WHERE FtsArtists MATCH ?) ON Artists.name = text WHERE score IS NOT NULL GROUP BY artist_id ORDER BY score DESC, Artists.name";
+        std::string query = "SELECT Artists.id, Artists.name, Artists.tadb_id, Artists.image_path, Artists.album_count, Artists.song_count, Artists.duration FROM Artists LEFT JOIN (SELECT DISTINCT content AS text, okapi_bm25(matchinfo(FtsArtists, 'pcxnal'), 0) AS score FROM FtsArtists WHERE FtsArtists MATCH ?) ON Artists.name = text WHERE score IS NOT NULL AND Artists.song_count > 0 ORDER BY score DESC, Artists.sort_name";
         query += (limit >= 0 ? " LIMIT ?;" : ";");
         bool ok = this->db->prepareQuery(query);
         std::string str = phrases[i];
@@ -1674,6 +2398,8 @@ std::vector<Metadata::Artist> Database::searchArtists(std::string str, int limit
             m.albumCount = tmp;
             ok = keepFalse(ok, this->db->getInt(5, tmp));
             m.songCount = tmp;
+            ok = keepFalse(ok, this->db->getInt(6, tmp));
+            m.duration = tmp;
 
             if (ok) {
                 v.push_back(m);
@@ -1869,6 +2595,25 @@ std::vector<std::string> Database::getAllImagePaths(bool & success) {
     return v;
 }
 
+bool Database::imagePathInUse(const std::string & path) {
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[imagePathInUse] No open connection");
+        return true;
+    }
+
+    // A row is only returned if the image is referenced
+    bool ok = this->db->prepareQuery(imageInUseQuery);
+    ok = keepFalse(ok, this->db->bindString(0, path));
+    ok = keepFalse(ok, this->db->executeQuery());
+    if (!ok) {
+        this->setErrorMsg("[imagePathInUse] An error occurred querying for the image");
+        return true;
+    }
+
+    return this->db->hasRow();
+}
+
 std::vector< std::pair<std::string, unsigned int> > Database::getAllSongFileInfo(bool & success) {
     std::vector< std::pair<std::string, unsigned int> > v;
 
@@ -1902,6 +2647,82 @@ std::vector< std::pair<std::string, unsigned int> > Database::getAllSongFileInfo
     return v;
 }
 
+std::vector<Metadata::Directory> Database::getAllDirectories(bool & success) {
+    std::vector<Metadata::Directory> v;
+
+    // Check we can read
+    if (this->db->connectionType() == SQLite::Connection::None) {
+        this->setErrorMsg("[getAllDirectories] No open connection");
+        success = false;
+        return v;
+    }
+
+    // Create a struct for each entry
+    bool ok = this->db->prepareAndExecuteQuery("SELECT path, modified, entries, hash FROM Directories ORDER BY path;");
+    if (!ok) {
+        this->setErrorMsg("[getAllDirectories] Unable to query directories");
+        success = false;
+        return v;
+    }
+    while (ok && this->db->hasRow()) {
+        Metadata::Directory d;
+        int modified, entries, hash;
+        ok = this->db->getString(0, d.path);
+        ok = keepFalse(ok, this->db->getInt(1, modified));
+        ok = keepFalse(ok, this->db->getInt(2, entries));
+        ok = keepFalse(ok, this->db->getInt(3, hash));
+        if (ok) {
+            d.modified = modified;
+            d.entries = entries;
+            d.hash = hash;
+            v.push_back(d);
+        }
+        ok = keepFalse(ok, this->db->nextRow());
+    }
+
+    success = true;
+    v.shrink_to_fit();
+    return v;
+}
+
+bool Database::setDirectories(const std::vector<Metadata::Directory> & dirs) {
+    // First check we have write permission
+    if (this->db->connectionType() != SQLite::Connection::ReadWrite) {
+        this->setErrorMsg("[setDirectories] Can't update directories as the database is unwritable");
+        return false;
+    }
+
+    // Remove old entries and insert new ones in one go
+    bool ok = this->db->beginTransaction();
+    ok = keepFalse(ok, this->db->prepareAndExecuteQuery("DELETE FROM Directories;"));
+    if (!ok) {
+        this->setErrorMsg("[setDirectories] Unable to remove old directories");
+        this->db->rollbackTransaction();
+        return false;
+    }
+
+    for (const Metadata::Directory & dir : dirs) {
+        ok = this->db->prepareQuery("INSERT INTO Directories (path, modified, entries, hash) VALUES (?, ?, ?, ?);");
+        ok = keepFalse(ok, this->db->bindString(0, dir.path));
+        ok = keepFalse(ok, this->db->bindInt(1, dir.modified));
+        ok = keepFalse(ok, this->db->bindInt(2, dir.entries));
+        ok = keepFalse(ok, this->db->bindInt(3, dir.hash));
+        ok = keepFalse(ok, this->db->executeQuery());
+        if (!ok) {
+            this->setErrorMsg("[setDirectories] Unable to add directory: " + dir.path);
+            this->db->rollbackTransaction();
+            return false;
+        }
+    }
+
+    ok = this->db->commitTransaction();
+    if (!ok) {
+        this->setErrorMsg("[setDirectories] Unable to commit changes");
+        this->db->rollbackTransaction();
+    }
+    return ok;
+}
+
 ArtistID Database::getArtistIDForName(const std::string & name) {
     int aID = -1;
 
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include "db/MetadataStore.hpp"
+#include "db/SyncDatabase.hpp"
+#include "Log.hpp"
+#include "utils/Search.hpp"
+#include "utils/Timer.hpp"
+
+// Sort the given strings by their sort key and store the position of each
+// (strings with the same key share a position, as the database treats them as equal)
+static void rankNames(const std::vector<std::string> & names, std::vector<uint32_t> & ranks) {
+    std::vector<std::string> keys(names.size());
+    std::vector<uint32_t> sorted(names.size());
+    for (size_t i = 0; i < sorted.size(); i++) {
+        keys[i] = Utils::Search::sortKey(names[i]);
+        sorted[i] = i;
+    }
+    std::sort(sorted.begin(), sorted.end(), [&keys](const uint32_t a, const uint32_t b) {
+        return keys[a] < keys[b];
+    });
+
+    ranks.resize(names.size());
+    uint32_t rank = 0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        if (i > 0 && keys[sorted[i]] != keys[sorted[i - 1]]) {
+            rank++;
+        }
+        ranks[sorted[i]] = rank;
+    }
+}
+
+MetadataStore::MetadataStore() {
+    this->totalDuration_ = 0;
+    this->version_ = 0;
+}
+
+bool MetadataStore::compare(const Row a, const Row b, const Database::SortBy sort) const {
+    // Strings are compared by rank as they have already been sorted by their keys
+    int title = (int)this->titleRanks[a] - (int)this->titleRanks[b];
+    int artist = (int)this->artistRanks[this->artists[a]] - (int)this->artistRanks[this->artists[b]];
+    int album = (int)this->albumRanks[this->albums[a]] - (int)this->albumRanks[this->albums[b]];
+    int duration = (this->durations[a] < this->durations[b] ? -1 : (this->durations[a] > this->durations[b] ? 1 : 0));
+
+    // Each case matches the ORDER BY used by the database
+    switch (sort) {
+        case Database::SortBy::TitleAsc:
+        default:
+            return (title != 0 ? title < 0 : (artist != 0 ? artist < 0 : album < 0));
+
+        case Database::SortBy::TitleDsc:
+            return (title != 0 ? title > 0 : (artist != 0 ? artist < 0 : album < 0));
+
+        case Database::SortBy::ArtistAsc:
+            return (artist != 0 ? artist < 0 : title < 0);
+
+        case Database::SortBy::ArtistDsc:
+            return (artist != 0 ? artist > 0 : title < 0);
+
+        case Database::SortBy::AlbumAsc:
+            return (album != 0 ? album < 0 : title < 0);
+
+        case Database::SortBy::AlbumDsc:
+            return (album != 0 ? album > 0 : title < 0);
+
+        case Database::SortBy::LengthAsc:
+            return (duration != 0 ? duration < 0 : (title != 0 ? title < 0 : (artist != 0 ? artist < 0 : album < 0)));
+
+        case Database::SortBy::LengthDsc:
+            return (duration != 0 ? duration > 0 : (title != 0 ? title < 0 : (artist != 0 ? artist < 0 : album < 0)));
+    }
+}
+
+bool MetadataStore::load(const SyncDatabase & db, const unsigned int version) {
+    Utils::Timer timer;
+    timer.start();
+    this->version_ = version;
+
+    // Names are interned using their ID, so each is only stored once
+    std::unordered_map<ArtistID, uint32_t> artistIdx;
+    std::unordered_map<AlbumID, uint32_t> albumIdx;
+    bool ok = db->getAllSongColumns([&](SongID id, std::string & title, ArtistID artistID, std::string & artist, AlbumID albumID, std::string & album, unsigned int duration) {
+        std::unordered_map<ArtistID, uint32_t>::iterator artistIt = artistIdx.find(artistID);
+        if (artistIt == artistIdx.end()) {
+            artistIt = artistIdx.emplace(artistID, this->artistNames.size()).first;
+            this->artistNames.push_back(std::move(artist));
+        }
+        std::unordered_map<AlbumID, uint32_t>::iterator albumIt = albumIdx.find(albumID);
+        if (albumIt == albumIdx.end()) {
+            albumIt = albumIdx.emplace(albumID, this->albumNames.size()).first;
+            this->albumNames.push_back(std::move(album));
+        }
+
+        this->rows.emplace(id, this->ids.size());
+        this->ids.push_back(id);
+        this->titles.push_back(std::move(title));
+        this->artists.push_back(artistIt->second);
+        this->albums.push_back(albumIt->second);
+        this->durations.push_back(duration);
+        this->totalDuration_ += duration;
+    });
+
+    if (!ok) {
+        Log::writeError("[METADATA] Failed to load song metadata: " + db->error());
+        *this = MetadataStore();
+        this->version_ = version;
+        return false;
+    }
+
+    // Free any extra capacity and prepare for sorting
+    this->ids.shrink_to_fit();
+    this->titles.shrink_to_fit();
+    this->artists.shrink_to_fit();
+    this->albums.shrink_to_fit();
+    this->durations.shrink_to_fit();
+    this->artistNames.shrink_to_fit();
+    this->albumNames.shrink_to_fit();
+    rankNames(this->titles, this->titleRanks);
+    rankNames(this->artistNames, this->artistRanks);
+    rankNames(this->albumNames, this->albumRanks);
+
+    Log::writeInfo("[METADATA] Loaded " + std::to_string(this->ids.size()) + " songs in " + std::to_string((int)timer.elapsedMillis()) + "ms");
+    return true;
+}
+
+unsigned int MetadataStore::version() const {
+    return this->version_;
+}
+
+size_t MetadataStore::size() const {
+    return this->ids.size();
+}
+
+unsigned long MetadataStore::totalDuration() const {
+    return this->totalDuration_;
+}
+
+MetadataStore::Row MetadataStore::row(const SongID id) const {
+    std::unordered_map<SongID, Row>::const_iterator it = this->rows.find(id);
+    return (it == this->rows.end() ? NoRow : it->second);
+}
+
+const std::vector<MetadataStore::Row> & MetadataStore::order(const Database::SortBy sort) const {
+    // Sort once and reuse the result
+    std::unordered_map<int, std::vector<Row>>::iterator it = this->orders.find(static_cast<int>(sort));
+    if (it != this->orders.end()) {
+        return it->second;
+    }
+
+    // Rows are loaded in order of ID, so a stable sort keeps equal songs in that order
+    std::vector<Row> & rows = this->orders[static_cast<int>(sort)];
+    rows.resize(this->ids.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        rows[i] = i;
+    }
+    std::stable_sort(rows.begin(), rows.end(), [this, sort](const Row a, const Row b) {
+        return this->compare(a, b, sort);
+    });
+    return rows;
+}
+
+std::vector<Database::SortBy> MetadataStore::sortedOrders() const {
+    std::vector<Database::SortBy> sorts;
+    for (const std::pair<const int, std::vector<Row>> & order : this->orders) {
+        sorts.push_back(static_cast<Database::SortBy>(order.first));
+    }
+    return sorts;
+}
+
+SongID MetadataStore::id(const Row r) const {
+    return this->ids[r];
+}
+
+const std::string & MetadataStore::title(const Row r) const {
+    return this->titles[r];
+}
+
+const std::string & MetadataStore::artist(const Row r) const {
+    return this->artistNames[this->artists[r]];
+}
+
+const std::string & MetadataStore::album(const Row r) const {
+    return this->albumNames[this->albums[r]];
+}
+
+unsigned int MetadataStore::duration(const Row r) const {
+    return this->durations[r];
+}
\ No newline at end of file
@@ -33,4 +33,12 @@ SyncDatabase::SyncDatabaseProxy SyncDatabase::operator->() const {
     }, [this]() {
         mutex.unlock();
     });
+}
+
+void SyncDatabase::lock() const {
+    this->mutex.lock();
+}
+
+void SyncDatabase::unlock() const {
+    this->mutex.unlock();
 }
\ No newline at end of file
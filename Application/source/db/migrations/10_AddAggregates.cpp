@@ -0,0 +1,103 @@
+#include "db/migrations/10_AddAggregates.hpp"
+
+// Expression for the artist shown for an album (must be used in an UPDATE of Albums)
+#define ALBUM_ARTIST_NAME "CASE WHEN Albums.artist_count > 1 THEN 'Various Artists' ELSE IFNULL((SELECT Artists.name FROM Songs JOIN Artists ON Artists.id = Songs.artist_id WHERE Songs.album_id = Albums.id LIMIT 1), '') END"
+
+namespace Migration {
+    std::string migrateTo10(SQLite * db) {
+        // Add aggregate columns
+        bool ok = db->prepareAndExecuteQuery("ALTER TABLE Artists ADD COLUMN song_count INT NOT NULL DEFAULT 0;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Artists ADD COLUMN album_count INT NOT NULL DEFAULT 0;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Artists ADD COLUMN duration INT NOT NULL DEFAULT 0;");
+        if (!ok) {
+            return "Unable to add aggregate columns to Artists";
+        }
+        ok = db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN song_count INT NOT NULL DEFAULT 0;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN artist_count INT NOT NULL DEFAULT 0;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN duration INT NOT NULL DEFAULT 0;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN artist_name TEXT NOT NULL DEFAULT '';");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN sort_artist TEXT NOT NULL DEFAULT '';");
+        if (!ok) {
+            return "Unable to add aggregate columns to Albums";
+        }
+
+        // Calculate the values for existing rows
+        ok = db->prepareAndExecuteQuery("UPDATE Artists SET song_count = (SELECT COUNT(*) FROM Songs WHERE artist_id = Artists.id), album_count = (SELECT COUNT(DISTINCT album_id) FROM Songs WHERE artist_id = Artists.id), duration = (SELECT IFNULL(SUM(duration), 0) FROM Songs WHERE artist_id = Artists.id);");
+        ok = ok && db->prepareAndExecuteQuery("UPDATE Albums SET song_count = (SELECT COUNT(*) FROM Songs WHERE album_id = Albums.id), artist_count = (SELECT COUNT(DISTINCT artist_id) FROM Songs WHERE album_id = Albums.id), duration = (SELECT IFNULL(SUM(duration), 0) FROM Songs WHERE album_id = Albums.id);");
+        ok = ok && db->prepareAndExecuteQuery("UPDATE Albums SET artist_name = " ALBUM_ARTIST_NAME ";");
+        ok = ok && db->prepareAndExecuteQuery("UPDATE Albums SET sort_artist = sortKey(artist_name);");
+        if (!ok) {
+            return "Unable to initialize aggregate columns";
+        }
+
+        // Create triggers which adjust the values as songs are added, moved and removed
+        // (an artist/album pair is only counted when the first song is added/last song is removed)
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER insertSongAggregates AFTER INSERT ON Songs BEGIN "
+                                        "UPDATE Albums SET song_count = song_count + 1, duration = duration + NEW.duration, artist_count = artist_count + NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = NEW.album_id AND artist_id = NEW.artist_id AND id != NEW.id) WHERE id = NEW.album_id; "
+                                        "UPDATE Artists SET song_count = song_count + 1, duration = duration + NEW.duration, album_count = album_count + NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = NEW.album_id AND artist_id = NEW.artist_id AND id != NEW.id) WHERE id = NEW.artist_id; END;");
+        if (!ok) {
+            return "Unable to create 'insertSongAggregates' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER deleteSongAggregates AFTER DELETE ON Songs BEGIN "
+                                        "UPDATE Albums SET song_count = song_count - 1, duration = duration - OLD.duration, artist_count = artist_count - NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = OLD.album_id AND artist_id = OLD.artist_id) WHERE id = OLD.album_id; "
+                                        "UPDATE Artists SET song_count = song_count - 1, duration = duration - OLD.duration, album_count = album_count - NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = OLD.album_id AND artist_id = OLD.artist_id) WHERE id = OLD.artist_id; END;");
+        if (!ok) {
+            return "Unable to create 'deleteSongAggregates' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER updateSongDuration AFTER UPDATE OF artist_id, album_id, duration ON Songs WHEN OLD.artist_id = NEW.artist_id AND OLD.album_id = NEW.album_id BEGIN "
+                                        "UPDATE Albums SET duration = duration + NEW.duration - OLD.duration WHERE id = NEW.album_id; "
+                                        "UPDATE Artists SET duration = duration + NEW.duration - OLD.duration WHERE id = NEW.artist_id; END;");
+        if (!ok) {
+            return "Unable to create 'updateSongDuration' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER moveSongAggregates AFTER UPDATE OF artist_id, album_id, duration ON Songs WHEN OLD.artist_id != NEW.artist_id OR OLD.album_id != NEW.album_id BEGIN "
+                                        "UPDATE Albums SET song_count = song_count - 1, duration = duration - OLD.duration, artist_count = artist_count - NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = OLD.album_id AND artist_id = OLD.artist_id) WHERE id = OLD.album_id; "
+                                        "UPDATE Artists SET song_count = song_count - 1, duration = duration - OLD.duration, album_count = album_count - NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = OLD.album_id AND artist_id = OLD.artist_id) WHERE id = OLD.artist_id; "
+                                        "UPDATE Albums SET song_count = song_count + 1, duration = duration + NEW.duration, artist_count = artist_count + NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = NEW.album_id AND artist_id = NEW.artist_id AND id != NEW.id) WHERE id = NEW.album_id; "
+                                        "UPDATE Artists SET song_count = song_count + 1, duration = duration + NEW.duration, album_count = album_count + NOT EXISTS (SELECT 1 FROM Songs WHERE album_id = NEW.album_id AND artist_id = NEW.artist_id AND id != NEW.id) WHERE id = NEW.artist_id; END;");
+        if (!ok) {
+            return "Unable to create 'moveSongAggregates' trigger";
+        }
+
+        // Create triggers to keep the artist shown for each album up to date
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER updateAlbumArtist AFTER UPDATE OF artist_count ON Albums WHEN OLD.artist_count != NEW.artist_count BEGIN "
+                                        "UPDATE Albums SET artist_name = " ALBUM_ARTIST_NAME " WHERE id = NEW.id; "
+                                        "UPDATE Albums SET sort_artist = sortKey(artist_name) WHERE id = NEW.id; END;");
+        if (!ok) {
+            return "Unable to create 'updateAlbumArtist' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER renameAlbumArtist AFTER UPDATE OF name ON Artists BEGIN "
+                                        "UPDATE Albums SET artist_name = NEW.name, sort_artist = sortKey(NEW.name) WHERE artist_count = 1 AND id IN (SELECT album_id FROM Songs WHERE artist_id = NEW.id); END;");
+        if (!ok) {
+            return "Unable to create 'renameAlbumArtist' trigger";
+        }
+
+        // Create an index for each album/artist order (names are already indexed in ascending order)
+        const char * indexes[] = {
+            "CREATE INDEX AlbumsByNameDsc ON Albums (sort_name DESC);",
+            "CREATE INDEX AlbumsByArtistAsc ON Albums (sort_artist ASC, sort_name ASC);",
+            "CREATE INDEX AlbumsByArtistDsc ON Albums (sort_artist DESC, sort_name ASC);",
+            "CREATE INDEX AlbumsBySongsAsc ON Albums (song_count ASC, sort_name ASC);",
+            "CREATE INDEX AlbumsBySongsDsc ON Albums (song_count DESC, sort_name ASC);",
+            "CREATE INDEX ArtistsByNameDsc ON Artists (sort_name DESC);",
+            "CREATE INDEX ArtistsByAlbumsAsc ON Artists (album_count ASC, sort_name ASC);",
+            "CREATE INDEX ArtistsByAlbumsDsc ON Artists (album_count DESC, sort_name ASC);",
+            "CREATE INDEX ArtistsBySongsAsc ON Artists (song_count ASC, sort_name ASC);",
+            "CREATE INDEX ArtistsBySongsDsc ON Artists (song_count DESC, sort_name ASC);"
+        };
+        for (const char * query : indexes) {
+            ok = db->prepareAndExecuteQuery(query);
+            if (!ok) {
+                return "Unable to create index: " + std::string(query);
+            }
+        }
+
+        // Bump up version number
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 10 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 10";
+        }
+
+        return "";
+    };
+}
\ No newline at end of file
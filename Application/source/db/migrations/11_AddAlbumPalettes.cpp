@@ -0,0 +1,30 @@
+#include "db/migrations/11_AddAlbumPalettes.hpp"
+
+namespace Migration {
+    std::string migrateTo11(SQLite * db) {
+        // Add palette columns (NULL until a palette has been picked)
+        bool ok = db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN palette_light INT;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN palette_background INT;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN palette_primary INT;");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN palette_secondary INT;");
+        if (!ok) {
+            return "Unable to add palette columns to Albums";
+        }
+
+        // A palette only matches the image it was picked from
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER clearAlbumPalette AFTER UPDATE OF image_path ON Albums WHEN OLD.image_path IS NOT NEW.image_path BEGIN "
+                                        "UPDATE Albums SET palette_light = NULL, palette_background = NULL, palette_primary = NULL, palette_secondary = NULL WHERE id = NEW.id; "
+                                        "END;");
+        if (!ok) {
+            return "Unable to create trigger to clear palettes";
+        }
+
+        // Bump up version number
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 11 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 11";
+        }
+
+        return "";
+    };
+}
\ No newline at end of file
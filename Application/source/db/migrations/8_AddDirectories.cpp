@@ -0,0 +1,19 @@
+#include "db/migrations/8_AddDirectories.hpp"
+
+namespace Migration {
+    std::string migrateTo8(SQLite * db) {
+        // Create Directories table
+        bool ok = db->prepareAndExecuteQuery("CREATE TABLE Directories (path TEXT NOT NULL PRIMARY KEY, modified INT NOT NULL, entries INT NOT NULL, hash INT NOT NULL);");
+        if (!ok) {
+            return "Unable to create the Directories table";
+        }
+
+        // Bump up version number
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 8 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 8";
+        }
+
+        return "";
+    };
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "db/migrations/9_AddSortKeys.hpp"
+
+namespace Migration {
+    std::string migrateTo9(SQLite * db) {
+        // Add sort key columns (songs also hold a copy of their artist's and album's so each order only involves one table)
+        bool ok = db->prepareAndExecuteQuery("ALTER TABLE Artists ADD COLUMN sort_name TEXT NOT NULL DEFAULT '';");
+        if (!ok) {
+            return "Unable to add sort_name column to Artists";
+        }
+        ok = db->prepareAndExecuteQuery("ALTER TABLE Albums ADD COLUMN sort_name TEXT NOT NULL DEFAULT '';");
+        if (!ok) {
+            return "Unable to add sort_name column to Albums";
+        }
+        ok = db->prepareAndExecuteQuery("ALTER TABLE Songs ADD COLUMN sort_title TEXT NOT NULL DEFAULT '';");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Songs ADD COLUMN sort_artist TEXT NOT NULL DEFAULT '';");
+        ok = ok && db->prepareAndExecuteQuery("ALTER TABLE Songs ADD COLUMN sort_album TEXT NOT NULL DEFAULT '';");
+        if (!ok) {
+            return "Unable to add sort key columns to Songs";
+        }
+
+        // Fill in the keys for existing rows
+        ok = db->prepareAndExecuteQuery("UPDATE Artists SET sort_name = sortKey(name);");
+        ok = ok && db->prepareAndExecuteQuery("UPDATE Albums SET sort_name = sortKey(name);");
+        ok = ok && db->prepareAndExecuteQuery("UPDATE Songs SET sort_title = sortKey(title), sort_artist = (SELECT sort_name FROM Artists WHERE Artists.id = Songs.artist_id), sort_album = (SELECT sort_name FROM Albums WHERE Albums.id = Songs.album_id);");
+        if (!ok) {
+            return "Unable to initialize sort keys";
+        }
+
+        // Create triggers to keep the keys up to date
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER insertArtistSortKey AFTER INSERT ON Artists BEGIN UPDATE Artists SET sort_name = sortKey(NEW.name) WHERE id = NEW.id; END;");
+        if (!ok) {
+            return "Unable to create 'insertArtistSortKey' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER updateArtistSortKey AFTER UPDATE OF name ON Artists BEGIN UPDATE Artists SET sort_name = sortKey(NEW.name) WHERE id = NEW.id; UPDATE Songs SET sort_artist = sortKey(NEW.name) WHERE artist_id = NEW.id; END;");
+        if (!ok) {
+            return "Unable to create 'updateArtistSortKey' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER insertAlbumSortKey AFTER INSERT ON Albums BEGIN UPDATE Albums SET sort_name = sortKey(NEW.name) WHERE id = NEW.id; END;");
+        if (!ok) {
+            return "Unable to create 'insertAlbumSortKey' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER updateAlbumSortKey AFTER UPDATE OF name ON Albums BEGIN UPDATE Albums SET sort_name = sortKey(NEW.name) WHERE id = NEW.id; UPDATE Songs SET sort_album = sortKey(NEW.name) WHERE album_id = NEW.id; END;");
+        if (!ok) {
+            return "Unable to create 'updateAlbumSortKey' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER insertSongSortKeys AFTER INSERT ON Songs BEGIN UPDATE Songs SET sort_title = sortKey(NEW.title), sort_artist = (SELECT sort_name FROM Artists WHERE Artists.id = NEW.artist_id), sort_album = (SELECT sort_name FROM Albums WHERE Albums.id = NEW.album_id) WHERE id = NEW.id; END;");
+        if (!ok) {
+            return "Unable to create 'insertSongSortKeys' trigger";
+        }
+        ok = db->prepareAndExecuteQuery("CREATE TRIGGER updateSongSortKeys AFTER UPDATE OF title, artist_id, album_id ON Songs BEGIN UPDATE Songs SET sort_title = sortKey(NEW.title), sort_artist = (SELECT sort_name FROM Artists WHERE Artists.id = NEW.artist_id), sort_album = (SELECT sort_name FROM Albums WHERE Albums.id = NEW.album_id) WHERE id = NEW.id; END;");
+        if (!ok) {
+            return "Unable to create 'updateSongSortKeys' trigger";
+        }
+
+        // Create an index for each song order (the row ID is implicitly last, which breaks ties when paging)
+        const char * songIndexes[] = {
+            "CREATE INDEX SongsByTitleAsc ON Songs (sort_title ASC, sort_artist ASC, sort_album ASC);",
+            "CREATE INDEX SongsByTitleDsc ON Songs (sort_title DESC, sort_artist ASC, sort_album ASC);",
+            "CREATE INDEX SongsByArtistAsc ON Songs (sort_artist ASC, sort_title ASC);",
+            "CREATE INDEX SongsByArtistDsc ON Songs (sort_artist DESC, sort_title ASC);",
+            "CREATE INDEX SongsByAlbumAsc ON Songs (sort_album ASC, sort_title ASC);",
+            "CREATE INDEX SongsByAlbumDsc ON Songs (sort_album DESC, sort_title ASC);",
+            "CREATE INDEX SongsByLengthAsc ON Songs (duration ASC, sort_title ASC, sort_artist ASC, sort_album ASC);",
+            "CREATE INDEX SongsByLengthDsc ON Songs (duration DESC, sort_title ASC, sort_artist ASC, sort_album ASC);"
+        };
+        for (const char * query : songIndexes) {
+            ok = db->prepareAndExecuteQuery(query);
+            if (!ok) {
+                return "Unable to create index: " + std::string(query);
+            }
+        }
+
+        // Create indexes for the joins and per artist/album listings (these also speed up the delete triggers)
+        ok = db->prepareAndExecuteQuery("CREATE INDEX SongsForArtist ON Songs (artist_id, sort_title);");
+        ok = ok && db->prepareAndExecuteQuery("CREATE INDEX SongsForAlbum ON Songs (album_id, artist_id);");
+        ok = ok && db->prepareAndExecuteQuery("CREATE INDEX PlaylistSongsForPlaylist ON PlaylistSongs (playlist_id, song_id);");
+        if (!ok) {
+            return "Unable to create indexes for joins";
+        }
+
+        // Create indexes for artist/album orders
+        ok = db->prepareAndExecuteQuery("CREATE INDEX ArtistsByName ON Artists (sort_name);");
+        ok = ok && db->prepareAndExecuteQuery("CREATE INDEX AlbumsByName ON Albums (sort_name);");
+        if (!ok) {
+            return "Unable to create indexes for artists/albums";
+        }
+
+        // Bump up version number
+        ok = db->prepareAndExecuteQuery("UPDATE Variables SET value = 9 WHERE name = 'version';");
+        if (!ok) {
+            return "Unable to set version to 9";
+        }
+
+        return "";
+    };
+}
\ No newline at end of file
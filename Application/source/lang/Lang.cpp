@@ -1,14 +1,37 @@
 #include <fstream>
 #include "lang/Lang.hpp"
 #include "lang/Language.hpp"
+#include "Log.hpp"
+#include <mutex>
 #include "nlohmann/json.hpp"
-#include <sstream>
+#include <unordered_map>
 #include "utils/FS.hpp"
 #include "utils/NX.hpp"
 
 namespace Utils::Lang {
-    // JSON object which reads and caches strings from file
-    static nlohmann::json j = nullptr;
+    // Strings read from file, stored under the hash of their full key (e.g. 'Common.Cancel')
+    static std::unordered_map<uint64_t, std::string> strings;
+    // Keys without a string, which are returned in place of one (locked as any thread may add to it)
+    static std::unordered_map<uint64_t, std::string> missing;
+    static std::mutex missingMutex;
+
+    // Add every string within the given object to the table, with keys starting with the prefix
+    static void addStrings(const nlohmann::json & obj, std::string & prefix) {
+        for (nlohmann::json::const_iterator it = obj.begin(); it != obj.end(); it++) {
+            size_t length = prefix.length();
+            prefix += it.key();
+            if (it->is_object()) {
+                prefix += '.';
+                addStrings(*it, prefix);
+
+            } else if (it->is_string()) {
+                if (!strings.try_emplace(hashKey(prefix), it->get<std::string>()).second) {
+                    Log::writeWarning("[LANG] Hash of '", prefix, "' matches another key, it will be ignored");
+                }
+            }
+            prefix.resize(length);
+        }
+    }
 
     // Read in a file, returning whether successful
     bool readFromFile(const std::string & path) {
@@ -17,9 +40,14 @@ namespace Utils::Lang {
             return false;
         }
 
-        // Read in
+        // Read in and flatten into the table, so lookups don't need to walk the JSON
         std::ifstream in(path);
-        j = nlohmann::json::parse(in);
+        nlohmann::json j = nlohmann::json::parse(in);
+        strings.clear();
+        if (j.is_object()) {
+            std::string prefix;
+            addStrings(j, prefix);
+        }
         return true;
     }
 
@@ -57,20 +85,14 @@ namespace Utils::Lang {
         return readFromFile(path);
     }
 
-    std::string string(const std::string & key) {
-        // First 'navigate' to nested object
-        nlohmann::json t = j;
-        std::istringstream ss(key);
-        std::string k;
-        while (std::getline(ss, k, '.') && t != nullptr) {
-            t = t[k];
+    const std::string & string(const uint64_t hash, const std::string_view key) {
+        std::unordered_map<uint64_t, std::string>::const_iterator it = strings.find(hash);
+        if (it != strings.end()) {
+            return it->second;
         }
 
         // If the string is not present return key
-        if (t == nullptr || !t.is_string()) {
-            return key;
-        }
-
-        return t.get<std::string>();
+        std::lock_guard<std::mutex> mtx(missingMutex);
+        return missing.try_emplace(hash, key).first->second;
     }
 };
\ No newline at end of file
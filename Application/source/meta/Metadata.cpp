@@ -1,6 +1,7 @@
 #include "Log.hpp"
 #include "meta/AudioDB.hpp"
 #include "meta/Metadata.hpp"
+#include "meta/TagReader.hpp"
 #include "utils/FS.hpp"
 
 // Taglib headers
@@ -396,7 +397,7 @@ namespace Metadata {
             }
 
         } else {
-            Log::writeInfo("[META] [FLAC] No XiphComment found in: " + path);
+            Log::writeInfo("[META] [FLAC] No XiphComment found in: ", path);
         }
 
         // Check ID3v2 next
@@ -407,7 +408,7 @@ namespace Metadata {
             }
 
         } else {
-            Log::writeInfo("[META] [FLAC] No ID3v2 tags found in: " + path);
+            Log::writeInfo("[META] [FLAC] No ID3v2 tags found in: ", path);
         }
 
         // Finally check ID3v1
@@ -418,7 +419,7 @@ namespace Metadata {
             }
 
         } else {
-            Log::writeInfo("[META] [FLAC] No ID3v1 tags found in: " + path);
+            Log::writeInfo("[META] [FLAC] No ID3v1 tags found in: ", path);
         }
 
         // Fill in missing values with default values (does nothing if all filled)
@@ -458,7 +459,7 @@ namespace Metadata {
             }
 
         } else {
-            Log::writeInfo("[META] [MP3] No ID3v2 tags found in: " + path);
+            Log::writeInfo("[META] [MP3] No ID3v2 tags found in: ", path);
         }
 
         // Finally check ID3v1
@@ -469,7 +470,7 @@ namespace Metadata {
             }
 
         } else {
-            Log::writeInfo("[META] [MP3] No ID3v1 tags found in: " + path);
+            Log::writeInfo("[META] [MP3] No ID3v1 tags found in: ", path);
         }
 
         // Fill in missing values with default values (does nothing if all filled)
@@ -509,7 +510,7 @@ namespace Metadata {
             }
 
         } else {
-            Log::writeInfo("[META] [WAV] No INFO tag found in: " + path);
+            Log::writeInfo("[META] [WAV] No INFO tag found in: ", path);
         }
 
         // Then check ID3v2
@@ -520,7 +521,7 @@ namespace Metadata {
             }
 
         } else {
-            Log::writeInfo("[META] [WAV] No ID3v2 tags found in: " + path);
+            Log::writeInfo("[META] [WAV] No ID3v2 tags found in: ", path);
         }
 
         // Fill in missing values with default values (does nothing if all filled)
@@ -530,7 +531,25 @@ namespace Metadata {
     }
 
     Song readFromFile(const std::string & path, const AudioFormat format) {
-        // Call relevant function
+        // Try reading only the tags first (each thread keeps it's own reader to reuse it's buffer)
+        static thread_local TagReader reader;
+        Song m = getBlankMetadata();
+        m.format = format;
+        m.path = path;
+        TagReader::Result result = reader.read(path, format, m);
+        if (result == TagReader::Result::Ok) {
+            m.ID = -1;
+            fillMissingValues(path, m);
+            return m;
+
+        } else if (result == TagReader::Result::Error) {
+            Log::writeError("[META] Unable to open file: " + path);
+            m.ID = -3;
+            return m;
+        }
+
+        // Otherwise let TagLib handle the malformed file
+        Log::writeInfo("[META] Using TagLib to read: ", path);
         switch (format) {
             case AudioFormat::FLAC:
                 return readFromFLAC(path);
@@ -0,0 +1,763 @@
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include "meta/TagReader.hpp"
+#include "utils/MP3.hpp"
+
+// Size of each read from a file
+#define READ_SIZE 65536
+// Largest single block that will be read (anything larger is skipped)
+#define MAX_FETCH 1048576
+
+namespace Metadata {
+    // Helpers to read integers of different widths/endianness
+    static inline uint32_t readBE32(const unsigned char * p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+    }
+
+    static inline uint32_t readBE24(const unsigned char * p) {
+        return (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[2];
+    }
+
+    static inline uint32_t readLE32(const unsigned char * p) {
+        return (static_cast<uint32_t>(p[3]) << 24) | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[1]) << 8) | p[0];
+    }
+
+    static inline uint32_t readSyncsafe(const unsigned char * p) {
+        return (static_cast<uint32_t>(p[0] & 0x7F) << 21) | (static_cast<uint32_t>(p[1] & 0x7F) << 14) | (static_cast<uint32_t>(p[2] & 0x7F) << 7) | (p[3] & 0x7F);
+    }
+
+    // Append a unicode code point to the string as UTF-8
+    static void appendUTF8(std::string & str, uint32_t c) {
+        if (c < 0x80) {
+            str += static_cast<char>(c);
+        } else if (c < 0x800) {
+            str += static_cast<char>(0xC0 | (c >> 6));
+            str += static_cast<char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            str += static_cast<char>(0xE0 | (c >> 12));
+            str += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            str += static_cast<char>(0x80 | (c & 0x3F));
+        } else {
+            str += static_cast<char>(0xF0 | (c >> 18));
+            str += static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+            str += static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+            str += static_cast<char>(0x80 | (c & 0x3F));
+        }
+    }
+
+    // Convert an ISO-8859-1 string to UTF-8
+    static void appendLatin1(std::string & str, const std::string_view & in) {
+        for (const char ch : in) {
+            appendUTF8(str, static_cast<unsigned char>(ch));
+        }
+    }
+
+    // Convert a UTF-16 string (without BOM) to UTF-8
+    static void appendUTF16(std::string & str, const unsigned char * p, const size_t len, const bool bigEndian) {
+        for (size_t i = 0; i + 1 < len; i += 2) {
+            uint32_t c = (bigEndian ? (p[i] << 8) | p[i+1] : (p[i+1] << 8) | p[i]);
+
+            // Join surrogate pairs
+            if (c >= 0xD800 && c < 0xDC00 && i + 3 < len) {
+                uint32_t low = (bigEndian ? (p[i+2] << 8) | p[i+3] : (p[i+3] << 8) | p[i+2]);
+                if (low >= 0xDC00 && low < 0xE000) {
+                    c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                    i += 2;
+                }
+            }
+            appendUTF8(str, c);
+        }
+    }
+
+    // Returns whether the string is valid UTF-8
+    static bool isUTF8(const std::string_view & str) {
+        size_t i = 0;
+        while (i < str.length()) {
+            unsigned char c = str[i];
+            size_t extra = (c < 0x80 ? 0 : (c >> 5) == 0x6 ? 1 : (c >> 4) == 0xE ? 2 : (c >> 3) == 0x1E ? 3 : 4);
+            if (extra > 3 || i + extra >= str.length()) {
+                return false;
+            }
+            for (size_t j = 1; j <= extra; j++) {
+                if ((static_cast<unsigned char>(str[i + j]) & 0xC0) != 0x80) {
+                    return false;
+                }
+            }
+            i += extra + 1;
+        }
+        return true;
+    }
+
+    // Returns the string up to the first null
+    static std::string_view cutAtNull(const std::string_view & str) {
+        size_t pos = str.find('\0');
+        return (pos == std::string_view::npos ? str : str.substr(0, pos));
+    }
+
+    // Remove leading and trailing whitespace
+    static std::string_view trim(const std::string_view & str) {
+        size_t start = str.find_first_not_of(" \t\r\n");
+        if (start == std::string_view::npos) {
+            return std::string_view();
+        }
+        return str.substr(start, str.find_last_not_of(" \t\r\n") - start + 1);
+    }
+
+    // Convert a string with an optional encoding to UTF-8 (assumes ISO-8859-1 if it's not valid UTF-8)
+    static std::string toUTF8(const std::string_view & str) {
+        if (isUTF8(str)) {
+            return std::string(str);
+        }
+
+        std::string out;
+        appendLatin1(out, str);
+        return out;
+    }
+
+    // Parse the integer at the start of the string (i.e. '1/2' returns 1), returns 0 if there isn't one
+    static int toInt(const std::string_view & str) {
+        std::string_view tmp = trim(str);
+        size_t i = 0;
+        bool negative = false;
+        if (i < tmp.length() && (tmp[i] == '-' || tmp[i] == '+')) {
+            negative = (tmp[i] == '-');
+            i++;
+        }
+
+        int val = 0;
+        while (i < tmp.length() && tmp[i] >= '0' && tmp[i] <= '9') {
+            val = (val * 10) + (tmp[i] - '0');
+            i++;
+        }
+        return (negative ? -val : val);
+    }
+
+    // Case insensitive comparison of ASCII strings
+    static bool equalsIgnoreCase(const std::string_view & a, const std::string_view & b) {
+        if (a.length() != b.length()) {
+            return false;
+        }
+
+        for (size_t i = 0; i < a.length(); i++) {
+            if (std::toupper(static_cast<unsigned char>(a[i])) != std::toupper(static_cast<unsigned char>(b[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Copy any values which are missing from 'to' across from 'from'
+    static void fillFrom(const Song & from, Song & to) {
+        if (to.title.empty()) {
+            to.title = from.title;
+        }
+        if (to.artist.empty()) {
+            to.artist = from.artist;
+        }
+        if (to.album.empty()) {
+            to.album = from.album;
+        }
+        if (to.trackNumber < 0) {
+            to.trackNumber = from.trackNumber;
+        }
+        if (to.discNumber < 0) {
+            to.discNumber = from.discNumber;
+        }
+    }
+
+    // Decode the text stored within an ID3v2 text frame, joining multiple values with a space
+    static std::string decodeID3v2Text(const unsigned char * data, const size_t size) {
+        std::string str;
+        if (size < 2) {
+            return str;
+        }
+
+        // First byte indicates encoding, strings are separated by nulls
+        const unsigned char encoding = data[0];
+        const unsigned char * p = data + 1;
+        const size_t len = size - 1;
+        if (encoding == 1 || encoding == 2) {
+            size_t start = 0;
+            for (size_t i = 0; i <= len; i += 2) {
+                if (i + 1 < len && (p[i] != 0 || p[i+1] != 0)) {
+                    continue;
+                }
+
+                // Each string has it's own BOM if encoding is 1
+                const unsigned char * s = p + start;
+                size_t sLen = std::min(i, len) - start;
+                bool bigEndian = (encoding == 2);
+                if (encoding == 1 && sLen >= 2 && ((s[0] == 0xFF && s[1] == 0xFE) || (s[0] == 0xFE && s[1] == 0xFF))) {
+                    bigEndian = (s[0] == 0xFE);
+                    s += 2;
+                    sLen -= 2;
+                }
+                if (sLen > 0) {
+                    if (!str.empty()) {
+                        str += ' ';
+                    }
+                    appendUTF16(str, s, sLen, bigEndian);
+                }
+                start = i + 2;
+            }
+
+        } else {
+            std::string_view view(reinterpret_cast<const char *>(p), len);
+            while (!view.empty()) {
+                std::string_view value = cutAtNull(view);
+                if (!value.empty()) {
+                    if (!str.empty()) {
+                        str += ' ';
+                    }
+                    if (encoding == 3) {
+                        str += value;
+                    } else {
+                        appendLatin1(str, value);
+                    }
+                }
+                view.remove_prefix(std::min(value.length() + 1, view.length()));
+            }
+        }
+
+        return str;
+    }
+
+    TagReader::TagReader() {
+        this->file = nullptr;
+        this->fileSize = 0;
+        this->buffer.resize(READ_SIZE);
+        this->bufferOffset = 0;
+        this->bufferSize = 0;
+    }
+
+    const unsigned char * TagReader::fetch(const size_t offset, const size_t len) {
+        if (len > MAX_FETCH || offset > this->fileSize || len > this->fileSize - offset) {
+            return nullptr;
+        }
+
+        // Use what's buffered if possible
+        if (offset >= this->bufferOffset && offset + len <= this->bufferOffset + this->bufferSize) {
+            return this->buffer.data() + (offset - this->bufferOffset);
+        }
+
+        // Otherwise read a large block starting at the offset
+        size_t size = std::min(std::max(len, static_cast<size_t>(READ_SIZE)), this->fileSize - offset);
+        if (this->buffer.size() < size) {
+            this->buffer.resize(size);
+        }
+        this->bufferSize = 0;
+        if (std::fseek(this->file, offset, SEEK_SET) != 0 || std::fread(this->buffer.data(), 1, size, this->file) != size) {
+            return nullptr;
+        }
+        this->bufferOffset = offset;
+        this->bufferSize = size;
+        return this->buffer.data();
+    }
+
+    bool TagReader::readID3v1(Song & m) {
+        if (this->fileSize < 128) {
+            return false;
+        }
+
+        const unsigned char * data = this->fetch(this->fileSize - 128, 128);
+        if (data == nullptr || std::memcmp(data, "TAG", 3) != 0) {
+            return false;
+        }
+
+        // Fixed width ISO-8859-1 fields
+        const char * str = reinterpret_cast<const char *>(data);
+        std::string_view title = trim(cutAtNull(std::string_view(str + 3, 30)));
+        if (m.title.empty() && !title.empty()) {
+            appendLatin1(m.title, title);
+        }
+        std::string_view artist = trim(cutAtNull(std::string_view(str + 33, 30)));
+        if (m.artist.empty() && !artist.empty()) {
+            appendLatin1(m.artist, artist);
+        }
+        std::string_view album = trim(cutAtNull(std::string_view(str + 63, 30)));
+        if (m.album.empty() && !album.empty()) {
+            appendLatin1(m.album, album);
+        }
+
+        // ID3v1.1 stores the track number at the end of the comment
+        if (m.trackNumber < 0 && data[125] == 0 && data[126] != 0) {
+            m.trackNumber = data[126];
+        }
+        return true;
+    }
+
+    TagReader::Result TagReader::readID3v2(const size_t offset, Song & m, size_t & tagSize) {
+        tagSize = 0;
+        const unsigned char * header = this->fetch(offset, 10);
+        if (header == nullptr || std::memcmp(header, "ID3", 3) != 0) {
+            return Result::Ok;
+        }
+
+        // Check the header is sensible
+        const int major = header[3];
+        const unsigned char flags = header[5];
+        if (major < 2 || major > 4 || (header[6] & 0x80) || (header[7] & 0x80) || (header[8] & 0x80) || (header[9] & 0x80)) {
+            return Result::Malformed;
+        }
+        const size_t size = readSyncsafe(header + 6);
+        tagSize = 10 + size + (major == 4 && (flags & 0x10) ? 10 : 0);
+        if (offset + 10 + size > this->fileSize || (major == 2 && (flags & 0x40))) {
+            return Result::Malformed;
+        }
+
+        size_t pos = offset + 10;
+        size_t end = pos + size;
+
+        // Unsynchronisation applies to the whole tag before v2.4, so remove it from the buffered copy first
+        if (major < 4 && (flags & 0x80)) {
+            const unsigned char * data = this->fetch(pos, size);
+            if (data == nullptr) {
+                return Result::Malformed;
+            }
+
+            unsigned char * out = this->buffer.data() + (pos - this->bufferOffset);
+            size_t len = 0;
+            for (size_t i = 0; i < size; i++) {
+                out[len++] = data[i];
+                if (data[i] == 0xFF && i + 1 < size && data[i+1] == 0) {
+                    i++;
+                }
+            }
+            end = pos + len;
+            this->bufferSize = end - this->bufferOffset;
+        }
+
+        // Skip the extended header
+        if (major > 2 && (flags & 0x40)) {
+            const unsigned char * ext = this->fetch(pos, 4);
+            if (ext == nullptr) {
+                return Result::Malformed;
+            }
+            pos += (major == 3 ? 4 + readBE32(ext) : readSyncsafe(ext));
+        }
+
+        // Iterate over each frame, only fetching the ones we want
+        const size_t headerLen = (major == 2 ? 6 : 10);
+        while (pos + headerLen <= end) {
+            const unsigned char * frame = this->fetch(pos, headerLen);
+            if (frame == nullptr || frame[0] == 0) {
+                break;
+            }
+
+            std::string_view id(reinterpret_cast<const char *>(frame), major == 2 ? 3 : 4);
+            size_t frameSize;
+            unsigned char formatFlags = 0;
+            if (major == 2) {
+                frameSize = readBE24(frame + 3);
+            } else if (major == 3) {
+                frameSize = readBE32(frame + 4);
+                formatFlags = frame[9];
+            } else {
+                // Some taggers incorrectly write non-syncsafe sizes
+                bool syncsafe = !((frame[4] | frame[5] | frame[6] | frame[7]) & 0x80);
+                frameSize = (syncsafe ? readSyncsafe(frame + 4) : readBE32(frame + 4));
+                formatFlags = frame[9];
+            }
+            if (frameSize > end - pos - headerLen) {
+                break;
+            }
+
+            // Only text frames that we store are read
+            const bool wanted = (id == "TIT2" || id == "TPE1" || id == "TALB" || id == "TRCK" || id == "TPOS" ||
+                                 id == "TT2" || id == "TP1" || id == "TAL" || id == "TRK" || id == "TPA");
+            const bool compressed = (major == 3 ? (formatFlags & 0xC0) : (formatFlags & 0x0C));
+            if (wanted && !compressed && frameSize > 0) {
+                std::string frameID(id);
+                const unsigned char * data = this->fetch(pos + headerLen, frameSize);
+                if (data != nullptr) {
+                    size_t len = frameSize;
+
+                    // Skip grouping identifier/data length indicator
+                    size_t skip = 0;
+                    if (major == 3 && (formatFlags & 0x20)) {
+                        skip = 1;
+                    } else if (major == 4 && (formatFlags & 0x01)) {
+                        skip = 4;
+                    }
+                    data += std::min(skip, len);
+                    len -= std::min(skip, len);
+
+                    // Frames in v2.4 can be unsynchronised individually
+                    if (major == 4 && ((formatFlags & 0x02) || (flags & 0x80))) {
+                        std::vector<unsigned char> tmp;
+                        tmp.reserve(len);
+                        for (size_t i = 0; i < len; i++) {
+                            tmp.push_back(data[i]);
+                            if (data[i] == 0xFF && i + 1 < len && data[i+1] == 0) {
+                                i++;
+                            }
+                        }
+                        this->parseID3v2Frame(frameID, tmp.data(), tmp.size(), m);
+
+                    } else {
+                        this->parseID3v2Frame(frameID, data, len, m);
+                    }
+                }
+            }
+
+            pos += headerLen + frameSize;
+        }
+
+        // Don't let the modified buffer be used again
+        if (major < 4 && (flags & 0x80)) {
+            this->bufferSize = 0;
+        }
+        return Result::Ok;
+    }
+
+    void TagReader::parseID3v2Frame(const std::string_view & id, const unsigned char * data, const size_t size, Song & m) {
+        if (id == "TIT2" || id == "TT2") {
+            if (m.title.empty()) {
+                m.title = decodeID3v2Text(data, size);
+            }
+
+        } else if (id == "TPE1" || id == "TP1") {
+            if (m.artist.empty()) {
+                m.artist = decodeID3v2Text(data, size);
+            }
+
+        } else if (id == "TALB" || id == "TAL") {
+            if (m.album.empty()) {
+                m.album = decodeID3v2Text(data, size);
+            }
+
+        } else if (id == "TRCK" || id == "TRK") {
+            if (m.trackNumber < 0) {
+                int track = toInt(decodeID3v2Text(data, size));
+                if (track != 0) {
+                    m.trackNumber = track;
+                }
+            }
+
+        } else if (id == "TPOS" || id == "TPA") {
+            // Note: This correctly handles 1/2, etc...
+            if (m.discNumber < 0) {
+                std::string disc = decodeID3v2Text(data, size);
+                if (!disc.empty()) {
+                    m.discNumber = toInt(disc);
+                }
+            }
+        }
+    }
+
+    void TagReader::parseXiphComment(const unsigned char * data, const size_t size, Song & m) {
+        // Skip vendor string
+        if (size < 8) {
+            return;
+        }
+        size_t pos = 4 + readLE32(data);
+        if (pos > size - 4) {
+            return;
+        }
+        uint32_t count = readLE32(data + pos);
+        pos += 4;
+
+        // Look at each field (values are already UTF-8), joining repeated fields like TagLib
+        std::string title, artist, album;
+        std::string_view track, disc;
+        bool trackNumber = false;
+        for (uint32_t i = 0; i < count && pos + 4 <= size; i++) {
+            uint32_t len = readLE32(data + pos);
+            pos += 4;
+            if (len > size - pos) {
+                break;
+            }
+
+            std::string_view field(reinterpret_cast<const char *>(data + pos), len);
+            pos += len;
+            size_t split = field.find('=');
+            if (split == std::string_view::npos) {
+                continue;
+            }
+            std::string_view name = field.substr(0, split);
+            std::string_view value = field.substr(split + 1);
+
+            std::string * str = nullptr;
+            if (equalsIgnoreCase(name, "TITLE")) {
+                str = &title;
+            } else if (equalsIgnoreCase(name, "ARTIST")) {
+                str = &artist;
+            } else if (equalsIgnoreCase(name, "ALBUM")) {
+                str = &album;
+            } else if (equalsIgnoreCase(name, "TRACKNUMBER") && !trackNumber) {
+                track = value;
+                trackNumber = true;
+            } else if (equalsIgnoreCase(name, "TRACKNUM") && track.empty()) {
+                track = value;
+            } else if (equalsIgnoreCase(name, "DISCNUMBER") && disc.empty()) {
+                disc = value;
+            }
+
+            if (str != nullptr) {
+                if (!str->empty()) {
+                    *str += ' ';
+                }
+                *str += value;
+            }
+        }
+
+        if (m.title.empty()) {
+            m.title = title;
+        }
+        if (m.artist.empty()) {
+            m.artist = artist;
+        }
+        if (m.album.empty()) {
+            m.album = album;
+        }
+        if (m.trackNumber < 0 && toInt(track) != 0) {
+            m.trackNumber = toInt(track);
+        }
+        if (m.discNumber < 0 && !disc.empty()) {
+            m.discNumber = toInt(disc);
+        }
+    }
+
+    void TagReader::parseRIFFInfo(const unsigned char * data, const size_t size, Song & m) {
+        // Each sub-chunk is a four character ID, size and null-terminated string
+        size_t pos = 0;
+        while (pos + 8 <= size) {
+            std::string_view id(reinterpret_cast<const char *>(data + pos), 4);
+            uint32_t len = readLE32(data + pos + 4);
+            pos += 8;
+            if (len > size - pos) {
+                break;
+            }
+
+            std::string_view value = cutAtNull(std::string_view(reinterpret_cast<const char *>(data + pos), len));
+            if (!value.empty()) {
+                if (id == "INAM" && m.title.empty()) {
+                    m.title = toUTF8(value);
+                } else if (id == "IART" && m.artist.empty()) {
+                    m.artist = toUTF8(value);
+                } else if (id == "IPRD" && m.album.empty()) {
+                    m.album = toUTF8(value);
+                } else if ((id == "IPRT" || id == "ITRK") && m.trackNumber < 0 && toInt(value) != 0) {
+                    m.trackNumber = toInt(value);
+                }
+            }
+
+            // Chunks are padded to an even length
+            pos += len + (len & 1);
+        }
+
+        // Note that RIFF Info chunks don't appear to store disc number
+    }
+
+    TagReader::Result TagReader::readFLAC(Song & m) {
+        // Some files have an ID3v2 tag before the FLAC stream, however the
+        // Vorbis comment takes priority so it's merged afterwards
+        Song id3 = m;
+        size_t pos;
+        Result result = this->readID3v2(0, id3, pos);
+        if (result != Result::Ok) {
+            return result;
+        }
+
+        const unsigned char * data = this->fetch(pos, 4);
+        if (data == nullptr || std::memcmp(data, "fLaC", 4) != 0) {
+            return Result::Malformed;
+        }
+        pos += 4;
+
+        // Iterate over each metadata block (STREAMINFO must be first)
+        bool first = true;
+        bool last = false;
+        while (!last) {
+            const unsigned char * header = this->fetch(pos, 4);
+            if (header == nullptr) {
+                return Result::Malformed;
+            }
+            last = (header[0] & 0x80);
+            const int type = header[0] & 0x7F;
+            const size_t len = readBE24(header + 1);
+            pos += 4;
+            if ((first && (type != 0 || len < 18)) || len > this->fileSize - pos) {
+                return Result::Malformed;
+            }
+            first = false;
+
+            // STREAMINFO (duration is total samples / sample rate)
+            if (type == 0) {
+                data = this->fetch(pos, 18);
+                if (data == nullptr) {
+                    return Result::Malformed;
+                }
+                uint32_t sampleRate = (data[10] << 12) | (data[11] << 4) | (data[12] >> 4);
+                uint64_t samples = (static_cast<uint64_t>(data[13] & 0x0F) << 32) | readBE32(data + 14);
+                if (sampleRate > 0 && samples > 0) {
+                    m.duration = static_cast<unsigned int>(samples / sampleRate);
+                }
+
+            // VORBIS_COMMENT
+            } else if (type == 4) {
+                data = this->fetch(pos, len);
+                if (data != nullptr) {
+                    this->parseXiphComment(data, len, m);
+                }
+            }
+
+            // Anything else (i.e. pictures) is skipped
+            pos += len;
+        }
+
+        // Finally use the ID3 tags
+        fillFrom(id3, m);
+        this->readID3v1(m);
+        return Result::Ok;
+    }
+
+    TagReader::Result TagReader::readMP3(Song & m) {
+        // Tags are stored at the start and end of the file
+        size_t start;
+        Result result = this->readID3v2(0, m, start);
+        if (result != Result::Ok) {
+            return result;
+        }
+        size_t end = this->fileSize - (this->readID3v1(m) ? 128 : 0);
+        if (start >= end) {
+            return Result::Malformed;
+        }
+
+        // Find the first frame after the tag
+        size_t len = std::min(end - start, static_cast<size_t>(READ_SIZE));
+        const unsigned char * data = this->fetch(start, len);
+        if (data == nullptr) {
+            return Result::Error;
+        }
+        size_t frame;
+        Utils::MP3::FrameHeader header;
+        if (!Utils::MP3::findFirstFrame(data, len, frame, header)) {
+            return Result::Malformed;
+        }
+
+        // Use the Xing/VBRI header if present, otherwise estimate from the bitrate (the exact
+        // length of VBR files without either is found by the sysmodule when played)
+        Utils::MP3::StreamLength length;
+        if (!Utils::MP3::getStreamLength(data + frame, len - frame, end - start - frame, length)) {
+            return Result::Malformed;
+        }
+        m.duration = static_cast<unsigned int>(length.samples / length.sampleRate);
+        return Result::Ok;
+    }
+
+    TagReader::Result TagReader::readWAV(Song & m) {
+        const unsigned char * data = this->fetch(0, 12);
+        if (data == nullptr || std::memcmp(data, "RIFF", 4) != 0 || std::memcmp(data + 8, "WAVE", 4) != 0) {
+            return Result::Malformed;
+        }
+        size_t end = std::min(static_cast<size_t>(readLE32(data + 4)) + 8, this->fileSize);
+
+        // Only read the chunk headers, noting where tags are
+        uint32_t byteRate = 0;
+        size_t dataSize = 0;
+        size_t infoPos = 0, infoLen = 0;
+        size_t id3Pos = 0;
+        size_t pos = 12;
+        while (pos + 8 <= end) {
+            data = this->fetch(pos, 8);
+            if (data == nullptr) {
+                return Result::Malformed;
+            }
+            std::string_view id(reinterpret_cast<const char *>(data), 4);
+            size_t len = readLE32(data + 4);
+
+            if (id == "fmt ") {
+                data = this->fetch(pos + 8, 12);
+                if (data != nullptr) {
+                    byteRate = readLE32(data + 8);
+                }
+
+            } else if (id == "data") {
+                dataSize = std::min(len, this->fileSize - pos - 8);
+
+            } else if (id == "LIST" && len >= 4) {
+                data = this->fetch(pos + 8, 4);
+                if (data != nullptr && std::memcmp(data, "INFO", 4) == 0) {
+                    infoPos = pos + 12;
+                    infoLen = len - 4;
+                }
+
+            } else if (id == "id3 " || id == "ID3 ") {
+                id3Pos = pos + 8;
+            }
+
+            pos += 8 + len + (len & 1);
+        }
+
+        if (byteRate == 0) {
+            return Result::Malformed;
+        }
+        m.duration = static_cast<unsigned int>(dataSize / byteRate);
+
+        // INFO takes priority over ID3v2
+        if (infoPos > 0) {
+            data = this->fetch(infoPos, std::min(infoLen, this->fileSize - infoPos));
+            if (data != nullptr) {
+                this->parseRIFFInfo(data, std::min(infoLen, this->fileSize - infoPos), m);
+            }
+        }
+        if (id3Pos > 0) {
+            size_t size;
+            this->readID3v2(id3Pos, m, size);
+        }
+        return Result::Ok;
+    }
+
+    TagReader::Result TagReader::read(const std::string & path, const AudioFormat format, Song & m) {
+        // Open the file, using our own buffer instead of the stream's
+        this->file = std::fopen(path.c_str(), "rb");
+        if (this->file == nullptr) {
+            return Result::Error;
+        }
+        std::setvbuf(this->file, nullptr, _IONBF, 0);
+        Result result = Result::Error;
+        if (std::fseek(this->file, 0, SEEK_END) == 0) {
+            long size = std::ftell(this->file);
+            this->fileSize = (size < 0 ? 0 : size);
+            this->bufferOffset = 0;
+            this->bufferSize = 0;
+
+            switch (format) {
+                case AudioFormat::FLAC:
+                    result = this->readFLAC(m);
+                    break;
+
+                case AudioFormat::MP3:
+                    result = this->readMP3(m);
+                    break;
+
+                case AudioFormat::WAV:
+                    result = this->readWAV(m);
+                    break;
+
+                default:
+                    result = Result::Malformed;
+                    break;
+            }
+        }
+
+        std::fclose(this->file);
+        this->file = nullptr;
+
+        // Don't hold on to a large buffer
+        if (this->buffer.size() > READ_SIZE) {
+            this->buffer.resize(READ_SIZE);
+            this->buffer.shrink_to_fit();
+        }
+        return result;
+    }
+
+    TagReader::~TagReader() {
+        if (this->file != nullptr) {
+            std::fclose(this->file);
+        }
+    }
+};
\ No newline at end of file
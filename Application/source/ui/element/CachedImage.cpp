@@ -0,0 +1,28 @@
+#include "ui/element/CachedImage.hpp"
+
+namespace CustomElm {
+    CachedImage::CachedImage(int x, int y, int w, int h, const std::string & path) : Aether::Element(x, y, w, h) {
+        this->handle = Utils::TextureCache::get(path, (w > h ? w : h));
+        this->colour = Aether::Colour{255, 255, 255, 255};
+    }
+
+    CachedImage::CachedImage(int x, int y, int w, int h, const Utils::TextureCache::Handle & handle) : Aether::Element(x, y, w, h) {
+        this->handle = handle;
+        this->colour = Aether::Colour{255, 255, 255, 255};
+    }
+
+    void CachedImage::setHandle(const Utils::TextureCache::Handle & handle) {
+        this->handle = handle;
+    }
+
+    void CachedImage::setColour(const Aether::Colour & c) {
+        this->colour = c;
+    }
+
+    void CachedImage::render() {
+        if (this->handle->texture != nullptr) {
+            SDLHelper::drawTexture(this->handle->texture, this->colour, this->x(), this->y(), this->w(), this->h());
+        }
+        Element::render();
+    }
+};
\ No newline at end of file
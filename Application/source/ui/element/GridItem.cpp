@@ -1,3 +1,5 @@
+#include <algorithm>
+#include "Paths.hpp"
 #include "ui/element/GridItem.hpp"
 
 // Font sizes
@@ -14,9 +16,14 @@
 
 namespace CustomElm {
     GridItem::GridItem(std::string path) : Element(0, 0, WIDTH, HEIGHT) {
-        this->image = new Aether::Image(this->x(), this->y(), path, 1, 1, Aether::RenderType::Deferred);
+        this->path = path;
+        this->placeholder = Utils::TextureCache::get(Path::App::DefaultArtFile, IMAGE_SIZE);
+        this->ticket = nullptr;
+        this->image = new CustomElm::CachedImage(this->x(), this->y(), IMAGE_SIZE, IMAGE_SIZE, this->placeholder);
         this->addElement(this->image);
         this->image->setHidden(true);
+        this->lastX = this->x();
+        this->lastY = this->y();
         this->main = new Aether::Text(this->x(), this->y(), "", SUB_FONT_SIZE, Aether::FontStyle::Regular, Aether::RenderType::Deferred);
         this->main->setHidden(true);
         this->main->setScrollSpeed(35);
@@ -84,7 +91,7 @@ namespace CustomElm {
             case Waiting:
                 // Waiting to render - check position and start if within threshold
                 if (this->x() > -TEX_THRESHOLD && this->x() + this->w() < 1280 + TEX_THRESHOLD && this->y() + this->h() > -TEX_THRESHOLD && this->y() < 720 + TEX_THRESHOLD) {
-                    this->image->startRendering();
+                    this->requestImage();
                     this->main->startRendering();
                     this->sub->startRendering();
                     this->dots->startRendering();
@@ -94,7 +101,7 @@ namespace CustomElm {
 
             case InProgress:
                 // Check if all are ready and if so move show and change to done
-                if (this->image->textureReady() && this->main->textureReady() && this->sub->textureReady() && this->dots->textureReady()) {
+                if (this->main->textureReady() && this->sub->textureReady() && this->dots->textureReady()) {
                     this->positionItems();
                     this->image->setHidden(false);
                     this->main->setHidden(false);
@@ -106,24 +113,28 @@ namespace CustomElm {
             case Done:
                 // Check if move outside of threshold and if so remove texture to save memory
                 if (this->x() < -TEX_THRESHOLD || this->x() + this->w() > 1280 + TEX_THRESHOLD || this->y() + this->h() < -TEX_THRESHOLD || this->y() > 720 + TEX_THRESHOLD) {
-                    this->image->destroyTexture();
-                    this->main->destroyTexture();
-                    this->sub->destroyTexture();
-                    this->dots->destroyTexture();
-                    this->image->setHidden(true);
-                    this->main->setHidden(true);
-                    this->sub->setHidden(true);
-                    this->dots->setHidden(true);
-                    this->isRendering = Waiting;
+                    this->destroyTextures();
                 }
                 break;
         }
+
+        // Swap in the image once it has been decoded
+        if (this->ticket != nullptr) {
+            this->checkImage();
+        }
+        this->lastX = this->x();
+        this->lastY = this->y();
     }
 
     void GridItem::setMoreCallback(std::function<void()> f) {
         this->moreCallback = f;
     }
 
+    void GridItem::setImagePath(const std::string & path) {
+        this->releaseImage();
+        this->path = path;
+    }
+
     void GridItem::setMainString(std::string s) {
         this->main->setString(s);
     }
@@ -132,6 +143,10 @@ namespace CustomElm {
         this->sub->setString(s);
     }
 
+    void GridItem::refresh() {
+        this->destroyTextures();
+    }
+
     void GridItem::setDotsColour(Aether::Colour c) {
         this->dots->setColour(c);
     }
@@ -144,9 +159,68 @@ namespace CustomElm {
         this->sub->setColour(c);
     }
 
+    int GridItem::imagePriority() {
+        // Distance outside of the screen in each direction (negative if on screen)
+        int distX = std::max(-(this->x() + this->w()), this->x() - 1280);
+        int distY = std::max(-(this->y() + this->h()), this->y() - 720);
+        int dist = std::max(0, std::max(distX, distY));
+
+        // Items scrolling towards the screen are needed sooner than those moving away
+        bool approaching = (this->x() > 1280 && this->x() < this->lastX) || (this->x() + this->w() < 0 && this->x() > this->lastX) ||
+                           (this->y() > 720 && this->y() < this->lastY) || (this->y() + this->h() < 0 && this->y() > this->lastY);
+        return (approaching ? dist/2 : dist);
+    }
+
+    void GridItem::requestImage() {
+        if (this->path == Path::App::DefaultArtFile) {
+            return;
+        }
+
+        // Use the cached texture if there is one, otherwise decode in the background
+        Utils::TextureCache::Handle handle = Utils::TextureCache::find(this->path, IMAGE_SIZE);
+        if (handle != nullptr) {
+            this->image->setHandle(handle);
+        } else {
+            this->ticket = Utils::ImageLoader::request(this->path, IMAGE_SIZE, this->imagePriority());
+        }
+    }
+
+    void GridItem::checkImage() {
+        if (this->ticket->status != Utils::ImageLoader::Status::Done) {
+            this->ticket->priority = this->imagePriority();
+            return;
+        }
+
+        // Keep showing the placeholder if the image couldn't be decoded
+        SDL_Surface * surface = Utils::ImageLoader::take(this->ticket);
+        if (surface != nullptr) {
+            this->image->setHandle(Utils::TextureCache::insert(this->path, IMAGE_SIZE, surface));
+        }
+        this->ticket = nullptr;
+    }
+
+    void GridItem::releaseImage() {
+        if (this->ticket != nullptr) {
+            Utils::ImageLoader::cancel(this->ticket);
+            this->ticket = nullptr;
+        }
+        this->image->setHandle(this->placeholder);
+    }
+
+    void GridItem::destroyTextures() {
+        this->releaseImage();
+        this->main->destroyTexture();
+        this->sub->destroyTexture();
+        this->dots->destroyTexture();
+        this->image->setHidden(true);
+        this->main->setHidden(true);
+        this->sub->setHidden(true);
+        this->dots->setHidden(true);
+        this->isRendering = Waiting;
+    }
+
     void GridItem::positionItems() {
         this->image->setXY(this->x() + (this->w() - IMAGE_SIZE)/2, this->y() + 5);
-        this->image->setWH(IMAGE_SIZE, IMAGE_SIZE);
 
         // Make text scrollable if it's too long
         this->main->setY(this->image->y() + this->image->h() + 5);
@@ -166,4 +240,10 @@ namespace CustomElm {
 
         this->dots->setXY(this->x() + this->w() - 20, this->sub->y() - 2 - (this->dots->h())/2);
     }
+
+    GridItem::~GridItem() {
+        if (this->ticket != nullptr) {
+            Utils::ImageLoader::cancel(this->ticket);
+        }
+    }
 }
\ No newline at end of file
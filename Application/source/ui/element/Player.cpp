@@ -1,4 +1,5 @@
 #include "Paths.hpp"
+#include "ui/element/CachedImage.hpp"
 #include "ui/element/Player.hpp"
 #include "utils/Utils.hpp"
 
@@ -7,6 +8,9 @@
 // Scroll if song name is longer than this
 #define TITLE_MAX_WIDTH 280
 
+// Size of album cover
+#define ALBUM_COVER_SIZE 110
+
 // Diameter of play/pause button
 #define BTN_PLAYPAUSE_SIZE 60
 // Diameter of 'main' buttons
@@ -20,8 +24,7 @@ namespace CustomElm {
         this->addElement(this->playerBg);
 
         // Album/song playing
-        this->albumCover = new Aether::Image(10, 600, Path::App::DefaultArtFile);
-        this->albumCover->setWH(110, 110);
+        this->albumCover = new CustomElm::CachedImage(10, 600, ALBUM_COVER_SIZE, ALBUM_COVER_SIZE, Path::App::DefaultArtFile);
         this->addElement(this->albumCover);
         this->trackName = new Aether::Text(140, 625, "", 24);
         this->trackName->setScroll(true);
@@ -112,16 +115,20 @@ namespace CustomElm {
         this->addElement(this->fullscreenC);
     }
 
-    void Player::setAlbumCover(Aether::Image * i) {
+    void Player::setAlbumCover(Aether::Element * i) {
         this->removeElement(this->albumCover);
         this->albumCover = i;
         if (i != nullptr) {
             this->albumCover->setXY(10, 600);
-            this->albumCover->setWH(110, 110);
+            this->albumCover->setWH(ALBUM_COVER_SIZE, ALBUM_COVER_SIZE);
             this->addElement(this->albumCover);
         }
     }
 
+    void Player::setAlbumCover(const std::string & path) {
+        this->setAlbumCover(new CustomElm::CachedImage(0, 0, ALBUM_COVER_SIZE, ALBUM_COVER_SIZE, path));
+    }
+
     void Player::setTrackName(std::string str) {
         // Scroll song name if too long
         this->trackName->setString(str);
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <limits>
 #include "ui/element/ScrollableGrid.hpp"
 
 // Variables to alter scroll animation
@@ -12,6 +14,9 @@
 // Amount touch can deviate (in px) before scrolling
 #define TOUCH_RADIUS 30
 
+// Number of rows to keep created above and below the visible rows (data source only)
+#define MARGIN_ROWS 1
+
 // Minimum height of scroll bar
 #define MIN_SCROLLBAR_SIZE 100
 // Width of scroll bar
@@ -20,6 +25,11 @@
 namespace CustomElm {
     ScrollableGrid::ScrollableGrid(int x, int y, int w, int h, unsigned int rh, unsigned int c) : Container(x, y, w, h) {
         this->cols = c;
+        this->createItem = nullptr;
+        this->bindItem = nullptr;
+        this->dataSource = false;
+        this->count_ = 0;
+        this->focusedIndex_ = 0;
         this->isScrolling = false;
         this->isTouched = false;
         this->rowHeight = rh;
@@ -44,7 +54,111 @@ namespace CustomElm {
         e->setY(this->y() + 10 + r*this->rowHeight - this->scrollPos);
     }
 
+    size_t ScrollableGrid::itemCount() {
+        return (this->dataSource ? this->count_ : this->children.size());
+    }
+
+    void ScrollableGrid::createItems() {
+        // Enough rows to cover the grid plus the margin, but no more than needed
+        size_t needed = (this->h()/this->rowHeight + 2 + 2*MARGIN_ROWS) * this->cols;
+        if (needed > this->count_) {
+            needed = this->count_;
+        }
+
+        // Reuse the existing items if there's the right amount
+        if (needed != this->children.size()) {
+            Container::removeAllElements();
+            for (size_t i = 0; i < needed; i++) {
+                Container::addElementAt(this->createItem(), i);
+            }
+        }
+        this->itemIndex = std::vector<size_t>(this->children.size(), std::numeric_limits<size_t>::max());
+    }
+
+    void ScrollableGrid::bindItems() {
+        if (this->children.empty()) {
+            return;
+        }
+
+        // Determine the first index to bind, keeping the margin above the visible rows if possible
+        size_t n = this->children.size();
+        size_t row = this->scrollPos/this->rowHeight;
+        size_t first = (row > MARGIN_ROWS ? row - MARGIN_ROWS : 0) * this->cols;
+        if (first + n > this->count_) {
+            first = this->count_ - n;
+        }
+
+        // Only items which now show a different index need to be rebound
+        for (size_t i = first; i < first + n; i++) {
+            size_t slot = i % n;
+            if (this->itemIndex[slot] != i) {
+                this->bindItem(this->children[slot], i);
+                this->itemIndex[slot] = i;
+            }
+            this->positionChild(this->children[slot], i);
+        }
+
+        this->focusItem();
+    }
+
+    void ScrollableGrid::focusItem() {
+        if (this->children.empty()) {
+            return;
+        }
+
+        // Nothing to do if the focused index isn't bound (it will be once scrolled to)
+        size_t slot = this->focusedIndex_ % this->children.size();
+        if (this->itemIndex[slot] != this->focusedIndex_ || this->focused() == this->children[slot]) {
+            return;
+        }
+
+        if (this->focused() != nullptr) {
+            this->focused()->setInactive();
+        }
+        this->setFocused(this->children[slot]);
+        if (this->parent() != nullptr && this->parent()->focused() == this) {
+            this->children[slot]->setActive();
+        }
+    }
+
+    bool ScrollableGrid::moveFocus(int delta) {
+        // Don't wrap between rows when moving left/right (so focus can leave the grid)
+        long idx = (long)this->focusedIndex_ + delta;
+        if (delta == -1 || delta == 1) {
+            if (idx < 0 || idx >= (long)this->count_ || (size_t)idx/this->cols != this->focusedIndex_/this->cols) {
+                return false;
+            }
+
+        // Moving down onto a partially filled last row focuses its last item
+        } else if (idx >= (long)this->count_) {
+            if ((this->count_ - 1)/this->cols == this->focusedIndex_/this->cols) {
+                return false;
+            }
+            idx = this->count_ - 1;
+
+        } else if (idx < 0) {
+            return false;
+        }
+
+        this->setFocusedIndex(idx);
+        return true;
+    }
+
     void ScrollableGrid::stopScrolling() {
+        // Move focus to the top visible row (in the same column) if the focused item isn't visible
+        if (this->isScrolling && this->dataSource) {
+            int top = 10 + (this->focusedIndex_/this->cols)*this->rowHeight;
+            if (this->count_ > 0 && (top < this->scrollPos || top + (int)this->rowHeight > this->scrollPos + this->h())) {
+                size_t row = (this->scrollPos + this->rowHeight - 1)/this->rowHeight;
+                size_t idx = row*this->cols + this->focusedIndex_ % this->cols;
+                this->focusedIndex_ = (idx < this->count_ ? idx : this->count_ - 1);
+                this->focusItem();
+            }
+
+            this->scrollVelocity = 0;
+            this->isScrolling = false;
+        }
+
         // Move highlight to top element (in same column) if not visible
         if (this->isScrolling) {
             if (this->hasSelectable() && this->focused() != nullptr) {
@@ -83,8 +197,10 @@ namespace CustomElm {
             this->scrollPos = pos;
         }
 
-        // Update children positions
-        if (old != this->scrollPos) {
+        // Update children positions (or bind different items)
+        if (old != this->scrollPos && this->dataSource) {
+            this->bindItems();
+        } else if (old != this->scrollPos) {
             for (size_t i = 0; i < this->children.size(); i++) {
                 this->children[i]->setY(this->children[i]->y() - (this->scrollPos - old));
             }
@@ -93,7 +209,7 @@ namespace CustomElm {
 
     void ScrollableGrid::updateMaxScrollPos() {
         // The maximum scroll position is simple
-        size_t rows = this->children.size()/this->cols + (this->children.size() % this->cols > 0 ? 1 : 0);
+        size_t rows = this->itemCount()/this->cols + (this->itemCount() % this->cols > 0 ? 1 : 0);
         this->maxScrollPos = 2 * PADDING + (rows * rowHeight);
 
         // If children don't take up enough space don't scroll!
@@ -119,10 +235,77 @@ namespace CustomElm {
     void ScrollableGrid::removeAllElements() {
         this->stopScrolling();
         Container::removeAllElements();
+        this->itemIndex.clear();
+        this->count_ = 0;
+        this->focusedIndex_ = 0;
         this->setScrollPos(0);
         this->updateMaxScrollPos();
     }
 
+    void ScrollableGrid::setCreateItemFunc(std::function<Aether::Element *()> f) {
+        this->createItem = f;
+    }
+
+    void ScrollableGrid::setBindItemFunc(std::function<void(Aether::Element *, size_t)> f) {
+        this->bindItem = f;
+    }
+
+    void ScrollableGrid::setCount(const size_t count) {
+        this->isScrolling = false;
+        this->scrollVelocity = 0;
+        this->dataSource = true;
+        this->count_ = count;
+        this->focusedIndex_ = 0;
+        this->scrollPos = 0;
+        this->createItems();
+        this->updateMaxScrollPos();
+        this->bindItems();
+    }
+
+    void ScrollableGrid::updateCount(const size_t count) {
+        // Items are only created again if a different number are needed to fill the grid
+        this->count_ = count;
+        if (this->focusedIndex_ >= count) {
+            this->focusedIndex_ = (count > 0 ? count - 1 : 0);
+        }
+        size_t needed = (this->h()/this->rowHeight + 2 + 2*MARGIN_ROWS) * this->cols;
+        if (this->children.size() != std::min(needed, count)) {
+            this->createItems();
+        }
+        this->updateMaxScrollPos();
+        if (this->scrollPos > this->maxScrollPos) {
+            this->scrollPos = this->maxScrollPos;
+        }
+        this->bindItems();
+    }
+
+    void ScrollableGrid::refresh() {
+        this->itemIndex = std::vector<size_t>(this->children.size(), std::numeric_limits<size_t>::max());
+        this->bindItems();
+    }
+
+    size_t ScrollableGrid::focusedIndex() {
+        return this->focusedIndex_;
+    }
+
+    void ScrollableGrid::setFocusedIndex(const size_t idx) {
+        if (this->count_ == 0) {
+            return;
+        }
+        this->focusedIndex_ = (idx < this->count_ ? idx : this->count_ - 1);
+
+        // Jump straight to the row if it isn't bound, otherwise update() scrolls to it smoothly
+        if (this->itemIndex[this->focusedIndex_ % this->children.size()] != this->focusedIndex_) {
+            int top = (this->focusedIndex_/this->cols)*this->rowHeight;
+            if (top < this->scrollPos) {
+                this->setScrollPos(top);
+            } else {
+                this->setScrollPos(10 + top + this->rowHeight + PADDING - this->h());
+            }
+        }
+        this->focusItem();
+    }
+
     bool ScrollableGrid::handleEvent(Aether::InputEvent * e) {
         if (e->type() == Aether::EventType::TouchPressed) {
             if (e->touchX() >= this->x() && e->touchX() <= this->x() + this->w() && e->touchY() >= this->y() && e->touchY() <= this->y() + this->h()) {
@@ -184,6 +367,23 @@ namespace CustomElm {
                 return true;
             }
 
+        // Move focus by index when using a data source, as the neighbouring item may not be bound yet
+        } else if (this->dataSource && e->type() == Aether::EventType::ButtonPressed && (e->button() == Aether::Button::DPAD_UP || e->button() == Aether::Button::DPAD_DOWN || e->button() == Aether::Button::DPAD_LEFT || e->button() == Aether::Button::DPAD_RIGHT)) {
+            this->stopScrolling();
+            switch (e->button()) {
+                case Aether::Button::DPAD_UP:
+                    return this->moveFocus(-(int)this->cols);
+
+                case Aether::Button::DPAD_DOWN:
+                    return this->moveFocus(this->cols);
+
+                case Aether::Button::DPAD_LEFT:
+                    return this->moveFocus(-1);
+
+                default:
+                    return this->moveFocus(1);
+            }
+
         // Not a touch event, so let the container handle it
         } else {
             this->stopScrolling();
@@ -227,13 +427,21 @@ namespace CustomElm {
 
         // If focused element is not completely inside list scroll to it
         if (!this->isScrolling && !this->isTouched && !this->isTouch && this->maxScrollPos != 0 && this->focused() != nullptr) {
+            // Use the focused index's position as its item may not be bound
+            int top = this->focused()->y();
+            int bottom = top + this->focused()->h();
+            if (this->dataSource) {
+                top = this->y() + 10 + (int)((this->focusedIndex_/this->cols)*this->rowHeight) - this->scrollPos;
+                bottom = top + this->focused()->h();
+            }
+
             // Check if above
-            if (this->focused()->y() < this->y() + PADDING) {
-                this->setScrollPos(this->scrollPos + (CATCHUP * (this->focused()->y() - (this->y() + PADDING)) * (dt/1000.0)));
+            if (top < this->y() + PADDING) {
+                this->setScrollPos(this->scrollPos + (CATCHUP * (top - (this->y() + PADDING)) * (dt/1000.0)));
 
             // And below ;)
-            } else if (this->focused()->y() + this->focused()->h() > this->y() + this->h() - (PADDING*2)) {
-                this->setScrollPos(this->scrollPos - (CATCHUP * ((this->y() + this->h() - (PADDING*2)) - (this->focused()->y() + this->focused()->h())) * (dt/1000.0)));
+            } else if (bottom > this->y() + this->h() - (PADDING*2)) {
+                this->setScrollPos(this->scrollPos - (CATCHUP * ((this->y() + this->h() - (PADDING*2)) - bottom) * (dt/1000.0)));
             }
         }
     }
@@ -257,14 +465,24 @@ namespace CustomElm {
         Container::setW(w);
 
         // Position children again
-        for (size_t i = 0; i < this->children.size(); i++) {
-            this->positionChild(this->children[i], i);
+        if (this->dataSource) {
+            this->bindItems();
+        } else {
+            for (size_t i = 0; i < this->children.size(); i++) {
+                this->positionChild(this->children[i], i);
+            }
         }
     }
 
     void ScrollableGrid::setH(int h) {
         Container::setH(h);
+        if (this->dataSource) {
+            this->createItems();
+        }
         this->updateMaxScrollPos();
+        if (this->dataSource) {
+            this->bindItems();
+        }
     }
 
     void ScrollableGrid::setShowScrollBar(bool b) {
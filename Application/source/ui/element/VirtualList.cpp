@@ -0,0 +1,392 @@
+#include <limits>
+#include "ui/element/VirtualList.hpp"
+
+// Variables to alter scroll animation
+#define CATCHUP 13.5
+#define DAMPENING 20
+#define MAX_VELOCITY 70
+
+// Padding above first row
+#define TOP_PADDING 10
+// Padding for very bottom elements
+#define PADDING 40
+// Padding either side of rows (to allow for scroll bar)
+#define SIDE_PADDING 50
+// Amount touch can deviate (in px) before scrolling
+#define TOUCH_RADIUS 30
+// Number of rows to keep bound above and below the visible area
+#define MARGIN_ROWS 3
+
+// Minimum height of scroll bar
+#define MIN_SCROLLBAR_SIZE 100
+// Width of scroll bar
+#define SCROLLBAR_WIDTH 5
+
+// Index of an unbound row
+constexpr size_t unbound = std::numeric_limits<size_t>::max();
+
+namespace CustomElm {
+    VirtualList::VirtualList(int x, int y, int w, int h, unsigned int rh) : Container(x, y, w, h) {
+        this->createRow = nullptr;
+        this->bindRow = nullptr;
+        this->count_ = 0;
+        this->rowHeight = rh;
+        this->focusedIndex_ = 0;
+        this->isScrolling = false;
+        this->isTouched = false;
+        this->scrollVelocity = 0;
+        this->scrollPos = 0;
+        this->maxScrollPos = 0;
+        this->scrollBar = nullptr;
+        this->scrollBarColour = Aether::Colour{255, 255, 255, 255};
+        this->showScrollBar_ = true;
+        this->touchY = std::numeric_limits<int>::min();
+    }
+
+    void VirtualList::createRows() {
+        // Enough rows to cover the list plus the margin, but no more than needed
+        size_t needed = this->h()/this->rowHeight + 2 + 2*MARGIN_ROWS;
+        if (needed > this->count_) {
+            needed = this->count_;
+        }
+
+        // Reuse the existing elements if there's the right amount
+        if (needed != this->rows.size()) {
+            Container::removeAllElements();
+            this->rows.clear();
+            for (size_t i = 0; i < needed; i++) {
+                Aether::Element * e = this->createRow();
+                Container::addElement(e);
+                e->setX(this->x() + SIDE_PADDING);
+                e->setW(this->w() - 2*SIDE_PADDING);
+                this->rows.push_back(e);
+            }
+        }
+        this->rowIndex = std::vector<size_t>(this->rows.size(), unbound);
+    }
+
+    void VirtualList::bindRows() {
+        if (this->rows.empty()) {
+            return;
+        }
+
+        // Determine the first index to bind, keeping the margin above the visible area if possible
+        size_t n = this->rows.size();
+        size_t first = this->scrollPos/this->rowHeight;
+        first = (first > MARGIN_ROWS ? first - MARGIN_ROWS : 0);
+        if (first + n > this->count_) {
+            first = this->count_ - n;
+        }
+
+        // Only rows which now show a different index need to be rebound
+        for (size_t i = first; i < first + n; i++) {
+            size_t slot = i % n;
+            if (this->rowIndex[slot] != i) {
+                this->bindRow(this->rows[slot], i);
+                this->rowIndex[slot] = i;
+            }
+            this->rows[slot]->setY(this->y() + TOP_PADDING + (int)(i*this->rowHeight) - this->scrollPos);
+        }
+
+        this->focusRow();
+    }
+
+    void VirtualList::focusRow() {
+        if (this->rows.empty()) {
+            return;
+        }
+
+        // Nothing to do if the focused index isn't bound (it will be once scrolled to)
+        Aether::Element * e = this->rows[this->focusedIndex_ % this->rows.size()];
+        if (this->rowIndex[this->focusedIndex_ % this->rows.size()] != this->focusedIndex_ || this->focused() == e) {
+            return;
+        }
+
+        if (this->focused() != nullptr) {
+            this->focused()->setInactive();
+        }
+        this->setFocused(e);
+        if (this->parent() != nullptr && this->parent()->focused() == this) {
+            e->setActive();
+        }
+    }
+
+    void VirtualList::stopScrolling() {
+        // Move focus to the top visible row if the focused one isn't visible
+        if (this->isScrolling) {
+            int top = this->focusedIndex_*this->rowHeight + TOP_PADDING;
+            if (this->count_ > 0 && (top < this->scrollPos || top + (int)this->rowHeight > this->scrollPos + this->h())) {
+                size_t idx = (this->scrollPos + this->rowHeight - 1)/this->rowHeight;
+                this->focusedIndex_ = (idx < this->count_ ? idx : this->count_ - 1);
+                this->focusRow();
+            }
+
+            this->scrollVelocity = 0;
+            this->isScrolling = false;
+        }
+    }
+
+    void VirtualList::updateMaxScrollPos() {
+        this->maxScrollPos = TOP_PADDING + (int)(this->count_*this->rowHeight) + PADDING - this->h();
+        if (this->maxScrollPos < 0) {
+            this->maxScrollPos = 0;
+        }
+
+        // Delete scroll bar due to new height
+        SDLHelper::destroyTexture(this->scrollBar);
+        this->scrollBar = nullptr;
+    }
+
+    void VirtualList::setCreateRowFunc(std::function<Aether::Element *()> f) {
+        this->createRow = f;
+    }
+
+    void VirtualList::setBindRowFunc(std::function<void(Aether::Element *, size_t)> f) {
+        this->bindRow = f;
+    }
+
+    void VirtualList::setCount(const size_t count) {
+        this->isScrolling = false;
+        this->scrollVelocity = 0;
+        this->count_ = count;
+        this->focusedIndex_ = 0;
+        this->scrollPos = 0;
+        this->createRows();
+        this->updateMaxScrollPos();
+        this->bindRows();
+    }
+
+    void VirtualList::updateCount(const size_t count) {
+        this->count_ = count;
+        if (this->focusedIndex_ >= this->count_) {
+            this->focusedIndex_ = (this->count_ > 0 ? this->count_ - 1 : 0);
+        }
+        this->createRows();
+        this->updateMaxScrollPos();
+        if (this->scrollPos > this->maxScrollPos) {
+            this->scrollPos = this->maxScrollPos;
+        }
+        this->refresh();
+    }
+
+    size_t VirtualList::count() {
+        return this->count_;
+    }
+
+    void VirtualList::refresh() {
+        this->rowIndex = std::vector<size_t>(this->rows.size(), unbound);
+        this->bindRows();
+    }
+
+    void VirtualList::setScrollPos(int pos) {
+        if (pos < 0) {
+            pos = 0;
+        } else if (pos > this->maxScrollPos) {
+            pos = this->maxScrollPos;
+        }
+
+        if (pos != this->scrollPos) {
+            this->scrollPos = pos;
+            this->bindRows();
+        }
+    }
+
+    void VirtualList::scrollToIndex(const size_t idx) {
+        this->stopScrolling();
+        this->setScrollPos(idx*this->rowHeight);
+        this->setFocusedIndex(idx);
+    }
+
+    size_t VirtualList::focusedIndex() {
+        return this->focusedIndex_;
+    }
+
+    void VirtualList::setFocusedIndex(const size_t idx) {
+        if (this->count_ == 0) {
+            return;
+        }
+        this->focusedIndex_ = (idx < this->count_ ? idx : this->count_ - 1);
+
+        // Jump straight to the row if it isn't bound, otherwise update() scrolls to it smoothly
+        if (this->rowIndex[this->focusedIndex_ % this->rows.size()] != this->focusedIndex_) {
+            int top = this->focusedIndex_*this->rowHeight;
+            if (top < this->scrollPos) {
+                this->setScrollPos(top);
+            } else {
+                this->setScrollPos(TOP_PADDING + top + this->rowHeight + PADDING - this->h());
+            }
+        }
+        this->focusRow();
+    }
+
+    bool VirtualList::handleEvent(Aether::InputEvent * e) {
+        if (e->type() == Aether::EventType::TouchPressed) {
+            if (e->touchX() >= this->x() && e->touchX() <= this->x() + this->w() && e->touchY() >= this->y() && e->touchY() <= this->y() + this->h()) {
+                // Activate this element
+                this->isTouched = true;
+                // Note we need to traverse up the tree in order to ensure list is focussed
+                Element * elm = this->parent();
+                if (elm != nullptr) {
+                    while (elm->parent() != nullptr) {
+                        elm->parent()->setFocused(elm);
+                        elm = elm->parent();
+                    }
+                }
+                // Now set list focussed
+                this->parent()->setFocused(this);
+
+                this->touchY = e->touchY();
+                if (this->isScrolling) {
+                    this->scrollVelocity = 0;
+                } else {
+                    // If not scrolling pass event (ie. select)
+                    Container::handleEvent(e);
+                }
+                return true;
+            }
+
+        } else if (e->type() == Aether::EventType::TouchMoved) {
+            if (this->isTouched) {
+                // Check touchY and change from tap to swipe if outside threshold
+                if (this->touchY != std::numeric_limits<int>::min()) {
+                    if (e->touchY() > this->touchY + TOUCH_RADIUS || e->touchY() < this->touchY - TOUCH_RADIUS || e->touchX() < this->x() || e->touchX() > this->x() + this->w()) {
+                        for (size_t i = 0; i < this->children.size(); i++) {
+                            if (this->children[i]->selected() || this->children[i]->hasSelected()) {
+                                this->children[i]->setInactive();
+                                break;
+                            }
+                        }
+                        this->touchY = std::numeric_limits<int>::min();
+                    }
+                } else {
+                    this->setScrollPos(this->scrollPos - e->touchDY());
+                    this->scrollVelocity = -e->touchDY();
+                    if (this->scrollVelocity > MAX_VELOCITY) {
+                        this->scrollVelocity = MAX_VELOCITY;
+                    } else if (this->scrollVelocity < -MAX_VELOCITY) {
+                        this->scrollVelocity = -MAX_VELOCITY;
+                    }
+                }
+
+                return true;
+            }
+
+        } else if (e->type() == Aether::EventType::TouchReleased) {
+            if (this->isTouched) {
+                this->isTouched = false;
+                this->touchY = std::numeric_limits<int>::min();
+                Container::handleEvent(e);
+                this->isScrolling = true;
+                return true;
+            }
+
+        // Move focus by index, as the neighbouring row's element may not be bound yet
+        } else if (e->type() == Aether::EventType::ButtonPressed && (e->button() == Aether::Button::DPAD_UP || e->button() == Aether::Button::DPAD_DOWN)) {
+            this->stopScrolling();
+            if (e->button() == Aether::Button::DPAD_UP && this->focusedIndex_ > 0) {
+                this->setFocusedIndex(this->focusedIndex_ - 1);
+                return true;
+            } else if (e->button() == Aether::Button::DPAD_DOWN && this->focusedIndex_ + 1 < this->count_) {
+                this->setFocusedIndex(this->focusedIndex_ + 1);
+                return true;
+            }
+            return false;
+
+        // Not a touch event, so let the container handle it
+        } else {
+            this->stopScrolling();
+            return Container::handleEvent(e);
+        }
+
+        return false;
+    }
+
+    void VirtualList::update(uint32_t dt) {
+        // Update all rows first
+        Container::update(dt);
+
+        // If scrolling due to touch event
+        if (this->isScrolling) {
+            this->setScrollPos(this->scrollPos + this->scrollVelocity);
+            if (this->scrollPos == 0 || this->scrollPos == this->maxScrollPos) {
+                this->scrollVelocity = 0;
+            }
+
+            if (this->scrollVelocity < 0) {
+                this->scrollVelocity += DAMPENING * (dt/1000.0);
+            } else if (this->scrollVelocity > 0) {
+                this->scrollVelocity -= DAMPENING * (dt/1000.0);
+            }
+
+            if (this->scrollVelocity > -1 && this->scrollVelocity < 1) {
+                this->stopScrolling();
+            }
+        }
+
+        // Recreate scroll bar texture if needed
+        if (this->scrollBar == nullptr) {
+            int size = (0.8*this->h()) * (this->h()/(double)(this->h() + this->maxScrollPos/3));
+            if (size < MIN_SCROLLBAR_SIZE) {
+                size = MIN_SCROLLBAR_SIZE;
+            }
+            this->scrollBar = SDLHelper::renderFilledRoundRect(SCROLLBAR_WIDTH, size, SCROLLBAR_WIDTH/2);
+        }
+
+        // If focused row is not completely inside list scroll to it
+        if (!this->isScrolling && !this->isTouched && !this->isTouch && this->maxScrollPos != 0 && this->count_ > 0) {
+            int top = this->y() + TOP_PADDING + (int)(this->focusedIndex_*this->rowHeight) - this->scrollPos;
+            // Check if above
+            if (top < this->y() + PADDING) {
+                this->setScrollPos(this->scrollPos + (CATCHUP * (top - (this->y() + PADDING)) * (dt/1000.0)));
+
+            // And below ;)
+            } else if (top + (int)this->rowHeight > this->y() + this->h() - (PADDING*2)) {
+                this->setScrollPos(this->scrollPos - (CATCHUP * ((this->y() + this->h() - (PADDING*2)) - (top + (int)this->rowHeight)) * (dt/1000.0)));
+            }
+        }
+    }
+
+    void VirtualList::render() {
+        // Set clip rectangle to match list position + size
+        SDLHelper::setClip(this->x(), this->y(), this->x() + this->w(), this->y() + this->h());
+        Container::render();
+        SDLHelper::resetClip();
+
+        // Draw scroll bar
+        if (this->maxScrollPos != 0 && this->showScrollBar_ && this->scrollBar != nullptr) {
+            int w, h;
+            SDLHelper::getDimensions(this->scrollBar, &w, &h);
+            int yPos = this->y() + PADDING/2 + (((float)this->scrollPos / this->maxScrollPos) * (this->h() - h - PADDING));
+            SDLHelper::drawTexture(this->scrollBar, this->scrollBarColour, this->x() + this->w() - w, yPos);
+        }
+    }
+
+    void VirtualList::setW(int w) {
+        Container::setW(w);
+        for (Aether::Element * e : this->rows) {
+            e->setW(this->w() - 2*SIDE_PADDING);
+        }
+    }
+
+    void VirtualList::setH(int h) {
+        Container::setH(h);
+        if (this->createRow != nullptr) {
+            this->createRows();
+        }
+        this->updateMaxScrollPos();
+        this->setScrollPos(this->scrollPos);
+        this->bindRows();
+    }
+
+    void VirtualList::setShowScrollBar(bool b) {
+        this->showScrollBar_ = b;
+    }
+
+    void VirtualList::setScrollBarColour(Aether::Colour c) {
+        this->scrollBarColour = c;
+    }
+
+    VirtualList::~VirtualList() {
+        SDLHelper::destroyTexture(this->scrollBar);
+    }
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "ui/element/listitem/Artist.hpp"
+#include "utils/Image.hpp"
 
 // Font size of text
 #define FONT_SIZE 24
@@ -9,7 +10,7 @@
 
 namespace CustomElm::ListItem {
     Artist::Artist(const std::string & path) : Item(HEIGHT) {
-        this->image = new Aether::Image(0, 0, path, 1, 1, Aether::RenderType::Deferred);
+        this->image = new Aether::Image(0, 0, Utils::Image::thumbnailPath(path, HEIGHT - 2*PADDING), 1, 1, Aether::RenderType::Deferred);
         this->watchTexture(this->image);
         this->name = new Aether::Text(0, 0, "", FONT_SIZE, Aether::FontStyle::Regular, Aether::RenderType::Deferred);
         this->name->setScrollSpeed(35);
@@ -28,6 +28,14 @@ namespace CustomElm::ListItem {
         this->lineColour = c;
     }
 
+    void Item::refresh() {
+        for (size_t i = 0; i < this->textures.size(); i++) {
+            this->textures[i]->destroyTexture();
+            this->textures[i]->setHidden(true);
+        }
+        this->renderStatus = Status::Waiting;
+    }
+
     void Item::update(uint32_t dt) {
         // Update children
         Element::update(dt);
@@ -1,4 +1,5 @@
 #include "ui/element/listitem/Playlist.hpp"
+#include "utils/Image.hpp"
 
 // Font sizes
 #define NAME_FONT_SIZE 28
@@ -10,7 +11,7 @@
 
 namespace CustomElm::ListItem {
     Playlist::Playlist(const std::string & img) : More(HEIGHT) {
-        this->image = new Aether::Image(this->x() + PADDING, this->y() + PADDING, img, 1, 1, Aether::RenderType::Deferred);
+        this->image = new Aether::Image(this->x() + PADDING, this->y() + PADDING, Utils::Image::thumbnailPath(img, HEIGHT - 2*PADDING), 1, 1, Aether::RenderType::Deferred);
         this->watchTexture(this->image);
         this->name = new Aether::Text(this->x(), this->y(), "", NAME_FONT_SIZE, Aether::FontStyle::Regular, Aether::RenderType::Deferred);
         this->watchTexture(this->name);
@@ -2,6 +2,7 @@
 #include "lang/Lang.hpp"
 #include <limits>
 #include "Paths.hpp"
+#include "ui/element/CachedImage.hpp"
 #include "ui/element/listitem/AlbumSong.hpp"
 #include "ui/frame/Album.hpp"
 #include "ui/overlay/ArtistList.hpp"
@@ -44,8 +45,7 @@ namespace Frame {
         }
 
         // Populate with Album's data
-        Aether::Image * image = new Aether::Image(this->x() + 50, this->y() + 50, this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : this->metadata.imagePath);
-        image->setWH(IMAGE_SIZE, IMAGE_SIZE);
+        CustomElm::CachedImage * image = new CustomElm::CachedImage(this->x() + 50, this->y() + 50, IMAGE_SIZE, IMAGE_SIZE, this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : this->metadata.imagePath);
         this->addElement(image);
         this->heading->setString(this->metadata.name);
         this->heading->setX(image->x() + image->w() + 28);
@@ -281,7 +281,7 @@ namespace Frame {
         // Song metadata
         this->songMenu->setMainText(this->songs[pos].title);
         this->songMenu->setSubText(this->songs[pos].artist);
-        this->songMenu->setImage(new Aether::Image(0, 0, this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : this->metadata.imagePath));
+        this->songMenu->setImage(this->metadata.imagePath.empty() ? Path::App::DefaultArtFile : this->metadata.imagePath);
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -5,6 +5,8 @@
 #include "ui/frame/AlbumInfo.hpp"
 #include "utils/FS.hpp"
 #include "utils/Image.hpp"
+#include "utils/Splash.hpp"
+#include "utils/TextureCache.hpp"
 #include "utils/Utils.hpp"
 
 // Default path for file browser
@@ -275,32 +277,42 @@ namespace Frame {
         }
 
         // Copy new image to disk
+        Utils::Splash::Palette palette;
+        palette.invalid = true;
         if (this->updateImage && !this->metadata.imagePath.empty()) {
             // Extract image (if needed) and resize
             if (!this->newImagePath.empty()) {
                 Utils::Fs::readFile(this->newImagePath, this->dlBuffer);
             }
-            bool resized = Utils::Image::resize(this->dlBuffer, 400, 400);
+            bool resized = Utils::Image::resize(this->dlBuffer, 400, 400, Utils::Image::Filter::Quality);
             if (!resized) {
                 Log::writeWarning("[META] Couldn't resize playlist image, saving with original dimensions");
             }
 
-            // Write (hopefully resized) to file
-            Utils::Fs::writeFile(this->metadata.imagePath, this->dlBuffer);
+            // Write (hopefully resized) to file along with smaller copies
+            if (Utils::Fs::writeFile(this->metadata.imagePath, this->dlBuffer)) {
+                Utils::Image::writeThumbnails(this->dlBuffer, this->metadata.imagePath);
+                Utils::TextureCache::invalidate(this->metadata.imagePath);
+                palette = Utils::Splash::getPaletteForImage(this->metadata.imagePath);
+            }
         }
 
         // Commit changes to db (acquires lock and then writes)
+        // The palette is set even if the path is unchanged as the image may have been overwritten
         this->app->lockDatabase();
         bool ok = this->app->database()->updateAlbum(this->metadata);
+        if (ok && !palette.invalid) {
+            this->app->database()->setAlbumPaletteForImage(this->metadata.imagePath, Utils::Splash::packPalette(palette));
+        }
         this->app->unlockDatabase();
 
-        // Delete image if everything succeeded, revert copied image on an error
+        // Delete image if everything succeeded (and no other album shares it), revert copied image on an error
         if (this->updateImage) {
-            if (ok && !oldPath.empty()) {
-                Utils::Fs::deleteFile(oldPath);
+            if (ok && !oldPath.empty() && !this->app->database()->imagePathInUse(oldPath)) {
+                Utils::Image::deleteImage(oldPath);
 
             } else if (!ok && !this->metadata.imagePath.empty()) {
-                Utils::Fs::deleteFile(this->metadata.imagePath);
+                Utils::Image::deleteImage(this->metadata.imagePath);
             }
         }
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Application.hpp"
 #include "lang/Lang.hpp"
 #include "Paths.hpp"
@@ -10,6 +11,8 @@
 
 // Number of GridItems per row
 #define COLUMNS 3
+// Number of items to load at once
+#define PAGE_SIZE 60
 
 namespace Frame {
     Albums::Albums(Main::Application * a) : Frame(a) {
@@ -25,6 +28,29 @@ namespace Frame {
         this->grid = new CustomElm::ScrollableGrid(this->x(), this->y() + 170, this->w() - 10, this->h() - 170, 250, 3);
         this->grid->setShowScrollBar(true);
         this->grid->setScrollBarColour(this->app->theme()->muted2());
+        this->grid->setCreateItemFunc([this]() {
+            CustomElm::GridItem * l = new CustomElm::GridItem(Path::App::DefaultArtFile);
+            l->setDotsColour(this->app->theme()->muted());
+            l->setTextColour(this->app->theme()->FG());
+            l->setMutedTextColour(this->app->theme()->muted());
+            return l;
+        });
+        this->grid->setBindItemFunc([this](Aether::Element * e, size_t i) {
+            this->albums->prefetch(i);
+            const Metadata::Album & m = (*this->albums)[i];
+            CustomElm::GridItem * l = static_cast<CustomElm::GridItem *>(e);
+            l->setImagePath(m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath);
+            l->setMainString(m.name);
+            l->setSubString(m.artist);
+            AlbumID id = m.ID;
+            l->setCallback([this, id](){
+                this->changeFrame(Type::Album, Action::Push, id);
+            });
+            l->setMoreCallback([this, id]() {
+                this->createMenu(id);
+            });
+            l->refresh();
+        });
         this->bottomContainer->addElement(this->grid);
 
         // Create sort menu
@@ -43,6 +69,8 @@ namespace Frame {
         this->sortMenu->setLineColour(this->app->theme()->muted2());
         this->sortMenu->setTextColour(this->app->theme()->FG());
 
+        this->emptyMsg = nullptr;
+        this->albums = nullptr;
         this->createList(Database::SortBy::AlbumAsc);
         this->bottomContainer->setFocussed(this->grid);
         this->artistsList = nullptr;
@@ -76,39 +104,38 @@ namespace Frame {
     }
 
     void Albums::createList(Database::SortBy sort) {
-        // Remove previous items
-        this->grid->removeAllElements();
-
-        // Create items for albums
-        std::vector<Metadata::Album> m = this->app->database()->getAllAlbumMetadata(sort);
-        if (m.size() > 0) {
-            for (size_t i = 0; i < m.size(); i++) {
-                std::string img = (m[i].imagePath.empty() ? Path::App::DefaultArtFile : m[i].imagePath);
-                CustomElm::GridItem * l = new CustomElm::GridItem(img);
-                l->setMainString(m[i].name);
-                l->setSubString(m[i].artist);
-                l->setDotsColour(this->app->theme()->muted());
-                l->setTextColour(this->app->theme()->FG());
-                l->setMutedTextColour(this->app->theme()->muted());
-                AlbumID id = m[i].ID;
-                l->setCallback([this, id](){
-                    this->changeFrame(Type::Album, Action::Push, id);
-                });
-                l->setMoreCallback([this, id]() {
-                    this->createMenu(id);
-                });
-                this->grid->addElement(l);
-            }
-            this->subHeading->setString((m.size() == 1 ? "Album.CountOne"_lang : Utils::substituteTokens("Album.CountMany"_lang, std::to_string(m.size()))));
+        this->sortType = sort;
+        this->libraryVersion = this->app->libraryVersion();
+
+        // Items are created/bound by the grid as needed, and only the first page is loaded now
+        delete this->albums;
+        this->albums = new Utils::Pager<Metadata::Album>([this](Database::Cursor & cursor, const size_t count) {
+            return this->app->database()->getAlbumMetadataPage(cursor, count);
+        }, sort, PAGE_SIZE);
+        this->grid->setCount(this->albums->size());
+        this->updateTotal();
+    }
+
+    void Albums::updateTotal() {
+        if (this->emptyMsg != nullptr) {
+            this->removeElement(this->emptyMsg);
+            this->emptyMsg = nullptr;
+        }
+        this->grid->setHidden(false);
+        this->subHeading->setHidden(false);
+
+        size_t total = std::max(this->app->database()->getAlbumCount(), (int)this->albums->size());
+        if (this->albums->size() > 0) {
+            this->subHeading->setString((total == 1 ? "Album.CountOne"_lang : Utils::substituteTokens("Album.CountMany"_lang, std::to_string(total))));
 
         // Show message if no albums
         } else {
             this->grid->setHidden(true);
             this->subHeading->setHidden(true);
-            Aether::Text * emptyMsg = new Aether::Text(0, grid->y() + grid->h()*0.4, "Album.NotFound"_lang, 24);
-            emptyMsg->setColour(this->app->theme()->FG());
-            emptyMsg->setX(this->x() + (this->w() - emptyMsg->w())/2);
-            this->addElement(emptyMsg);
+            this->emptyMsg = new Aether::Text(0, grid->y() + grid->h()*0.4, "Album.NotFound"_lang, 24);
+            this->emptyMsg->setColour(this->app->theme()->FG());
+            this->emptyMsg->setX(this->x() + (this->w() - this->emptyMsg->w())/2);
+            this->addElement(this->emptyMsg);
         }
 
     }
@@ -129,7 +156,7 @@ namespace Frame {
         this->albumMenu->addSeparator(this->app->theme()->muted2());
 
         // Album metadata
-        this->albumMenu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath));
+        this->albumMenu->setImage(m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath);
         this->albumMenu->setMainText(m.name);
         this->albumMenu->setSubText(m.artist);
 
@@ -226,7 +253,29 @@ namespace Frame {
         this->app->addOverlay(this->albumMenu);
     }
 
+    void Albums::update(uint32_t dt) {
+        // Reload the albums already loaded in the background when the library changes (i.e. during
+        // a scan), keeping the user's place
+        if (this->app->libraryVersion() != this->libraryVersion) {
+            this->libraryVersion = this->app->libraryVersion();
+            this->albums->refresh();
+        }
+
+        // Show the reloaded items, or any newly loaded ones
+        if (this->albums->finishRefresh()) {
+            this->grid->updateCount(this->albums->size());
+            this->grid->refresh();
+            this->updateTotal();
+
+        } else if (this->albums->update()) {
+            this->grid->updateCount(this->albums->size());
+        }
+
+        Frame::update(dt);
+    }
+
     Albums::~Albums() {
+        delete this->albums;
         delete this->artistsList;
         delete this->albumMenu;
         delete this->sortMenu;
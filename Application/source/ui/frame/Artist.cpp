@@ -1,6 +1,7 @@
 #include "Application.hpp"
 #include "lang/Lang.hpp"
 #include "Paths.hpp"
+#include "ui/element/CachedImage.hpp"
 #include "ui/element/GridItem.hpp"
 #include "ui/element/ScrollableGrid.hpp"
 #include "ui/frame/Artist.hpp"
@@ -36,8 +37,7 @@ namespace Frame {
         }
 
         // Populate with Artist's data
-        Aether::Image * image = new Aether::Image(this->x() + 50, this->y() + 50, this->meta.imagePath.empty() ? "romfs:/misc/noartist.png" : this->meta.imagePath);
-        image->setWH(IMAGE_SIZE, IMAGE_SIZE);
+        CustomElm::CachedImage * image = new CustomElm::CachedImage(this->x() + 50, this->y() + 50, IMAGE_SIZE, IMAGE_SIZE, this->meta.imagePath.empty() ? "romfs:/misc/noartist.png" : this->meta.imagePath);
         this->addElement(image);
         this->heading->setString(this->meta.name);
         this->heading->setX(image->x() + image->w() + 28);
@@ -207,7 +207,7 @@ namespace Frame {
         this->albumMenu->addSeparator(this->app->theme()->muted2());
 
         // Album metadata
-        this->albumMenu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath));
+        this->albumMenu->setImage(m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath);
         this->albumMenu->setMainText(m.name);
         this->albumMenu->setSubText(m.artist);
 
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "Application.hpp"
 #include "lang/Lang.hpp"
 #include "ui/element/GridItem.hpp"
@@ -8,6 +9,8 @@
 
 // Number of GridItems per row
 #define COLUMNS 3
+// Number of items to load at once
+#define PAGE_SIZE 60
 
 namespace Frame {
     Artists::Artists(Main::Application * a) : Frame(a) {
@@ -23,6 +26,42 @@ namespace Frame {
         this->grid = new CustomElm::ScrollableGrid(this->x(), this->y() + 170, this->w() - 10, this->h() - 170, 250, 3);
         this->grid->setShowScrollBar(true);
         this->grid->setScrollBarColour(this->app->theme()->muted2());
+        this->grid->setCreateItemFunc([this]() {
+            CustomElm::GridItem * l = new CustomElm::GridItem("romfs:/misc/noartist.png");
+            l->setDotsColour(this->app->theme()->muted());
+            l->setTextColour(this->app->theme()->FG());
+            l->setMutedTextColour(this->app->theme()->muted());
+            return l;
+        });
+        this->grid->setBindItemFunc([this](Aether::Element * e, size_t i) {
+            this->artists->prefetch(i);
+            const Metadata::Artist & m = (*this->artists)[i];
+            CustomElm::GridItem * l = static_cast<CustomElm::GridItem *>(e);
+            l->setImagePath(m.imagePath.empty() ? "romfs:/misc/noartist.png" : m.imagePath);
+            l->setMainString(m.name);
+            std::string str;
+            if (m.albumCount == 1 && m.songCount == 1) {
+                str = "Artist.DetailsOneOne"_lang;
+
+            } else if (m.albumCount == 1) {
+                str = Utils::substituteTokens("Artist.DetailsOneMany"_lang, std::to_string(m.songCount));
+
+            } else if (m.songCount == 1) {
+                str = Utils::substituteTokens("Artist.DetailsManyOne"_lang, std::to_string(m.albumCount));
+
+            } else {
+                str = Utils::substituteTokens("Artist.DetailsManyMany"_lang, std::to_string(m.albumCount), std::to_string(m.songCount));
+            }
+            l->setSubString(str);
+            ArtistID id = m.ID;
+            l->setCallback([this, id](){
+                this->changeFrame(Type::Artist, Action::Push, id);
+            });
+            l->setMoreCallback([this, id]() {
+                this->createMenu(id);
+            });
+            l->refresh();
+        });
         this->bottomContainer->addElement(this->grid);
 
         // Create sort menu
@@ -43,58 +82,46 @@ namespace Frame {
         this->sortMenu->setLineColour(this->app->theme()->muted2());
         this->sortMenu->setTextColour(this->app->theme()->FG());
 
+        this->emptyMsg = nullptr;
+        this->artists = nullptr;
         this->createList(Database::SortBy::ArtistAsc);
         this->bottomContainer->setFocussed(this->grid);
         this->menu = nullptr;
     }
 
     void Artists::createList(Database::SortBy sort) {
-        // Remove previous items
-        this->grid->removeAllElements();
-
-        // Create items for artists
-        std::vector<Metadata::Artist> m = this->app->database()->getAllArtistMetadata(sort);
-        if (m.size() > 0) {
-            for (size_t i = 0; i < m.size(); i++) {
-                std::string img = (m[i].imagePath.empty() ? "romfs:/misc/noartist.png" : m[i].imagePath);
-                CustomElm::GridItem * l = new CustomElm::GridItem(img);
-                l->setMainString(m[i].name);
-                std::string str;
-                if (m[i].albumCount == 1 && m[i].songCount == 1) {
-                    str = "Artist.DetailsOneOne"_lang;
-
-                } else if (m[i].albumCount == 1) {
-                    str = Utils::substituteTokens("Artist.DetailsOneMany"_lang, std::to_string(m[i].songCount));
-
-                } else if (m[i].songCount == 1) {
-                    str = Utils::substituteTokens("Artist.DetailsManyOne"_lang, std::to_string(m[i].albumCount));
-
-                } else {
-                    str = Utils::substituteTokens("Artist.DetailsManyMany"_lang, std::to_string(m[i].albumCount), std::to_string(m[i].songCount));
-                }
-                l->setSubString(str);
-                l->setDotsColour(this->app->theme()->muted());
-                l->setTextColour(this->app->theme()->FG());
-                l->setMutedTextColour(this->app->theme()->muted());
-                ArtistID id = m[i].ID;
-                l->setCallback([this, id](){
-                    this->changeFrame(Type::Artist, Action::Push, id);
-                });
-                l->setMoreCallback([this, id]() {
-                    this->createMenu(id);
-                });
-                this->grid->addElement(l);
-            }
-            this->subHeading->setString(m.size() == 1 ? "Artist.CountOne"_lang : Utils::substituteTokens("Artist.CountMany"_lang, std::to_string(m.size())));
+        this->sortType = sort;
+        this->libraryVersion = this->app->libraryVersion();
+
+        // Items are created/bound by the grid as needed, and only the first page is loaded now
+        delete this->artists;
+        this->artists = new Utils::Pager<Metadata::Artist>([this](Database::Cursor & cursor, const size_t count) {
+            return this->app->database()->getArtistMetadataPage(cursor, count);
+        }, sort, PAGE_SIZE);
+        this->grid->setCount(this->artists->size());
+        this->updateTotal();
+    }
+
+    void Artists::updateTotal() {
+        if (this->emptyMsg != nullptr) {
+            this->removeElement(this->emptyMsg);
+            this->emptyMsg = nullptr;
+        }
+        this->grid->setHidden(false);
+        this->subHeading->setHidden(false);
+
+        size_t total = std::max(this->app->database()->getArtistCount(), (int)this->artists->size());
+        if (this->artists->size() > 0) {
+            this->subHeading->setString(total == 1 ? "Artist.CountOne"_lang : Utils::substituteTokens("Artist.CountMany"_lang, std::to_string(total)));
 
         // Show message if no artists
         } else {
             this->grid->setHidden(true);
             this->subHeading->setHidden(true);
-            Aether::Text * emptyMsg = new Aether::Text(0, grid->y() + grid->h()*0.4, "Artist.NotFound"_lang, 24);
-            emptyMsg->setColour(this->app->theme()->FG());
-            emptyMsg->setX(this->x() + (this->w() - emptyMsg->w())/2);
-            this->addElement(emptyMsg);
+            this->emptyMsg = new Aether::Text(0, grid->y() + grid->h()*0.4, "Artist.NotFound"_lang, 24);
+            this->emptyMsg->setColour(this->app->theme()->FG());
+            this->emptyMsg->setX(this->x() + (this->w() - this->emptyMsg->w())/2);
+            this->addElement(this->emptyMsg);
         }
     }
 
@@ -114,7 +141,7 @@ namespace Frame {
         this->menu->addSeparator(this->app->theme()->muted2());
 
         // Set artist specific things
-        this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? "romfs:/misc/noartist.png" : m.imagePath));
+        this->menu->setImage(m.imagePath.empty() ? "romfs:/misc/noartist.png" : m.imagePath);
         this->menu->setMainText(m.name);
         std::string str;
         if (m.albumCount == 1 && m.songCount == 1) {
@@ -201,7 +228,29 @@ namespace Frame {
         this->app->addOverlay(this->menu);
     }
 
+    void Artists::update(uint32_t dt) {
+        // Reload the artists already loaded in the background when the library changes (i.e. during
+        // a scan), keeping the user's place
+        if (this->app->libraryVersion() != this->libraryVersion) {
+            this->libraryVersion = this->app->libraryVersion();
+            this->artists->refresh();
+        }
+
+        // Show the reloaded items, or any newly loaded ones
+        if (this->artists->finishRefresh()) {
+            this->grid->updateCount(this->artists->size());
+            this->grid->refresh();
+            this->updateTotal();
+
+        } else if (this->artists->update()) {
+            this->grid->updateCount(this->artists->size());
+        }
+
+        Frame::update(dt);
+    }
+
     Artists::~Artists() {
+        delete this->artists;
         delete this->sortMenu;
         delete this->menu;
     }
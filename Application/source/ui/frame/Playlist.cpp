@@ -3,11 +3,13 @@
 #include <limits>
 #include "meta/M3U.hpp"
 #include "Paths.hpp"
+#include "ui/element/CachedImage.hpp"
 #include "ui/element/listitem/Song.hpp"
+#include "ui/element/VirtualList.hpp"
 #include "ui/frame/Playlist.hpp"
 #include "ui/overlay/ItemMenu.hpp"
 #include "ui/overlay/SortBy.hpp"
-#include "utils/FS.hpp"
+#include "utils/Image.hpp"
 #include "utils/Utils.hpp"
 
 // Play button dimensions
@@ -25,8 +27,25 @@ namespace Frame {
         this->titleH->setY(this->albumH->y());
         this->artistH->setY(this->albumH->y());
         this->lengthH->setY(this->albumH->y());
-        this->list->setY(this->list->y() + 80);
-        this->list->setH(this->list->h() - 80);
+
+        // Replace the list with one that only creates rows for the visible songs
+        this->songList = new CustomElm::VirtualList(this->list->x(), this->list->y() + 80, this->list->w(), this->list->h() - 80, 60);
+        this->songList->setScrollBarColour(this->app->theme()->muted2());
+        this->songList->setShowScrollBar(true);
+        this->songList->setCreateRowFunc([this]() -> Aether::Element * {
+            CustomElm::ListItem::Song * l = new CustomElm::ListItem::Song();
+            l->setLineColour(this->app->theme()->muted2());
+            l->setMoreColour(this->app->theme()->muted());
+            l->setTextColour(this->app->theme()->FG());
+            return l;
+        });
+        this->songList->setBindRowFunc([this](Aether::Element * e, size_t i) {
+            this->bindRow(e, i);
+        });
+        this->bottomContainer->removeElement(this->list);
+        this->list = nullptr;
+        this->bottomContainer->addElement(this->songList);
+        this->bottomContainer->setFocussed(this->songList);
 
         // First get metadata for the provided playlist
         this->metadata = this->app->database()->getPlaylistMetadataForID(id);
@@ -41,8 +60,7 @@ namespace Frame {
         }
 
         // Populate with Playlist's data
-        this->image = new Aether::Image(this->x() + 50, this->y() + 50, this->metadata.imagePath.empty() ? "romfs:/misc/noplaylist.png" : this->metadata.imagePath);
-        this->image->setWH(IMAGE_SIZE, IMAGE_SIZE);
+        this->image = new CustomElm::CachedImage(this->x() + 50, this->y() + 50, IMAGE_SIZE, IMAGE_SIZE, this->metadata.imagePath.empty() ? "romfs:/misc/noplaylist.png" : this->metadata.imagePath);
         this->addElement(this->image);
         this->heading->setString(this->metadata.name);
         this->heading->setX(image->x() + image->w() + 28);
@@ -112,7 +130,8 @@ namespace Frame {
         // Get a list of all file paths and make relative to root music folder
         Metadata::M3U::Playlist m3u;
         m3u.name = this->metadata.name;
-        for (const Metadata::PlaylistSong & meta : this->songs) {
+        std::vector<Metadata::PlaylistSong> songs = this->app->database()->getSongMetadataForPlaylist(this->metadata.ID, this->sortType);
+        for (const Metadata::PlaylistSong & meta : songs) {
             // I'm assuming it's always "/music/" here, so we remove the first 7 characters
             if (meta.song.path.length() > 7) {
                 m3u.paths.push_back(meta.song.path.substr(7, meta.song.path.length() - 7));
@@ -161,7 +180,7 @@ namespace Frame {
         if (this->songs.size() > 0) {
             std::vector<SongID> ids;
             for (size_t i = 0; i < this->songs.size(); i++) {
-                ids.push_back(this->songs[i].song.ID);
+                ids.push_back(this->songs[i].second);
             }
             this->playNewQueue(this->metadata.name, ids, (pos == std::numeric_limits<size_t>::max() ? 0 : pos), (pos == std::numeric_limits<size_t>::max()));
         }
@@ -171,7 +190,10 @@ namespace Frame {
         // Show number of songs and duration
         unsigned int total = 0;
         for (size_t i = 0; i < this->songs.size(); i++) {
-            total += this->songs[i].song.duration;
+            MetadataStore::Row row = this->store->row(this->songs[i].second);
+            if (row != MetadataStore::NoRow) {
+                total += this->store->duration(row);
+            }
         }
         std::string str = Utils::secondsToHoursMins(total);
         if (this->songs.size() == 1) {
@@ -185,11 +207,11 @@ namespace Frame {
         this->removeElement(this->emptyMsg);
         this->emptyMsg = nullptr;
         if (this->songs.size() == 0) {
-            this->emptyMsg = new Aether::Text(0, this->list->y() + this->list->h()*0.4, "Playlist.NoSongs"_lang, 24);
+            this->emptyMsg = new Aether::Text(0, this->songList->y() + this->songList->h()*0.4, "Playlist.NoSongs"_lang, 24);
             this->emptyMsg->setColour(this->app->theme()->FG());
             this->emptyMsg->setX(this->x() + (this->w() - emptyMsg->w())/2);
             this->addElement(this->emptyMsg);
-            this->list->setHidden(true);
+            this->songList->setHidden(true);
             this->setFocused(this->topContainer);
         }
     }
@@ -197,44 +219,37 @@ namespace Frame {
     void Playlist::refreshList(Database::SortBy sort) {
         this->sortType = sort;
 
-        // Create list elements for each song
-        this->elms.clear();
-        this->list->removeAllElements();
+        // Rows are only created for the visible songs, and their metadata is shared
         this->metadata = this->app->database()->getPlaylistMetadataForID(this->metadata.ID);
-        this->songs = this->app->database()->getSongMetadataForPlaylist(this->metadata.ID, sort);
-        if (this->songs.size() > 0) {
-            for (size_t i = 0; i < this->songs.size(); i++) {
-                CustomElm::ListItem::Song * l = new CustomElm::ListItem::Song();
-                l->setTitleString(this->songs[i].song.title);
-                l->setArtistString(this->songs[i].song.artist);
-                l->setAlbumString(this->songs[i].song.album);
-                l->setLengthString(Utils::secondsToHMS(this->songs[i].song.duration));
-                l->setLineColour(this->app->theme()->muted2());
-                l->setMoreColour(this->app->theme()->muted());
-                l->setTextColour(this->app->theme()->FG());
-                // Need to search for element as order is changed when a song is removed
-                l->setCallback([this, l](){
-                    std::vector<CustomElm::ListItem::Song *>::iterator it = std::find(this->elms.begin(), this->elms.end(), l);
-                    if (it != this->elms.end()) {
-                        this->playPlaylist(std::distance(this->elms.begin(), it));
-                    }
-                });
-                l->setMoreCallback([this, l]() {
-                    std::vector<CustomElm::ListItem::Song *>::iterator it = std::find(this->elms.begin(), this->elms.end(), l);
-                    if (it != this->elms.end()) {
-                        this->createSongMenu(std::distance(this->elms.begin(), it));
-                    }
-                });
-                this->list->addElement(l);
-                this->elms.push_back(l);
+        this->store = this->app->metadata();
+        this->songs = this->app->database()->getSongIDsForPlaylist(this->metadata.ID, sort);
+        this->songList->setCount(this->songs.size());
+        this->calculateStats();
+    }
 
-                if (i == 0) {
-                    l->setY(this->list->y() + 10);
-                }
-            }
+    void Playlist::bindRow(Aether::Element * e, size_t i) {
+        // Rows are rebound when a song is removed, so the index is always current
+        CustomElm::ListItem::Song * l = static_cast<CustomElm::ListItem::Song *>(e);
+        MetadataStore::Row row = this->store->row(this->songs[i].second);
+        if (row != MetadataStore::NoRow) {
+            l->setTitleString(this->store->title(row));
+            l->setArtistString(this->store->artist(row));
+            l->setAlbumString(this->store->album(row));
+            l->setLengthString(Utils::secondsToHMS(this->store->duration(row)));
+        } else {
+            // Clear the recycled row's strings if the song isn't in the metadata (e.g. it's since been removed)
+            l->setTitleString("");
+            l->setArtistString("");
+            l->setAlbumString("");
+            l->setLengthString(Utils::secondsToHMS(0));
         }
-
-        this->calculateStats();
+        l->setCallback([this, i](){
+            this->playPlaylist(i);
+        });
+        l->setMoreCallback([this, i]() {
+            this->createSongMenu(i);
+        });
+        l->refresh();
     }
 
     void Playlist::createDeleteMenu() {
@@ -251,7 +266,7 @@ namespace Frame {
 
             // Delete image and frame if succeeded
             if (ok) {
-                Utils::Fs::deleteFile(this->metadata.imagePath);
+                Utils::Image::deleteImage(this->metadata.imagePath);
                 this->goBack = true;
             }
         });
@@ -283,7 +298,7 @@ namespace Frame {
             b->setTextColour(this->app->theme()->FG());
             b->setCallback([this]() {
                 for (size_t i = 0; i < this->songs.size(); i++) {
-                    this->app->sysmodule()->sendAddToSubQueue(this->songs[i].song.ID);
+                    this->app->sysmodule()->sendAddToSubQueue(this->songs[i].second);
                 }
                 this->playlistMenu->close();
             });
@@ -299,7 +314,7 @@ namespace Frame {
                 this->showAddToPlaylist([this](PlaylistID i) {
                     if (i >= 0) {
                         for (size_t j = 0; j < this->songs.size(); j++) {
-                            this->app->database()->addSongToPlaylist(i, this->songs[j].song.ID);
+                            this->app->database()->addSongToPlaylist(i, this->songs[j].second);
                         }
                         this->playlistMenu->close();
 
@@ -366,11 +381,14 @@ namespace Frame {
         this->songMenu->addSeparator(this->app->theme()->muted2());
 
         // Song metadata
-        this->songMenu->setMainText(this->songs[pos].song.title);
-        this->songMenu->setSubText(this->songs[pos].song.artist);
-        AlbumID id = this->app->database()->getAlbumIDForSong(this->songs[pos].song.ID);
+        MetadataStore::Row row = this->store->row(this->songs[pos].second);
+        if (row != MetadataStore::NoRow) {
+            this->songMenu->setMainText(this->store->title(row));
+            this->songMenu->setSubText(this->store->artist(row));
+        }
+        AlbumID id = this->app->database()->getAlbumIDForSong(this->songs[pos].second);
         Metadata::Album md = this->app->database()->getAlbumMetadataForID(id);
-        this->songMenu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        this->songMenu->setImage(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -379,7 +397,7 @@ namespace Frame {
         b->setText("Common.AddToQueue"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->setCallback([this, pos]() {
-            this->app->sysmodule()->sendAddToSubQueue(this->songs[pos].song.ID);
+            this->app->sysmodule()->sendAddToSubQueue(this->songs[pos].second);
             this->songMenu->close();
         });
         this->songMenu->addButton(b);
@@ -393,7 +411,7 @@ namespace Frame {
         b->setCallback([this, pos]() {
             this->showAddToPlaylist([this, pos](PlaylistID i) {
                 if (i >= 0) {
-                    this->app->database()->addSongToPlaylist(i, this->songs[pos].song.ID);
+                    this->app->database()->addSongToPlaylist(i, this->songs[pos].second);
                     this->songMenu->close();
 
                     // Refresh the list if it's this playlist
@@ -414,14 +432,13 @@ namespace Frame {
         b->setCallback([this, pos]() {
             // Remove from database
             this->app->lockDatabase();
-            bool ok = this->app->database()->removeSongFromPlaylist(this->songs[pos].ID);
+            bool ok = this->app->database()->removeSongFromPlaylist(this->songs[pos].first);
             this->app->unlockDatabase();
 
             // Remove from lists
             if (ok) {
-                this->list->removeElement(this->elms[pos]);
-                this->elms.erase(this->elms.begin() + pos);
                 this->songs.erase(this->songs.begin() + pos);
+                this->songList->updateCount(this->songs.size());
                 this->calculateStats();
             }
             this->songMenu->close();
@@ -436,7 +453,7 @@ namespace Frame {
         b->setText("Common.GoToArtist"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->setCallback([this, pos]() {
-            ArtistID a = this->app->database()->getArtistIDForSong(this->songs[pos].song.ID);
+            ArtistID a = this->app->database()->getArtistIDForSong(this->songs[pos].second);
             if (a >= 0) {
                 this->changeFrame(Type::Artist, Action::Push, a);
             }
@@ -452,7 +469,7 @@ namespace Frame {
         b->setText("Common.ViewInformation"_lang);
         b->setTextColour(this->app->theme()->FG());
         b->setCallback([this, pos]() {
-            this->changeFrame(Type::SongInfo, Action::Push, this->songs[pos].song.ID);
+            this->changeFrame(Type::SongInfo, Action::Push, this->songs[pos].second);
             this->songMenu->close();
         });
         this->songMenu->addButton(b);
@@ -481,8 +498,7 @@ namespace Frame {
             Metadata::Playlist m = this->app->database()->getPlaylistMetadataForID(this->metadata.ID);
             if (m.imagePath != this->metadata.imagePath) {
                 this->removeElement(this->image);
-                this->image = new Aether::Image(this->x() + 50, this->y() + 50, m.imagePath.empty() ? "romfs:/misc/noplaylist.png" : m.imagePath);
-                this->image->setWH(IMAGE_SIZE, IMAGE_SIZE);
+                this->image = new CustomElm::CachedImage(this->x() + 50, this->y() + 50, IMAGE_SIZE, IMAGE_SIZE, m.imagePath.empty() ? "romfs:/misc/noplaylist.png" : m.imagePath);
                 this->addElement(this->image);
             }
             this->heading->setString(m.name);
@@ -7,6 +7,7 @@
 #include "ui/overlay/FileBrowser.hpp"
 #include "utils/FS.hpp"
 #include "utils/Image.hpp"
+#include "utils/TextureCache.hpp"
 #include "utils/Utils.hpp"
 
 // Default path for file browser
@@ -218,13 +219,16 @@ namespace Frame {
             if (!this->newImagePath.empty()) {
                 Utils::Fs::readFile(this->newImagePath, this->dlBuffer);
             }
-            bool resized = Utils::Image::resize(this->dlBuffer, 400, 400);
+            bool resized = Utils::Image::resize(this->dlBuffer, 400, 400, Utils::Image::Filter::Quality);
             if (!resized) {
                 Log::writeWarning("[META] Couldn't resize playlist image, saving with original dimensions");
             }
 
-            // Write (hopefully resized) to file
-            Utils::Fs::writeFile(this->metadata.imagePath, this->dlBuffer);
+            // Write (hopefully resized) to file along with smaller copies
+            if (Utils::Fs::writeFile(this->metadata.imagePath, this->dlBuffer)) {
+                Utils::Image::writeThumbnails(this->dlBuffer, this->metadata.imagePath);
+                Utils::TextureCache::invalidate(this->metadata.imagePath);
+            }
         }
 
         // Commit changes to db (acquires lock and then writes)
@@ -235,10 +239,10 @@ namespace Frame {
         // Delete image if everything succeeded, revert copied image on an error
         if (this->updateImage) {
             if (ok && !oldPath.empty()) {
-                Utils::Fs::deleteFile(oldPath);
+                Utils::Image::deleteImage(oldPath);
 
             } else if (!ok && !this->metadata.imagePath.empty()) {
-                Utils::Fs::deleteFile(this->metadata.imagePath);
+                Utils::Image::deleteImage(this->metadata.imagePath);
             }
         }
 
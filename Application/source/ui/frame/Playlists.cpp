@@ -174,7 +174,7 @@ namespace Frame {
 
             // Remove image and item from list if succeeded
             if (ok) {
-                Utils::Fs::deleteFile(this->items[pos].meta.imagePath);
+                Utils::Image::deleteImage(this->items[pos].meta.imagePath);
                 this->list->removeElement(this->items[pos].elm);
                 this->items.erase(this->items.begin() + pos);
                 if (this->items.empty()) {
@@ -229,7 +229,7 @@ namespace Frame {
         this->menu->addSeparator(this->app->theme()->muted2());
 
         // Set playlist specific things
-        this->menu->setImage(new Aether::Image(0, 0, this->items[pos].meta.imagePath.empty() ? "romfs:/misc/noplaylist.png" : this->items[pos].meta.imagePath));
+        this->menu->setImage(this->items[pos].meta.imagePath.empty() ? "romfs:/misc/noplaylist.png" : this->items[pos].meta.imagePath);
         this->menu->setMainText(this->items[pos].meta.name);
         std::string str = (this->items[pos].meta.songCount == 1 ? "Common.Song"_lang : Utils::substituteTokens("Common.Songs"_lang, std::to_string(this->items[pos].meta.songCount)));
         this->menu->setSubText(str);
@@ -542,7 +542,9 @@ namespace Frame {
                 std::vector<unsigned char> buffer;
                 Utils::Fs::readFile(src, buffer);
                 Utils::Image::resize(buffer, 400, 400);
-                Utils::Fs::writeFile(this->newData.imagePath, buffer);
+                if (Utils::Fs::writeFile(this->newData.imagePath, buffer)) {
+                    Utils::Image::writeThumbnails(buffer, this->newData.imagePath);
+                }
             }
             // Completely recreate list
             this->refreshList(this->sortType);
@@ -9,21 +9,18 @@
 #include "utils/Utils.hpp"
 
 // Helper function returning length of songs in queue in seconds
-unsigned int durationOfQueue(std::vector<SongID> & queue, std::vector<Metadata::Song> & songMeta) {
+unsigned int durationOfQueue(std::vector<SongID> & queue, const MetadataStore & store) {
     unsigned int total = 0;
 
     // Get info for each song and sum up
     for (size_t i = 0; i < queue.size(); i++) {
-        // I can't think of a case where the same metadata would be in there twice
-        std::vector<Metadata::Song>::iterator it = std::lower_bound(songMeta.begin(), songMeta.end(), queue[i], [](const Metadata::Song info, const SongID id) {
-            return info.ID < id;
-        });
-        if (it == songMeta.end()) {
+        MetadataStore::Row row = store.row(queue[i]);
+        if (row == MetadataStore::NoRow) {
             // If not found don't add
             continue;
         }
 
-        total += (*it).duration;
+        total += store.duration(row);
     }
 
     return total;
@@ -35,11 +32,8 @@ namespace Frame {
         this->sort->setHidden(true);
         this->topContainer->setHasSelectable(false);
 
-        // Get sorted list of metadata (faster than iterating per song)
-        this->songMeta = this->app->database()->getAllSongMetadata(Database::SortBy::TitleAsc);
-        std::sort(this->songMeta.begin(), this->songMeta.end(), [](const Metadata::Song lhs, const Metadata::Song rhs) {
-            return lhs.ID < rhs.ID;
-        });
+        // Use the shared metadata (faster than querying per song)
+        this->songMeta = this->app->metadata();
 
         this->cachedSongID = -1;
         this->emptyMsg = nullptr;
@@ -241,7 +235,7 @@ namespace Frame {
 
         // Update length + track strings
         std::vector<SongID> tmp = {this->cachedSongID};
-        unsigned int totalSecs = durationOfQueue(this->cachedQueue, this->songMeta) + durationOfQueue(this->cachedSubQueue, this->songMeta) + durationOfQueue(tmp, this->songMeta);
+        unsigned int totalSecs = durationOfQueue(this->cachedQueue, *this->songMeta) + durationOfQueue(this->cachedSubQueue, *this->songMeta) + durationOfQueue(tmp, *this->songMeta);
         unsigned int totalTracks = this->cachedQueue.size() + this->cachedSubQueue.size() + 1;  // Plus 1 for playing song
         if (totalTracks == 1) {
             this->subHeading->setString(Utils::substituteTokens("Queue.CountOne"_lang, Utils::secondsToHoursMins(totalSecs)));
@@ -251,22 +245,17 @@ namespace Frame {
     }
 
     CustomElm::ListItem::Song * Queue::getListSong(size_t id, Section sec) {
-        // Get info for song (will be blank if not found)
-        Metadata::Song m;
-        // I can't think of a case where the same metadata would be in there twice
-        std::vector<Metadata::Song>::iterator it = std::lower_bound(this->songMeta.begin(), this->songMeta.end(), id, [](const Metadata::Song info, const SongID id) {
-            return info.ID < id;
-        });
-        if (it != this->songMeta.end()) {
-            m = *(it);
-        }
-
-        // Create element
+        // Create element (will be blank if not found)
         CustomElm::ListItem::Song * l = new CustomElm::ListItem::Song();
-        l->setTitleString(m.title);
-        l->setArtistString(m.artist);
-        l->setAlbumString(m.album);
-        l->setLengthString(Utils::secondsToHMS(m.duration));
+        MetadataStore::Row row = this->songMeta->row(id);
+        if (row != MetadataStore::NoRow) {
+            l->setTitleString(this->songMeta->title(row));
+            l->setArtistString(this->songMeta->artist(row));
+            l->setAlbumString(this->songMeta->album(row));
+            l->setLengthString(Utils::secondsToHMS(this->songMeta->duration(row)));
+        } else {
+            l->setLengthString(Utils::secondsToHMS(0));
+        }
         l->setLineColour(this->app->theme()->muted2());
         l->setMoreColour(this->app->theme()->muted());
         l->setTextColour(this->app->theme()->FG());
@@ -333,7 +322,7 @@ namespace Frame {
         this->menu->setSubText(m.artist);
         AlbumID aID = this->app->database()->getAlbumIDForSong(m.ID);
         Metadata::Album md = this->app->database()->getAlbumMetadataForID(aID);
-        this->menu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        this->menu->setImage(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
 
         // Remove from Queue (if not playing)
         CustomElm::MenuButton * b;
@@ -1,14 +1,20 @@
 #include "Application.hpp"
 #include "lang/Lang.hpp"
+#include "Log.hpp"
 #include "Paths.hpp"
 #include "ui/element/GridItem.hpp"
 #include "ui/element/HorizontalList.hpp"
 #include "ui/element/ListHeadingCount.hpp"
 #include "ui/element/listitem/Song.hpp"
 #include "ui/frame/Search.hpp"
+#include "utils/LRUCache.hpp"
 #include "utils/NX.hpp"
+#include "utils/Timer.hpp"
 #include "utils/Utils.hpp"
 
+// Number of recent queries to keep results for
+#define CACHE_SIZE 8
+
 // Keyboard config (see utils/NX.hpp)
 static struct Utils::NX::Keyboard keyboard = {
     "",             // buffer
@@ -19,6 +25,13 @@ static struct Utils::NX::Keyboard keyboard = {
     ""              // subheading
 };
 
+// Results of recent searches (shared between all search frames)
+static Utils::LRUCache<std::string, Frame::Search::Results> cache(CACHE_SIZE);
+static std::mutex cacheMutex;
+
+// Incremented each time a search is started, which causes any older searches to stop
+static std::atomic<unsigned int> latestGeneration = 0;
+
 namespace Frame {
     Search::Search(Main::Application * a) : Frame(a) {
         // Hide everything
@@ -33,6 +46,9 @@ namespace Frame {
         this->menu = nullptr;
         this->searchContainer = nullptr;
         this->heading->setString("Search.ResultsEmpty"_lang);
+        this->listEmpty = true;
+        this->cancelled = false;
+        this->generation = ++latestGeneration;
 
         // Get input first
         keyboard.heading = "Search.Search"_lang;
@@ -46,19 +62,25 @@ namespace Frame {
             return;
         }
 
-        // Search the database and populate the list!
+        // Search the database on another thread, results are added to the list as they come in
         std::string copy = keyboard.buffer;
         this->threadDone = false;
         this->showSearching();
-        this->searchThread = std::async(std::launch::async, [this, copy]() -> bool {
+        this->searchThread = std::async(std::launch::async, [this, copy]() {
             Utils::NX::setCPUBoost(true);
-            bool ok = this->searchDatabase(copy);
+            this->searchDatabase(copy);
             Utils::NX::setCPUBoost(false);
-            return ok;
         });
     }
 
-    void Search::addEntries() {
+    void Search::prepareList() {
+        // Only needs to be done once (when the searching animation is removed)
+        if (this->searchContainer == nullptr) {
+            return;
+        }
+        this->removeElement(this->searchContainer);
+        this->searchContainer = nullptr;
+
         // Set heading and position
         this->heading->setString(Utils::substituteTokens("Search.Results"_lang, keyboard.buffer));
         int maxW = (this->w() - (this->heading->x() - this->x())*2);
@@ -70,24 +92,15 @@ namespace Frame {
         }
 
         // Position the list
-        this->listEmpty = true;
         this->list->setY(this->heading->y() + this->heading->h() + (this->heading->y() - this->y()));
         this->list->setH(this->h() - this->list->y());
+    }
 
-        // Show message if no results found
-        if (this->playlists.empty() && this->artists.empty() && this->albums.empty() && this->songs.empty()) {
-            Aether::Text * text = new Aether::Text(this->x() + this->w()/2, this->y() + this->h()/2, "Search.NoResults"_lang, 26);
-            text->setX(text->x() - text->w()/2);
-            text->setColour(this->app->theme()->FG());
-            this->addElement(text);
-            return;
-        }
-
-        // Add elements to list
-        this->addPlaylists();
-        this->addArtists();
-        this->addAlbums();
-        this->addSongs();
+    void Search::showNoResults() {
+        Aether::Text * text = new Aether::Text(this->x() + this->w()/2, this->y() + this->h()/2, "Search.NoResults"_lang, 26);
+        text->setX(text->x() - text->w()/2);
+        text->setColour(this->app->theme()->FG());
+        this->addElement(text);
     }
 
     void Search::addPlaylists() {
@@ -261,24 +274,118 @@ namespace Frame {
         this->songs.clear();
     }
 
-    bool Search::searchDatabase(const std::string & phrase) {
-        // Ensure the database is up to date
+    bool Search::isStale() {
+        return (this->cancelled || this->generation != latestGeneration);
+    }
+
+    void Search::publishStage(const Stage stage) {
+        std::scoped_lock<std::mutex> mtx(this->pendingMutex);
+        this->pendingStages.push_back(stage);
+    }
+
+    void Search::searchDatabase(const std::string phrase) {
+        Utils::Timer timer = Utils::Timer();
+        Utils::Timer total = Utils::Timer();
+        total.start();
+
+        // Ensure the database is up to date (any cached results are now stale)
         if (this->app->database()->needsSearchUpdate()) {
+            timer.start();
             this->app->lockDatabase();
             bool ok = this->app->database()->prepareSearch();
             this->app->unlockDatabase();
+            timer.stop();
 
+            std::scoped_lock<std::mutex> mtx(cacheMutex);
+            cache.clear();
             if (!ok) {
-                return false;
+                this->publishStage(Stage::Error);
+                return;
             }
+            Log::writeInfo("[SEARCH] Updated search tables in " + std::to_string((int)timer.elapsedMillis()) + "ms");
         }
 
-        // Search for each type of entry and return
-        this->playlists = this->app->database()->searchPlaylists(phrase, this->app->config()->searchMaxPlaylists());
-        this->artists = this->app->database()->searchArtists(phrase, this->app->config()->searchMaxArtists());
-        this->albums = this->app->database()->searchAlbums(phrase, this->app->config()->searchMaxAlbums());
-        this->songs = this->app->database()->searchSongs(phrase, this->app->config()->searchMaxSongs());
-        return true;
+        // Results depend on the limits too, so they form part of the key
+        Config * config = this->app->config();
+        std::string key = phrase + "\n" + std::to_string(config->searchMaxSongs()) + "," + std::to_string(config->searchMaxAlbums()) + "," + std::to_string(config->searchMaxArtists()) + "," + std::to_string(config->searchMaxPlaylists());
+
+        // Use cached results if we've searched this recently
+        Results results;
+        bool cached;
+        {
+            std::scoped_lock<std::mutex> mtx(cacheMutex);
+            cached = cache.get(key, results);
+        }
+        if (cached) {
+            std::scoped_lock<std::mutex> mtx(this->pendingMutex);
+            this->pending = results;
+            this->pendingStages.insert(this->pendingStages.end(), {Stage::Songs, Stage::Albums, Stage::Artists, Stage::Playlists, Stage::Done});
+            Log::writeInfo("[SEARCH] Using cached results for '" + phrase + "'");
+            return;
+        }
+
+        // Search for each type of entry, handing each to the UI thread once found
+        // The search is abandoned between stages if it's no longer wanted
+        if (this->isStale()) {
+            return;
+        }
+        timer.start();
+        results.songs = this->app->database()->searchSongs(phrase, config->searchMaxSongs());
+        timer.stop();
+        Log::writeInfo("[SEARCH] Found " + std::to_string(results.songs.size()) + " songs in " + std::to_string((int)timer.elapsedMillis()) + "ms");
+        {
+            std::scoped_lock<std::mutex> mtx(this->pendingMutex);
+            this->pending.songs = results.songs;
+            this->pendingStages.push_back(Stage::Songs);
+        }
+
+        if (this->isStale()) {
+            return;
+        }
+        timer.start();
+        results.albums = this->app->database()->searchAlbums(phrase, config->searchMaxAlbums());
+        timer.stop();
+        Log::writeInfo("[SEARCH] Found " + std::to_string(results.albums.size()) + " albums in " + std::to_string((int)timer.elapsedMillis()) + "ms");
+        {
+            std::scoped_lock<std::mutex> mtx(this->pendingMutex);
+            this->pending.albums = results.albums;
+            this->pendingStages.push_back(Stage::Albums);
+        }
+
+        if (this->isStale()) {
+            return;
+        }
+        timer.start();
+        results.artists = this->app->database()->searchArtists(phrase, config->searchMaxArtists());
+        timer.stop();
+        Log::writeInfo("[SEARCH] Found " + std::to_string(results.artists.size()) + " artists in " + std::to_string((int)timer.elapsedMillis()) + "ms");
+        {
+            std::scoped_lock<std::mutex> mtx(this->pendingMutex);
+            this->pending.artists = results.artists;
+            this->pendingStages.push_back(Stage::Artists);
+        }
+
+        if (this->isStale()) {
+            return;
+        }
+        timer.start();
+        results.playlists = this->app->database()->searchPlaylists(phrase, config->searchMaxPlaylists());
+        timer.stop();
+        Log::writeInfo("[SEARCH] Found " + std::to_string(results.playlists.size()) + " playlists in " + std::to_string((int)timer.elapsedMillis()) + "ms");
+        {
+            std::scoped_lock<std::mutex> mtx(this->pendingMutex);
+            this->pending.playlists = results.playlists;
+            this->pendingStages.push_back(Stage::Playlists);
+        }
+
+        // Remember these results for next time
+        {
+            std::scoped_lock<std::mutex> mtx(cacheMutex);
+            cache.put(key, results);
+        }
+        total.stop();
+        Log::writeInfo("[SEARCH] Search for '" + phrase + "' completed in " + std::to_string((int)total.elapsedMillis()) + "ms");
+        this->publishStage(Stage::Done);
     }
 
     void Search::showError(const std::string & message) {
@@ -337,7 +444,7 @@ namespace Frame {
 
         // Set playlist specific things
         Metadata::Playlist m = this->app->database()->getPlaylistMetadataForID(id);
-        this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? "romfs:/misc/noplaylist.png" : m.imagePath));
+        this->menu->setImage(m.imagePath.empty() ? "romfs:/misc/noplaylist.png" : m.imagePath);
         this->menu->setMainText(m.name);
         std::string str = (m.songCount == 1 ? "Common.Song"_lang : Utils::substituteTokens("Common.Songs"_lang, std::to_string(m.songCount)));
         this->menu->setSubText(str);
@@ -419,7 +526,7 @@ namespace Frame {
 
         // Set artist specific things
         Metadata::Artist m = this->app->database()->getArtistMetadataForID(id);
-        this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? "romfs:/misc/noartist.png" : m.imagePath));
+        this->menu->setImage(m.imagePath.empty() ? "romfs:/misc/noartist.png" : m.imagePath);
         this->menu->setMainText(m.name);
         std::string str;
         if (m.albumCount == 1 && m.songCount == 1) {
@@ -510,7 +617,7 @@ namespace Frame {
 
         // Album metadata
         Metadata::Album m = this->app->database()->getAlbumMetadataForID(id);
-        this->menu->setImage(new Aether::Image(0, 0, m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath));
+        this->menu->setImage(m.imagePath.empty() ? Path::App::DefaultArtFile : m.imagePath);
         this->menu->setMainText(m.name);
         this->menu->setSubText(m.artist);
 
@@ -615,7 +722,7 @@ namespace Frame {
         this->menu->setSubText(m.artist);
         AlbumID aID = this->app->database()->getAlbumIDForSong(m.ID);
         Metadata::Album md = this->app->database()->getAlbumMetadataForID(aID);
-        this->menu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        this->menu->setImage(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -720,17 +827,76 @@ namespace Frame {
     }
 
     void Search::update(uint32_t dt) {
-        // Wait until the thread is finished and update frame
+        // Add any categories that have been found since the last update
         if (!this->threadDone) {
-            if (this->searchThread.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-                bool result = this->searchThread.get();
-                if (!result) {
-                    this->showError("Search.SearchError"_lang);
-                } else {
-                    this->removeElement(this->searchContainer);
-                    this->addEntries();
+            std::vector<Stage> stages;
+            {
+                std::scoped_lock<std::mutex> mtx(this->pendingMutex);
+                stages.swap(this->pendingStages);
+                for (const Stage stage : stages) {
+                    switch (stage) {
+                        case Stage::Songs:
+                            this->songs = std::move(this->pending.songs);
+                            break;
+
+                        case Stage::Albums:
+                            this->albums = std::move(this->pending.albums);
+                            break;
+
+                        case Stage::Artists:
+                            this->artists = std::move(this->pending.artists);
+                            break;
+
+                        case Stage::Playlists:
+                            this->playlists = std::move(this->pending.playlists);
+                            break;
+
+                        default:
+                            break;
+                    }
+                }
+            }
+
+            // Only set up the list once there's something to show
+            if (!(this->songs.empty() && this->albums.empty() && this->artists.empty() && this->playlists.empty())) {
+                this->prepareList();
+            }
+
+            for (const Stage stage : stages) {
+                switch (stage) {
+                    case Stage::Songs:
+                        this->addSongs();
+                        break;
+
+                    case Stage::Albums:
+                        this->addAlbums();
+                        break;
+
+                    case Stage::Artists:
+                        this->addArtists();
+                        break;
+
+                    case Stage::Playlists:
+                        this->addPlaylists();
+                        break;
+
+                    case Stage::Done:
+                        if (this->listEmpty) {
+                            this->prepareList();
+                            this->showNoResults();
+                        }
+                        this->threadDone = true;
+                        break;
+
+                    case Stage::Error:
+                        if (this->searchContainer != nullptr) {
+                            this->removeElement(this->searchContainer);
+                            this->searchContainer = nullptr;
+                        }
+                        this->showError("Search.SearchError"_lang);
+                        this->threadDone = true;
+                        break;
                 }
-                this->threadDone = true;
             }
         }
 
@@ -738,6 +904,12 @@ namespace Frame {
     }
 
     Search::~Search() {
+        // Stop the search at the next stage and wait for it to finish
+        this->cancelled = true;
+        if (this->searchThread.valid()) {
+            this->searchThread.wait();
+        }
+
         delete this->artistsList;
         delete this->menu;
     }
@@ -2,6 +2,7 @@
 #include "lang/Lang.hpp"
 #include "Paths.hpp"
 #include "ui/element/listitem/Song.hpp"
+#include "ui/element/VirtualList.hpp"
 #include "ui/frame/Songs.hpp"
 #include "ui/overlay/ItemMenu.hpp"
 #include "ui/overlay/SortBy.hpp"
@@ -10,6 +11,26 @@
 namespace Frame {
     Songs::Songs(Main::Application * a) : Frame(a) {
         this->heading->setString("Song.Songs"_lang);
+        this->emptyMsg = nullptr;
+
+        // Replace the list with one that only creates rows for the visible songs
+        this->songList = new CustomElm::VirtualList(this->list->x(), this->list->y(), this->list->w(), this->list->h(), 60);
+        this->songList->setScrollBarColour(this->app->theme()->muted2());
+        this->songList->setShowScrollBar(true);
+        this->songList->setCreateRowFunc([this]() -> Aether::Element * {
+            CustomElm::ListItem::Song * l = new CustomElm::ListItem::Song();
+            l->setLineColour(this->app->theme()->muted2());
+            l->setMoreColour(this->app->theme()->muted());
+            l->setTextColour(this->app->theme()->FG());
+            return l;
+        });
+        this->songList->setBindRowFunc([this](Aether::Element * e, size_t i) {
+            this->bindRow(e, i);
+        });
+        this->bottomContainer->removeElement(this->list);
+        this->list = nullptr;
+        this->bottomContainer->addElement(this->songList);
+        this->bottomContainer->setFocussed(this->songList);
         this->createList(Database::SortBy::TitleAsc);
 
         // Set up sort overlay
@@ -35,60 +56,68 @@ namespace Frame {
         this->menu = nullptr;
     }
 
-    void Songs::createList(Database::SortBy sort) {
-        // Remove old items
-        this->list->removeAllElements();
-        this->songIDs.clear();
+    void Songs::createList(Database::SortBy sort, const bool keepPosition) {
+        this->sortType = sort;
+        if (this->emptyMsg != nullptr) {
+            this->removeElement(this->emptyMsg);
+            this->emptyMsg = nullptr;
+        }
+        this->songList->setHidden(false);
+        this->subHeading->setHidden(false);
 
-        // Create items for songs
-        unsigned int totalSecs = 0;
-        std::vector<Metadata::Song> m = this->app->database()->getAllSongMetadata(sort);
-        if (m.size() > 0) {
-            for (size_t i = 0; i < m.size(); i++) {
-                this->songIDs.push_back(m[i].ID);
-                totalSecs += m[i].duration;
-                CustomElm::ListItem::Song * l = new CustomElm::ListItem::Song();
-                l->setTitleString(m[i].title);
-                l->setArtistString(m[i].artist);
-                l->setAlbumString(m[i].album);
-                l->setLengthString(Utils::secondsToHMS(m[i].duration));
-                l->setLineColour(this->app->theme()->muted2());
-                l->setMoreColour(this->app->theme()->muted());
-                l->setTextColour(this->app->theme()->FG());
-                l->setCallback([this, i](){
-                    this->playNewQueue("Song.YourSongs"_lang, this->songIDs, i, false);
-                });
-                SongID id = m[i].ID;
-                l->setMoreCallback([this, id]() {
-                    this->createMenu(id);
-                });
-                this->list->addElement(l);
-
-                if (i == 0) {
-                    l->setY(this->list->y() + 10);
-                }
-            }
+        // Rows are only created for the visible songs, so just use the shared metadata
+        this->store = this->app->metadata();
+        this->rows = this->store->order(sort);
+        this->songIDs.clear();
+        this->songIDs.reserve(this->rows.size());
+        for (const MetadataStore::Row row : this->rows) {
+            this->songIDs.push_back(this->store->id(row));
+        }
+        if (keepPosition) {
+            this->songList->updateCount(this->rows.size());
+        } else {
+            this->songList->setCount(this->rows.size());
+        }
 
+        if (this->rows.size() > 0) {
             // Set subheading
             std::string str;
-            if (m.size() == 1) {
+            unsigned int totalSecs = this->store->totalDuration();
+            if (this->rows.size() == 1) {
                 str = Utils::substituteTokens("Song.DetailsOne"_lang, Utils::secondsToHoursMins(totalSecs));
             } else {
-                str = Utils::substituteTokens("Song.DetailsMany"_lang, std::to_string(m.size()), Utils::secondsToHoursMins(totalSecs));
+                str = Utils::substituteTokens("Song.DetailsMany"_lang, std::to_string(this->rows.size()), Utils::secondsToHoursMins(totalSecs));
             }
             this->subHeading->setString(str);
 
         // Show message if no songs
         } else {
-            this->list->setHidden(true);
+            this->songList->setHidden(true);
             this->subHeading->setHidden(true);
-            Aether::Text * emptyMsg = new Aether::Text(0, this->list->y() + this->list->h()*0.4, "Song.NotFound"_lang, 24);
-            emptyMsg->setColour(this->app->theme()->FG());
-            emptyMsg->setX(this->x() + (this->w() - emptyMsg->w())/2);
-            this->addElement(emptyMsg);
+            this->emptyMsg = new Aether::Text(0, this->songList->y() + this->songList->h()*0.4, "Song.NotFound"_lang, 24);
+            this->emptyMsg->setColour(this->app->theme()->FG());
+            this->emptyMsg->setX(this->x() + (this->w() - this->emptyMsg->w())/2);
+            this->addElement(this->emptyMsg);
         }
     }
 
+    void Songs::bindRow(Aether::Element * e, size_t i) {
+        CustomElm::ListItem::Song * l = static_cast<CustomElm::ListItem::Song *>(e);
+        MetadataStore::Row row = this->rows[i];
+        l->setTitleString(this->store->title(row));
+        l->setArtistString(this->store->artist(row));
+        l->setAlbumString(this->store->album(row));
+        l->setLengthString(Utils::secondsToHMS(this->store->duration(row)));
+        l->setCallback([this, i](){
+            this->playNewQueue("Song.YourSongs"_lang, this->songIDs, i, false);
+        });
+        SongID id = this->store->id(row);
+        l->setMoreCallback([this, id]() {
+            this->createMenu(id);
+        });
+        l->refresh();
+    }
+
     void Songs::createMenu(SongID id) {
         // Create menu
         delete this->menu;
@@ -104,7 +133,7 @@ namespace Frame {
         this->menu->setSubText(m.artist);
         AlbumID aID = this->app->database()->getAlbumIDForSong(m.ID);
         Metadata::Album md = this->app->database()->getAlbumMetadataForID(aID);
-        this->menu->setImage(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+        this->menu->setImage(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
 
         // Add to Queue
         CustomElm::MenuButton * b = new CustomElm::MenuButton();
@@ -183,6 +212,15 @@ namespace Frame {
         this->app->addOverlay(this->menu);
     }
 
+    void Songs::update(uint32_t dt) {
+        // Keep the user's place when the shared metadata is replaced (i.e. songs are added by a scan)
+        if (this->app->metadata() != this->store) {
+            this->createList(this->sortType, true);
+        }
+
+        Frame::update(dt);
+    }
+
     Songs::~Songs() {
         delete this->menu;
         delete this->sortMenu;
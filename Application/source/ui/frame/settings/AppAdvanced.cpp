@@ -3,6 +3,9 @@
 #include "lang/Lang.hpp"
 #include "ui/frame/settings/AppAdvanced.hpp"
 #include "utils/FS.hpp"
+#include "utils/Image.hpp"
+#include "utils/TextureCache.hpp"
+#include "utils/Utils.hpp"
 
 namespace Frame::Settings {
     AppAdvanced::AppAdvanced(Main::Application * a) : Frame(a) {
@@ -26,6 +29,31 @@ namespace Frame::Settings {
         this->addComment("Settings.AppAdvanced.RemoveUnneededImagesText"_lang);
         this->list->addElement(new Aether::ListSeparator());
 
+        // Advanced::image_cache_size
+        opt = new Aether::ListOption("Settings.AppAdvanced.ImageCacheSize"_lang, std::to_string(cfg->imageCacheSize()), nullptr);
+        opt->setCallback([this, cfg, opt]() {
+            int val = cfg->imageCacheSize();
+            if (this->getNumberInput(val, "Settings.AppAdvanced.ImageCacheSize"_lang, "", false)) {
+                val = (val < 8 ? 8 : (val > 256 ? 256 : val));
+                if (cfg->setImageCacheSize(val)) {
+                    opt->setValue(std::to_string(val));
+                    Utils::TextureCache::setBudget(val * 1024 * 1024);
+                }
+            }
+        });
+        opt->setColours(this->app->theme()->muted2(), this->app->theme()->FG(), this->app->theme()->accent());
+        this->list->addElement(opt);
+        this->addComment("Settings.AppAdvanced.ImageCacheSizeText"_lang);
+
+        // Image cache counters (pressing refreshes them)
+        opt = new Aether::ListOption("Settings.AppAdvanced.ImageCacheUsage"_lang, this->imageCacheStats(), nullptr);
+        opt->setCallback([this, opt]() {
+            opt->setValue(this->imageCacheStats());
+        });
+        opt->setColours(this->app->theme()->muted2(), this->app->theme()->FG(), this->app->theme()->accent());
+        this->list->addElement(opt);
+        this->list->addElement(new Aether::ListSeparator());
+
         // Advanced::set_queue_max
         opt = new Aether::ListOption("Settings.AppAdvanced.InitialQueueSize"_lang, std::to_string(cfg->setQueueMax()), nullptr);
         opt->setCallback([this, cfg, opt]() {
@@ -76,6 +104,11 @@ namespace Frame::Settings {
         this->addComment("Settings.AppAdvanced.MaximumSearchScoreText"_lang);
     }
 
+    std::string AppAdvanced::imageCacheStats() {
+        Utils::TextureCache::Stats stats = Utils::TextureCache::stats();
+        return Utils::substituteTokens("Settings.AppAdvanced.ImageCacheUsageValue"_lang, Utils::truncateToDecimalPlace(std::to_string(stats.bytes / (1024.0 * 1024.0)), 1), std::to_string(stats.budget / (1024 * 1024)), std::to_string(stats.hits), std::to_string(stats.misses));
+    }
+
     void AppAdvanced::removeImages() {
         // Get list of all images referenced in database (returned in order)
         bool ok;
@@ -84,6 +117,14 @@ namespace Frame::Settings {
             return;
         }
 
+        // Keep the smaller copies of each image too
+        size_t count = dbFiles.size();
+        for (size_t i = 0; i < count; i++) {
+            std::vector<std::string> thumbs = Utils::Image::thumbnailPaths(dbFiles[i]);
+            dbFiles.insert(dbFiles.end(), thumbs.begin(), thumbs.end());
+        }
+        std::sort(dbFiles.begin(), dbFiles.end());
+
         // Get list of all files in folder
         std::vector<std::string> folderFiles;
         for (auto & entry: std::filesystem::recursive_directory_iterator("/switch/TriPlayer/images/")) {
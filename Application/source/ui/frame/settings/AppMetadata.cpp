@@ -5,6 +5,7 @@
 #include "ui/overlay/ProgressBox.hpp"
 #include "utils/FS.hpp"
 #include "utils/Image.hpp"
+#include "utils/Splash.hpp"
 #include "meta/Metadata.hpp"
 #include "utils/Utils.hpp"
 
@@ -23,10 +24,17 @@ namespace Frame::Settings {
 
         // Scan now
         this->addButton("Settings.AppMetadata.ScanNow"_lang, [this]() {
+            this->app->startLibraryScan();
             this->app->popScreen();
-            this->app->setScreen(Main::ScreenID::Splash);
         });
         this->addComment("Settings.AppMetadata.ScanNowText"_lang);
+
+        // Full scan
+        this->addButton("Settings.AppMetadata.FullScan"_lang, [this]() {
+            this->app->startLibraryScan(true);
+            this->app->popScreen();
+        });
+        this->addComment("Settings.AppMetadata.FullScanText"_lang);
         this->list->addElement(new Aether::ListSeparator());
 
         // Search for images
@@ -122,12 +130,20 @@ namespace Frame::Settings {
                 if (!Utils::Fs::writeFile(filename, buffer)) {
                     continue;
                 }
+                Utils::Image::writeThumbnails(buffer, filename);
 
                 // Update database, deleting file if an error occurs
                 albums[i].tadbID = id;
                 albums[i].imagePath = filename;
                 if (!this->app->database()->updateAlbum(albums[i])) {
-                    Utils::Fs::deleteFile(filename);
+                    Utils::Image::deleteImage(filename);
+                    continue;
+                }
+
+                // Pick a palette for the player now the smaller copies exist
+                Utils::Splash::Palette palette = Utils::Splash::getPaletteForImage(filename);
+                if (!palette.invalid) {
+                    this->app->database()->setAlbumPaletteForImage(filename, Utils::Splash::packPalette(palette));
                 }
             }
         }
@@ -170,12 +186,13 @@ namespace Frame::Settings {
                 if (!Utils::Fs::writeFile(filename, buffer)) {
                     continue;
                 }
+                Utils::Image::writeThumbnails(buffer, filename);
 
                 // Update database, deleting file if an error occurs
                 artists[i].tadbID = id;
                 artists[i].imagePath = filename;
                 if (!this->app->database()->updateArtist(artists[i])) {
-                    Utils::Fs::deleteFile(filename);
+                    Utils::Image::deleteImage(filename);
                 }
             }
         }
@@ -32,17 +32,15 @@ namespace Frame::Settings {
         // General::pause_on_sleep
         this->addToggle("Settings.SysGeneral.PauseOnSleep"_lang, [cfg]() -> bool {
             return cfg->sysPauseOnSleep();
-        }, [this, cfg](bool b) {
+        }, [cfg](bool b) {
             cfg->setSysPauseOnSleep(b);
-            this->app->sysmodule()->sendReloadConfig();
         });
 
         // General::pause_on_unplug
         this->addToggle("Settings.SysGeneral.PauseOnUnplug"_lang, [cfg]() -> bool {
             return cfg->sysPauseOnUnplug();
-        }, [this, cfg](bool b) {
+        }, [cfg](bool b) {
             cfg->setSysPauseOnUnplug(b);
-            this->app->sysmodule()->sendReloadConfig();
         });
         this->addComment("Settings.SysGeneral.PauseText"_lang);
         this->list->addElement(new Aether::ListSeparator());
@@ -50,9 +48,8 @@ namespace Frame::Settings {
         // General::key_combo_enabled
         this->addToggle("Settings.SysGeneral.AdjustPlayback"_lang, [cfg]() -> bool {
             return cfg->sysKeyComboEnabled();
-        }, [this, cfg](bool b) {
+        }, [cfg](bool b) {
             cfg->setSysKeyComboEnabled(b);
-            this->app->sysmodule()->sendReloadConfig();
         });
 
         // General::key_combo_next
@@ -160,7 +157,6 @@ namespace Frame::Settings {
             this->ovlList->addEntry(str, [this, opt, str, level]() {
                 opt->setValue(str);
                 this->app->config()->setSysLogLevel(level);
-                this->app->sysmodule()->sendReloadConfig();
             }, current == level);
         }
 
@@ -181,7 +177,6 @@ namespace Frame::Settings {
             // Otherwise update config and only change if written successfully
             if (set(nxCombo)) {
                 opt->setValue(NX::comboToUnicodeString(nxCombo, " + "));
-                this->app->sysmodule()->sendReloadConfig();
             }
         });
         this->app->addOverlay(this->ovlCombo);
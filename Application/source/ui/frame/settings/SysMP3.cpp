@@ -10,9 +10,8 @@ namespace Frame::Settings {
         // MP3::accurate_seek
         this->addToggle("Settings.SysMP3.AccurateSeek"_lang, [cfg]() -> bool {
             return cfg->sysMP3AccurateSeek();
-        }, [this, cfg](bool b) {
+        }, [cfg](bool b) {
             cfg->setSysMP3AccurateSeek(b);
-            this->app->sysmodule()->sendReloadConfig();
         });
         this->addComment("Settings.SysMP3.AccurateSeekText"_lang);
 
@@ -37,7 +36,6 @@ namespace Frame::Settings {
         this->ovlEQ->setApplyCallback([this]() {
             std::array<float, 32> arr = this->ovlEQ->getValues();
             this->app->config()->setSysMP3Equalizer(arr);
-            this->app->sysmodule()->sendReloadConfig();
         });
         this->ovlEQ->setResetCallback([this]() {
             std::array<float, 32> arr;
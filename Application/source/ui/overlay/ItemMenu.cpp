@@ -1,3 +1,4 @@
+#include "ui/element/CachedImage.hpp"
 #include "ui/overlay/ItemMenu.hpp"
 
 // Size of image
@@ -22,7 +23,7 @@ namespace CustomOvl {
         this->nextY += this->top->h() + 5;
     }
 
-    void ItemMenu::setImage(Aether::Image * i) {
+    void ItemMenu::setImage(Aether::Element * i) {
         this->top->removeElement(this->image);
         this->image = i;
         this->image->setXY(this->top->x() + 5, this->top->y() + 15);
@@ -30,6 +31,10 @@ namespace CustomOvl {
         this->top->addElement(this->image);
     }
 
+    void ItemMenu::setImage(const std::string & path) {
+        this->setImage(new CustomElm::CachedImage(0, 0, IMAGE_SIZE, IMAGE_SIZE, path));
+    }
+
     void ItemMenu::setMainText(const std::string & s) {
         this->mainText->setString(s);
         int maxW = this->top->x() + this->top->w() - this->mainText->x() - PADDING;
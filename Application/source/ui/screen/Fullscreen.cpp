@@ -65,7 +65,7 @@ namespace Screen {
         this->seekBar->setKnobColour(this->primary);
     }
 
-    void Fullscreen::updateImage(const std::string & path) {
+    void Fullscreen::updateImage(const std::string & path, const AlbumID id) {
         // Move old image into vector
         if (this->albumArt != nullptr) {
             this->oldAlbumArt.push_back(this->albumArt);
@@ -78,7 +78,14 @@ namespace Screen {
         SDL_Surface * image = SDLHelper::renderImageS(path);
 
         if (!useDefault) {
-            Utils::Splash::Palette palette = Utils::Splash::getPaletteForSurface(image);
+            // Use the palette picked when the image was saved, only picking one now if there isn't one
+            Metadata::Palette stored;
+            Utils::Splash::Palette palette;
+            if (this->app->database()->getAlbumPalette(id, stored)) {
+                palette = Utils::Splash::unpackPalette(stored);
+            } else {
+                palette = Utils::Splash::getPaletteForSurface(image);
+            }
             if (!palette.invalid) {
                 // Set matching colours if valid
                 if (palette.bgLight) {
@@ -269,7 +276,7 @@ namespace Screen {
             // Change album cover
             AlbumID id = this->app->database()->getAlbumIDForSong(m.ID);
             Metadata::Album md = this->app->database()->getAlbumMetadataForID(id);
-            this->updateImage(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
+            this->updateImage(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath, id);
         }
 
         // Update the seekbar
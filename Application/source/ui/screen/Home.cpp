@@ -241,6 +241,63 @@ namespace Screen {
         this->finalizeState();
     }
 
+    void Home::updateScanProgress() {
+        Main::ScanStage stage = this->app->scanStage();
+        size_t file, total, remaining;
+        this->app->scanProgress(file, total, remaining);
+        if (stage == this->scanStage && file == this->scanFile) {
+            return;
+        }
+
+        // Show the stage (and number of files where known) below the sidebar
+        this->scanText->setHidden(false);
+        this->scanProgress->setHidden(true);
+        bool failed = (stage == Main::ScanStage::Error);
+        if (!failed && this->sideContainer->focussed() == this->scanRetry) {
+            this->sideContainer->setFocussed(this->sideSettings);
+        }
+        this->scanRetry->setHidden(!failed);
+        switch (stage) {
+            case Main::ScanStage::Files:
+                this->scanText->setString("Splash.Preparing"_lang);
+                break;
+
+            case Main::ScanStage::Metadata:
+                if (remaining > 0) {
+                    this->scanText->setString(Utils::substituteTokens("Splash.FileOutOfWithTime"_lang, std::to_string(file), std::to_string(total), Utils::secondsToHMS(remaining)));
+                } else {
+                    this->scanText->setString(Utils::substituteTokens("Splash.FileOutOf"_lang, std::to_string(file), std::to_string(total)));
+                }
+                this->scanProgress->setValue(100 * (float)file/(total + 1));
+                this->scanProgress->setHidden(false);
+                break;
+
+            case Main::ScanStage::Database:
+                this->scanText->setString("Splash.Updating"_lang);
+                break;
+
+            case Main::ScanStage::Art:
+                this->scanText->setString(Utils::substituteTokens("Splash.AlbumsProcessed"_lang, std::to_string(file)));
+                break;
+
+            case Main::ScanStage::Error:
+                this->scanText->setString("Splash.ScanError"_lang);
+                break;
+
+            default:
+                this->scanText->setHidden(true);
+                break;
+        }
+
+        // Keep the text within the sidebar (and beside the retry button)
+        int maxW = (failed ? this->scanRetry->x() - this->scanText->x() - 10 : 250);
+        if (this->scanText->w() > maxW) {
+            this->scanText->setW(maxW);
+        }
+        this->scanStage = stage;
+        this->scanFile = file;
+    }
+
     void Home::update(uint32_t dt) {
         // Update the player elements
         PlaybackStatus ps = this->app->sysmodule()->status();
@@ -268,7 +325,7 @@ namespace Screen {
                     this->player->setDuration(m.duration);
                     AlbumID id = this->app->database()->getAlbumIDForSong(m.ID);
                     Metadata::Album md = this->app->database()->getAlbumMetadataForID(id);
-                    this->player->setAlbumCover(new Aether::Image(0, 0, md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath));
+                    this->player->setAlbumCover(md.imagePath.empty() ? Path::App::DefaultArtFile : md.imagePath);
                     updated = true;
                 }
             }
@@ -278,7 +335,7 @@ namespace Screen {
                 this->player->setTrackName("Common.NotPlaying1"_lang);
                 this->player->setTrackArtist("Common.NotPlaying2"_lang);
                 this->player->setDuration(0);
-                this->player->setAlbumCover(new Aether::Image(0, 0, Path::App::DefaultArtFile));
+                this->player->setAlbumCover(Path::App::DefaultArtFile);
             }
         }
 
@@ -307,6 +364,7 @@ namespace Screen {
         this->touchContainer->setHidden(!this->app->config()->showTouchControls());
         this->sideContainer->setY(this->app->config()->showTouchControls() ? 0 : -65);
         this->updateDot->setHidden(!this->app->hasUpdate());
+        this->updateScanProgress();
 
         // Now update elements
         Screen::update(dt);
@@ -326,6 +384,7 @@ namespace Screen {
         this->sideQueue->setActiveColour(this->app->theme()->accent());
         this->sideSettings->setActiveColour(this->app->theme()->accent());
         this->updateDot->setColour(this->app->theme()->accent());
+        this->scanProgress->setForegroundColour(this->app->theme()->accent());
         this->player->setAccentColour(this->app->theme()->accent());
 
         // Now also update current frame and all on stack
@@ -593,6 +652,24 @@ namespace Screen {
         this->updateDot->setColour(this->app->theme()->accent());
         this->sideContainer->addElement(this->updateDot);
 
+        this->scanText = new Aether::Text(30, this->sideSettings->y() + this->sideSettings->h() + 2, "", 16);
+        this->scanText->setColour(this->app->theme()->muted());
+        this->scanText->setHidden(true);
+        this->sideContainer->addElement(this->scanText);
+        this->scanProgress = new Aether::RoundProgressBar(30, this->scanText->y() + 22, 250, 4);
+        this->scanProgress->setBackgroundColour(this->app->theme()->muted2());
+        this->scanProgress->setForegroundColour(this->app->theme()->accent());
+        this->scanProgress->setHidden(true);
+        this->sideContainer->addElement(this->scanProgress);
+        // Shown beside the text if the scan fails (there's no room below it)
+        this->scanRetry = new Aether::BorderButton(180, this->scanText->y() - 2, 100, 26, 2, "Splash.ScanRetry"_lang, 16, [this]() {
+            this->app->startLibraryScan();
+        });
+        this->scanRetry->setBorderColour(this->app->theme()->FG());
+        this->scanRetry->setTextColour(this->app->theme()->FG());
+        this->scanRetry->setHidden(true);
+        this->sideContainer->addElement(this->scanRetry);
+
         // Set appropriate button active
         switch (this->app->config()->initialFrame()) {
             case Frame::Type::Playlists:
@@ -674,6 +751,8 @@ namespace Screen {
         this->backOneFrame = 0;
         this->confirmQueue = nullptr;
         this->playingID = -100;     // This number needs to be less than -1, as >= -1 are valid values
+        this->scanStage = Main::ScanStage::None;
+        this->scanFile = 0;
     }
 
     void Home::onUnload() {
@@ -1,10 +1,20 @@
+#include <algorithm>
 #include "avir.h"
+#include <cmath>
 #include <cstdio>
 #include <cstring>
 #include <jpeglib.h>
 #include "Log.hpp"
 #include <png.h>
+#include "utils/FS.hpp"
 #include "utils/Image.hpp"
+#include <zlib.h>
+
+// Sizes of the smaller copies of an image (smallest first)
+static const size_t thumbnailSizes[] = {96, 200};
+
+// Number of fractional bits in the fast filter's weights
+#define WEIGHT_BITS 14
 
 namespace Utils::Image {
     // Type of image
@@ -51,7 +61,9 @@ namespace Utils::Image {
     }
 
     // Extracts the raw pixel values from the given JPEG buffer
-    ImageData extractJPEG(std::vector<unsigned char> & data) {
+    // The image is decoded at the smallest power-of-two scale (down to 1/8) which is still at least
+    // the given dimensions, which is much quicker and smaller than decoding it at full size
+    ImageData extractJPEG(std::vector<unsigned char> & data, size_t minW, size_t minH) {
         ImageData extracted;
         extracted.width = 0;
         extracted.height = 0;
@@ -69,8 +81,20 @@ namespace Utils::Image {
         if (result != 1) {
             // Invalid JPEG
             Log::writeError("[IMAGE] JPEG is corrupt or invalid");
+            jpeg_destroy_decompress(&jpeg);
             return extracted;
         }
+
+        // Pick scale and always output RGB (greyscale images are converted)
+        unsigned int denom = 1;
+        while (denom < 8 && (jpeg.image_width + 2*denom - 1) / (2*denom) >= minW && (jpeg.image_height + 2*denom - 1) / (2*denom) >= minH) {
+            denom *= 2;
+        }
+        jpeg.scale_num = 1;
+        jpeg.scale_denom = denom;
+        if (jpeg.jpeg_color_space == JCS_GRAYSCALE) {
+            jpeg.out_color_space = JCS_RGB;
+        }
         jpeg_start_decompress(&jpeg);
 
         // Set metadata
@@ -161,6 +185,11 @@ namespace Utils::Image {
 
         // Write header
         png_set_IHDR(png, info, image.width, image.height, image.bitDepth, (image.channels == 3 ? PNG_COLOR_TYPE_RGB : PNG_COLOR_TYPE_RGB_ALPHA), PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+
+        // Favour speed over size: a single cheap filter is quicker to apply and undo than
+        // libpng's adaptive filtering, and the fastest zlib level barely changes the size of photos
+        png_set_filter(png, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+        png_set_compression_level(png, Z_BEST_SPEED);
         png_write_info(png, info);
 
         // Write pixel data
@@ -249,26 +278,159 @@ namespace Utils::Image {
         return extracted;
     }
 
-    bool resize(std::vector<unsigned char> & data, size_t destW, size_t destH) {
-        // Determine the format of the image first and then extract raw pixel data
-        ImageFormat format = getImageFormat(data);
-        ImageData image;
-        switch (format) {
+    // Extracts the raw pixel values from the given PNG/JPEG buffer, which will be at least
+    // the given size if it was larger to begin with. Returned image has no pixels on an error
+    ImageData extractImage(std::vector<unsigned char> & data, size_t minW, size_t minH) {
+        switch (getImageFormat(data)) {
             case ImageFormat::PNG:
-                image = extractPNG(data);
-                break;
+                return extractPNG(data);
 
             case ImageFormat::JPEG:
-                image = extractJPEG(data);
-                break;
+                return extractJPEG(data, minW, minH);
 
             default:
                 Log::writeError("[IMAGE] Couldn't determine image format");
-                return false;
                 break;
         }
 
-        // Stop if we have no pixels
+        ImageData empty;
+        empty.width = 0;
+        empty.height = 0;
+        empty.bitDepth = 8;
+        empty.channels = 0;
+        return empty;
+    }
+
+    // Pixels (and their weights) contributing to one output pixel when resampling a row/column
+    struct Contribution {
+        size_t first;                   // Index of first input pixel
+        std::vector<int32_t> weights;   // Weight of each pixel from the first (sums to 1 << WEIGHT_BITS)
+    };
+
+    // Calculate the contributions for each output pixel when resampling from inSize to outSize pixels
+    // Uses a triangle filter which is widened when downscaling so every input pixel is used (bilinear/area)
+    std::vector<Contribution> getContributions(size_t inSize, size_t outSize) {
+        std::vector<Contribution> contribs(outSize);
+        double scale = static_cast<double>(inSize) / outSize;
+        double radius = std::max(scale, 1.0);
+        for (size_t out = 0; out < outSize; out++) {
+            // Find range of input pixels under the filter
+            double centre = (out + 0.5) * scale;
+            long first = std::max(0L, static_cast<long>(std::floor(centre - radius)));
+            long last = std::min(static_cast<long>(inSize) - 1, static_cast<long>(std::ceil(centre + radius)));
+
+            // Calculate weights and normalize them to fixed point
+            std::vector<double> weights;
+            double total = 0;
+            for (long in = first; in <= last; in++) {
+                double weight = std::max(0.0, 1.0 - std::abs((in + 0.5 - centre) / radius));
+                weights.push_back(weight);
+                total += weight;
+            }
+
+            contribs[out].first = first;
+            int32_t sum = 0;
+            for (double weight : weights) {
+                contribs[out].weights.push_back(std::lround((weight / total) * (1 << WEIGHT_BITS)));
+                sum += contribs[out].weights.back();
+            }
+
+            // Put any rounding error on the centre pixel so flat colours stay flat
+            contribs[out].weights[weights.size()/2] += (1 << WEIGHT_BITS) - sum;
+        }
+        return contribs;
+    }
+
+    // Convert an accumulated fixed point value back to a byte
+    inline uint8_t clampWeighted(int32_t value) {
+        value = (value + (1 << (WEIGHT_BITS - 1))) >> WEIGHT_BITS;
+        return (value < 0 ? 0 : (value > 255 ? 255 : value));
+    }
+
+    // Resizes the pixels in the given image using a separable bilinear/area filter
+    // The inner loops only use integer multiply-adds over contiguous bytes so they vectorize well
+    void resizePixelsFast(ImageData & image, size_t destW, size_t destH) {
+        const size_t channels = image.channels;
+
+        // Resize each row horizontally
+        std::vector<Contribution> contribs = getContributions(image.width, destW);
+        std::vector<uint8_t> rows(image.height * destW * channels);
+        std::vector<int32_t> acc(channels);
+        for (size_t y = 0; y < image.height; y++) {
+            const uint8_t * in = &image.pixels[y * image.width * channels];
+            uint8_t * out = &rows[y * destW * channels];
+            for (size_t x = 0; x < destW; x++) {
+                std::fill(acc.begin(), acc.end(), 0);
+                const uint8_t * px = in + contribs[x].first * channels;
+                for (int32_t weight : contribs[x].weights) {
+                    for (size_t c = 0; c < channels; c++) {
+                        acc[c] += px[c] * weight;
+                    }
+                    px += channels;
+                }
+                for (size_t c = 0; c < channels; c++) {
+                    out[x * channels + c] = clampWeighted(acc[c]);
+                }
+            }
+        }
+        image.pixels.clear();
+        image.pixels.shrink_to_fit();
+
+        // Then resize each column, working on whole rows at a time
+        contribs = getContributions(image.height, destH);
+        const size_t rowSize = destW * channels;
+        std::vector<uint8_t> resized(destH * rowSize);
+        std::vector<int32_t> rowAcc(rowSize);
+        for (size_t y = 0; y < destH; y++) {
+            std::fill(rowAcc.begin(), rowAcc.end(), 0);
+            const uint8_t * in = &rows[contribs[y].first * rowSize];
+            for (int32_t weight : contribs[y].weights) {
+                for (size_t i = 0; i < rowSize; i++) {
+                    rowAcc[i] += in[i] * weight;
+                }
+                in += rowSize;
+            }
+
+            uint8_t * out = &resized[y * rowSize];
+            for (size_t i = 0; i < rowSize; i++) {
+                out[i] = clampWeighted(rowAcc[i]);
+            }
+        }
+
+        image.pixels = std::move(resized);
+        image.width = destW;
+        image.height = destH;
+    }
+
+    // Resizes the pixels in the given image to the provided dimensions using AVIR
+    void resizePixels(ImageData & image, size_t destW, size_t destH) {
+        // Create the output buffer
+        std::vector<uint8_t> resized;
+        resized.resize(destW * destH * image.channels, 0);
+
+        // Resize and fill buffer
+        avir::CImageResizer<> ImageResizer(8);
+        ImageResizer.resizeImage(&image.pixels[0], image.width, image.height, 0, &resized[0], destW, destH, image.channels, 0);
+
+        // Update ImageData struct
+        image.pixels = resized;
+        image.width = destW;
+        image.height = destH;
+    }
+
+    // Returns the path to the copy of an image with the given size
+    std::string thumbnailPathForSize(const std::string & path, size_t size) {
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+            dot = path.length();
+        }
+        return path.substr(0, dot) + "_" + std::to_string(size) + ".png";
+    }
+
+    bool resize(std::vector<unsigned char> & data, size_t destW, size_t destH, const Filter filter) {
+        // Extract raw pixel data and stop if we have no pixels
+        ImageData image = extractImage(data, destW, destH);
         if (image.pixels.empty()) {
             Log::writeInfo("[IMAGE] Extracted zero pixels from image; can't resize");
             return false;
@@ -276,19 +438,11 @@ namespace Utils::Image {
 
         // Resize if it's not the destination size
         if (!(image.width == destW && image.height == destH)) {
-            // Create the output buffer
-            std::vector<uint8_t> resized;
-            resized.resize(destW * destH * image.channels, 0);
-
-            // Resize and fill buffer
-            avir::CImageResizer<> ImageResizer(8);
-            ImageResizer.resizeImage(&image.pixels[0], image.width, image.height, 0, &resized[0], destW, destH, image.channels, 0);
-
-            // Update ImageData struct
-            image.pixels = resized;
-            image.width = destW;
-            image.height = destH;
-
+            if (filter == Filter::Quality) {
+                resizePixels(image, destW, destH);
+            } else {
+                resizePixelsFast(image, destW, destH);
+            }
         } else {
             Log::writeInfo("[IMAGE] No need to resize image as it has the required dimensions");
         }
@@ -299,4 +453,99 @@ namespace Utils::Image {
         Log::writeInfo("[IMAGE] Resized successfully");
         return true;
     }
+
+    bool getPixels(const std::vector<unsigned char> & data, size_t maxSize, std::vector<unsigned char> & pixels, size_t & width, size_t & height) {
+        std::vector<unsigned char> copy = data;
+        ImageData image = extractImage(copy, maxSize, maxSize);
+        if (image.pixels.empty()) {
+            Log::writeError("[IMAGE] Extracted zero pixels from image; can't get pixels");
+            return false;
+        }
+
+        // Shrink before adding an alpha channel so there's less to convert
+        if (image.width > maxSize || image.height > maxSize) {
+            size_t longest = std::max(image.width, image.height);
+            resizePixelsFast(image, std::max<size_t>(1, (image.width * maxSize) / longest), std::max<size_t>(1, (image.height * maxSize) / longest));
+        }
+
+        width = image.width;
+        height = image.height;
+        if (image.channels == 4) {
+            pixels = std::move(image.pixels);
+            return true;
+        }
+
+        pixels.resize(width * height * 4);
+        for (size_t i = 0; i < width * height; i++) {
+            pixels[i*4] = image.pixels[i*3];
+            pixels[i*4 + 1] = image.pixels[i*3 + 1];
+            pixels[i*4 + 2] = image.pixels[i*3 + 2];
+            pixels[i*4 + 3] = 255;
+        }
+        return true;
+    }
+
+    bool writeThumbnails(const std::vector<unsigned char> & data, const std::string & path) {
+        // Decode at no less than the largest size (JPEGs may be scaled down while decoding)
+        const size_t count = sizeof(thumbnailSizes)/sizeof(thumbnailSizes[0]);
+        std::vector<unsigned char> copy = data;
+        ImageData image = extractImage(copy, thumbnailSizes[count - 1], thumbnailSizes[count - 1]);
+        if (image.pixels.empty()) {
+            Log::writeError("[IMAGE] Extracted zero pixels from image; can't create thumbnails");
+            return false;
+        }
+
+        // Resize from largest to smallest so each copy is made from the previous one
+        bool ok = true;
+        for (size_t i = count; i > 0; i--) {
+            size_t size = thumbnailSizes[i - 1];
+            if (image.width > size || image.height > size) {
+                resizePixelsFast(image, size, size);
+            }
+
+            ok = Utils::Fs::writeFile(thumbnailPathForSize(path, size), compressPNG(image));
+            if (!ok) {
+                Log::writeError("[IMAGE] Unable to write thumbnail for: " + path);
+                break;
+            }
+        }
+
+        return ok;
+    }
+
+    std::string thumbnailPath(const std::string & path, const size_t size) {
+        for (size_t thumbSize : thumbnailSizes) {
+            if (size <= thumbSize) {
+                std::string thumb = thumbnailPathForSize(path, thumbSize);
+                if (Utils::Fs::fileExists(thumb)) {
+                    return thumb;
+                }
+            }
+        }
+        return path;
+    }
+
+    bool hasThumbnails(const std::string & path) {
+        for (size_t thumbSize : thumbnailSizes) {
+            if (!Utils::Fs::fileExists(thumbnailPathForSize(path, thumbSize))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::vector<std::string> thumbnailPaths(const std::string & path) {
+        std::vector<std::string> paths;
+        for (size_t thumbSize : thumbnailSizes) {
+            paths.push_back(thumbnailPathForSize(path, thumbSize));
+        }
+        return paths;
+    }
+
+    void deleteImage(const std::string & path) {
+        Utils::Fs::deleteFile(path);
+        for (size_t thumbSize : thumbnailSizes) {
+            Utils::Fs::deleteFile(thumbnailPathForSize(path, thumbSize));
+        }
+    }
 };
\ No newline at end of file
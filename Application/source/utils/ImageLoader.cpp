@@ -0,0 +1,141 @@
+#include <algorithm>
+#include <condition_variable>
+#include "Log.hpp"
+#include <mutex>
+#include <thread>
+#include "utils/Image.hpp"
+#include "utils/ImageLoader.hpp"
+#include <vector>
+
+namespace Utils::ImageLoader {
+    // Requests waiting for a worker
+    static std::vector<Ticket> queue;
+    static std::mutex queueMutex;
+    static std::condition_variable queueCond;
+
+    // Worker threads
+    static std::vector<std::thread> workers;
+    static bool stopping = false;
+
+    Request::~Request() {
+        if (this->surface != nullptr) {
+            SDL_FreeSurface(this->surface);
+        }
+    }
+
+    // Remove and return the queued request with the lowest priority value, blocking until
+    // there is one (returns nullptr once stopping)
+    static Ticket nextRequest() {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        while (true) {
+            if (stopping) {
+                return nullptr;
+            }
+
+            // Drop cancelled requests as they'll never be decoded
+            queue.erase(std::remove_if(queue.begin(), queue.end(), [](const Ticket & ticket) {
+                return (ticket->status == Status::Cancelled);
+            }), queue.end());
+
+            if (!queue.empty()) {
+                std::vector<Ticket>::iterator best = std::min_element(queue.begin(), queue.end(), [](const Ticket & a, const Ticket & b) {
+                    return (a->priority < b->priority);
+                });
+                Ticket ticket = *best;
+                queue.erase(best);
+                return ticket;
+            }
+            queueCond.wait(lock);
+        }
+    }
+
+    // Decode requests until stopped
+    static void runWorker() {
+        while (true) {
+            Ticket ticket = nextRequest();
+            if (ticket == nullptr) {
+                break;
+            }
+
+            // Skip if cancelled while we were fetching it
+            Status expected = Status::Queued;
+            if (!ticket->status.compare_exchange_strong(expected, Status::Decoding)) {
+                continue;
+            }
+
+            SDL_Surface * surface = SDLHelper::renderImageS(Utils::Image::thumbnailPath(ticket->path, ticket->size));
+            if (surface == nullptr) {
+                Log::writeWarning("[IMAGE] Unable to decode image: " + ticket->path);
+            }
+
+            // Only hand over the surface if it's still wanted
+            ticket->surface = surface;
+            expected = Status::Decoding;
+            if (!ticket->status.compare_exchange_strong(expected, Status::Done)) {
+                ticket->surface = nullptr;
+                if (surface != nullptr) {
+                    SDL_FreeSurface(surface);
+                }
+            }
+        }
+    }
+
+    void start(const size_t threads) {
+        std::scoped_lock<std::mutex> lock(queueMutex);
+        stopping = false;
+        for (size_t i = 0; i < threads; i++) {
+            workers.emplace_back(runWorker);
+        }
+    }
+
+    void stop() {
+        {
+            std::scoped_lock<std::mutex> lock(queueMutex);
+            stopping = true;
+            for (Ticket & ticket : queue) {
+                ticket->status = Status::Cancelled;
+            }
+            queue.clear();
+        }
+        queueCond.notify_all();
+
+        for (std::thread & worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+    }
+
+    Ticket request(const std::string & path, const size_t size, const int priority) {
+        Ticket ticket = std::make_shared<Request>();
+        ticket->path = path;
+        ticket->size = size;
+        ticket->priority = priority;
+        ticket->status = Status::Queued;
+        ticket->surface = nullptr;
+
+        {
+            std::scoped_lock<std::mutex> lock(queueMutex);
+            queue.push_back(ticket);
+        }
+        queueCond.notify_one();
+        return ticket;
+    }
+
+    void cancel(const Ticket & ticket) {
+        Status status = ticket->status.exchange(Status::Cancelled);
+        if (status == Status::Done && ticket->surface != nullptr) {
+            SDL_FreeSurface(ticket->surface);
+            ticket->surface = nullptr;
+        }
+    }
+
+    SDL_Surface * take(const Ticket & ticket) {
+        if (ticket->status != Status::Done) {
+            return nullptr;
+        }
+
+        SDL_Surface * surface = ticket->surface;
+        ticket->surface = nullptr;
+        return surface;
+    }
+};
\ No newline at end of file
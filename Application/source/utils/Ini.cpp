@@ -0,0 +1,243 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include "Log.hpp"
+#include "utils/FS.hpp"
+#include "utils/Ini.hpp"
+#include "utils/Utils.hpp"
+
+// Characters which start a comment
+#define COMMENT_CHARS ";#"
+// Characters removed from the start and end of names/values
+#define WHITESPACE " \t\r"
+
+// Returns the given string with whitespace removed from either end
+static std::string trim(const std::string & str) {
+    size_t start = str.find_first_not_of(WHITESPACE);
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = str.find_last_not_of(WHITESPACE);
+    return str.substr(start, end - start + 1);
+}
+
+// Returns the name of the section if the line starts one, otherwise a blank string
+static std::string sectionName(const std::string & line) {
+    std::string str = trim(line);
+    if (str.length() < 2 || str[0] != '[') {
+        return "";
+    }
+    size_t end = str.find(']');
+    if (end == std::string::npos) {
+        return "";
+    }
+    return trim(str.substr(1, end - 1));
+}
+
+namespace Utils {
+    Ini::Ini(const std::string & path) {
+        this->path = path;
+        this->crlf = false;
+        this->changed = false;
+    }
+
+    int Ini::findKey(const std::string & section, const std::string & key, int & insert) {
+        const std::string lSection = Utils::toLowercase(section);
+        const std::string lKey = Utils::toLowercase(key);
+        bool inSection = false;
+        insert = -1;
+
+        for (size_t i = 0; i < this->lines.size(); i++) {
+            const std::string & line = this->lines[i];
+            std::string name = sectionName(line);
+            if (!name.empty()) {
+                // Stop once the end of the section is reached
+                if (inSection) {
+                    break;
+                }
+                inSection = (Utils::toLowercase(name) == lSection);
+                if (inSection) {
+                    insert = i + 1;
+                }
+                continue;
+            }
+
+            if (!inSection) {
+                continue;
+            }
+
+            // New keys are added after the last line holding something
+            std::string str = trim(line);
+            if (str.empty()) {
+                continue;
+            }
+            insert = i + 1;
+            if (str.find_first_of(COMMENT_CHARS) == 0) {
+                continue;
+            }
+
+            size_t pos = str.find('=');
+            if (pos != std::string::npos && Utils::toLowercase(trim(str.substr(0, pos))) == lKey) {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    bool Ini::read() {
+        // A missing file may have been left as the temporary file if writing was interrupted
+        std::string tmpPath = this->path + ".tmp";
+        if (!Utils::Fs::fileExists(this->path) && Utils::Fs::fileExists(tmpPath)) {
+            Log::writeWarning("[INI] Recovering ", this->path, " from an interrupted write");
+            std::rename(tmpPath.c_str(), this->path.c_str());
+        }
+
+        std::ifstream in(this->path);
+        if (!in) {
+            return false;
+        }
+
+        this->lines.clear();
+        this->crlf = false;
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+                this->crlf = true;
+            }
+            this->lines.push_back(line);
+        }
+        this->changed = false;
+        return true;
+    }
+
+    bool Ini::hasChanges(const unsigned int idle) {
+        if (!this->changed) {
+            return false;
+        }
+        return (std::chrono::steady_clock::now() - this->changeTime >= std::chrono::milliseconds(idle));
+    }
+
+    bool Ini::write() {
+        if (!this->changed) {
+            return true;
+        }
+
+        // Write to a temporary file first so a partially written file is never read
+        std::string tmpPath = this->path + ".tmp";
+        std::FILE * fp = std::fopen(tmpPath.c_str(), "w");
+        if (fp == nullptr) {
+            Log::writeError("[INI] Unable to open ", tmpPath, " for writing");
+            return false;
+        }
+        bool ok = true;
+        const char * end = (this->crlf ? "\r\n" : "\n");
+        for (const std::string & line : this->lines) {
+            ok = ok && (std::fputs(line.c_str(), fp) >= 0) && (std::fputs(end, fp) >= 0);
+        }
+        ok = (std::fclose(fp) == 0) && ok;
+        if (!ok) {
+            Log::writeError("[INI] Unable to write to ", tmpPath);
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+        // Rename doesn't replace existing files on the Switch, so the old one is removed first
+        std::remove(this->path.c_str());
+        if (std::rename(tmpPath.c_str(), this->path.c_str()) != 0) {
+            Log::writeError("[INI] Unable to rename ", tmpPath, " to ", this->path);
+            return false;
+        }
+
+        this->changed = false;
+        return true;
+    }
+
+    std::string Ini::gets(const std::string & section, const std::string & key, const std::string & def) {
+        int insert;
+        int idx = this->findKey(section, key, insert);
+        if (idx < 0) {
+            return def;
+        }
+
+        // Remove any trailing comment and quotes around the value
+        const std::string & line = this->lines[idx];
+        std::string value = line.substr(line.find('=') + 1);
+        value = trim(value.substr(0, value.find_first_of(COMMENT_CHARS)));
+        if (value.length() >= 2 && value.front() == '"' && value.back() == '"') {
+            value = value.substr(1, value.length() - 2);
+        }
+        return value;
+    }
+
+    long Ini::geti(const std::string & section, const std::string & key, const long def) {
+        std::string value = this->gets(section, key);
+        if (value.empty()) {
+            return def;
+        }
+        return std::strtol(value.c_str(), nullptr, 10);
+    }
+
+    bool Ini::getbool(const std::string & section, const std::string & key, const bool def) {
+        std::string value = this->gets(section, key);
+        if (value.empty()) {
+            return def;
+        }
+
+        // Same values as accepted by minIni
+        switch (value[0]) {
+            case 'Y':
+            case 'y':
+            case 'T':
+            case 't':
+            case '1':
+                return true;
+
+            case 'N':
+            case 'n':
+            case 'F':
+            case 'f':
+            case '0':
+                return false;
+
+            default:
+                return def;
+        }
+    }
+
+    bool Ini::put(const std::string & section, const std::string & key, const std::string & value) {
+        if (section.empty() || key.empty()) {
+            return false;
+        }
+
+        int insert;
+        int idx = this->findKey(section, key, insert);
+        std::string line = key + " = " + value;
+        if (idx >= 0) {
+            if (this->lines[idx] == line) {
+                return true;
+            }
+            this->lines[idx] = line;
+
+        } else if (insert >= 0) {
+            this->lines.insert(this->lines.begin() + insert, line);
+
+        } else {
+            // Append a new section, separated from the last
+            if (!this->lines.empty() && !trim(this->lines.back()).empty()) {
+                this->lines.push_back("");
+            }
+            this->lines.push_back("[" + section + "]");
+            this->lines.push_back(line);
+        }
+
+        this->changed = true;
+        this->changeTime = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    bool Ini::put(const std::string & section, const std::string & key, const long value) {
+        return this->put(section, key, std::to_string(value));
+    }
+};
\ No newline at end of file
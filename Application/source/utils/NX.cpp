@@ -151,10 +151,19 @@ namespace Utils::NX {
         boost = enable;
     }
 
+    bool inFocus() {
+        return (appletGetFocusState() == AppletFocusState_InFocus);
+    }
+
     void setLowFsPriority(bool low) {
         fsSetPriority(low ? FsPriority_Background : FsPriority_Normal);
     }
 
+    void setLowThreadPriority(bool low) {
+        // Threads are created with the same priority as the main thread (0x2C)
+        svcSetThreadPriority(CUR_THREAD_HANDLE, (low ? 0x3B : 0x2C));
+    }
+
     static bool media = false;
     void setPlayingMedia(bool enable) {
         // Only set if different state
@@ -1,3 +1,5 @@
+#include <cctype>
+#include <cstdint>
 #include <queue>
 #include <set>
 #include "utils/Search.hpp"
@@ -116,4 +118,69 @@ namespace Utils::Search {
 
         return phrases;
     }
+    // Base letters for U+00C0 to U+00FF (nullptr where the character is kept as is)
+    static const char * latin1Bases[64] = {
+        "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+        "d", "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", "th", "ss",
+        "a", "a", "a", "a", "a", "a", "ae", "c", "e", "e", "e", "e", "i", "i", "i", "i",
+        "d", "n", "o", "o", "o", "o", "o", nullptr, "o", "u", "u", "u", "u", "y", "th", "y"
+    };
+
+    // Base letters for U+0100 to U+017F, stored as runs ending at the given codepoint
+    struct LatinRun {
+        uint16_t last;
+        const char * base;
+    };
+    static const LatinRun latinExtBases[] = {
+        {0x105, "a"}, {0x10D, "c"}, {0x111, "d"}, {0x11B, "e"}, {0x123, "g"}, {0x127, "h"},
+        {0x131, "i"}, {0x133, "ij"}, {0x135, "j"}, {0x138, "k"}, {0x142, "l"}, {0x14B, "n"},
+        {0x151, "o"}, {0x153, "oe"}, {0x159, "r"}, {0x161, "s"}, {0x167, "t"}, {0x173, "u"},
+        {0x175, "w"}, {0x178, "y"}, {0x17E, "z"}, {0x17F, "s"}
+    };
+
+    std::string sortKey(const std::string & str) {
+        std::string key;
+        key.reserve(str.length());
+
+        for (size_t i = 0; i < str.length(); i++) {
+            unsigned char c = str[i];
+
+            // ASCII is lowercased
+            if (c < 0x80) {
+                key.push_back(std::tolower(c));
+                continue;
+            }
+
+            // Two byte sequences from U+00C0 to U+017F are replaced with their base letter(s)
+            if (c >= 0xC3 && c <= 0xC5 && i + 1 < str.length() && (str[i + 1] & 0xC0) == 0x80) {
+                uint16_t cp = ((c & 0x1F) << 6) | (str[i + 1] & 0x3F);
+                const char * base = nullptr;
+                if (cp < 0x100) {
+                    base = latin1Bases[cp - 0xC0];
+                } else {
+                    for (const LatinRun & run : latinExtBases) {
+                        if (cp <= run.last) {
+                            base = run.base;
+                            break;
+                        }
+                    }
+                }
+
+                if (base != nullptr) {
+                    key += base;
+                    i++;
+                    continue;
+                }
+            }
+
+            // Anything else is kept as is
+            key.push_back(c);
+        }
+
+        // Ignore leading "The " as long as something follows it
+        if (key.length() > 4 && key.compare(0, 4, "the ") == 0) {
+            key.erase(0, 4);
+        }
+        return key;
+    }
 };
\ No newline at end of file
@@ -1,7 +1,13 @@
+#include <algorithm>
 #include "Log.hpp"
 #include "splash/Splash.hpp"
+#include "utils/FS.hpp"
+#include "utils/Image.hpp"
 #include "utils/Splash.hpp"
 
+// Maximum width/height of the image colours are picked from
+#define PALETTE_SIZE 96
+
 namespace Utils::Splash {
     Aether::Colour changeLightness(Aether::Colour old, int val) {
         ::Splash::Colour col = ::Splash::Colour(old.a, old.r, old.g, old.b);
@@ -9,37 +15,21 @@ namespace Utils::Splash {
         return Aether::Colour{(uint8_t)col.r(), (uint8_t)col.g(), (uint8_t)col.b(), (uint8_t)col.a()};
     }
 
-    Palette getPaletteForSurface(SDL_Surface * surf) {
-        // Struct to return
+    // Pick colours from the given RGBA pixels
+    static Palette getPaletteForPixels(const std::vector<uint8_t> & rgba, size_t width, size_t height) {
         Palette palette;
         palette.invalid = true;
 
-        // Check we actually have a surface
-        if (surf == nullptr) {
-            Log::writeError("[SPLASH] Attempted to get a palette for a null surface");
-            return palette;
-        }
-
-        // First read pixels from the surface and convert to Splash::Colour
+        // Create a Splash::Bitmap and fill with pixels
         std::vector<::Splash::Colour> pixels;
-        SDL_LockSurface(surf);
-        size_t count = surf->w * surf->h;
-        for (size_t i = 0; i < count; i++) {
-            // Get RGB values
-            uint8_t r, g, b, a;
-            SDL_GetRGBA(*((uint32_t *)surf->pixels + i), surf->format, &r, &g, &b, &a);
-
-            // Create object and push onto vector
-            ::Splash::Colour colour = ::Splash::Colour(a, r, g, b);
-            pixels.push_back(colour);
+        pixels.reserve(width * height);
+        for (size_t i = 0; i < rgba.size(); i += 4) {
+            pixels.push_back(::Splash::Colour(rgba[i + 3], rgba[i], rgba[i + 1], rgba[i + 2]));
         }
-        SDL_UnlockSurface(surf);
-
-        // Now create a Splash::Bitmap and fill with pixels
-        ::Splash::Bitmap image = ::Splash::Bitmap(surf->w, surf->h);
+        ::Splash::Bitmap image = ::Splash::Bitmap(width, height);
         size_t amt = image.setPixels(pixels, 0, 0, image.getWidth(), image.getHeight());
         if (amt != pixels.size()) {
-            Log::writeWarning("[SPLASH] Not enough pixels were written to the bitmap - this may result in incorrect colours being picked (wrote: " + std::to_string(amt) + ", wanted: " + std::to_string(surf->w * surf->h) + ")");
+            Log::writeWarning("[SPLASH] Not enough pixels were written to the bitmap - this may result in incorrect colours being picked (wrote: " + std::to_string(amt) + ", wanted: " + std::to_string(pixels.size()) + ")");
         }
         pixels.clear();
 
@@ -60,6 +50,116 @@ namespace Utils::Splash {
         return palette;
     }
 
+    Palette getPaletteForSurface(SDL_Surface * surf) {
+        // Check we actually have a surface
+        if (surf == nullptr) {
+            Log::writeError("[SPLASH] Attempted to get a palette for a null surface");
+            Palette palette;
+            palette.invalid = true;
+            return palette;
+        }
+
+        // Convert to bytes in RGBA order so pixels can be read without SDL_GetRGBA()
+        SDL_Surface * rgbaSurf = (surf->format->format == SDL_PIXELFORMAT_RGBA32 ? surf : SDL_ConvertSurfaceFormat(surf, SDL_PIXELFORMAT_RGBA32, 0));
+        if (rgbaSurf == nullptr) {
+            Log::writeError("[SPLASH] Unable to convert surface to RGBA");
+            Palette palette;
+            palette.invalid = true;
+            return palette;
+        }
+
+        // Average each block of pixels (the scale is rounded up so neither side is larger than PALETTE_SIZE)
+        size_t scale = std::max<size_t>(1, (std::max(rgbaSurf->w, rgbaSurf->h) + PALETTE_SIZE - 1) / PALETTE_SIZE);
+        size_t width = rgbaSurf->w / scale;
+        size_t height = rgbaSurf->h / scale;
+        std::vector<uint32_t> sums(width * scale * 4);
+        std::vector<uint8_t> rgba(width * height * 4);
+        SDL_LockSurface(rgbaSurf);
+        for (size_t y = 0; y < height; y++) {
+            // Sum the block's rows first, which is a plain add over contiguous bytes so it vectorizes
+            std::fill(sums.begin(), sums.end(), 0);
+            for (size_t row = y * scale; row < (y + 1) * scale; row++) {
+                const uint8_t * px = static_cast<const uint8_t *>(rgbaSurf->pixels) + row * rgbaSurf->pitch;
+                for (size_t i = 0; i < sums.size(); i++) {
+                    sums[i] += px[i];
+                }
+            }
+
+            // Then sum the columns in each block
+            uint8_t * out = &rgba[y * width * 4];
+            for (size_t x = 0; x < width; x++) {
+                uint32_t total[4] = {0, 0, 0, 0};
+                for (size_t i = x * scale * 4; i < (x + 1) * scale * 4; i += 4) {
+                    total[0] += sums[i];
+                    total[1] += sums[i + 1];
+                    total[2] += sums[i + 2];
+                    total[3] += sums[i + 3];
+                }
+                for (size_t c = 0; c < 4; c++) {
+                    out[x * 4 + c] = total[c] / (scale * scale);
+                }
+            }
+        }
+        SDL_UnlockSurface(rgbaSurf);
+        if (rgbaSurf != surf) {
+            SDL_FreeSurface(rgbaSurf);
+        }
+
+        if (rgba.empty()) {
+            Log::writeError("[SPLASH] Surface is too small to get a palette for");
+            Palette palette;
+            palette.invalid = true;
+            return palette;
+        }
+        return getPaletteForPixels(rgba, width, height);
+    }
+
+    Palette getPaletteForImage(const std::string & path) {
+        Palette palette;
+        palette.invalid = true;
+
+        std::vector<unsigned char> data;
+        if (!Utils::Fs::readFile(Utils::Image::thumbnailPath(path, 0), data)) {
+            Log::writeError("[SPLASH] Unable to read image: " + path);
+            return palette;
+        }
+
+        std::vector<unsigned char> rgba;
+        size_t width, height;
+        if (!Utils::Image::getPixels(data, PALETTE_SIZE, rgba, width, height)) {
+            return palette;
+        }
+        return getPaletteForPixels(rgba, width, height);
+    }
+
+    // Colours are stored as 0xRRGGBBAA
+    static uint32_t packColour(const Aether::Colour & col) {
+        return (static_cast<uint32_t>(col.r) << 24) | (col.g << 16) | (col.b << 8) | col.a;
+    }
+
+    static Aether::Colour unpackColour(const uint32_t col) {
+        return Aether::Colour{(uint8_t)(col >> 24), (uint8_t)(col >> 16), (uint8_t)(col >> 8), (uint8_t)col};
+    }
+
+    Metadata::Palette packPalette(const Palette & palette) {
+        Metadata::Palette packed;
+        packed.light = palette.bgLight;
+        packed.background = packColour(palette.background);
+        packed.primary = packColour(palette.primary);
+        packed.secondary = packColour(palette.secondary);
+        return packed;
+    }
+
+    Palette unpackPalette(const Metadata::Palette & packed) {
+        Palette palette;
+        palette.invalid = false;
+        palette.bgLight = packed.light;
+        palette.background = unpackColour(packed.background);
+        palette.primary = unpackColour(packed.primary);
+        palette.secondary = unpackColour(packed.secondary);
+        return palette;
+    }
+
     Aether::Colour interpolateColours(const Aether::Colour & start, const Aether::Colour & end, double amt) {
         amt = (amt < 0.0 ? 0.0 : amt);
         amt = (amt > 1.0 ? 1.0 : amt);
@@ -0,0 +1,116 @@
+#include "Log.hpp"
+#include "utils/Image.hpp"
+#include "utils/LRUCache.hpp"
+#include "utils/TextureCache.hpp"
+
+// Default budget (bytes)
+#define DEFAULT_BUDGET (48 * 1024 * 1024)
+
+namespace Utils::TextureCache {
+    // A texture held by the cache
+    struct Entry {
+        std::string path;           // Path to image that was requested
+        Handle handle;              // Shared texture
+    };
+
+    // Textures keyed by path and size, costing their size in bytes (textures still being
+    // drawn somewhere aren't destroyed, as they wouldn't free any memory)
+    static LRUCache<std::string, Entry> cache(DEFAULT_BUDGET, [](const Entry & entry) {
+        return entry.handle.use_count() == 1;
+    });
+
+    // Counters
+    static size_t hits = 0;
+    static size_t misses = 0;
+
+    Texture::~Texture() {
+        if (this->texture != nullptr) {
+            SDLHelper::destroyTexture(this->texture);
+        }
+    }
+
+    // Returns the key for the given path and size
+    static std::string keyFor(const std::string & path, const size_t size) {
+        return path + "@" + std::to_string(size);
+    }
+
+    // Create a texture from the given surface (which is freed)
+    static Handle createTexture(SDL_Surface * surface) {
+        Handle handle = std::make_shared<Texture>();
+        handle->texture = nullptr;
+        handle->width = 0;
+        handle->height = 0;
+        handle->bytes = 0;
+        if (surface == nullptr) {
+            return handle;
+        }
+
+        handle->width = surface->w;
+        handle->height = surface->h;
+        handle->bytes = handle->width * handle->height * 4;
+        handle->texture = SDLHelper::convertSurfaceToTexture(surface);
+        return handle;
+    }
+
+    // Add a loaded texture to the cache, only caching if it was actually loaded (so it's retried next time)
+    static void addEntry(const std::string & path, const size_t size, const Handle & handle) {
+        if (handle->texture == nullptr) {
+            return;
+        }
+
+        cache.put(keyFor(path, size), Entry{path, handle}, handle->bytes);
+    }
+
+    Handle get(const std::string & path, const size_t size) {
+        // Use cached copy if present
+        Handle handle = find(path, size);
+        if (handle != nullptr) {
+            return handle;
+        }
+
+        // Otherwise load it
+        misses++;
+        SDL_Surface * surface = SDLHelper::renderImageS(Utils::Image::thumbnailPath(path, size));
+        if (surface == nullptr) {
+            Log::writeWarning("[IMAGE] Unable to load image: " + path);
+        }
+        handle = createTexture(surface);
+        addEntry(path, size, handle);
+        return handle;
+    }
+
+    Handle find(const std::string & path, const size_t size) {
+        Entry * entry = cache.find(keyFor(path, size));
+        if (entry == nullptr) {
+            return nullptr;
+        }
+
+        hits++;
+        return entry->handle;
+    }
+
+    Handle insert(const std::string & path, const size_t size, SDL_Surface * surface) {
+        misses++;
+        Handle handle = createTexture(surface);
+        addEntry(path, size, handle);
+        return handle;
+    }
+
+    void invalidate(const std::string & path) {
+        cache.eraseIf([&path](const Entry & entry) {
+            return entry.path == path;
+        });
+    }
+
+    void setBudget(const size_t size) {
+        cache.setCapacity(size);
+    }
+
+    Stats stats() {
+        return Stats{hits, misses, cache.evictions(), cache.size(), cache.cost(), cache.capacity()};
+    }
+
+    void clear() {
+        cache.clear();
+    }
+};
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <cstdint>
+#include <cstdio>
 #include <ctime>
 #include "lang/Lang.hpp"
 #include "utils/Utils.hpp"
@@ -57,6 +59,18 @@ namespace Utils {
         return std::string(buf);
     }
 
+    std::string hashBytes(const std::vector<unsigned char> & bytes) {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (const unsigned char byte : bytes) {
+            hash ^= byte;
+            hash *= 0x100000001b3;
+        }
+
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(hash));
+        return std::string(buf);
+    }
+
     // From: https://stackoverflow.com/questions/440133/how-do-i-create-a-random-alpha-numeric-string-in-c/12468109#12468109
     static bool seedSet = false;
     std::string randomString(size_t length) {
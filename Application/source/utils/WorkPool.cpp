@@ -0,0 +1,84 @@
+#include <future>
+#include "utils/NX.hpp"
+#include "utils/WorkPool.hpp"
+
+namespace Utils {
+    WorkPool::WorkPool(const size_t threads, const bool low) {
+        for (size_t i = 0; i < (threads == 0 ? 1 : threads); i++) {
+            this->queues.push_back(std::make_unique<Queue>());
+        }
+        this->nextWorker = 0;
+        this->lowPriority = low;
+    }
+
+    bool WorkPool::popTask(const size_t worker, Task & task) {
+        Queue * queue = this->queues[worker].get();
+        std::scoped_lock<std::mutex> mtx(queue->mutex);
+        if (queue->tasks.empty()) {
+            return false;
+        }
+
+        task = std::move(queue->tasks.front());
+        queue->tasks.pop_front();
+        return true;
+    }
+
+    bool WorkPool::stealTask(const size_t worker, Task & task) {
+        // Start with the next worker so that all threads don't target the same queue
+        for (size_t i = 1; i < this->queues.size(); i++) {
+            Queue * queue = this->queues[(worker + i) % this->queues.size()].get();
+            std::scoped_lock<std::mutex> mtx(queue->mutex);
+            if (!queue->tasks.empty()) {
+                task = std::move(queue->tasks.back());
+                queue->tasks.pop_back();
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void WorkPool::runWorker(const size_t worker) {
+        // As tasks can't be added while running, we're done once every queue is empty
+        Task task;
+        while (this->popTask(worker, task) || this->stealTask(worker, task)) {
+            task();
+        }
+    }
+
+    size_t WorkPool::workers() {
+        return this->queues.size();
+    }
+
+    void WorkPool::addTask(const Task & task) {
+        this->addTask(this->nextWorker, task);
+        this->nextWorker = (this->nextWorker + 1) % this->queues.size();
+    }
+
+    void WorkPool::addTask(const size_t worker, const Task & task) {
+        Queue * queue = this->queues[worker % this->queues.size()].get();
+        std::scoped_lock<std::mutex> mtx(queue->mutex);
+        queue->tasks.push_back(task);
+    }
+
+    void WorkPool::run() {
+        // Start a thread for each other worker
+        std::vector< std::future<void> > threads;
+        for (size_t i = 1; i < this->queues.size(); i++) {
+            threads.push_back(std::async(std::launch::async, [this, i]() {
+                if (this->lowPriority) {
+                    Utils::NX::setLowThreadPriority(true);
+                    Utils::NX::setLowFsPriority(true);
+                }
+                this->runWorker(i);
+            }));
+        }
+
+        // Use this thread as the first worker and then wait for the others
+        this->runWorker(0);
+        for (std::future<void> & thread : threads) {
+            thread.get();
+        }
+        this->nextWorker = 0;
+    }
+};
\ No newline at end of file
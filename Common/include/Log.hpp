@@ -1,8 +1,14 @@
 #ifndef LOG_HPP
 #define LOG_HPP
 
+#include <cstddef>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
+// Messages are queued and written to the file by a background thread, so logging never waits on the
+// SD card. Each write function checks the level before anything is formatted, and accepts a list of
+// strings/numbers which are joined together without allocating, e.g. Log::writeInfo("[X] Took ", ms, "ms")
 namespace Log {
     // Log levels (level set will log it and everything below)
     enum class Level {
@@ -13,6 +19,51 @@ namespace Log {
         None = 4
     };
 
+    // Maximum length of a message (longer messages are cut short)
+    constexpr size_t MessageSize = 240;
+
+    // A message built in a fixed-size buffer
+    class Message {
+        private:
+            char text[MessageSize];
+            size_t length;
+
+            // Append each type of value
+            void appendString(const std::string_view);
+            void appendSigned(const long long);
+            void appendUnsigned(const unsigned long long);
+            void appendDouble(const double);
+
+        public:
+            // Constructor creates an empty message
+            Message();
+
+            // Append a string, character, number or enum value to the message
+            template <typename T>
+            void append(const T & value) {
+                if constexpr (std::is_same_v<T, char>) {
+                    this->appendString(std::string_view(&value, 1));
+                } else if constexpr (std::is_same_v<T, bool>) {
+                    this->appendString(value ? "true" : "false");
+                } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+                    this->appendSigned(value);
+                } else if constexpr (std::is_integral_v<T>) {
+                    this->appendUnsigned(value);
+                } else if constexpr (std::is_floating_point_v<T>) {
+                    this->appendDouble(value);
+                } else if constexpr (std::is_enum_v<T>) {
+                    this->appendSigned(static_cast<long long>(value));
+                } else {
+                    this->appendString(std::string_view(value));
+                }
+            }
+
+            // Returns the text of the message (not null-terminated)
+            const char * data() const;
+            // Returns the length of the message
+            size_t size() const;
+    };
+
     // Returns log level (can be used to save some log calls)
     Level loggingLevel();
 
@@ -23,15 +74,42 @@ namespace Log {
     // Returns '?' if an unexpected value is passed
     std::string levelToString(const Level);
 
-    // Open/close file for writing
+    // Open/close file for writing (closing writes any queued messages first)
     bool openFile(std::string, Level = Level::Info);
     void closeFile();
 
+    // Queue a message to be written to the file (it's dropped if the queue is full)
+    void submit(const Level, const Message &);
+
+    // Join the arguments into a message and queue it if the level is logged
+    template <typename... Args>
+    void write(const Level l, const Args &... args) {
+        if (l < loggingLevel()) {
+            return;
+        }
+
+        Message msg;
+        (msg.append(args), ...);
+        submit(l, msg);
+    }
+
     // Log message
-    void writeError(std::string);
-    void writeInfo(std::string);
-    void writeSuccess(std::string);
-    void writeWarning(std::string);
+    template <typename... Args>
+    void writeError(const Args &... args) {
+        write(Level::Error, args...);
+    }
+    template <typename... Args>
+    void writeInfo(const Args &... args) {
+        write(Level::Info, args...);
+    }
+    template <typename... Args>
+    void writeSuccess(const Args &... args) {
+        write(Level::Success, args...);
+    }
+    template <typename... Args>
+    void writeWarning(const Args &... args) {
+        write(Level::Warning, args...);
+    }
 }
 
 #endif
\ No newline at end of file
@@ -14,12 +14,14 @@ namespace Path {
 
         extern const std::string DatabaseFile;
         extern const std::string DatabaseBackupFile;
+        extern const std::string SnapshotFile;
     };
 
     // Application specific paths
     namespace App {
         extern const std::string ConfigFile;
         extern const std::string LogFile;
+        extern const std::string ScanJournalFile;
 
         extern const std::string UpdateFile;
         extern const std::string UpdateFolder;
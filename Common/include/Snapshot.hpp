@@ -0,0 +1,89 @@
+#ifndef SNAPSHOT_HPP
+#define SNAPSHOT_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// The snapshot is a compact copy of the song metadata needed by the sysmodule and overlay,
+// written by the application each time the database is changed. Looking up a song only
+// needs two small reads, so neither of them need to open the database. The file contains
+// (in native byte order):
+//  - A header
+//  - The ID of the first record in each block of records (kept in memory when read)
+//  - One fixed-size record per song, sorted by ID
+//  - A pool of strings, with each record's strings stored one after another
+namespace Snapshot {
+    // Metadata stored for each song
+    struct Entry {
+        int id;                     // ID of song
+        unsigned int duration;      // Duration of song (in seconds)
+        std::string title;          // Title of song
+        std::string artist;         // Name of artist
+        std::string imagePath;      // Path to album art (blank if there is none)
+        std::string path;           // Path to file
+    };
+
+    // Start of the file
+    struct Header {
+        char magic[4];              // Always 'TPSS'
+        uint32_t version;           // Version of the format
+        uint32_t count;             // Number of records
+        uint32_t blockSize;         // Number of records per block
+        uint32_t recordsOffset;     // Offset of the first record
+        uint32_t stringsOffset;     // Offset of the string pool
+    };
+
+    // Fixed-size record for each song
+    struct Record {
+        int32_t id;                 // ID of song
+        uint32_t duration;          // Duration of song (in seconds)
+        uint32_t strings;           // Offset of the strings within the pool
+        uint16_t lengths[4];        // Length of title, artist, image path and file path
+    };
+
+    // Writes the given entries (which must be sorted by ID) to the file at the given path,
+    // replacing it only once everything has been written
+    // Returns true if successful, false otherwise
+    bool write(const std::string &, const std::vector<Entry> &);
+
+    // Reads entries from a snapshot file. The file is kept open until close() is called.
+    class Reader {
+        private:
+            // Open file (nullptr if not open)
+            std::FILE * file;
+            // Header read when opened
+            Header header;
+            // ID of the first record in each block
+            std::vector<int32_t> blocks;
+            // Records of the most recently read block
+            std::vector<Record> records;
+            // Index of the block in the above vector
+            size_t cachedBlock;
+
+            // Read the given number of bytes at the given offset
+            bool readAt(const uint32_t, void *, const size_t);
+
+        public:
+            // Constructor doesn't open anything
+            Reader();
+
+            // Open the snapshot at the given path
+            // Returns false if it couldn't be opened or isn't a supported version
+            bool open(const std::string &);
+            // Returns whether a snapshot is open
+            bool isOpen();
+            // Close the snapshot (if one is open)
+            void close();
+
+            // Find the song with the given ID, filling in the passed entry
+            // Returns false if it isn't in the snapshot or an error occurred
+            bool find(const int, Entry &);
+
+            // Destructor closes the file
+            ~Reader();
+    };
+};
+
+#endif
\ No newline at end of file
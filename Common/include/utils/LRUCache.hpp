@@ -0,0 +1,151 @@
+#ifndef UTILS_LRUCACHE_HPP
+#define UTILS_LRUCACHE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+
+namespace Utils {
+    // A least-recently-used cache mapping keys to values. Each entry has a cost (1 unless given,
+    // so the capacity is a number of entries) and once the total cost is over the capacity the
+    // entries that were accessed longest ago are evicted. Entries can be kept by passing a function
+    // which returns whether a value may be evicted (e.g. while something else is using it).
+    // Note that this class is not thread-safe; callers must provide their own locking.
+    template <typename Key, typename Value>
+    class LRUCache {
+        private:
+            // A stored value
+            struct Entry {
+                Key key;
+                Value value;
+                size_t cost;
+            };
+
+            // Entries ordered from most recently used (front) to least recently used (back)
+            std::list<Entry> entries;
+            // Key -> position in above list
+            std::unordered_map<Key, typename std::list<Entry>::iterator> lookup;
+            // Maximum total cost of entries, and current total
+            size_t capacity_;
+            size_t cost_;
+            // Returns whether a value may be evicted (all can be if nullptr)
+            std::function<bool(const Value &)> evictable;
+            // Number of entries evicted
+            size_t evictions_;
+
+            // Remove the given entry
+            void remove(typename std::list<Entry>::iterator it) {
+                this->cost_ -= it->cost;
+                this->lookup.erase(it->key);
+                this->entries.erase(it);
+            }
+
+            // Remove entries from the back until we're within capacity (skipping any that can't be evicted)
+            void trim() {
+                typename std::list<Entry>::iterator it = this->entries.end();
+                while (this->cost_ > this->capacity_ && it != this->entries.begin()) {
+                    it--;
+                    if (this->evictable != nullptr && !this->evictable(it->value)) {
+                        continue;
+                    }
+
+                    typename std::list<Entry>::iterator next = std::next(it);
+                    this->remove(it);
+                    it = next;
+                    this->evictions_++;
+                }
+            }
+
+        public:
+            // Constructor takes maximum total cost, and optionally the function returning whether a value may be evicted
+            LRUCache(const size_t capacity, const std::function<bool(const Value &)> & evictable = nullptr) {
+                this->capacity_ = capacity;
+                this->cost_ = 0;
+                this->evictable = evictable;
+                this->evictions_ = 0;
+            }
+
+            // Returns/sets the maximum total cost (evicting if required)
+            size_t capacity() const {
+                return this->capacity_;
+            }
+
+            void setCapacity(const size_t capacity) {
+                this->capacity_ = capacity;
+                this->trim();
+            }
+
+            // Returns the number of stored entries, their total cost and the number evicted so far
+            size_t size() const {
+                return this->entries.size();
+            }
+
+            size_t cost() const {
+                return this->cost_;
+            }
+
+            size_t evictions() const {
+                return this->evictions_;
+            }
+
+            // Copies the value for the given key into the passed reference and marks it as used
+            // Returns true if found, false otherwise (value is untouched)
+            bool get(const Key & key, Value & value) {
+                Value * found = this->find(key);
+                if (found == nullptr) {
+                    return false;
+                }
+
+                value = *found;
+                return true;
+            }
+
+            // Returns a pointer to the value for the given key and marks it as used
+            // Returns nullptr if not found (pointer is invalidated by any other call)
+            Value * find(const Key & key) {
+                typename std::unordered_map<Key, typename std::list<Entry>::iterator>::iterator it = this->lookup.find(key);
+                if (it == this->lookup.end()) {
+                    return nullptr;
+                }
+
+                this->entries.splice(this->entries.begin(), this->entries, it->second);
+                return &(it->second->value);
+            }
+
+            // Insert (or replace) the value for the given key with the given cost, evicting the oldest entries if needed
+            void put(const Key & key, const Value & value, const size_t cost = 1) {
+                typename std::unordered_map<Key, typename std::list<Entry>::iterator>::iterator it = this->lookup.find(key);
+                if (it != this->lookup.end()) {
+                    this->remove(it->second);
+                }
+
+                this->entries.push_front(Entry{key, value, cost});
+                this->lookup[key] = this->entries.begin();
+                this->cost_ += cost;
+                this->trim();
+            }
+
+            // Remove every entry whose value matches the given function
+            void eraseIf(const std::function<bool(const Value &)> & func) {
+                typename std::list<Entry>::iterator it = this->entries.begin();
+                while (it != this->entries.end()) {
+                    typename std::list<Entry>::iterator next = std::next(it);
+                    if (func(it->value)) {
+                        this->remove(it);
+                    }
+                    it = next;
+                }
+            }
+
+            // Remove all entries
+            void clear() {
+                this->lookup.clear();
+                this->entries.clear();
+                this->cost_ = 0;
+            }
+    };
+};
+
+#endif
\ No newline at end of file
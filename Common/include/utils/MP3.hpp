@@ -0,0 +1,41 @@
+#ifndef UTILS_MP3_HPP
+#define UTILS_MP3_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Helper functions to read the structure of MPEG audio streams without decoding them
+namespace Utils::MP3 {
+    // Information decoded from a frame header
+    struct FrameHeader {
+        int version;                // 1 = MPEG1, 2 = MPEG2, 3 = MPEG2.5
+        int layer;                  // 1, 2 or 3
+        unsigned int bitrate;       // Bitrate in kbps
+        unsigned int sampleRate;    // Sample rate in Hz
+        bool mono;                  // Whether the frame has a single channel
+        size_t length;              // Length of frame in bytes (including header)
+        unsigned int samples;       // Number of samples in the frame
+    };
+
+    // Length of a stream
+    struct StreamLength {
+        uint64_t samples;           // Total number of samples (per channel)
+        unsigned int sampleRate;    // Sample rate in Hz
+        bool exact;                 // Set false if estimated from the bitrate
+    };
+
+    // Decode the four byte frame header at the given pointer
+    // Returns false if it isn't a valid header
+    bool parseFrameHeader(const unsigned char *, FrameHeader &);
+
+    // Find the first frame in the buffer, checking the following frame (if buffered) to avoid false syncs
+    // Accepts buffer and it's size, sets offset and header of the frame. Returns false if not found.
+    bool findFirstFrame(const unsigned char *, const size_t, size_t &, FrameHeader &);
+
+    // Determine the length of a stream from the Xing/Info (+ LAME) or VBRI header in it's first frame,
+    // otherwise estimate from the first frame's bitrate. Accepts buffer starting at the first frame,
+    // it's size and the number of bytes in the stream from the first frame. Returns false on an error.
+    bool getStreamLength(const unsigned char *, const size_t, const size_t, StreamLength &);
+};
+
+#endif
\ No newline at end of file
@@ -1,7 +1,51 @@
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
 #include <ctime>
 #include "Log.hpp"
 #include <mutex>
+#include <thread>
+
+namespace Log {
+    Message::Message() {
+        this->length = 0;
+    }
+
+    void Message::appendString(const std::string_view str) {
+        size_t count = std::min(str.length(), MessageSize - this->length);
+        std::memcpy(this->text + this->length, str.data(), count);
+        this->length += count;
+    }
+
+    void Message::appendSigned(const long long val) {
+        char buf[24];
+        int count = std::snprintf(buf, sizeof(buf), "%lld", val);
+        this->appendString(std::string_view(buf, count));
+    }
+
+    void Message::appendUnsigned(const unsigned long long val) {
+        char buf[24];
+        int count = std::snprintf(buf, sizeof(buf), "%llu", val);
+        this->appendString(std::string_view(buf, count));
+    }
+
+    void Message::appendDouble(const double val) {
+        // Matches std::to_string()
+        char buf[32];
+        int count = std::snprintf(buf, sizeof(buf), "%f", val);
+        this->appendString(std::string_view(buf, std::min<size_t>(count, sizeof(buf) - 1)));
+    }
+
+    const char * Message::data() const {
+        return this->text;
+    }
+
+    size_t Message::size() const {
+        return this->length;
+    }
+};
 
 // Use blank functions if overlay
 #ifdef _OVERLAY_
@@ -27,52 +71,130 @@ namespace Log {
 
     }
 
-    void writeError(std::string msg) {
-
-    }
-
-    void writeInfo(std::string msg) {
-
-    }
-
-    void writeSuccess(std::string msg) {
-
-    }
-
-    void writeWarning(std::string msg) {
+    void submit(const Level l, const Message & msg) {
 
     }
 };
 
 #else
 
+// Number of messages which can be waiting to be written (the sysmodule's heap is small)
+#ifdef _SYSMODULE_
+#define QUEUE_SIZE 32
+#else
+#define QUEUE_SIZE 256
+#endif
+// Number of milliseconds between writing queued messages
+#define WRITE_INTERVAL 100
+
+// Message waiting to be written
+// The sequence number is used to pass ownership between the threads queueing messages and the
+// writing thread without a lock (see http://www.1024cores.net/home/lock-free-algorithms/queues)
+struct Slot {
+    std::atomic<size_t> sequence;
+    Log::Level level;
+    Log::Message message;
+};
+static Slot queue[QUEUE_SIZE];
+// Position of the next slot to fill
+static std::atomic<size_t> head = 0;
+// Position of the next slot to write (only used by the writing thread)
+static size_t tail = 0;
+// Number of messages dropped as the queue was full
+static std::atomic<size_t> dropped = 0;
+
 // Log file pointer
 static std::atomic<FILE *> file = nullptr;
 // Log level
 static std::atomic<Log::Level> level = Log::Level::None;
-// Mutex to handle actually writing to file
-static std::mutex mutex;
 
-static void writeString(std::string msg) {
-    if (file == nullptr) {
-        return;
-    }
+// Thread which writes queued messages, and what is used to wake it
+static std::thread writer;
+static std::condition_variable wakeCondition;
+static std::mutex wakeMutex;
+static bool running = false;
+// Set when an error is queued so it's written straight away
+static std::atomic<bool> errorQueued = false;
 
-    // Get timestamp
-    std::scoped_lock<std::mutex> mtx(mutex);
+// Write the current time into the given buffer (at least 12 chars)
+static void formatTime(char * buf) {
     std::time_t time = std::time(nullptr);
-    struct tm * t = std::localtime(&time);
-    char buf[12];
-    std::strftime(buf, sizeof(buf), "[%T] ", t);
+    std::strftime(buf, 12, "[%T] ", std::localtime(&time));
+}
+
+// Write all queued messages to the file
+static void writeQueued() {
+    // Messages are stamped with the time they're written, which is at most WRITE_INTERVAL later
+    char timestamp[12];
+    bool wrote = false;
+    while (true) {
+        Slot & slot = queue[tail % QUEUE_SIZE];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+            break;
+        }
 
-    // Lock stream and write!
-    fprintf(file, "%s%s\n", buf, msg.c_str());
-    fflush(file);
+        if (!wrote) {
+            formatTime(timestamp);
+            wrote = true;
+        }
+        const char * prefix = "[I] ";
+        switch (slot.level) {
+            case Log::Level::Success:
+                prefix = "[S] ";
+                break;
+
+            case Log::Level::Warning:
+                prefix = "[W] ";
+                break;
+
+            case Log::Level::Error:
+                prefix = "[E] ";
+                break;
+
+            default:
+                break;
+        }
+        std::fputs(timestamp, file);
+        std::fputs(prefix, file);
+        std::fwrite(slot.message.data(), 1, slot.message.size(), file);
+        std::fputc('\n', file);
+
+        // Hand the slot back for reuse
+        slot.sequence.store(tail + QUEUE_SIZE, std::memory_order_release);
+        tail++;
+    }
+
+    size_t lost = dropped.exchange(0);
+    if (lost > 0) {
+        if (!wrote) {
+            formatTime(timestamp);
+            wrote = true;
+        }
+        std::fprintf(file, "%s[W] %zu messages were dropped as they were logged too quickly\n", timestamp, lost);
+    }
+    if (wrote) {
+        std::fflush(file);
+    }
+}
+
+// Function run by the writing thread
+static void writerThread() {
+    std::unique_lock<std::mutex> mtx(wakeMutex);
+    while (running) {
+        mtx.unlock();
+        writeQueued();
+        mtx.lock();
+        wakeCondition.wait_for(mtx, std::chrono::milliseconds(WRITE_INTERVAL), []() {
+            return (!running || errorQueued.exchange(false));
+        });
+    }
+    mtx.unlock();
+    writeQueued();
 }
 
 namespace Log {
     Level loggingLevel() {
-        return level;
+        return level.load(std::memory_order_relaxed);
     }
 
     void setLogLevel(Level l) {
@@ -109,44 +231,79 @@ namespace Log {
     }
 
     bool openFile(std::string f, Level l) {
+        closeFile();
         level = l;
 
         // Open log file
-        file = fopen(f.c_str(), "a");
-        if (file == nullptr) {
+        FILE * fp = fopen(f.c_str(), "a");
+        if (fp == nullptr) {
             return false;
         }
 
+        // Empty the queue before anything can be added to it
+        for (size_t i = 0; i < QUEUE_SIZE; i++) {
+            queue[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        head = 0;
+        tail = 0;
+        dropped = 0;
+
+        running = true;
+        writer = std::thread(writerThread);
+        file = fp;
         return true;
     }
 
     void closeFile() {
-        if (file != nullptr) {
-            fclose(file);
-            file = nullptr;
+        if (file == nullptr) {
+            return;
         }
-    }
 
-    void writeError(std::string msg) {
-        if (level <= Level::Error) {
-            writeString("[E] " + msg);
-        }
+        // Stop the thread once it has written everything
+        std::unique_lock<std::mutex> mtx(wakeMutex);
+        running = false;
+        mtx.unlock();
+        wakeCondition.notify_one();
+        writer.join();
+
+        fclose(file);
+        file = nullptr;
     }
-    void writeInfo(std::string msg) {
-        if (level <= Level::Info) {
-            writeString("[I] " + msg);
+
+    void submit(const Level l, const Message & msg) {
+        if (file == nullptr) {
+            return;
         }
-    }
-    void writeSuccess(std::string msg) {
-        if (level <= Level::Success) {
-            writeString("[S] " + msg);
+
+        // Claim the next slot, or drop the message if the writer hasn't caught up
+        size_t pos = head.load(std::memory_order_relaxed);
+        Slot * slot;
+        while (true) {
+            slot = &queue[pos % QUEUE_SIZE];
+            size_t seq = slot->sequence.load(std::memory_order_acquire);
+            if (seq == pos) {
+                if (head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (seq < pos) {
+                dropped++;
+                return;
+            } else {
+                pos = head.load(std::memory_order_relaxed);
+            }
         }
-    }
-    void writeWarning(std::string msg) {
-        if (level <= Level::Warning) {
-            writeString("[W] " + msg);
+
+        // Fill the slot and mark it as ready to write
+        slot->level = l;
+        slot->message = msg;
+        slot->sequence.store(pos + 1, std::memory_order_release);
+
+        // Errors are written straight away as they may be followed by a crash
+        if (l == Level::Error) {
+            errorQueued = true;
+            wakeCondition.notify_one();
         }
     }
-}
+};
 
 #endif
\ No newline at end of file
@@ -3,18 +3,25 @@
 // locations throughout the entire project.
 #include "Paths.hpp"
 
+// Folder used as the root of the SD card (only set when built for Linux)
+#ifndef SD_ROOT
+#define SD_ROOT ""
+#endif
+
 namespace Path {
     namespace Common {
-        const std::string ConfigFolder = "/config/TriPlayer/";
-        const std::string SwitchFolder = "/switch/TriPlayer/";
+        const std::string ConfigFolder = SD_ROOT "/config/TriPlayer/";
+        const std::string SwitchFolder = SD_ROOT "/switch/TriPlayer/";
 
         const std::string DatabaseFile = Common::SwitchFolder + "data.sqlite3";
         const std::string DatabaseBackupFile = Common::SwitchFolder + "data_old.sqlite3";
+        const std::string SnapshotFile = Common::SwitchFolder + "snapshot.bin";
     };
 
     namespace App {
         const std::string ConfigFile = Common::ConfigFolder + "app_config.ini";
         const std::string LogFile = Common::SwitchFolder + "application.log";
+        const std::string ScanJournalFile = Common::SwitchFolder + "scan.journal";
 
         const std::string UpdateFolder = Common::SwitchFolder + "update/";
         const std::string UpdateFile = UpdateFolder + "update.zip";
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cstring>
+#include "Log.hpp"
+#include "Snapshot.hpp"
+
+// Increase if the layout of the file changes
+#define FORMAT_VERSION 1
+// Number of records read at once (a block is 1.25kB)
+#define BLOCK_SIZE 64
+// Marks an empty cache
+#define NO_BLOCK SIZE_MAX
+
+static_assert(sizeof(Snapshot::Header) == 24, "Snapshot header must be packed");
+static_assert(sizeof(Snapshot::Record) == 20, "Snapshot record must be packed");
+
+namespace Snapshot {
+    bool write(const std::string & path, const std::vector<Entry> & entries) {
+        Header header;
+        std::memcpy(header.magic, "TPSS", 4);
+        header.version = FORMAT_VERSION;
+        header.count = entries.size();
+        header.blockSize = BLOCK_SIZE;
+        size_t blockCount = (entries.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        header.recordsOffset = sizeof(Header) + blockCount * sizeof(int32_t);
+        header.stringsOffset = header.recordsOffset + entries.size() * sizeof(Record);
+
+        // Build the index, records and string pool in memory
+        std::vector<int32_t> blocks;
+        blocks.reserve(blockCount);
+        std::vector<Record> records;
+        records.reserve(entries.size());
+        std::string strings;
+        for (size_t i = 0; i < entries.size(); i++) {
+            const Entry & e = entries[i];
+            if (i % BLOCK_SIZE == 0) {
+                blocks.push_back(e.id);
+            }
+
+            Record r;
+            r.id = e.id;
+            r.duration = e.duration;
+            r.strings = strings.length();
+            const std::string * values[4] = {&e.title, &e.artist, &e.imagePath, &e.path};
+            for (size_t j = 0; j < 4; j++) {
+                r.lengths[j] = std::min<size_t>(values[j]->length(), UINT16_MAX);
+                strings.append(*values[j], 0, r.lengths[j]);
+            }
+            records.push_back(r);
+        }
+
+        // Write to a temporary file first so a partially written snapshot is never read
+        std::string tmpPath = path + ".tmp";
+        std::FILE * fp = std::fopen(tmpPath.c_str(), "wb");
+        if (fp == nullptr) {
+            Log::writeError("[SNAPSHOT] Unable to open " + tmpPath + " for writing");
+            return false;
+        }
+        bool ok = (std::fwrite(&header, sizeof(Header), 1, fp) == 1);
+        ok = ok && (std::fwrite(blocks.data(), sizeof(int32_t), blocks.size(), fp) == blocks.size());
+        ok = ok && (std::fwrite(records.data(), sizeof(Record), records.size(), fp) == records.size());
+        ok = ok && (std::fwrite(strings.data(), 1, strings.length(), fp) == strings.length());
+        ok = (std::fclose(fp) == 0) && ok;
+        if (!ok) {
+            Log::writeError("[SNAPSHOT] Unable to write to " + tmpPath);
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+
+        // Rename doesn't replace existing files on the Switch, so the old one is removed first
+        std::remove(path.c_str());
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            Log::writeError("[SNAPSHOT] Unable to rename " + tmpPath + " to " + path);
+            return false;
+        }
+        return true;
+    }
+
+    Reader::Reader() {
+        this->file = nullptr;
+        this->cachedBlock = NO_BLOCK;
+    }
+
+    bool Reader::readAt(const uint32_t offset, void * buffer, const size_t size) {
+        if (std::fseek(this->file, offset, SEEK_SET) != 0) {
+            return false;
+        }
+        return (std::fread(buffer, 1, size, this->file) == size);
+    }
+
+    bool Reader::open(const std::string & path) {
+        this->close();
+        this->file = std::fopen(path.c_str(), "rb");
+        if (this->file == nullptr) {
+            return false;
+        }
+
+        // Check the header before reading the index
+        bool ok = this->readAt(0, &this->header, sizeof(Header));
+        if (!ok || std::memcmp(this->header.magic, "TPSS", 4) != 0 || this->header.version != FORMAT_VERSION || this->header.blockSize == 0) {
+            Log::writeError("[SNAPSHOT] " + path + " is not a supported snapshot");
+            this->close();
+            return false;
+        }
+
+        this->blocks.resize((this->header.count + this->header.blockSize - 1) / this->header.blockSize);
+        if (!this->readAt(sizeof(Header), this->blocks.data(), this->blocks.size() * sizeof(int32_t))) {
+            Log::writeError("[SNAPSHOT] Unable to read the index of " + path);
+            this->close();
+            return false;
+        }
+        return true;
+    }
+
+    bool Reader::isOpen() {
+        return (this->file != nullptr);
+    }
+
+    void Reader::close() {
+        if (this->file != nullptr) {
+            std::fclose(this->file);
+            this->file = nullptr;
+        }
+        this->blocks.clear();
+        this->records.clear();
+        this->cachedBlock = NO_BLOCK;
+    }
+
+    bool Reader::find(const int id, Entry & entry) {
+        if (this->file == nullptr) {
+            return false;
+        }
+
+        // Find the last block starting at or before the ID
+        std::vector<int32_t>::iterator it = std::upper_bound(this->blocks.begin(), this->blocks.end(), id);
+        if (it == this->blocks.begin()) {
+            return false;
+        }
+        size_t block = (it - this->blocks.begin()) - 1;
+
+        // Read the whole block unless it was the last one read
+        if (block != this->cachedBlock) {
+            size_t first = block * this->header.blockSize;
+            this->records.resize(std::min<size_t>(this->header.blockSize, this->header.count - first));
+            if (!this->readAt(this->header.recordsOffset + first * sizeof(Record), this->records.data(), this->records.size() * sizeof(Record))) {
+                Log::writeError("[SNAPSHOT] Unable to read records");
+                this->cachedBlock = NO_BLOCK;
+                return false;
+            }
+            this->cachedBlock = block;
+        }
+
+        std::vector<Record>::iterator rIt = std::lower_bound(this->records.begin(), this->records.end(), id, [](const Record & r, const int id) {
+            return r.id < id;
+        });
+        if (rIt == this->records.end() || rIt->id != id) {
+            return false;
+        }
+
+        // Read all of the record's strings at once and split them up
+        const Record & r = *rIt;
+        std::string strings(r.lengths[0] + r.lengths[1] + r.lengths[2] + r.lengths[3], '\0');
+        if (!this->readAt(this->header.stringsOffset + r.strings, strings.data(), strings.length())) {
+            Log::writeError("[SNAPSHOT] Unable to read strings for ID " + std::to_string(id));
+            return false;
+        }
+
+        entry.id = r.id;
+        entry.duration = r.duration;
+        size_t pos = 0;
+        std::string * values[4] = {&entry.title, &entry.artist, &entry.imagePath, &entry.path};
+        for (size_t i = 0; i < 4; i++) {
+            values[i]->assign(strings, pos, r.lengths[i]);
+            pos += r.lengths[i];
+        }
+        return true;
+    }
+
+    Reader::~Reader() {
+        this->close();
+    }
+};
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include <cstring>
+#include "utils/MP3.hpp"
+
+// Position of a VBRI header from the start of a frame
+#define VBRI_OFFSET 36
+
+namespace Utils::MP3 {
+    static inline uint32_t readBE32(const unsigned char * p) {
+        return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+    }
+
+    bool parseFrameHeader(const unsigned char * p, FrameHeader & h) {
+        static const unsigned int bitrates[2][3][16] = {
+            {{0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+             {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+             {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0}},
+            {{0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+             {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},
+             {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0}}
+        };
+        static const unsigned int sampleRates[3][3] = {
+            {44100, 48000, 32000},
+            {22050, 24000, 16000},
+            {11025, 12000, 8000}
+        };
+
+        // Check sync bits and reserved values
+        if (p[0] != 0xFF || (p[1] & 0xE0) != 0xE0) {
+            return false;
+        }
+        const int versionBits = (p[1] >> 3) & 0x3;
+        const int layerBits = (p[1] >> 1) & 0x3;
+        const int bitrateIdx = p[2] >> 4;
+        const int sampleIdx = (p[2] >> 2) & 0x3;
+        if (versionBits == 1 || layerBits == 0 || bitrateIdx == 0 || bitrateIdx == 15 || sampleIdx == 3) {
+            return false;
+        }
+
+        h.version = (versionBits == 3 ? 1 : versionBits == 2 ? 2 : 3);
+        h.layer = 4 - layerBits;
+        h.bitrate = bitrates[h.version == 1 ? 0 : 1][h.layer - 1][bitrateIdx];
+        h.sampleRate = sampleRates[h.version - 1][sampleIdx];
+        h.mono = ((p[3] >> 6) == 3);
+
+        const unsigned int padding = (p[2] >> 1) & 0x1;
+        if (h.layer == 1) {
+            h.samples = 384;
+            h.length = ((12000 * h.bitrate / h.sampleRate) + padding) * 4;
+        } else {
+            h.samples = (h.layer == 3 && h.version != 1 ? 576 : 1152);
+            h.length = (h.samples / 8 * 1000 * h.bitrate / h.sampleRate) + padding;
+        }
+        return true;
+    }
+
+    bool findFirstFrame(const unsigned char * data, const size_t size, size_t & offset, FrameHeader & header) {
+        for (size_t i = 0; i + 4 <= size; i++) {
+            if (!parseFrameHeader(data + i, header)) {
+                continue;
+            }
+
+            // Accept if the next frame matches (or isn't buffered)
+            FrameHeader next;
+            size_t nextPos = i + header.length;
+            if (nextPos + 4 > size || (parseFrameHeader(data + nextPos, next) && next.version == header.version && next.layer == header.layer && next.sampleRate == header.sampleRate)) {
+                offset = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool getStreamLength(const unsigned char * data, const size_t size, const size_t streamSize, StreamLength & length) {
+        FrameHeader header;
+        if (size < 4 || !parseFrameHeader(data, header)) {
+            return false;
+        }
+        length.sampleRate = header.sampleRate;
+
+        // Xing/Info header is placed after the side information
+        size_t pos = 4 + (header.version == 1 ? (header.mono ? 17 : 32) : (header.mono ? 9 : 17));
+        if (header.layer == 3 && pos + 8 <= size && (std::memcmp(data + pos, "Xing", 4) == 0 || std::memcmp(data + pos, "Info", 4) == 0)) {
+            const uint32_t flags = readBE32(data + pos + 4);
+            pos += 8;
+            uint32_t frames = 0;
+            if ((flags & 0x1) && pos + 4 <= size) {
+                frames = readBE32(data + pos);
+                pos += 4;
+            }
+            pos += (flags & 0x2 ? 4 : 0) + (flags & 0x4 ? 100 : 0) + (flags & 0x8 ? 4 : 0);
+
+            if (frames > 0) {
+                length.samples = static_cast<uint64_t>(frames) * header.samples;
+                length.exact = true;
+
+                // A LAME tag stores the encoder delay and padding (which gapless decoding removes)
+                if (pos + 24 <= size && (std::memcmp(data + pos, "LAME", 4) == 0 || std::memcmp(data + pos, "Lavf", 4) == 0 || std::memcmp(data + pos, "Lavc", 4) == 0)) {
+                    const uint32_t delay = (data[pos + 21] << 4) | (data[pos + 22] >> 4);
+                    const uint32_t padding = ((data[pos + 22] & 0x0F) << 8) | data[pos + 23];
+                    if (delay + padding < length.samples) {
+                        length.samples -= delay + padding;
+                    }
+                }
+                return true;
+            }
+        }
+
+        // VBRI header is always at a fixed position
+        if (header.layer == 3 && VBRI_OFFSET + 18 <= size && std::memcmp(data + VBRI_OFFSET, "VBRI", 4) == 0) {
+            const uint32_t frames = readBE32(data + VBRI_OFFSET + 14);
+            if (frames > 0) {
+                length.samples = static_cast<uint64_t>(frames) * header.samples;
+                length.exact = true;
+                return true;
+            }
+        }
+
+        // Otherwise assume the bitrate is constant
+        length.samples = (static_cast<uint64_t>(streamSize) * 8 * header.sampleRate) / (header.bitrate * 1000);
+        length.exact = false;
+        return true;
+    }
+};
\ No newline at end of file
@@ -3,16 +3,18 @@
 
 #include "tesla.hpp"
 
-// Forward declare database object
-class Database;
+// Forward declare snapshot object
+namespace Snapshot {
+    class Reader;
+};
 
 // The main overlay class. Contains code to start/stop services and load the initial
 // GUI frame. The frame loaded depends on whether the services started successfully.
 class TriOverlay : public tsl::Overlay {
     private:
-        Database * database;        // Database object passed to gui
-        bool dbInitialized;         // Indicates whether database opened successfully
-        bool triInitialized;        // Indicates whether TriPlayer initialized
+        Snapshot::Reader * snapshot;    // Snapshot object passed to gui
+        bool dbInitialized;             // Indicates whether the snapshot opened successfully
+        bool triInitialized;            // Indicates whether TriPlayer initialized
 
     public:
         // Constructor initializes variables
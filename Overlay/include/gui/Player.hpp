@@ -4,10 +4,12 @@
 #include "tesla.hpp"
 
 // Forward declarations
-class Database;
 namespace Element {
     class Player;
 };
+namespace Snapshot {
+    class Reader;
+};
 
 // The Player gui represents the main player controls frame.
 // It contains a single Player element, which in turn presents
@@ -15,17 +17,17 @@ namespace Element {
 namespace Gui {
     class Player : public tsl::Gui {
         private:
-            Database * database;        // Database used to read metadata from
-            Element::Player * player;   // Main element
-            unsigned char ticks;        // Number of ticks in update() since last check
+            Snapshot::Reader * snapshot;    // Snapshot used to read metadata from
+            Element::Player * player;       // Main element
+            unsigned char ticks;            // Number of ticks in update() since last check
 
-            int currentSongID;          // ID of song matching stored metadata
+            int currentSongID;              // ID of song matching stored metadata
 
         public:
             // Initialize objects
-            Player(Database *);
+            Player(Snapshot::Reader *);
 
-            // Accepts database object to read metadata from
+            // Accepts snapshot object to read metadata from
             tsl::elm::Element * createUI();
 
             // Periodically check if we need to update the element
@@ -1,7 +1,8 @@
-#include "Database.hpp"
 #include "ipc/TriPlayer.hpp"
 #include "gui/Error.hpp"
 #include "gui/Player.hpp"
+#include "Paths.hpp"
+#include "Snapshot.hpp"
 #include "TriOverlay.hpp"
 
 TriOverlay::TriOverlay() : tsl::Overlay() {
@@ -15,14 +16,14 @@ void TriOverlay::initServices() {
     // Attempt to connect to TriPlayer
     this->triInitialized = TriPlayer::initialize();
 
-    // Attempt to open connection to database to ensure it's working properly
-    this->database = new Database();
-    this->dbInitialized = this->database->openReadOnly();
-    this->database->close();
+    // Attempt to open the snapshot to ensure it's working properly
+    this->snapshot = new Snapshot::Reader();
+    this->dbInitialized = this->snapshot->open(Path::Common::SnapshotFile);
+    this->snapshot->close();
 }
 
 void TriOverlay::exitServices() {
-    delete this->database;
+    delete this->snapshot;
 
     if (this->triInitialized) {
         TriPlayer::exit();
@@ -39,5 +40,5 @@ std::unique_ptr<tsl::Gui> TriOverlay::loadInitialGui() {
     }
 
     // Otherwise proceed to normal (player) frame
-    return std::make_unique<Gui::Player>(this->database);
+    return std::make_unique<Gui::Player>(this->snapshot);
 }
\ No newline at end of file
@@ -1,12 +1,13 @@
-#include "Database.hpp"
 #include "element/Player.hpp"
 #include "gui/Player.hpp"
 #include "ipc/TriPlayer.hpp"
+#include "Paths.hpp"
+#include "Snapshot.hpp"
 #include "utils/FS.hpp"
 
 namespace Gui {
-    Player::Player(Database * db) {
-        this->database = db;
+    Player::Player(Snapshot::Reader * snapshot) {
+        this->snapshot = snapshot;
         this->player = nullptr;
         this->currentSongID = -100;
         this->ticks = 0;
@@ -41,15 +42,16 @@ namespace Gui {
             return;
         }
         if (songID != this->currentSongID) {
-            // Get metadata from database
-            Metadata meta;
+            // Get metadata from the snapshot
+            Snapshot::Entry meta;
             meta.id = -3;
             if (songID >= 0) {
-                // Open a very brief connection to the database to fetch id
-                bool ok = this->database->openReadOnly();
-                if (ok) {
-                    meta = this->database->getMetadataForID(songID);
-                    this->database->close();
+                // Only keep the snapshot open briefly as the application replaces it
+                if (this->snapshot->open(Path::Common::SnapshotFile)) {
+                    if (!this->snapshot->find(songID, meta)) {
+                        meta.id = -2;
+                    }
+                    this->snapshot->close();
                 }
             }
             this->currentSongID = songID;
@@ -0,0 +1,181 @@
+// Stand-in for the parts of libnx used by the sysmodule's IPC code, so it can be built and run on
+// Linux. The thread-local storage has a simplified layout which is only understood by the functions
+// below. Clients and the server talk over a Unix domain socket instead of the kernel (see the
+// Host* structures at the bottom), using the same command IDs.
+#ifndef HOST_SWITCH_H
+#define HOST_SWITCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int32_t s32;
+typedef u32 Result;
+typedef u32 Handle;
+
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_FAILED(res) ((res) != 0)
+#define MAKERESULT(module, description) ((((module) & 0x1FF)) | ((description) & 0x1FFF) << 9)
+#define Module_Libnx 345
+
+#define MAX_WAIT_OBJECTS 0x40
+
+#define CMIF_IN_HEADER_MAGIC 0x49434653
+#define CMIF_OUT_HEADER_MAGIC 0x4F434653
+
+enum CmifCommandType {
+    CmifCommandType_Invalid = 0,
+    CmifCommandType_Close = 2,
+    CmifCommandType_Request = 4
+};
+
+struct HipcMetadata {
+    u32 type;
+    u32 num_send_buffers;
+    u32 num_recv_buffers;
+    u32 num_data_words;
+};
+
+struct HipcBufferDescriptor {
+    void * address;
+    size_t size;
+};
+
+// Layout of the stand-in thread-local storage
+struct HipcTls {
+    HipcMetadata meta;
+    HipcBufferDescriptor send_buffers[2];
+    HipcBufferDescriptor recv_buffers[2];
+    alignas(16) u32 data_words[64];
+};
+
+struct HipcParsedRequest {
+    HipcMetadata meta;
+    struct {
+        HipcBufferDescriptor * send_buffers;
+        HipcBufferDescriptor * recv_buffers;
+        u32 * data_words;
+    } data;
+};
+
+struct HipcRequest {
+    HipcBufferDescriptor * send_buffers;
+    HipcBufferDescriptor * recv_buffers;
+    u32 * data_words;
+};
+
+inline void * armGetTls() {
+    alignas(16) static thread_local HipcTls tls;
+    return &tls;
+}
+
+inline HipcParsedRequest hipcParseRequest(void * base) {
+    HipcTls * tls = static_cast<HipcTls *>(base);
+    return HipcParsedRequest{tls->meta, {tls->send_buffers, tls->recv_buffers, tls->data_words}};
+}
+
+inline HipcRequest hipcMakeRequest(void * base, HipcMetadata meta) {
+    HipcTls * tls = static_cast<HipcTls *>(base);
+    tls->meta = meta;
+    return HipcRequest{tls->send_buffers, tls->recv_buffers, tls->data_words};
+}
+#define hipcMakeRequestInline(_base, ...) hipcMakeRequest((_base), HipcMetadata{ __VA_ARGS__ })
+
+inline void * hipcGetBufferAddress(const HipcBufferDescriptor * desc) {
+    return desc->address;
+}
+
+inline size_t hipcGetBufferSize(const HipcBufferDescriptor * desc) {
+    return desc->size;
+}
+
+inline void * cmifGetAlignedDataStart(u32 * data_words, void * base) {
+    intptr_t start = reinterpret_cast<u8 *>(data_words) - static_cast<u8 *>(base);
+    intptr_t aligned = (start + 15) & ~15;
+    return static_cast<u8 *>(base) + aligned;
+}
+
+// Services (the session is the socket's file descriptor)
+struct SmServiceName {
+    char name[8];
+};
+
+struct Service {
+    Handle session;
+};
+
+inline SmServiceName smEncodeName(const char * name) {
+    SmServiceName out = {};
+    for (size_t i = 0; i < sizeof(out.name) && name[i] != '\0'; i++) {
+        out.name[i] = name[i];
+    }
+    return out;
+}
+
+// Returns the session used to talk to sm (only command 65100, 'has service', is supported)
+Service * smGetServiceSession();
+// Connects to the named server
+Result smGetServiceWrapper(Service *, SmServiceName);
+// Closes the connection to a server
+void serviceClose(Service *);
+
+enum SfBufferAttr {
+    SfBufferAttr_In = 1 << 0,
+    SfBufferAttr_Out = 1 << 1,
+    SfBufferAttr_HipcMapAlias = 1 << 2
+};
+
+struct SfBufferAttrs {
+    u32 attr0;
+    u32 attr1;
+    u32 attr2;
+    u32 attr3;
+    u32 attr4;
+    u32 attr5;
+    u32 attr6;
+    u32 attr7;
+};
+
+struct SfBuffer {
+    const void * ptr;
+    size_t size;
+};
+
+struct SfDispatchParams {
+    SfBufferAttrs buffer_attrs;
+    SfBuffer buffers[8];
+};
+
+// Sends a request and waits for the response (only the first 'in' and 'out' buffers are passed)
+Result serviceDispatchImpl(Service *, u32, const void *, u32, void *, u32, SfDispatchParams);
+
+#define serviceDispatch(_s, _rid, ...) serviceDispatchImpl((_s), (_rid), nullptr, 0, nullptr, 0, (SfDispatchParams){ __VA_ARGS__ })
+#define serviceDispatchIn(_s, _rid, _in, ...) serviceDispatchImpl((_s), (_rid), &(_in), sizeof(_in), nullptr, 0, (SfDispatchParams){ __VA_ARGS__ })
+#define serviceDispatchOut(_s, _rid, _out, ...) serviceDispatchImpl((_s), (_rid), nullptr, 0, &(_out), sizeof(_out), (SfDispatchParams){ __VA_ARGS__ })
+#define serviceDispatchInOut(_s, _rid, _in, _out, ...) serviceDispatchImpl((_s), (_rid), &(_in), sizeof(_in), &(_out), sizeof(_out), (SfDispatchParams){ __VA_ARGS__ })
+
+// Sent by a client for each request, followed by the data words and the 'in' buffer
+struct HostRequestHeader {
+    u32 type;               // CmifCommandType
+    u32 dataSize;           // Bytes of data words (CMIF header and arguments)
+    u32 sendSize;           // Size of the 'in' buffer
+    u32 recvSize;           // Size of the 'out' buffer
+};
+
+// Sent back by the server, followed by the data words and the contents of the 'out' buffer
+struct HostResponseHeader {
+    u32 dataSize;           // Bytes of data words (CMIF header and reply values)
+    u32 recvSize;           // Size of the 'out' buffer
+};
+
+// Returns the path of the socket the named server listens on
+std::string hostSocketPath(const SmServiceName &);
+// Read/write exactly the given number of bytes, returning false on an error or disconnection
+bool hostReadAll(int, void *, size_t);
+bool hostWriteAll(int, const void *, size_t);
+
+#endif
\ No newline at end of file
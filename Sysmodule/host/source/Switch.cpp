@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <switch.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Returned when a request can't be sent or its response can't be read
+constexpr Result socketError = MAKERESULT(Module_Libnx, 1);
+
+// Largest CMIF header plus arguments which fits in the thread-local storage
+constexpr size_t maxDataSize = sizeof(HipcTls::data_words);
+
+// Session used to talk to 'sm' (never connected)
+static Service smService = {0};
+
+// Opens a socket connected to the named server, returning -1 if it isn't running
+static int connectTo(const SmServiceName & name) {
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    std::string path = hostSocketPath(name);
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Returns the first buffer with the given attribute, or nullptr if there isn't one
+static const SfBuffer * findBuffer(const SfDispatchParams & disp, const u32 attr) {
+    u32 attrs[8];
+    std::memcpy(attrs, &disp.buffer_attrs, sizeof(attrs));
+    for (size_t i = 0; i < 8; i++) {
+        if (attrs[i] & attr) {
+            return &disp.buffers[i];
+        }
+    }
+    return nullptr;
+}
+
+std::string hostSocketPath(const SmServiceName & name) {
+    return "/tmp/sys-triplayer-" + std::string(name.name, strnlen(name.name, sizeof(name.name))) + ".sock";
+}
+
+bool hostReadAll(int fd, void * buf, size_t size) {
+    u8 * pos = static_cast<u8 *>(buf);
+    while (size > 0) {
+        ssize_t count = recv(fd, pos, size, 0);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        pos += count;
+        size -= count;
+    }
+    return true;
+}
+
+bool hostWriteAll(int fd, const void * buf, size_t size) {
+    const u8 * pos = static_cast<const u8 *>(buf);
+    while (size > 0) {
+        // Don't raise SIGPIPE if the other end has gone
+        ssize_t count = send(fd, pos, size, MSG_NOSIGNAL);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        pos += count;
+        size -= count;
+    }
+    return true;
+}
+
+Service * smGetServiceSession() {
+    return &smService;
+}
+
+Result smGetServiceWrapper(Service * s, SmServiceName name) {
+    int fd = connectTo(name);
+    if (fd < 0) {
+        return socketError;
+    }
+    s->session = fd;
+    return 0;
+}
+
+void serviceClose(Service * s) {
+    // Let the server know before disconnecting (as the kernel would)
+    HostRequestHeader header = {CmifCommandType_Close, 0, 0, 0};
+    HostResponseHeader response;
+    if (hostWriteAll(s->session, &header, sizeof(header))) {
+        hostReadAll(s->session, &response, sizeof(response));
+    }
+    close(s->session);
+}
+
+Result serviceDispatchImpl(Service * s, u32 id, const void * in, u32 inSize, void * out, u32 outSize, SfDispatchParams disp) {
+    // sm only needs to say whether a server is running
+    if (s == &smService) {
+        if (id != 65100 || inSize != sizeof(SmServiceName) || outSize != 1) {
+            return socketError;
+        }
+        int fd = connectTo(*static_cast<const SmServiceName *>(in));
+        *static_cast<u8 *>(out) = (fd >= 0);
+        if (fd >= 0) {
+            // The server sees this as a session being opened and closed
+            close(fd);
+        }
+        return 0;
+    }
+
+    // Data words are the CMIF header followed by the arguments
+    if (16 + inSize > maxDataSize) {
+        return socketError;
+    }
+    alignas(16) u8 data[maxDataSize];
+    u64 magic = CMIF_IN_HEADER_MAGIC;
+    u64 cmd = id;
+    std::memcpy(data, &magic, sizeof(magic));
+    std::memcpy(data + 8, &cmd, sizeof(cmd));
+    if (inSize > 0) {
+        std::memcpy(data + 16, in, inSize);
+    }
+
+    // Send request
+    const SfBuffer * sendBuf = findBuffer(disp, SfBufferAttr_In);
+    const SfBuffer * recvBuf = findBuffer(disp, SfBufferAttr_Out);
+    HostRequestHeader header = {CmifCommandType_Request, 16 + inSize, static_cast<u32>(sendBuf ? sendBuf->size : 0), static_cast<u32>(recvBuf ? recvBuf->size : 0)};
+    if (!hostWriteAll(s->session, &header, sizeof(header)) || !hostWriteAll(s->session, data, header.dataSize)) {
+        return socketError;
+    }
+    if (header.sendSize > 0 && !hostWriteAll(s->session, sendBuf->ptr, header.sendSize)) {
+        return socketError;
+    }
+
+    // Read response
+    HostResponseHeader response;
+    if (!hostReadAll(s->session, &response, sizeof(response))) {
+        return socketError;
+    }
+    if (response.dataSize < 16 || response.dataSize > maxDataSize || response.recvSize != header.recvSize) {
+        return socketError;
+    }
+    if (!hostReadAll(s->session, data, response.dataSize)) {
+        return socketError;
+    }
+    if (response.recvSize > 0 && !hostReadAll(s->session, const_cast<void *>(recvBuf->ptr), response.recvSize)) {
+        return socketError;
+    }
+
+    // Check header and copy reply value
+    std::memcpy(&magic, data, sizeof(magic));
+    if (magic != CMIF_OUT_HEADER_MAGIC) {
+        return socketError;
+    }
+    Result rc;
+    std::memcpy(&rc, data + 8, sizeof(rc));
+    if (R_SUCCEEDED(rc) && outSize > 0) {
+        size_t size = std::min<size_t>(outSize, response.dataSize - 16);
+        std::memcpy(out, data + 16, size);
+        std::memset(static_cast<u8 *>(out) + size, 0, outSize - size);
+    }
+    return rc;
+}
\ No newline at end of file
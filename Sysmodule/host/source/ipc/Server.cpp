@@ -0,0 +1,214 @@
+#include <cerrno>
+#include <cstring>
+#include "ipc/Server.hpp"
+#include "Log.hpp"
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Host version of the server, which listens on a Unix domain socket instead of registering with sm.
+// Each request is copied onto the (stand-in) thread-local storage, so it's read and answered by
+// Ipc::Request exactly as on the Switch.
+namespace Ipc {
+    constexpr int waitTimeout = 100;                            // Wait timeout when processing (in ms, so exit() is noticed)
+
+    // Copies of the client's buffers for the request being handled (only grow, so are rarely allocated)
+    static std::vector<uint8_t> sendBuffer;
+    static std::vector<uint8_t> recvBuffer;
+
+    Server::Server(const std::string & name, const size_t maxClients) {
+        // Set status variables
+        this->error_ = false;
+        this->handler = nullptr;
+        this->maxHandles = maxClients + 1;
+        this->handles.reserve(this->maxHandles);
+
+        // Exit if invalid session count given
+        if (maxClients < 1 || maxClients > MAX_WAIT_OBJECTS - 1) {
+            Log::writeError("[IPC] Invalid number of sessions requested");
+            this->error_ = true;
+            return;
+        }
+
+        // Create server (removing any socket left behind by a previous run)
+        this->serverName = smEncodeName(name.c_str());
+        std::string path = hostSocketPath(this->serverName);
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str());
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(fd, maxClients) != 0) {
+            Log::writeError("[IPC] Couldn't create server at ", path, ": ", std::strerror(errno));
+            if (fd >= 0) {
+                close(fd);
+            }
+            return;
+        }
+
+        Log::writeSuccess("[IPC] Server started at ", path);
+        this->handles.push_back(fd);
+    }
+
+    bool Server::processSession(const int32_t index) {
+        int fd = this->handles[index];
+
+        // Read request (a client disconnecting is the same as it closing the session)
+        HostRequestHeader header;
+        HipcTls * tls = static_cast<HipcTls *>(armGetTls());
+        uint8_t * data = static_cast<uint8_t *>(cmifGetAlignedDataStart(tls->data_words, tls));
+        bool ok = hostReadAll(fd, &header, sizeof(header));
+        ok = ok && header.dataSize <= sizeof(tls->data_words) && hostReadAll(fd, data, header.dataSize);
+        if (ok && header.sendSize > sendBuffer.size()) {
+            sendBuffer.resize(header.sendSize);
+        }
+        ok = ok && hostReadAll(fd, sendBuffer.data(), header.sendSize);
+        if (!ok) {
+            Log::writeInfo("[IPC] Client ", index, " disconnected (closing handle)");
+            close(fd);
+            this->handles.erase(this->handles.begin() + index);
+            return true;        // Return true as closing a session is valid behaviour
+        }
+        if (header.recvSize > recvBuffer.size()) {
+            recvBuffer.resize(header.recvSize);
+        }
+
+        // Place it on the thread-local storage as the kernel would
+        tls->meta.type = header.type;
+        tls->meta.num_data_words = (header.dataSize + 3) / 4;
+        tls->meta.num_send_buffers = (header.sendSize > 0 ? 1 : 0);
+        tls->send_buffers[0] = HipcBufferDescriptor{sendBuffer.data(), header.sendSize};
+        tls->meta.num_recv_buffers = (header.recvSize > 0 ? 1 : 0);
+        tls->recv_buffers[0] = HipcBufferDescriptor{recvBuffer.data(), header.recvSize};
+
+        // Read received data into the request object
+        Request * request = &this->request;
+        if (!request->fromTLS()) {
+            Log::writeError("[IPC] An error occurred reading the request (most likely bad header magic)");
+            return false;
+        }
+
+        // Take action based on request type
+        bool closeSession = false;
+        switch (request->type()) {
+            // Call handler to prepare response
+            case Request::Type::Request: {
+                uint32_t result = this->handler(request);
+                request->setResult(result);
+                request->toResponseTLS();
+                break;
+            }
+
+            // Prepare default response
+            case Request::Type::Close:
+                request->setResult(0);
+                request->toResponseTLS();
+                closeSession = true;
+                break;
+
+            // Otherwise prepare error response
+            default:
+                Log::writeInfo("[IPC] Received unexpected CmifCommand");
+                request->setResult(MAKERESULT(11, 403));
+                request->toResponseTLS();
+                break;
+        }
+
+        // Send response
+        HostResponseHeader response = {tls->meta.num_data_words * 4, header.recvSize};
+        ok = hostWriteAll(fd, &response, sizeof(response)) && hostWriteAll(fd, data, response.dataSize);
+        ok = ok && hostWriteAll(fd, recvBuffer.data(), response.recvSize);
+
+        // Close session on error or close request
+        if (!ok || closeSession) {
+            Log::writeInfo("Closing session ", index, " due to error/request");
+            close(fd);
+            this->handles.erase(this->handles.begin() + index);
+        }
+
+        return true;
+    }
+
+    bool Server::processNewSession() {
+        int session = accept(this->handles[0], nullptr, nullptr);
+        if (session >= 0) {
+            // Check we have room
+            if (this->handles.size() >= this->maxHandles) {
+                Log::writeWarning("[IPC] Couldn't handle new session due to limit");
+                close(session);
+
+            // Add session to vector
+            } else {
+                this->handles.push_back(session);
+            }
+
+            return true;
+        }
+
+        return (errno == EINTR || errno == ECONNABORTED);
+    }
+
+    void Server::setRequestHandler(Handler f) {
+        this->handler = f;
+    }
+
+    bool Server::process() {
+        if (this->error_ || this->handles.empty()) {
+            return false;
+        }
+
+        // Wait for a client to send a request/message
+        pollfd fds[MAX_WAIT_OBJECTS];
+        for (size_t i = 0; i < this->handles.size(); i++) {
+            fds[i] = pollfd{static_cast<int>(this->handles[i]), POLLIN, 0};
+        }
+        int count = poll(fds, this->handles.size(), waitTimeout);
+        if (count == 0 || (count < 0 && errno == EINTR)) {
+            return !this->error_;
+        }
+        if (count < 0) {
+            Log::writeError("[IPC] poll failed: ", std::strerror(errno));
+            this->error_ = true;
+            return false;
+        }
+
+        // Handle the first handle with something waiting (like svcWaitSynchronization)
+        int32_t handleIndex = 0;
+        while (fds[handleIndex].revents == 0) {
+            handleIndex++;
+        }
+
+        // If the index is not zero then we need to handle that client's request
+        bool ok = true;
+        if (handleIndex != 0) {
+            ok = this->processSession(handleIndex);
+
+        // Otherwise prepare for a new session
+        } else {
+            ok = this->processNewSession();
+        }
+
+        // Exit on an error
+        if (!ok) {
+            Log::writeInfo("[IPC] Failed to handle " + std::string(handleIndex == 0 ? "server" : "client " + std::to_string(handleIndex)) + " request");
+            this->error_ = true;
+        }
+
+        return !this->error_;
+    }
+
+    Server::~Server() {
+        // Close all client handles
+        for (size_t i = 1; i < this->handles.size(); i++) {
+            close(this->handles[i]);
+        }
+
+        // Finally close server handle
+        if (!this->handles.empty()) {
+            close(this->handles[0]);
+            unlink(hostSocketPath(this->serverName).c_str());
+        }
+    }
+}
\ No newline at end of file
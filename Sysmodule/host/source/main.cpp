@@ -0,0 +1,78 @@
+#include <csignal>
+#include "nx/Audio.hpp"
+#include "nx/NX.hpp"
+#include "Service.hpp"
+#include "source/MP3.hpp"
+
+// Host version of main(), which runs the service until it's told to quit or interrupted
+// Usage: TRIPLAYER_WAV=<file> sys-triplayer (the variable is optional)
+
+// Service being run (signals tell it to exit)
+static MainService * service = nullptr;
+
+static void handleSignal(int) {
+    if (service != nullptr) {
+        service->exit();
+    }
+}
+
+// Wrappers to call methods on MainService object
+void audioThread(void * arg) {
+    static_cast<Audio *>(arg)->process();
+}
+
+void serviceGpioThread(void * arg) {
+    static_cast<MainService *>(arg)->gpioEventThread();
+}
+
+void serviceHidThread(void * arg) {
+    static_cast<MainService *>(arg)->hidEventThread();
+}
+
+void serviceIpcThread(void * arg) {
+    static_cast<MainService *>(arg)->ipcThread();
+}
+
+void servicePowerThread(void * arg) {
+    static_cast<MainService *>(arg)->sleepEventThread();
+}
+
+int main(int argc, char * argv[]) {
+    // Initialize required services and prepare audio libraries
+    if (!NX::startServices()) {
+        return 1;
+    }
+    Source::MP3::initLib();
+
+    // Create Service
+    service = new MainService();
+    std::signal(SIGINT, handleSignal);
+    std::signal(SIGTERM, handleSignal);
+
+    // Spawn threads
+    NX::Thread::create("audio", audioThread, Audio::getInstance());
+    NX::Thread::create("gpio", serviceGpioThread, service);
+    NX::Thread::create("hid", serviceHidThread, service);
+    NX::Thread::create("ipc", serviceIpcThread, service);
+    NX::Thread::create("power", servicePowerThread, service);
+
+    // Use this thread to handle playback
+    service->playbackThread();
+
+    // Join threads (only executed after service has exit signal)
+    Audio::getInstance()->exit();
+    NX::Thread::join("power");
+    NX::Thread::join("ipc");
+    NX::Thread::join("hid");
+    NX::Thread::join("gpio");
+    NX::Thread::join("audio");
+
+    // Delete service, then clean up audio libraries and services
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+    delete service;
+    service = nullptr;
+    Source::MP3::freeLib();
+    NX::stopServices();
+    return 0;
+}
\ No newline at end of file
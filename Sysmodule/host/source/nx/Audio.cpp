@@ -0,0 +1,366 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "Log.hpp"
+#include "nx/Audio.hpp"
+#include "nx/NX.hpp"
+
+// Host version of Audio, which 'plays' queued buffers by counting off their samples in real time
+// instead of passing them to the audio renderer. If the TRIPLAYER_WAV environment variable is set
+// to a path, the played audio is also written to that file (volume isn't applied).
+
+constexpr size_t bufferSize = 0xC800;       // Size of each buffer (50kB)
+constexpr size_t maxBuffers = 6;            // Maximum number of buffer slots (50KB * 6 = 300KB)
+constexpr size_t memPoolAlignment = 0x1000; // Alignment of buffers on the Switch (AUDREN_MEMPOOL_ALIGNMENT)
+constexpr size_t frameInterval = 5;         // Milliseconds between counting played samples (about one renderer frame)
+
+Audio * Audio::instance = nullptr;          // Our singleton instance
+
+// Real size of a buffer (matches the Switch, so sources decode the same amount at a time)
+constexpr size_t realSize = ((bufferSize + (memPoolAlignment - 1)) &~ (memPoolAlignment - 1));
+
+// Stand-in for libnx's wave buffer
+struct AudioDriverWaveBuf {
+    size_t size;                                        // Bytes of audio in the buffer
+    size_t samples;                                     // Number of samples in the buffer
+    size_t played;                                      // Number of those samples which have been played
+    bool done;                                          // Set once played (or if never queued)
+};
+
+// Stand-in for the audio renderer's voice (should be safe as this is a singleton class)
+static struct {
+    long rate;                                          // Sample rate
+    size_t frameSize;                                   // Bytes per sample (across all channels)
+    int playing;                                        // Index of the buffer being played
+    int playedSamples;                                  // Number of samples played since starting
+    std::chrono::steady_clock::time_point lastUpdate;   // Time up to which samples have been counted
+} drv;
+
+// WAV file written to
+static struct {
+    std::FILE * file;                                   // File (nullptr if not writing)
+    bool started;                                       // Set once the format is set by the first song
+    bool matches;                                       // Whether the current song has the file's format
+    uint16_t formatTag;                                 // 1 for integers, 3 for floats
+    uint16_t channels;                                  // Number of channels
+    uint32_t rate;                                      // Sample rate
+    uint16_t bits;                                      // Bits per sample
+    uint32_t bytes;                                     // Bytes of audio written
+} wav;
+
+// Header at the start of a WAV file
+struct WavHeader {
+    char riff[4];
+    uint32_t riffSize;
+    char wave[4];
+    char fmt[4];
+    uint32_t fmtSize;
+    uint16_t formatTag;
+    uint16_t channels;
+    uint32_t rate;
+    uint32_t byteRate;
+    uint16_t blockAlign;
+    uint16_t bits;
+    char data[4];
+    uint32_t dataSize;
+};
+static_assert(sizeof(WavHeader) == 44, "WAV header must not be padded");
+
+// Returns the number of bytes taken by one sample of one channel
+static size_t bytesPerSample(const Format format) {
+    return (format == Format::Float ? 4 : static_cast<size_t>(format));
+}
+
+// (Re)write the header to match the audio written so far
+static void writeWavHeader() {
+    WavHeader header = {
+        {'R', 'I', 'F', 'F'}, 36 + wav.bytes, {'W', 'A', 'V', 'E'},
+        {'f', 'm', 't', ' '}, 16, wav.formatTag, wav.channels, wav.rate,
+        wav.rate * wav.channels * (wav.bits / 8u), static_cast<uint16_t>(wav.channels * (wav.bits / 8u)), wav.bits,
+        {'d', 'a', 't', 'a'}, wav.bytes
+    };
+    std::fseek(wav.file, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, wav.file);
+    std::fseek(wav.file, 0, SEEK_END);
+}
+
+// Append audio to the WAV file if the current song is being written
+static void writeWav(const uint8_t * data, const size_t size) {
+    if (wav.file != nullptr && wav.matches) {
+        std::fwrite(data, 1, size, wav.file);
+        wav.bytes += size;
+    }
+}
+
+// Count the samples which would have been played since the last update, marking any
+// buffers which have been finished as done
+static void playSamples(AudioDriverWaveBuf * waveBuf, uint8_t ** memPool) {
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - drv.lastUpdate).count();
+    int64_t samples = ns * drv.rate / 1000000000;
+    drv.lastUpdate += std::chrono::nanoseconds(samples * 1000000000 / drv.rate);
+
+    while (samples > 0 && !waveBuf[drv.playing].done) {
+        AudioDriverWaveBuf & buf = waveBuf[drv.playing];
+        size_t count = std::min<size_t>(samples, buf.samples - buf.played);
+        buf.played += count;
+        drv.playedSamples += count;
+        samples -= count;
+
+        // Move to the next buffer once this one is finished
+        if (buf.played == buf.samples) {
+            writeWav(memPool[drv.playing], buf.size);
+            buf.done = true;
+            drv.playing = (drv.playing + 1) % maxBuffers;
+        }
+    }
+}
+
+Audio::Audio() {
+    this->nextBuf = 0;
+    this->action = Status::Stopped;
+    this->sampleOffset = 0;
+    this->sink = 0;
+    this->status_ = Status::Stopped;
+    this->success = true;
+    this->voice = -1;
+    this->vol = 100.0;
+
+    // Create wave buffers and memory 'pool'
+    this->waveBuf = new AudioDriverWaveBuf[maxBuffers];
+    this->memPool = new uint8_t *[maxBuffers];
+    for (size_t i = 0; i < maxBuffers; i++) {
+        this->waveBuf[i].done = true;
+        this->memPool[i] = new uint8_t[realSize];
+    }
+
+    // Open the WAV file if requested
+    wav.file = nullptr;
+    const char * path = std::getenv("TRIPLAYER_WAV");
+    if (path != nullptr) {
+        wav.file = std::fopen(path, "wb");
+        if (wav.file == nullptr) {
+            Log::writeWarning("[AUDIO] Unable to open ", path, " to write audio to");
+        }
+    }
+
+    this->exit_ = false;
+    Log::writeSuccess("[AUDIO] Audio object created successfully");
+}
+
+Audio * Audio::getInstance() {
+    if (Audio::instance == nullptr) {
+        Audio::instance = new Audio();
+    }
+    return Audio::instance;
+}
+
+bool Audio::initialized() {
+    return this->success;
+}
+
+void Audio::exit() {
+    this->exit_ = true;
+}
+
+bool Audio::newSong(long rate, int channels, Format format) {
+    this->stop();
+    std::scoped_lock<std::mutex> mtx(this->mutex);
+    this->sampleOffset = 0;
+
+    // Create voice matching rate and channels
+    this->channels = channels;
+    this->voice = 0;
+    bool b = (rate > 0 && channels > 0);
+    if (!b) {
+        this->voice = -1;
+        Log::writeError("[AUDIO] Failed to init a new voice!");
+
+    } else {
+        drv.rate = rate;
+        drv.frameSize = channels * bytesPerSample(format);
+        drv.playedSamples = 0;
+        Log::writeInfo("[AUDIO] Created a new voice");
+
+        // The WAV file takes the format of the first song
+        if (wav.file != nullptr) {
+            uint16_t formatTag = (format == Format::Float ? 3 : 1);
+            uint16_t bits = bytesPerSample(format) * 8;
+            if (!wav.started) {
+                wav.formatTag = formatTag;
+                wav.channels = channels;
+                wav.rate = rate;
+                wav.bits = bits;
+                wav.bytes = 0;
+                wav.started = true;
+                writeWavHeader();
+            }
+            wav.matches = (wav.formatTag == formatTag && wav.channels == channels && wav.rate == rate && wav.bits == bits);
+            if (!wav.matches) {
+                Log::writeWarning("[AUDIO] Song isn't written to WAV as it's format differs from the first song");
+            }
+        }
+    }
+
+    Log::writeInfo("[AUDIO] Rate: ", rate, ", Channels: ", channels, ", Bit depth: ", static_cast<int>(format) * 8);
+    return b;
+}
+
+void Audio::addBuffer(uint8_t * buf, size_t sz) {
+    // Ensure appropriate size and a buffer is available
+    if (sz > realSize || sz == 0 || !this->bufferAvailable() || this->voice < 0) {
+        return;
+    }
+
+    // Copy contents into 'mempool' and fill relevant waveBuf
+    std::scoped_lock<std::mutex> mtx(this->mutex);
+    std::memcpy(this->memPool[this->nextBuf], buf, sz);
+    this->waveBuf[this->nextBuf] = AudioDriverWaveBuf{sz, sz / drv.frameSize, 0, false};
+
+    // Indicate playing (starting from this buffer)
+    if (this->status_ == Status::Stopped) {
+        drv.playing = this->nextBuf;
+        drv.lastUpdate = std::chrono::steady_clock::now();
+        this->status_ = Status::Playing;
+    }
+
+    // Move to next buffer
+    this->nextBuf = (this->nextBuf + 1) % maxBuffers;
+}
+
+bool Audio::bufferAvailable() {
+    std::scoped_lock<std::mutex> mtx(this->mutex);
+    return this->waveBuf[this->nextBuf].done;
+}
+
+size_t Audio::bufferSize() {
+    return realSize;
+}
+
+void Audio::resume() {
+    this->action = Status::Playing;
+}
+
+void Audio::pause() {
+    this->action = Status::Paused;
+}
+
+void Audio::stop() {
+    std::scoped_lock<std::mutex> mtx(this->mutex);
+    if (this->voice >= 0) {
+        this->sampleOffset += drv.playedSamples;
+        drv.playedSamples = 0;
+    }
+
+    // Keep what was played of the current buffer
+    if (this->status_ != Status::Stopped && !this->waveBuf[drv.playing].done) {
+        writeWav(this->memPool[drv.playing], this->waveBuf[drv.playing].played * drv.frameSize);
+    }
+
+    // Indicate buffers are 'empty'
+    for (size_t i = 0; i < maxBuffers; i++) {
+        this->waveBuf[i].done = true;
+    }
+    this->nextBuf = 0;
+    this->status_ = Status::Stopped;
+}
+
+Audio::Status Audio::status() {
+    return this->status_;
+}
+
+int Audio::samplesPlayed() {
+    if (this->voice < 0) {
+        return this->sampleOffset;
+    }
+
+    std::scoped_lock<std::mutex> mtx(this->mutex);
+    return (this->sampleOffset + drv.playedSamples);
+}
+
+void Audio::setSamplesPlayed(int s) {
+    std::scoped_lock<std::mutex> mtx(this->mutex);
+    this->sampleOffset = s;
+}
+
+double Audio::volume() {
+    return this->vol;
+}
+
+void Audio::setVolume(double v) {
+    // Check it's safe to change
+    if (v < 0.0 || v > 100.0 || !this->success) {
+        return;
+    }
+
+    std::scoped_lock<std::mutex> mtx(this->mutex);
+    this->vol = v;
+    Log::writeInfo("[AUDIO] Volume set to ", this->vol.load());
+}
+
+void Audio::process() {
+    while (!this->exit_) {
+        switch (this->status_) {
+            case Status::Playing: {
+                // Count what has been played since the last 'frame'
+                std::unique_lock<std::mutex> mtx(this->mutex);
+                playSamples(this->waveBuf, this->memPool);
+
+                // Check if we need to move to stopped state (no more buffers)
+                int lastBuf = ((this->nextBuf - 1) < 0 ? maxBuffers-1 : this->nextBuf - 1);
+                if (this->waveBuf[lastBuf].done) {
+                    mtx.unlock();
+                    this->stop();
+
+                // Check if we need to pause
+                } else if (this->action == Status::Paused) {
+                    this->status_ = Status::Paused;
+                    this->action = Status::Stopped;
+                }
+
+                // Wait for the next 'frame'
+                if (mtx.owns_lock()) {
+                    mtx.unlock();
+                }
+                NX::Thread::sleepMilli(frameInterval);
+                break;
+            }
+
+            case Status::Paused:
+                // Check if we need to resume (time spent paused isn't counted)
+                if (this->action == Status::Playing) {
+                    std::unique_lock<std::mutex> mtx(this->mutex);
+                    drv.lastUpdate = std::chrono::steady_clock::now();
+                    this->status_ = Status::Playing;
+                    this->action = Status::Stopped;
+                    break;
+                }
+
+            case Status::Stopped:
+                // Sleep if not doing anything
+                NX::Thread::sleepMilli(5);
+                break;
+        }
+    }
+}
+
+Audio::~Audio() {
+    // Finish WAV file
+    if (wav.file != nullptr) {
+        if (wav.started) {
+            writeWavHeader();
+        }
+        std::fclose(wav.file);
+        wav.file = nullptr;
+    }
+
+    // Free stuff
+    for (size_t i = 0; i < maxBuffers; i++) {
+        delete[] this->memPool[i];
+    }
+    delete[] this->memPool;
+    delete[] this->waveBuf;
+    Audio::instance = nullptr;
+}
\ No newline at end of file
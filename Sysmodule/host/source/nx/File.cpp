@@ -0,0 +1,181 @@
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include "Log.hpp"
+#include "nx/File.hpp"
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Host version of File, which reads using POSIX calls. The page cache does the job of the read
+// buffer used on the Switch, so there is no thread filling one.
+namespace NX {
+    struct File::FFile {
+        int fd;
+    };
+    struct File::FFileSystem {};
+
+    File::FFileSystem * File::filesystem = nullptr;             // Unused, but 'opened' to match the Switch
+    size_t File::fileID = 0;                                    // ID of the next file
+
+    File::File(const std::string & path) {
+        // Initialize variables in case error occurrs
+        this->buffer = nullptr;
+        this->error = true;
+        this->file = nullptr;
+
+        // Check the fs is ready
+        if (this->filesystem == nullptr) {
+            Log::writeError("[FS] Couldn't open file as fs not initialized!");
+            return;
+        }
+
+        // Try to open file and get it's size in order to seek
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            Log::writeError("[FS] Failed to open file: " + path);
+            return;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            Log::writeError("[FS] Couldn't get file size for: " + path);
+            close(fd);
+            return;
+        }
+
+        // Properly initialize variables
+        this->file = new FFile{fd};
+        this->bufferHead = 0;
+        this->bufferTail = 0;
+        this->error = false;
+        this->fileOffset = 0;
+        this->id = this->fileID++;
+        this->offset = 0;
+        this->size = st.st_size;
+        this->stopThread = true;
+    }
+
+    void File::fillBufferThread(void * arg) {
+
+    }
+
+    size_t File::bufferSize() {
+        return 0;
+    }
+
+    size_t File::copyToBuffer(void * outBuffer, const size_t count) {
+        return 0;
+    }
+
+    ssize_t File::read(void * outBuffer, const size_t count) {
+        // Check we haven't already encountered an error
+        if (this->error) {
+            return -1;
+        }
+
+        // Read until the requested number of bytes are read or EOF is reached
+        std::scoped_lock<std::mutex> mtx(this->fileMutex);
+        size_t total = 0;
+        while (total < count) {
+            ssize_t actualRead = ::read(this->file->fd, static_cast<uint8_t *>(outBuffer) + total, count - total);
+            if (actualRead < 0 && errno == EINTR) {
+                continue;
+            }
+            if (actualRead < 0) {
+                Log::writeError("[FS] I/O error when reading file: ", std::strerror(errno));
+                this->error = true;
+                return -1;
+            }
+            if (actualRead == 0) {
+                break;
+            }
+            total += actualRead;
+        }
+
+        this->fileOffset += total;
+        this->offset = this->fileOffset;
+        return total;
+    }
+
+    off_t File::seek(const off_t offset, const Position position) {
+        // Return if an error has occurred
+        if (this->error) {
+            return -1;
+        }
+
+        std::scoped_lock<std::mutex> mtx(this->fileMutex);
+        int whence = SEEK_SET;
+        switch (position) {
+            case Position::Start:
+                whence = SEEK_SET;
+                break;
+
+            case Position::Current:
+                whence = SEEK_CUR;
+                break;
+
+            case Position::End:
+                whence = SEEK_END;
+                break;
+        }
+
+        off_t pos = lseek(this->file->fd, offset, whence);
+        if (pos < 0) {
+            return -1;
+        }
+        this->fileOffset = pos;
+        this->offset = pos;
+        return this->offset;
+    }
+
+    File::~File() {
+        // Close file
+        if (this->file != nullptr) {
+            close(this->file->fd);
+            delete this->file;
+        }
+    }
+
+    bool File::initializeService() {
+        // Prevent opening twice
+        if (File::filesystem != nullptr) {
+            return true;
+        }
+
+        File::filesystem = new FFileSystem;
+        return true;
+    }
+
+    void File::closeService() {
+        delete File::filesystem;
+        File::filesystem = nullptr;
+    }
+
+    ssize_t File::readFile(void * file, void * buffer, size_t count) {
+        return static_cast<File *>(file)->read(buffer, count);
+    }
+
+    off_t File::seekFile(void * file, const off_t offset, const int type) {
+        Position position;
+        switch (type) {
+            case SEEK_SET:
+                position = Position::Start;
+                break;
+
+            case SEEK_CUR:
+                position = Position::Current;
+                break;
+
+            case SEEK_END:
+                position = Position::End;
+                break;
+
+            // If we can't handle the given type return -1 as it's an error
+            default:
+                Log::writeError("[FS] Unknown seek type");
+                return -1;
+                break;
+        }
+
+        return static_cast<File *>(file)->seek(offset, position);
+    }
+};
\ No newline at end of file
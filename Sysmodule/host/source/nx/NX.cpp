@@ -0,0 +1,155 @@
+#include <chrono>
+#include "Log.hpp"
+#include "nx/Audio.hpp"
+#include "nx/File.hpp"
+#include "nx/NX.hpp"
+#include "Paths.hpp"
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include "utils/FS.hpp"
+
+// Host versions of the Switch specific functions. There are no headphones, buttons or sleep
+// on the host, so those services are stand-ins which never report anything.
+namespace NX {
+    // Variables indicating if each service was initialized
+    static bool audioInitialized = false;
+    static bool fsInitialized = false;
+
+    // Starts all needed services
+    bool startServices() {
+        // Prevent starting twice
+        if (audioInitialized || fsInitialized) {
+            return true;
+        }
+
+        // FS (the folders on the SD card may not exist yet)
+        Utils::Fs::createPath(Path::Common::ConfigFolder);
+        Utils::Fs::createPath(Path::Common::SwitchFolder);
+        fsInitialized = File::initializeService();
+        if (!fsInitialized) {
+            return false;
+        }
+
+        // Open log file
+        Log::openFile(Path::Sys::LogFile, Log::Level::Warning);
+
+        // Audio
+        audioInitialized = Audio::getInstance()->initialized();
+        if (!audioInitialized) {
+            Log::writeError("[NX] Failed to initialize audio");
+            return false;
+        }
+
+        return true;
+    }
+
+    // Stops all started services (in reverse order)
+    void stopServices() {
+        // Audio
+        if (audioInitialized) {
+            delete Audio::getInstance();
+            audioInitialized = false;
+        }
+
+        // Close log
+        Log::closeFile();
+
+        // FS
+        if (fsInitialized) {
+            File::closeService();
+            fsInitialized = false;
+        }
+    }
+
+    namespace Fs {
+        void setHighPriority(const bool b) {
+
+        }
+    };
+
+    namespace Gpio {
+        bool prepare() {
+            return true;
+        }
+
+        void cleanup() {
+
+        }
+
+        bool headsetUnplugged() {
+            return false;
+        }
+    };
+
+    namespace Hid {
+        bool comboPressed(const std::vector<Button> & buttons) {
+            return false;
+        }
+    };
+
+    namespace Psc {
+        static std::function<void()> pscSleepFunc = nullptr;       // Function to call when entering sleep
+        static std::function<void()> pscWakeFunc = nullptr;        // Function to call when exiting sleep
+
+        bool prepare() {
+            return true;
+        }
+
+        void cleanup() {
+            pscSleepFunc = nullptr;
+            pscWakeFunc = nullptr;
+        }
+
+        void monitor(const size_t ms) {
+            Thread::sleepMilli(ms);
+        }
+
+        void setSleepFunc(const std::function<void()> & f) {
+            pscSleepFunc = f;
+        }
+
+        void setWakeFunc(const std::function<void()> & f) {
+            pscWakeFunc = f;
+        }
+    };
+
+    namespace Thread {
+        static std::unordered_map<std::string, std::thread> threads;    // Map from name/id to thread object
+        static std::mutex threadMutex;                                  // Mutex protecting map
+
+        bool create(const std::string & id, void(*func)(void *), void * arg, const size_t size) {
+            std::scoped_lock<std::mutex> mtx(threadMutex);
+
+            // Don't start if thread exists
+            if (threads.count(id) > 0) {
+                return false;
+            }
+
+            // Create thread and emplace in map
+            threads.emplace(id, std::thread(func, arg));
+            return true;
+        }
+
+        void join(const std::string & id) {
+            std::scoped_lock<std::mutex> mtx(threadMutex);
+
+            // Check if thread exists
+            if (threads.count(id) == 0) {
+                return;
+            }
+
+            // Wait for thread to finish
+            threads[id].join();
+            threads.erase(id);
+        }
+
+        void sleepNano(const size_t ns) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(ns));
+        }
+
+        void sleepMilli(const size_t ms) {
+            sleepNano(ms * 1000000);
+        }
+    }
+};
\ No newline at end of file
@@ -13,8 +13,10 @@
 // Forward declare pointers
 class Audio;
 class Config;
-class Database;
 class PlayQueue;
+namespace Snapshot {
+    class Reader;
+};
 namespace Source {
     class Source;
 };
@@ -35,8 +37,8 @@ class MainService {
         Audio * audio;
         // Config object
         Config * cfg;
-        // Database object
-        Database * db;
+        // Reads song paths from the snapshot written by the application
+        Snapshot::Reader * snapshot;
         // IPC Server which clients interact with
         Ipc::Server * ipcServer;
         // Main queue of songs
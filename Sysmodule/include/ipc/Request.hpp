@@ -1,17 +1,23 @@
 #ifndef IPC_REQUEST_HPP
 #define IPC_REQUEST_HPP
 
-#include <cstring>
 #include "ipc/Result.hpp"
 #include <string>
+#include <string_view>
 #include <switch.h>
-#include <vector>
 #include "utils/Buffer.hpp"
 
 // The Request class encapsulates all data/functionality related to an IPC request.
-// All data is copied from the thread-local storage which should allow other IPC calls
-// to be made in between operations on instances of this class.
+// The server reuses one object for every request, so nothing is allocated while handling them.
+// Values are copied from the thread-local storage, which should allow other IPC calls to be
+// made in between operations on instances of this class. Data is read from/written to the
+// buffers mapped by the client directly.
 namespace Ipc {
+    // Max bytes of 'arguments' which can be received (the size of the thread-local storage)
+    constexpr size_t maxRequestValueBytes = 0x100;
+    // Max bytes of reply 'value' which fit in the response (0x90 less the header)
+    constexpr size_t maxReplyValueBytes = 0x80;
+
     class Request {
         public:
             // Request type
@@ -26,22 +32,29 @@ namespace Ipc {
             uint32_t result;                            // IPC result code
             Type type_;                                 // Request type (see enum)
 
-            std::vector<uint8_t> inArgs;                // Received 'arguments'
+            uint8_t inArgs[maxRequestValueBytes];       // Received 'arguments'
+            size_t inArgsSize;                          // Number of bytes received
             size_t inArgsPos;                           // Position to read from next
-            std::vector<uint8_t> inData;                // Received data
+            const uint8_t * inData;                     // Received data (client's buffer)
+            size_t inDataSize;                          // Size of received data
             size_t inDataPos;                           // Position to read from next
 
-            std::vector<uint8_t> outArgs;               // Reply value(s)
-            std::vector<uint8_t> outData;               // Reply data
-            std::vector<HipcBufferDescriptor> outMeta;  // Copy of hipc metadata
+            uint8_t outArgs[maxReplyValueBytes];        // Reply value(s)
+            size_t outArgsSize;                         // Number of bytes to reply with
+            uint8_t * outData;                          // Reply data (client's buffer)
+            size_t outDataCapacity;                     // Size of client's buffer
+            size_t outDataSize;                         // Number of bytes written
 
-            // Private constructor as we can instantiate a request using different data
-            Request();
+            // Clear all values/positions (the buffers themselves aren't cleared)
+            void reset();
 
         public:
-            // Create a request from the thread-local storage
-            // Returns nullptr on a fatal error
-            static Request * fromTLS();
+            // Constructor creates an empty request
+            Request();
+
+            // Replace this request with the one on the thread-local storage
+            // Returns false on a fatal error
+            bool fromTLS();
 
             // Use class members to construct a response on thread-local storage
             void toResponseTLS();
@@ -55,58 +68,49 @@ namespace Ipc {
             // Return type of request
             Type type();
 
-            // Return a reference to the received data buffer (as a vector)
-            const std::vector<uint8_t> & getRequestBuffer();
-
-            // Return a reference to the reply data buffer (as a vector)
-            const std::vector<uint8_t> & getReplyBuffer();
-
             // Append a value to reply buffer
             template <typename T>
             Result appendReplyData(const T value) {
-                return (Utils::Buffer::appendValue(this->outData, value) ? Result::Ok : Result::BadInput);
+                return (Utils::Buffer::appendValue(this->outData, this->outDataCapacity, this->outDataSize, value) ? Result::Ok : Result::BadInput);
             }
 
             // Append a string to reply buffer
             Result appendReplyData(const std::string & str) {
-                return (Utils::Buffer::appendString(this->outData, str) ? Result::Ok : Result::BadInput);
+                return (Utils::Buffer::appendString(this->outData, this->outDataCapacity, this->outDataSize, str) ? Result::Ok : Result::BadInput);
             }
 
             // Append value to reply 'value'
             template <typename T>
             Result appendReplyValue(const T value) {
-                return (Utils::Buffer::appendValue(this->outArgs, value) ? Result::Ok : Result::BadInput);
+                return (Utils::Buffer::appendValue(this->outArgs, maxReplyValueBytes, this->outArgsSize, value) ? Result::Ok : Result::BadInput);
             }
 
             // Append a string to reply 'value'
             Result appendReplyValue(const std::string & str) {
-                return (Utils::Buffer::appendString(this->outArgs, str) ? Result::Ok : Result::BadInput);
+                return (Utils::Buffer::appendString(this->outArgs, maxReplyValueBytes, this->outArgsSize, str) ? Result::Ok : Result::BadInput);
             }
 
             // Sequentially read from received data
             template <typename T>
             Result readRequestData(T & out) {
-                return (Utils::Buffer::readValue(this->inData, this->inDataPos, out) ? Result::Ok : Result::BadInput);
+                return (Utils::Buffer::readValue(this->inData, this->inDataSize, this->inDataPos, out) ? Result::Ok : Result::BadInput);
             }
 
-            // Sequentially read a string from received data
-            Result readRequestData(std::string & out) {
-                return (Utils::Buffer::readString(this->inData, this->inDataPos, out) ? Result::Ok : Result::BadInput);
+            // Sequentially read a string from received data (the view is valid until the reply is sent)
+            Result readRequestData(std::string_view & out) {
+                return (Utils::Buffer::readString(this->inData, this->inDataSize, this->inDataPos, out) ? Result::Ok : Result::BadInput);
             }
 
             // Sequentially read from received 'arguments'
             template <typename T>
             Result readRequestValue(T & out) {
-                return (Utils::Buffer::readValue(this->inArgs, this->inArgsPos, out) ? Result::Ok : Result::BadInput);
+                return (Utils::Buffer::readValue(this->inArgs, this->inArgsSize, this->inArgsPos, out) ? Result::Ok : Result::BadInput);
             }
 
-            // Sequentially read a string from received 'arguments'
-            Result readRequestValue(std::string & out) {
-                return (Utils::Buffer::readString(this->inArgs, this->inArgsPos, out) ? Result::Ok : Result::BadInput);
+            // Sequentially read a string from received 'arguments' (the view is valid until the next request)
+            Result readRequestValue(std::string_view & out) {
+                return (Utils::Buffer::readString(this->inArgs, this->inArgsSize, this->inArgsPos, out) ? Result::Ok : Result::BadInput);
             }
-
-            // Destructor frees allocated memory
-            ~Request();
     };
 };
 
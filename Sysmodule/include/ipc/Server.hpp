@@ -22,6 +22,7 @@ namespace Ipc {
             SmServiceName serverName;       // Name of IPC server
             bool error_;                    // Set true when a fatal error occurs
             Handler handler;                // Function to handle request
+            Request request;                // Reused for each request (as they're handled one at a time)
 
             std::vector<Handle> handles;    // Server (index 0) and client's handles
             size_t maxHandles;              // Maximum number of clients
@@ -2,8 +2,14 @@
 #define SOURCE_MP3_HPP
 
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
 #include "source/Source.hpp"
 #include <string>
+#include "utils/LRUCache.hpp"
 
 // Forward declaration as we only need the pointers here
 typedef struct mpg123_handle_struct mpg123_handle;
@@ -22,6 +28,34 @@ namespace Source {
             // Object associated with file
             NX::File * file;
 
+            // Path to file (used to find exact length)
+            std::string path;
+            // Set true to stop counting samples
+            std::atomic<bool> stopCounting;
+
+            // Exact lengths of recently played files (path -> samples)
+            static Utils::LRUCache<std::string, int> lengthCache;
+            // Files waiting to have their samples counted, and the one being counted (nullptr if none)
+            static std::deque<MP3 *> lengthQueue;
+            static MP3 * counting;
+            // Set true to stop the counting thread
+            static bool lengthExit;
+            // Protects the above, and signalled when they change
+            static std::mutex lengthMutex;
+            static std::condition_variable lengthCondition;
+
+            // Read the length of the file from it's headers (or estimate it) without decoding
+            // Returns false if the file couldn't be read
+            static bool readStreamLength(const std::string &, int &, bool &);
+
+            // Walks through each frame in the file to count the exact number of samples
+            // Returns zero if the file couldn't be read or counting was stopped
+            uint64_t countSamples();
+
+            // Counts the samples of each queued file in turn, updating its total when done.
+            // Run on a separate thread (started by initLib()) as it reads the whole file
+            static void countSamplesThread(void *);
+
             // Logs most recent error
             static void logErrorMsg();
 
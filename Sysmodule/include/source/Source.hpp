@@ -1,6 +1,7 @@
 #ifndef SOURCE_SOURCE_HPP
 #define SOURCE_SOURCE_HPP
 
+#include <atomic>
 #include <cstddef>
 
 // Forward declarations
@@ -16,7 +17,7 @@ namespace Source {
             bool done_;
             Format format_;
             long sampleRate_;
-            int totalSamples_;
+            std::atomic<int> totalSamples_;     // Can be refined on another thread
             bool valid_;
 
         public:
@@ -1,38 +1,46 @@
 #ifndef UTILS_BUFFER_HPP
 #define UTILS_BUFFER_HPP
 
-#include <string>
-#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
 
-// Helpers to read/write values to a buffer (vector)
+// Helpers to read/write values to a fixed-size buffer (nothing is allocated)
+// Each takes a pointer to the buffer, its size and the position to read/write at next
 namespace Utils::Buffer {
-    // Append a string to a biffer
-    bool appendString(std::vector<uint8_t> &, const std::string &);
+    // Append a null-terminated string to a buffer and increment position (returns false if it doesn't fit)
+    bool appendString(uint8_t *, const size_t, size_t &, const std::string_view);
 
-    // Append value onto a buffer
+    // Append value onto a buffer and increment position (returns false if it doesn't fit)
     template <typename T>
-    bool appendValue(std::vector<uint8_t> & buf, const T val) {
-        const uint8_t * ptr = reinterpret_cast<const uint8_t *>(&val);
-        for (size_t i = 0; i < sizeof(val); i++) {
-            buf.push_back(ptr[i]);
+    bool appendValue(uint8_t * buf, const size_t size, size_t & pos, const T val) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be copied into a buffer");
+        size_t bytes = sizeof(val);
+        if (pos + bytes > size) {
+            return false;
         }
+
+        std::memcpy(buf + pos, &val, bytes);
+        pos += bytes;
         return true;
     }
 
-    // Retrieve a string from buffer and increment position (returns false if outside of buffer)
-    bool readString(const std::vector<uint8_t> &, size_t &, std::string &);
+    // Retrieve a string (which points into the buffer) and increment position (returns false if outside of buffer)
+    bool readString(const uint8_t *, const size_t, size_t &, std::string_view &);
 
     // Retrieve value from buffer and increment position (returns false if outside of buffer)
     template <typename T>
-    bool readValue(const std::vector<uint8_t> & buf, size_t & pos, T & val) {
+    bool readValue(const uint8_t * buf, const size_t size, size_t & pos, T & val) {
+        static_assert(std::is_trivially_copyable_v<T>, "Only plain values can be copied from a buffer");
         // Check we have enough bytes to read
         size_t bytes = sizeof(val);
-        if (pos + bytes > buf.size()) {
+        if (pos + bytes > size) {
             return false;
         }
 
         // Read required number of bytes and move position
-        std::memcpy(&val, &buf[pos], bytes);
+        std::memcpy(&val, buf + pos, bytes);
         pos += bytes;
         return true;
     }
@@ -1,16 +1,16 @@
 #include "Config.hpp"
-#include "Database.hpp"
 #include "ipc/TriPlayer.hpp"
 #include "nx/Audio.hpp"
 #include "nx/NX.hpp"
 #include "Paths.hpp"
 #include "PlayQueue.hpp"
 #include "Service.hpp"
+#include "Snapshot.hpp"
 #include "source/Factory.hpp"
 #include "source/MP3.hpp"
 #include "utils/FS.hpp"
 
-// Interval (in seconds) to test if DB file is accessible
+// Interval (in seconds) to test if the snapshot is accessible
 #define DB_TEST_INTERVAL 2
 // Number of milliseconds between polling system state
 #define POLL_INTERVAL 10
@@ -41,11 +41,11 @@ MainService::MainService() {
         return static_cast<uint32_t>(this->commandThread(r));
     });
 
-    // Create database
+    // Create snapshot reader
     if (!this->exit_) {
-        this->db = new Database();
+        this->snapshot = new Snapshot::Reader();
     } else {
-        this->db = nullptr;
+        this->snapshot = nullptr;
     }
 }
 
@@ -487,7 +487,7 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
 
         case Ipc::Command::SetPlayingFrom: {
             // Read string from input buffer
-            std::string str;
+            std::string_view str;
             Ipc::Result rc = request->readRequestData(str);
             if (rc != Ipc::Result::Ok) {
                 return rc;
@@ -495,7 +495,7 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
 
             // Lock queue to allow updating and return string
             std::unique_lock<std::shared_mutex> mtx(this->qMutex);
-            this->playingFrom = str.substr(0, (str.length() > 100) ? 100 : str.length());
+            this->playingFrom.assign(str.substr(0, 100));
             break;
         }
 
@@ -503,7 +503,7 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
         // Once we lock the mutex the decode thread is guaranteed to not be using the DB
         case Ipc::Command::RequestDBLock: {
             std::scoped_lock<std::mutex> mtx(this->dbMutex);
-            this->db->close();
+            this->snapshot->close();
             this->dbLocked = true;
             break;
         }
@@ -524,8 +524,8 @@ Ipc::Result MainService::commandThread(Ipc::Request * request) {
             std::scoped_lock<std::shared_mutex> qMtx(this->qMutex);
             std::scoped_lock<std::mutex> mtx(this->dbMutex);
 
-            // Ensure we're disconnected from the DB
-            this->db->close();
+            // Ensure the snapshot is closed
+            this->snapshot->close();
 
             // Stop playback and empty queues
             this->audio->stop();
@@ -721,19 +721,23 @@ void MainService::playbackThread() {
                     NX::Thread::sleepMilli(50);
                     std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
                     if (std::chrono::duration_cast< std::chrono::duration<double> >(now - last).count() > DB_TEST_INTERVAL) {
-                        if (Utils::Fs::fileAccessible("/switch/TriPlayer/data.sqlite3")) {
+                        if (Utils::Fs::fileAccessible(Path::Common::SnapshotFile)) {
                             this->dbLocked = false;
                         }
                         last = now;
                     }
                 }
 
-                // Now that the database is available actually read from it (note that this read-only connection
-                // is left intact until either RESET or REQUESTDBLOCK is received)
-                if (!this->db->openReadOnly()) {
-                    this->exit_ = true;
+                // Now that the snapshot is available actually read from it (note that it is left open
+                // until either RESET or REQUESTDBLOCK is received)
+                if (!this->snapshot->isOpen() && !this->snapshot->open(Path::Common::SnapshotFile)) {
+                    Log::writeError("[SNAPSHOT] Unable to open " + Path::Common::SnapshotFile);
+                }
+                Snapshot::Entry entry;
+                std::string path;
+                if (this->snapshot->find(this->queue->currentID(), entry)) {
+                    path = std::move(entry.path);
                 }
-                std::string path = this->db->getPathForID(this->queue->currentID());
                 mtx.unlock();
 
                 // Delete old source and prepare a new one
@@ -853,7 +857,7 @@ void MainService::sleepEventThread() {
 
 MainService::~MainService() {
     delete this->cfg;
-    delete this->db;
+    delete this->snapshot;
     delete this->ipcServer;
     delete this->queue;
     delete this->source;
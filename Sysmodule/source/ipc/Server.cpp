@@ -52,10 +52,10 @@ namespace Ipc {
             return true;        // Return true as closing a session is valid behaviour
         }
 
-        // Create object from received data
-        Request * request = Request::fromTLS();
-        if (!request) {
-            Log::writeError("[IPC] An error occurred creating the request object (most likely bad header magic)");
+        // Read received data into the request object
+        Request * request = &this->request;
+        if (!request->fromTLS()) {
+            Log::writeError("[IPC] An error occurred reading the request (most likely bad header magic)");
             return false;
         }
 
@@ -85,16 +85,15 @@ namespace Ipc {
                 break;
         }
 
-        // Send response and delete object
+        // Send response
         rc = svcReplyAndReceive(&tmp, &this->handles[index], 0, this->handles[index], 0);
         if (rc == KERNELRESULT(TimedOut)) {
             rc = 0;
         }
-        delete request;
 
         // Close session on error or close request
         if (R_FAILED(rc) || closeSession) {
-            Log::writeInfo("Closing session " + std::to_string(index) + " due to error/request");
+            Log::writeInfo("Closing session ", index, " due to error/request");
             svcCloseHandle(this->handles[index]);
             this->handles.erase(this->handles.begin() + index);
         }
@@ -5,10 +5,10 @@
 #include <switch.h>
 
 // Heap size:
-// DB:      ~0.5MB
-// IPC:     ~0.2MB
-// Queue:   ~0.2MB
-// Sources: ~0.5MB
+// IPC:      ~0.2MB
+// Queue:    ~0.2MB
+// Snapshot: <0.1MB
+// Sources:  ~0.5MB
 #define INNER_HEAP_SIZE (size_t)(2 * 1024 * 1024)
 
 // It hangs if I don't use C... I wish I knew why!
@@ -71,7 +71,7 @@ Audio::Audio() {
             delete[] this->memPool;
             delete[] this->waveBuf;
             audrvClose(&drv);
-            Log::writeError("[AUDIO] Unable to allocate memory pool (size: " + std::to_string(maxBuffers) + "x" + std::to_string(realSize) + ")");
+            Log::writeError("[AUDIO] Unable to allocate memory pool (size: ", maxBuffers, "x", realSize, ")");
         }
     }
 
@@ -141,7 +141,7 @@ bool Audio::newSong(long rate, int channels, Format format) {
         Log::writeInfo("[AUDIO] Created a new voice");
     }
 
-    Log::writeInfo("[AUDIO] Rate: " + std::to_string(rate) +  ", Channels: " + std::to_string(channels) + ", Bit depth: " + std::to_string(static_cast<int>(format) * 8));
+    Log::writeInfo("[AUDIO] Rate: ", rate, ", Channels: ", channels, ", Bit depth: ", static_cast<int>(format) * 8);
     return b;
 }
 
@@ -237,7 +237,7 @@ void Audio::setVolume(double v) {
     std::scoped_lock<std::mutex> mtx(this->mutex);
     this->vol = v;
     audrvMixSetVolume(&drv, this->sink, this->vol/100.0);
-    Log::writeInfo("[AUDIO] Volume set to " + std::to_string(this->vol));
+    Log::writeInfo("[AUDIO] Volume set to ", this->vol.load());
 }
 
 void Audio::process() {
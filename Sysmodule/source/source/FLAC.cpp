@@ -12,7 +12,7 @@ struct dr_flac : public drflac {};
 namespace Source {
     FLAC::FLAC(const std::string & path) : Source() {
         // Create decoder for file
-        Log::writeInfo("[FLAC] Opening file: " + path);
+        Log::writeInfo("[FLAC] Opening file: ", path);
         this->flac = static_cast<dr_flac *>(drflac_open_file(path.c_str(), nullptr));
 
         // Check if opened succesfully
@@ -76,7 +76,7 @@ namespace Source {
 
         drflac_bool32 ok = drflac_seek_to_pcm_frame(this->flac, pos);
         if (ok != DRFLAC_TRUE) {
-            Log::writeError("[FLAC] An error occurred attempting to seek to: " + std::to_string(pos));
+            Log::writeError("[FLAC] An error occurred attempting to seek to: ", pos);
         }
     }
 
@@ -1,18 +1,55 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <cstring>
 #include "Log.hpp"
 #include <mpg123.h>
+#include "nx/NX.hpp"
 #include "source/MP3.hpp"
 #include "Types.hpp"
+#include "utils/MP3.hpp"
+#include <vector>
 
 #ifdef USE_FILE_BUFFER
 #include "nx/File.hpp"
 #endif
 
+// Number of bytes read to find the first frame
+#define PROBE_SIZE 16384
+// Number of bytes read at a time when counting frames
+#define COUNT_SIZE 8192
+// Number of exact lengths to remember
+#define LENGTH_CACHE_SIZE 16
+
+// Name of thread counting samples
+#define LENGTH_THREAD "mp3Length"
+
 namespace Source {
     mpg123_handle * MP3::mpg = nullptr;
+    Utils::LRUCache<std::string, int> MP3::lengthCache(LENGTH_CACHE_SIZE);
+    std::deque<MP3 *> MP3::lengthQueue;
+    MP3 * MP3::counting = nullptr;
+    bool MP3::lengthExit = false;
+    std::mutex MP3::lengthMutex;
+    std::condition_variable MP3::lengthCondition;
+
+    // Returns the size of the ID3v2 tag at the start of the file (0 if not present)
+    static size_t skipID3v2(std::FILE * fp) {
+        unsigned char header[10];
+        if (std::fread(header, 1, 10, fp) != 10 || std::memcmp(header, "ID3", 3) != 0) {
+            return 0;
+        }
+
+        // Size is syncsafe and excludes the header and footer
+        size_t size = ((header[6] & 0x7F) << 21) | ((header[7] & 0x7F) << 14) | ((header[8] & 0x7F) << 7) | (header[9] & 0x7F);
+        return size + 10 + ((header[5] & 0x10) ? 10 : 0);
+    }
 
     MP3::MP3(const std::string & path) : Source() {
-        Log::writeInfo("[MP3] Opening file: " + path);
+        Log::writeInfo("[MP3] Opening file: ", path);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        this->path = path;
+        this->stopCounting = false;
 
         // Check the library is initialized
         if (this->mpg == nullptr) {
@@ -48,14 +85,165 @@ namespace Source {
             return;
         }
 
-        // Get length
-        this->totalSamples_ = mpg123_length(this->mpg);
-        if (this->totalSamples_ == MPG123_ERR) {
+        // Get length from a previous count, then the file's headers, avoiding mpg123_length()
+        // as it scans the whole file when there is no Xing/Info header
+        int samples;
+        std::unique_lock<std::mutex> mtx(MP3::lengthMutex);
+        bool found = MP3::lengthCache.get(path, samples);
+        mtx.unlock();
+
+        if (found) {
+            this->totalSamples_ = samples;
+
+        } else {
+            bool exact;
+            if (MP3::readStreamLength(path, samples, exact)) {
+                this->totalSamples_ = samples;
+
+                // Count the exact number of samples in the background if we only have an estimate
+                if (!exact) {
+                    mtx.lock();
+                    MP3::lengthQueue.push_back(this);
+                    mtx.unlock();
+                    MP3::lengthCondition.notify_all();
+                }
+
+            } else {
+                this->totalSamples_ = mpg123_length(this->mpg);
+            }
+        }
+
+        if (this->totalSamples_ <= 0) {
             Log::writeWarning("[MP3] Unable to determine length of song");
             this->totalSamples_ = 1;
         }
 
-        Log::writeInfo("[MP3] File opened successfully");
+        int ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+        Log::writeInfo("[MP3] File opened successfully in ", ms, " ms");
+    }
+
+    bool MP3::readStreamLength(const std::string & path, int & samples, bool & exact) {
+        std::FILE * fp = std::fopen(path.c_str(), "rb");
+        if (fp == nullptr) {
+            return false;
+        }
+
+        // Find where the stream starts and ends
+        size_t offset = skipID3v2(fp);
+        std::fseek(fp, 0, SEEK_END);
+        long end = std::ftell(fp);
+        if (end >= 128) {
+            char tag[3];
+            std::fseek(fp, end - 128, SEEK_SET);
+            if (std::fread(tag, 1, 3, fp) == 3 && std::memcmp(tag, "TAG", 3) == 0) {
+                end -= 128;
+            }
+        }
+
+        // Read the start of the stream and look for the first frame
+        std::vector<unsigned char> buf(PROBE_SIZE);
+        std::fseek(fp, offset, SEEK_SET);
+        size_t read = std::fread(buf.data(), 1, buf.size(), fp);
+        std::fclose(fp);
+
+        size_t frame;
+        Utils::MP3::FrameHeader header;
+        if (!Utils::MP3::findFirstFrame(buf.data(), read, frame, header)) {
+            Log::writeWarning("[MP3] Couldn't find first frame");
+            return false;
+        }
+
+        Utils::MP3::StreamLength length;
+        size_t streamSize = (end > static_cast<long>(offset + frame) ? end - (offset + frame) : 0);
+        if (!Utils::MP3::getStreamLength(buf.data() + frame, read - frame, streamSize, length)) {
+            Log::writeWarning("[MP3] Couldn't read length from headers");
+            return false;
+        }
+
+        samples = length.samples;
+        exact = length.exact;
+        return true;
+    }
+
+    uint64_t MP3::countSamples() {
+        std::FILE * fp = std::fopen(this->path.c_str(), "rb");
+        if (fp == nullptr) {
+            return 0;
+        }
+
+        // Walk each frame header, keeping the unused tail of each read
+        std::vector<unsigned char> buf(COUNT_SIZE);
+        size_t pos = skipID3v2(fp);
+        size_t have = 0;
+        size_t used = 0;
+        uint64_t samples = 0;
+        bool eof = false;
+        std::fseek(fp, pos, SEEK_SET);
+        while (!this->stopCounting) {
+            if (have - used < 4) {
+                if (eof) {
+                    break;
+                }
+
+                std::memmove(buf.data(), buf.data() + used, have - used);
+                have -= used;
+                used = 0;
+                size_t read = std::fread(buf.data() + have, 1, buf.size() - have, fp);
+                have += read;
+                eof = (read == 0);
+                continue;
+            }
+
+            // Resync a byte at a time if this isn't a frame (ie. ID3v1 tag or junk)
+            Utils::MP3::FrameHeader header;
+            if (!Utils::MP3::parseFrameHeader(buf.data() + used, header)) {
+                used++;
+                continue;
+            }
+
+            // Skip the frame body, seeking if it extends past the buffer
+            samples += header.samples;
+            if (used + header.length <= have) {
+                used += header.length;
+            } else {
+                pos = std::ftell(fp) - (have - used) + header.length;
+                std::fseek(fp, pos, SEEK_SET);
+                have = 0;
+                used = 0;
+            }
+        }
+        std::fclose(fp);
+        return (this->stopCounting ? 0 : samples);
+    }
+
+    void MP3::countSamplesThread(void * arg) {
+        std::unique_lock<std::mutex> mtx(MP3::lengthMutex);
+        while (true) {
+            // Wait for a file to count
+            MP3::lengthCondition.wait(mtx, []() {
+                return MP3::lengthExit || !MP3::lengthQueue.empty();
+            });
+            if (MP3::lengthExit) {
+                break;
+            }
+            MP3 * mp3 = MP3::lengthQueue.front();
+            MP3::lengthQueue.pop_front();
+
+            // Count without holding the lock (the object isn't deleted until we're done with it)
+            MP3::counting = mp3;
+            mtx.unlock();
+            uint64_t samples = mp3->countSamples();
+            mtx.lock();
+
+            // Update total and remember it for next time
+            if (samples > 0) {
+                mp3->totalSamples_ = samples;
+                MP3::lengthCache.put(mp3->path, samples);
+                Log::writeInfo("[MP3] Counted ", samples, " samples in: ", mp3->path);
+            }
+            MP3::counting = nullptr;
+            MP3::lengthCondition.notify_all();
+        }
     }
 
     void MP3::logErrorMsg() {
@@ -87,7 +275,7 @@ namespace Source {
 
         off_t res = mpg123_seek(this->mpg, pos, SEEK_SET);
         if (res < 0) {
-            Log::writeError("[MP3] An error occurred attempting to seek to: " + std::to_string(pos));
+            Log::writeError("[MP3] An error occurred attempting to seek to: ", pos);
         }
     }
 
@@ -104,6 +292,15 @@ namespace Source {
     }
 
     MP3::~MP3() {
+        // Stop counting samples, either by removing the request or waiting for the thread to finish with it
+        std::unique_lock<std::mutex> mtx(MP3::lengthMutex);
+        MP3::lengthQueue.erase(std::remove(MP3::lengthQueue.begin(), MP3::lengthQueue.end(), this), MP3::lengthQueue.end());
+        this->stopCounting = true;
+        MP3::lengthCondition.wait(mtx, [this]() {
+            return MP3::counting != this;
+        });
+        mtx.unlock();
+
         if (this->mpg != nullptr) {
             mpg123_close(this->mpg);
         }
@@ -148,12 +345,25 @@ namespace Source {
         // Use fuzzy seeking by default
         MP3::setAccurateSeek(false);
 
+        // Start thread which counts samples when the length is only an estimate
+        MP3::lengthExit = false;
+        if (!NX::Thread::create(LENGTH_THREAD, MP3::countSamplesThread, nullptr)) {
+            Log::writeWarning("[MP3] Unable to start thread to count samples");
+        }
+
         Log::writeSuccess("[MP3] Initialized successfully");
         return true;
     }
 
 
     void MP3::freeLib() {
+        // Stop counting thread
+        std::unique_lock<std::mutex> mtx(MP3::lengthMutex);
+        MP3::lengthExit = true;
+        mtx.unlock();
+        MP3::lengthCondition.notify_all();
+        NX::Thread::join(LENGTH_THREAD);
+
         // Delete handle
         if (MP3::mpg != nullptr) {
             Log::writeSuccess("[MP3] Library tidied up!");
@@ -190,7 +400,7 @@ namespace Source {
             result = mpg123_eq(MP3::mpg, MPG123_LR, i, eq[i]);
             if (result != MPG123_OK) {
                 MP3::logErrorMsg();
-                Log::writeError("[MP3] Failed to adjust equalizer band " + std::to_string(i));
+                Log::writeError("[MP3] Failed to adjust equalizer band ", i);
                 return false;
             }
         }
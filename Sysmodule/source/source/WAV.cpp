@@ -12,7 +12,7 @@ struct dr_wav : public drwav {};
 namespace Source {
     WAV::WAV(const std::string & path) : Source() {
         // Create decoder for file
-        Log::writeInfo("[WAV] Opening file: " + path);
+        Log::writeInfo("[WAV] Opening file: ", path);
         this->wav = new dr_wav;
         drwav_bool32 ok = drwav_init_file(static_cast<drwav *>(this->wav), path.c_str(), nullptr);
         if (ok != DRWAV_TRUE) {
@@ -77,7 +77,7 @@ namespace Source {
 
         drwav_bool32 ok = drwav_seek_to_pcm_frame(this->wav, pos);
         if (ok != DRWAV_TRUE) {
-            Log::writeError("[WAV] An error occurred attempting to seek to: " + std::to_string(pos));
+            Log::writeError("[WAV] An error occurred attempting to seek to: ", pos);
         }
     }
 
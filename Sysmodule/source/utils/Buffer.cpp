@@ -1,23 +1,29 @@
-#include <cstring>
 #include "utils/Buffer.hpp"
 
 namespace Utils::Buffer {
-    bool appendString(std::vector<uint8_t> & buf, const std::string & str) {
-        // Iterate over string
-        for (size_t i = 0; i < str.size(); i++) {
-            buf.push_back(str[i]);
+    bool appendString(uint8_t * buf, const size_t size, size_t & pos, const std::string_view str) {
+        // Copy the string and a terminating null in one go
+        if (pos + str.size() + 1 > size) {
+            return false;
         }
-        buf.push_back('\0');
+
+        std::memcpy(buf + pos, str.data(), str.size());
+        buf[pos + str.size()] = '\0';
+        pos += str.size() + 1;
         return true;
     }
 
-    bool readString(const std::vector<uint8_t> & buf, size_t & pos, std::string & str) {
-        if (pos >= buf.size()) {
+    bool readString(const uint8_t * buf, const size_t size, size_t & pos, std::string_view & str) {
+        if (pos >= size) {
             return false;
         }
 
-        str = std::string(reinterpret_cast<const char *>(&buf[pos]));
-        pos += str.length() + 1;
+        // Stop at the end of the buffer if there is no null
+        const uint8_t * start = buf + pos;
+        const uint8_t * end = static_cast<const uint8_t *>(std::memchr(start, '\0', size - pos));
+        size_t length = (end == nullptr ? size - pos : end - start);
+        str = std::string_view(reinterpret_cast<const char *>(start), length);
+        pos += length + 1;
         return true;
     }
 };
\ No newline at end of file
@@ -0,0 +1,103 @@
+// Benchmarks the sysmodule's decoders on Linux: each file is opened with Source::Factory and decoded
+// in chunks the size of an audio buffer, as MainService::playbackThread does. Reports the time taken
+// to open each file, to decode the first buffer (time to first audio) and to decode the whole file,
+// and how much faster than real time that is.
+//
+// With --length, the time mpg123_length() takes on a separately opened handle is also reported. The
+// sysmodule called it while opening every MP3 before the length was read from the file's headers,
+// so adding it to the time to first audio gives the old path.
+//
+// Build (from this directory, after 'make host' in the root of the repo):
+//   g++ -std=gnu++2a -O2 -I../../Sysmodule/host/include -I../../Sysmodule/include -I../../Common/include decode.cpp
+//       ../../Sysmodule/build/host/libsys-triplayer.a -lmpg123 -pthread -o decode
+//
+// Usage: ./decode [--length] <file> [file...]
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <mpg123.h>
+#include "nx/Audio.hpp"
+#include "nx/File.hpp"
+#include "source/Factory.hpp"
+#include "source/MP3.hpp"
+#include "source/Source.hpp"
+#include <vector>
+
+// Returns the time in ms mpg123_length() takes on a new handle with the sysmodule's flags (-1 if not an MP3)
+static double timeLength(const char * path) {
+    mpg123_handle * mpg = mpg123_new(nullptr, nullptr);
+    if (mpg == nullptr) {
+        return -1;
+    }
+    mpg123_param(mpg, MPG123_FLAGS, MPG123_QUIET | MPG123_GAPLESS, 0.0f);
+
+    double time = -1;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (mpg123_open(mpg, path) == MPG123_OK) {
+        mpg123_length(mpg);
+        time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        mpg123_close(mpg);
+    }
+    mpg123_delete(mpg);
+    return time;
+}
+
+int main(int argc, char * argv[]) {
+    int first = 1;
+    bool length = false;
+    if (argc > 1 && std::strcmp(argv[1], "--length") == 0) {
+        first = 2;
+        length = true;
+    }
+    if (argc <= first) {
+        std::cout << "Usage: " << argv[0] << " [--length] <file> [file...]" << std::endl;
+        return 1;
+    }
+
+    NX::File::initializeService();
+    Source::MP3::initLib();
+    std::vector<unsigned char> buf(Audio::getInstance()->bufferSize());
+
+    double totalAudio = 0;
+    double totalTime = 0;
+    for (int i = first; i < argc; i++) {
+        double lengthTime = (length ? timeLength(argv[i]) : -1);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Source::Source * source = Source::Factory::getSource(argv[i]);
+        if (source == nullptr || !source->valid()) {
+            std::cout << argv[i] << ": unable to open" << std::endl;
+            delete source;
+            continue;
+        }
+        double open = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // Decode the whole file, noting when the first buffer is ready to be queued
+        size_t bytes = source->decode(buf.data(), buf.size());
+        double firstAudio = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        while (source->valid() && !source->done()) {
+            bytes += source->decode(buf.data(), buf.size());
+        }
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double audio = static_cast<double>(source->totalSamples()) / source->sampleRate();
+
+        std::cout << argv[i] << ": opened in " << open << " ms, first buffer after " << firstAudio << " ms";
+        if (lengthTime >= 0) {
+            std::cout << " (mpg123_length() " << lengthTime << " ms)";
+        }
+        std::cout << ", " << bytes / (1024.0 * 1024.0) << " MB decoded in " << time * 1000 << " ms ("
+                  << audio / time << "x real time)" << std::endl;
+        totalAudio += audio;
+        totalTime += time;
+        delete source;
+    }
+
+    if (totalTime > 0) {
+        std::cout << "Total: " << totalAudio << " s of audio in " << totalTime * 1000 << " ms (" << totalAudio / totalTime << "x real time)" << std::endl;
+    }
+
+    delete Audio::getInstance();
+    Source::MP3::freeLib();
+    NX::File::closeService();
+    return 0;
+}
\ No newline at end of file
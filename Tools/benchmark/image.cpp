@@ -0,0 +1,130 @@
+// Benchmarks Utils::Image::resize on Linux using a folder of real cover art (JPEG/PNG),
+// reporting the time taken and peak memory used to resize each image with both filters.
+// Each resize is run in a forked process so the peak memory of one doesn't hide another's.
+//
+// Build (from this directory, with the avir submodule checked out):
+//   g++ -std=gnu++2a -O2 -I../../Application/include -I../../Application/libs/avir -I../../Common/include
+//       image.cpp ../../Application/source/utils/Image.cpp ../../Common/source/utils/FS.cpp
+//       ../../Common/source/Log.cpp ../../Common/source/Paths.cpp -ljpeg -lpng -o image
+//
+// Usage: ./image <directory> [size (px)]
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "utils/FS.hpp"
+#include "utils/Image.hpp"
+#include <vector>
+
+// Result of resizing one image
+struct Result {
+    bool ok;            // Whether the image was resized
+    double ms;          // Time taken (ms)
+    long peakKB;        // Growth in peak resident memory (KB)
+};
+
+// Returns the peak resident memory of this process in KB
+static long peakMemory() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Resize the image in a child process and return how it went
+static Result run(const std::vector<unsigned char> & data, size_t size, Utils::Image::Filter filter) {
+    Result result = {false, 0, 0};
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return result;
+    }
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        long before = peakMemory();
+        std::vector<unsigned char> copy = data;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        result.ok = Utils::Image::resize(copy, size, size, filter);
+        result.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.peakKB = peakMemory() - before;
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    if (pid > 0) {
+        if (read(fds[0], &result, sizeof(result)) != sizeof(result)) {
+            result.ok = false;
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    close(fds[0]);
+    return result;
+}
+
+int main(int argc, char * argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <directory> [size (px)]" << std::endl;
+        return 1;
+    }
+    size_t size = (argc > 2 ? std::stoul(argv[2]) : 400);
+
+    // Find images
+    std::vector<std::string> files;
+    for (const std::filesystem::directory_entry & entry : std::filesystem::recursive_directory_iterator(argv[1])) {
+        std::string ext = entry.path().extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+        if (entry.is_regular_file() && (ext == ".jpg" || ext == ".jpeg" || ext == ".png")) {
+            files.push_back(entry.path().string());
+        }
+    }
+    if (files.empty()) {
+        std::cout << "No images found in " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // Resize each with both filters
+    std::cout << "file, size (KB), fast (ms), fast peak (KB), quality (ms), quality peak (KB)" << std::endl;
+    Result total[2] = {{true, 0, 0}, {true, 0, 0}};
+    long maxPeak[2] = {0, 0};
+    size_t failed = 0;
+    for (const std::string & file : files) {
+        std::vector<unsigned char> data;
+        if (!Utils::Fs::readFile(file, data)) {
+            failed++;
+            continue;
+        }
+
+        Result fast = run(data, size, Utils::Image::Filter::Fast);
+        Result quality = run(data, size, Utils::Image::Filter::Quality);
+        if (!fast.ok || !quality.ok) {
+            std::cout << file << ", failed" << std::endl;
+            failed++;
+            continue;
+        }
+
+        std::cout << file << ", " << data.size() / 1024 << ", " << fast.ms << ", " << fast.peakKB << ", " << quality.ms << ", " << quality.peakKB << std::endl;
+        total[0].ms += fast.ms;
+        total[0].peakKB += fast.peakKB;
+        total[1].ms += quality.ms;
+        total[1].peakKB += quality.peakKB;
+        maxPeak[0] = std::max(maxPeak[0], fast.peakKB);
+        maxPeak[1] = std::max(maxPeak[1], quality.peakKB);
+    }
+
+    // Print summary
+    size_t count = files.size() - failed;
+    if (count == 0) {
+        return 1;
+    }
+    std::cout << std::endl << count << " images resized to " << size << "px (" << failed << " failed)" << std::endl;
+    std::cout << "Fast:    " << total[0].ms / count << " ms, " << total[0].peakKB / count << " KB peak (avg), " << maxPeak[0] << " KB peak (max)" << std::endl;
+    std::cout << "Quality: " << total[1].ms / count << " ms, " << total[1].peakKB / count << " KB peak (avg), " << maxPeak[1] << " KB peak (max)" << std::endl;
+    return (failed > 0 ? 1 : 0);
+}
\ No newline at end of file
@@ -0,0 +1,179 @@
+// Benchmarks the sysmodule's IPC request handling on Linux: reading a request from the thread-local
+// storage, dispatching it to a handler like MainService::commandThread and writing the response.
+// libnx is replaced by the host build's stand-in (Sysmodule/host/include/switch.h). Reports the time
+// taken and number of heap allocations per request for a mix of commands, which should be zero.
+//
+// Build (from this directory):
+//   g++ -std=gnu++2a -O2 -I../../Sysmodule/host/include -I../../Sysmodule/include -I../../Common/include ipc.cpp
+//       ../../Sysmodule/source/ipc/Request.cpp ../../Sysmodule/source/utils/Buffer.cpp -o ipc
+//
+// Usage: ./ipc [requests]
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "ipc/Command.hpp"
+#include "ipc/Request.hpp"
+#include <new>
+#include <string>
+#include <vector>
+
+#ifndef VER_STRING
+#define VER_STRING "0.0.0"
+#endif
+
+// Number of heap allocations made so far
+static std::atomic<size_t> allocations = 0;
+
+void * operator new(size_t size) {
+    allocations++;
+    void * ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void * ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void * ptr, size_t) noexcept {
+    std::free(ptr);
+}
+
+// State used by the handler (as in MainService)
+static std::vector<int> queue;
+static std::string playingFrom;
+static double volume = 75.0;
+
+// Handles a subset of commands the same way as MainService::commandThread
+static Ipc::Result handle(Ipc::Request * request) {
+    switch (static_cast<Ipc::Command>(request->cmd())) {
+        case Ipc::Command::Version:
+            request->appendReplyValue(std::string(VER_STRING));
+            break;
+
+        case Ipc::Command::GetVolume:
+            request->appendReplyValue(volume);
+            break;
+
+        case Ipc::Command::GetQueue: {
+            size_t index;
+            Ipc::Result rc = request->readRequestValue(index);
+            if (rc != Ipc::Result::Ok) {
+                return rc;
+            }
+            size_t count;
+            rc = request->readRequestValue(count);
+            if (rc != Ipc::Result::Ok) {
+                return rc;
+            }
+
+            size_t max = (count > queue.size() - index ? queue.size() - index : count);
+            for (size_t i = 0; i < max; i++) {
+                request->appendReplyData(queue[index + i]);
+            }
+            request->appendReplyValue(max);
+            break;
+        }
+
+        case Ipc::Command::GetPlayingFrom:
+            request->appendReplyData(playingFrom);
+            break;
+
+        case Ipc::Command::SetPlayingFrom: {
+            std::string_view str;
+            Ipc::Result rc = request->readRequestData(str);
+            if (rc != Ipc::Result::Ok) {
+                return rc;
+            }
+            playingFrom.assign(str.substr(0, 100));
+            break;
+        }
+
+        default:
+            return Ipc::Result::BadInput;
+    }
+
+    return Ipc::Result::Ok;
+}
+
+// Writes a request to the thread-local storage as a client would
+static void makeRequest(const Ipc::Command cmd, const void * args, const size_t argsSize, const void * in, const size_t inSize, void * out, const size_t outSize) {
+    HipcTls * tls = static_cast<HipcTls *>(armGetTls());
+    tls->meta.type = CmifCommandType_Request;
+    tls->meta.num_data_words = (16 + argsSize + 3) / 4;
+    tls->meta.num_send_buffers = (in != nullptr ? 1 : 0);
+    tls->send_buffers[0] = HipcBufferDescriptor{const_cast<void *>(in), inSize};
+    tls->meta.num_recv_buffers = (out != nullptr ? 1 : 0);
+    tls->recv_buffers[0] = HipcBufferDescriptor{out, outSize};
+
+    uint8_t * header = static_cast<uint8_t *>(cmifGetAlignedDataStart(tls->data_words, tls));
+    uint64_t magic = CMIF_IN_HEADER_MAGIC;
+    uint64_t id = static_cast<uint64_t>(cmd);
+    std::memcpy(header, &magic, sizeof(magic));
+    std::memcpy(header + 8, &id, sizeof(id));
+    if (argsSize > 0) {
+        std::memcpy(header + 16, args, argsSize);
+    }
+}
+
+int main(int argc, char * argv[]) {
+    size_t requests = (argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000);
+
+    // Set up state and client buffers (outside of the timed loop)
+    for (int i = 0; i < 5000; i++) {
+        queue.push_back(i);
+    }
+    playingFrom.reserve(101);
+    const char from[] = "A playlist with quite a long name, so it doesn't fit in a small string";
+    int ids[100];
+    char text[101];
+    size_t range[2] = {1000, 100};
+    Ipc::Request request;
+
+    size_t before = allocations;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < requests; i++) {
+        switch (i % 5) {
+            case 0:
+                makeRequest(Ipc::Command::Version, nullptr, 0, nullptr, 0, nullptr, 0);
+                break;
+
+            case 1:
+                makeRequest(Ipc::Command::GetVolume, nullptr, 0, nullptr, 0, nullptr, 0);
+                break;
+
+            case 2:
+                makeRequest(Ipc::Command::GetQueue, range, sizeof(range), nullptr, 0, ids, sizeof(ids));
+                break;
+
+            case 3:
+                makeRequest(Ipc::Command::SetPlayingFrom, nullptr, 0, from, sizeof(from), nullptr, 0);
+                break;
+
+            case 4:
+                makeRequest(Ipc::Command::GetPlayingFrom, nullptr, 0, nullptr, 0, text, sizeof(text));
+                break;
+        }
+
+        // Same steps as Ipc::Server::processSession
+        if (!request.fromTLS()) {
+            std::cout << "Failed to read request " << i << std::endl;
+            return 1;
+        }
+        request.setResult(static_cast<uint32_t>(handle(&request)));
+        request.toResponseTLS();
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    size_t count = allocations - before;
+
+    std::cout << "Requests: " << requests << std::endl;
+    std::cout << "Time per request: " << ns / requests << " ns" << std::endl;
+    std::cout << "Allocations per request: " << static_cast<double>(count) / requests << std::endl;
+    std::cout << "Last reply: '" << text << "', queue[" << range[0] << "] = " << ids[0] << std::endl;
+    return 0;
+}
\ No newline at end of file
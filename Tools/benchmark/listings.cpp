@@ -0,0 +1,239 @@
+// Benchmarks the sorted song, album and artist listings on Linux using a synthetic database of 50k
+// songs, timing each order before and after migrations 9 (sort keys and indexes) and 10 (album/artist
+// aggregates). The query plan of each is then checked with EXPLAIN QUERY PLAN, which should show an
+// index being used without a temp B-tree.
+//
+// Build (from this directory):
+//   g++ -std=gnu++2a -O2 -I../../Application/include -I../../Common/include listings.cpp
+//       ../../Application/source/db/migrations/9_AddSortKeys.cpp ../../Application/source/db/migrations/10_AddAggregates.cpp
+//       ../../Application/source/utils/Search.cpp
+//       ../../Common/source/SQLite.cpp ../../Common/source/Log.cpp ../../Common/source/Paths.cpp
+//       ../../Common/source/utils/FS.cpp -lsqlite3 -o listings
+//
+// Usage: ./listings [database file] [songs] [runs per query]
+
+#include <chrono>
+#include <cstdio>
+#include "db/migrations/10_AddAggregates.hpp"
+#include "db/migrations/9_AddSortKeys.hpp"
+#include <iostream>
+#include <random>
+#include "SQLite.hpp"
+#include <string>
+#include "utils/Search.hpp"
+#include <vector>
+
+// Words used to generate names (some with accents, to exercise the sort keys)
+static const std::vector<std::string> words = {
+    "love", "night", "Heart", "fire", "Dream", "Blue", "city", "Rain", "Café", "Élan", "Über", "ñandú",
+    "Ærø", "Łódź", "Summer", "ghost", "River", "golden", "Echo", "wild", "Silver", "Mañana", "Ocean", "Zoë"
+};
+
+// A sorted listing (the query before and after the migration)
+struct Listing {
+    std::string name;
+    std::string before;
+    std::string after;
+};
+
+// Helper function called by sqlite3 to get the key used to sort a name (as in Database.cpp)
+void sortKey(sqlite3_context * pCtx, int argc, sqlite3_value ** argv) {
+    if (argc < 1 || sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(pCtx);
+        return;
+    }
+
+    std::string key = Utils::Search::sortKey(std::string((const char *)sqlite3_value_text(argv[0])));
+    sqlite3_result_text(pCtx, key.c_str(), key.length(), SQLITE_TRANSIENT);
+}
+
+// Returns a name made from 1 to 4 random words, sometimes starting with 'The'
+static std::string randomName(std::mt19937 & rng) {
+    std::string name = (rng() % 8 == 0 ? "The " : "");
+    size_t count = 1 + rng() % 4;
+    for (size_t i = 0; i < count; i++) {
+        name += (i > 0 ? " " : "") + words[rng() % words.size()];
+    }
+    return name;
+}
+
+// Create the tables (as they are at version 8) and fill them with random songs
+static bool createDatabase(SQLite * db, const size_t songs) {
+    const char * schema[] = {
+        "CREATE TABLE Variables (name TEXT PRIMARY KEY, value INT);",
+        "INSERT INTO Variables (name, value) VALUES ('version', 8);",
+        "CREATE TABLE Artists (id INTEGER NOT NULL PRIMARY KEY, name TEXT UNIQUE NOT NULL, tadb_id INT NOT NULL DEFAULT -1, image_path TEXT NOT NULL DEFAULT '');",
+        "CREATE TABLE Albums (id INTEGER NOT NULL PRIMARY KEY, name TEXT UNIQUE NOT NULL, tadb_id INT NOT NULL DEFAULT -1, image_path TEXT NOT NULL DEFAULT '');",
+        "CREATE TABLE Songs (id INTEGER NOT NULL PRIMARY KEY, path TEXT UNIQUE NOT NULL, modified DATETIME NOT NULL, artist_id INT NOT NULL, album_id INT NOT NULL, title TEXT NOT NULL, duration INT NOT NULL, plays INT NOT NULL DEFAULT 0, favourite BOOLEAN NOT NULL DEFAULT 0, track INT NOT NULL DEFAULT 0, disc INT NOT NULL DEFAULT 0, format TEXT NOT NULL DEFAULT '');",
+        "CREATE TABLE PlaylistSongs (playlist_id INTEGER, song_id INTEGER);"
+    };
+    bool ok = db->beginTransaction();
+    for (const char * query : schema) {
+        ok = ok && db->prepareAndExecuteQuery(query);
+    }
+
+    // Roughly 20 songs per artist and 10 per album
+    std::mt19937 rng(42);
+    size_t artists = songs/20 + 1;
+    size_t albums = songs/10 + 1;
+    // Bound strings must outlive the query (they aren't copied)
+    for (size_t i = 0; ok && i < artists; i++) {
+        std::string name = randomName(rng) + " " + std::to_string(i);
+        ok = db->prepareQuery("INSERT INTO Artists (name) VALUES (?);");
+        ok = ok && db->bindString(0, name);
+        ok = ok && db->executeQuery();
+    }
+    for (size_t i = 0; ok && i < albums; i++) {
+        std::string name = randomName(rng) + " " + std::to_string(i);
+        ok = db->prepareQuery("INSERT INTO Albums (name) VALUES (?);");
+        ok = ok && db->bindString(0, name);
+        ok = ok && db->executeQuery();
+    }
+    for (size_t i = 0; ok && i < songs; i++) {
+        std::string path = "/music/" + std::to_string(i) + ".mp3";
+        std::string title = randomName(rng);
+        ok = db->prepareQuery("INSERT INTO Songs (path, modified, artist_id, album_id, title, duration, format) VALUES (?, 0, ?, ?, ?, ?, 'MP3');");
+        ok = ok && db->bindString(0, path);
+        ok = ok && db->bindInt(1, 1 + rng() % artists);
+        ok = ok && db->bindInt(2, 1 + rng() % albums);
+        ok = ok && db->bindString(3, title);
+        ok = ok && db->bindInt(4, 60 + rng() % 600);
+        ok = ok && db->executeQuery();
+    }
+    return (ok && db->commitTransaction());
+}
+
+// Run the query the given number of times, reading every row, and return the average time (ms)
+static double timeQuery(SQLite * db, const std::string & query, const size_t runs) {
+    double total = 0;
+    for (size_t i = 0; i < runs; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool ok = db->prepareAndExecuteQuery(query);
+        std::string title;
+        while (ok && db->hasRow()) {
+            ok = db->getString(1, title);
+            ok = ok && db->nextRow();
+        }
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return total / runs;
+}
+
+// Returns the query plan (one step per line) and whether a temp B-tree is used
+static std::string queryPlan(SQLite * db, const std::string & query, bool & tempBTree) {
+    std::string plan;
+    tempBTree = false;
+    bool ok = db->prepareAndExecuteQuery("EXPLAIN QUERY PLAN " + query);
+    while (ok && db->hasRow()) {
+        std::string step;
+        ok = db->getString(3, step);
+        tempBTree = (tempBTree || step.find("TEMP B-TREE") != std::string::npos);
+        plan += "    " + step + "\n";
+        ok = ok && db->nextRow();
+    }
+    return plan;
+}
+
+int main(int argc, char * argv[]) {
+    std::string path = (argc > 1 ? argv[1] : "listings.sqlite3");
+    size_t songs = (argc > 2 ? std::stoul(argv[2]) : 50000);
+    size_t runs = (argc > 3 ? std::stoul(argv[3]) : 5);
+
+    // Start with an empty file (SQLite only opens existing files)
+    std::remove(path.c_str());
+    FILE * file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        std::cout << "Unable to create " << path << std::endl;
+        return 1;
+    }
+    std::fclose(file);
+
+    SQLite * db = new SQLite(path);
+    if (!db->openConnection(SQLite::Connection::ReadWrite) || !db->createFunction("sortKey", sortKey, nullptr)) {
+        std::cout << "Unable to open " << path << std::endl;
+        return 1;
+    }
+    if (!createDatabase(db, songs)) {
+        std::cout << "Unable to create the database: " << db->errorMsg() << std::endl;
+        return 1;
+    }
+
+    // Each song order used by the application (matches songOrderBy() before and after)
+    std::string select = "SELECT Songs.id, Songs.title, Artists.name, Albums.name, Songs.duration FROM Songs JOIN Albums ON Albums.id = Songs.album_id JOIN Artists ON Artists.id = Songs.artist_id";
+    std::vector<Listing> listings = {
+        {"TitleAsc", "Songs.title ASC, Artists.name ASC, Albums.name ASC", "Songs.sort_title ASC, Songs.sort_artist ASC, Songs.sort_album ASC"},
+        {"TitleDsc", "Songs.title DESC, Artists.name ASC, Albums.name ASC", "Songs.sort_title DESC, Songs.sort_artist ASC, Songs.sort_album ASC"},
+        {"ArtistAsc", "Artists.name ASC, Songs.title ASC", "Songs.sort_artist ASC, Songs.sort_title ASC"},
+        {"ArtistDsc", "Artists.name DESC, Songs.title ASC", "Songs.sort_artist DESC, Songs.sort_title ASC"},
+        {"AlbumAsc", "Albums.name ASC, Songs.title ASC", "Songs.sort_album ASC, Songs.sort_title ASC"},
+        {"AlbumDsc", "Albums.name DESC, Songs.title ASC", "Songs.sort_album DESC, Songs.sort_title ASC"},
+        {"LengthAsc", "Songs.duration ASC, Songs.title ASC, Artists.name ASC, Albums.name ASC", "Songs.duration ASC, Songs.sort_title ASC, Songs.sort_artist ASC, Songs.sort_album ASC"},
+        {"LengthDsc", "Songs.duration DESC, Songs.title ASC, Artists.name ASC, Albums.name ASC", "Songs.duration DESC, Songs.sort_title ASC, Songs.sort_artist ASC, Songs.sort_album ASC"}
+    };
+    for (Listing & listing : listings) {
+        listing.before = select + " ORDER BY " + listing.before;
+        listing.after = select + " ORDER BY " + listing.after;
+    }
+    listings.push_back({"Artist's songs", select + " WHERE Songs.artist_id = 1 ORDER BY Songs.title", select + " WHERE Songs.artist_id = 1 ORDER BY Songs.sort_title"});
+
+    // Each album/artist order (matches getAllAlbumMetadata()/getAllArtistMetadata() before and after)
+    std::string albums = "SELECT album_id, Albums.name, CASE WHEN COUNT(DISTINCT artist_id) > 1 THEN 'Various Artists' ELSE Artists.name END AS artist_name, Albums.tadb_id, Albums.image_path, COUNT(*) AS song_count FROM Songs JOIN Albums ON Songs.album_id = Albums.id JOIN Artists ON Songs.artist_id = Artists.id GROUP BY album_id ORDER BY ";
+    std::string albumsAfter = "SELECT id, name, artist_name, tadb_id, image_path, song_count, duration, sort_name, sort_artist FROM Albums WHERE song_count > 0 ORDER BY ";
+    listings.push_back({"Albums AlbumAsc", albums + "Albums.name ASC", albumsAfter + "Albums.sort_name ASC"});
+    listings.push_back({"Albums AlbumDsc", albums + "Albums.name DESC", albumsAfter + "Albums.sort_name DESC"});
+    listings.push_back({"Albums ArtistAsc", albums + "artist_name ASC, Albums.name ASC", albumsAfter + "Albums.sort_artist ASC, Albums.sort_name ASC"});
+    listings.push_back({"Albums SongsDsc", albums + "song_count DESC, Albums.name ASC", albumsAfter + "song_count DESC, Albums.sort_name ASC"});
+    std::string artists = "SELECT artist_id, Artists.name, Artists.tadb_id, Artists.image_path, COUNT(DISTINCT album_id) AS album_count, COUNT(*) AS song_count FROM Songs JOIN Artists ON Songs.artist_id = Artists.id GROUP BY artist_id ORDER BY ";
+    std::string artistsAfter = "SELECT id, name, tadb_id, image_path, album_count, song_count, duration, sort_name FROM Artists WHERE song_count > 0 ORDER BY ";
+    listings.push_back({"Artists ArtistAsc", artists + "Artists.name ASC", artistsAfter + "Artists.sort_name ASC"});
+    listings.push_back({"Artists ArtistDsc", artists + "Artists.name DESC", artistsAfter + "Artists.sort_name DESC"});
+    listings.push_back({"Artists AlbumsDsc", artists + "album_count DESC, Artists.name ASC", artistsAfter + "album_count DESC, Artists.sort_name ASC"});
+    listings.push_back({"Artists SongsAsc", artists + "song_count ASC, Artists.name ASC", artistsAfter + "song_count ASC, Artists.sort_name ASC"});
+
+    // Time before migrating
+    std::vector<double> before;
+    for (const Listing & listing : listings) {
+        before.push_back(timeQuery(db, listing.before, runs));
+        before.push_back(timeQuery(db, listing.before + " LIMIT 60", runs));
+    }
+
+    // Migrate
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    bool ok = db->beginTransaction();
+    std::string err = Migration::migrateTo9(db);
+    if (err.empty()) {
+        err = Migration::migrateTo10(db);
+    }
+    ok = (ok && err.empty() && db->commitTransaction());
+    if (!ok) {
+        std::cout << "Migration failed: " << err << std::endl;
+        return 1;
+    }
+    double migrateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    db->prepareAndExecuteQuery("ANALYZE;");
+
+    // Time after migrating and check each plan
+    std::cout << songs << " songs, " << runs << " runs per query (migration took " << migrateMs << " ms)" << std::endl;
+    std::cout << "order, before all (ms), after all (ms), before first page (ms), after first page (ms), temp b-tree" << std::endl;
+    size_t unindexed = 0;
+    std::string plans;
+    for (size_t i = 0; i < listings.size(); i++) {
+        double all = timeQuery(db, listings[i].after, runs);
+        double page = timeQuery(db, listings[i].after + " LIMIT 60", runs);
+        bool tempBTree;
+        plans += listings[i].name + ":\n" + queryPlan(db, listings[i].after, tempBTree);
+        if (tempBTree) {
+            unindexed++;
+        }
+        std::cout << listings[i].name << ", " << before[i*2] << ", " << all << ", " << before[i*2 + 1] << ", " << page << ", " << (tempBTree ? "yes" : "no") << std::endl;
+    }
+    std::cout << std::endl << plans;
+
+    db->closeConnection();
+    delete db;
+    if (unindexed > 0) {
+        std::cout << std::endl << unindexed << " queries still sort using a temp B-tree" << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,283 @@
+// Checks the paged listings on Linux: a database is created from the template and filled with random
+// songs (with many repeated names and lengths, so rows tie on their sort keys), then every *Page()
+// method is read to the end in each order it supports. Each listing must return every row returned by
+// the matching getAll*() method exactly once, and albums/artists as many as get*Count() reports.
+// The query for each page after the first must also be able to seek to the cursor in an index
+// (i.e. EXPLAIN QUERY PLAN shows a SEARCH rather than a SCAN).
+//
+// Build (from this directory, compiling the SQLite extensions as C first):
+//   gcc -O2 -c ../../Application/source/db/extensions/*.c
+//   g++ -std=gnu++2a -O2 -DSD_ROOT=\"pages-sdmc\" -I../../Application/include -I../../Common/include pages.cpp
+//       ../../Application/source/db/Database.cpp ../../Application/source/db/migrations/*.cpp
+//       *.o ../../Application/source/utils/Search.cpp
+//       ../../Application/source/Types.cpp ../../Common/source/SQLite.cpp ../../Common/source/Log.cpp
+//       ../../Common/source/Paths.cpp ../../Common/source/utils/FS.cpp -lsqlite3 -pthread -o pages
+//
+// Usage: ./pages [songs] [page size]
+
+#include <cstdio>
+#include "db/Database.hpp"
+#include <functional>
+#include <iostream>
+#include "Paths.hpp"
+#include <random>
+#include <set>
+#include "sqlite3.h"
+#include <string>
+#include "utils/FS.hpp"
+#include "utils/Image.hpp"
+#include "utils/Utils.hpp"
+#include <vector>
+
+// Stand-ins for functions the database only uses when removing images and searching (their
+// files need libnx to build)
+void Utils::Image::deleteImage(const std::string & path) {
+
+}
+
+std::vector<std::string> Utils::splitIntoWords(const std::string & str, const char delim) {
+    return std::vector<std::string>();
+}
+
+// SQL of each page query which continues from a cursor
+static std::set<std::string> keysetQueries;
+
+// Called by SQLite as each statement starts, storing page queries which continue from a cursor
+static int traceStatement(unsigned int type, void * ctx, void * stmt, void * sql) {
+    std::string str = sqlite3_sql(static_cast<sqlite3_stmt *>(stmt));
+    if (str.find(" LIMIT ") != std::string::npos && str.find(" OR (") != std::string::npos) {
+        keysetQueries.insert(str);
+    }
+    return 0;
+}
+
+// Called by SQLite for each connection the database opens, to trace its statements
+static int traceConnection(sqlite3 * db, char ** error, const sqlite3_api_routines * api) {
+    sqlite3_trace_v2(db, SQLITE_TRACE_STMT, traceStatement, nullptr);
+    return SQLITE_OK;
+}
+
+// Check every traced page query seeks to the cursor instead of scanning from the start
+// Returns the number of failures
+static size_t checkPlans() {
+    sqlite3 * db;
+    if (sqlite3_open_v2(Path::Common::DatabaseFile.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        std::cout << "Unable to open the database to check query plans" << std::endl;
+        return 1;
+    }
+
+    size_t failed = 0;
+    for (const std::string & query : keysetQueries) {
+        sqlite3_stmt * stmt;
+        if (sqlite3_prepare_v2(db, ("EXPLAIN QUERY PLAN " + query).c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            std::cout << "Unable to explain: " << query << std::endl;
+            failed++;
+            continue;
+        }
+
+        std::string plan = "";
+        bool search = false;
+        bool scan = false;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            std::string detail = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+            search = search || detail.rfind("SEARCH", 0) == 0;
+            scan = scan || detail.rfind("SCAN", 0) == 0;
+            plan += "\n    " + detail;
+        }
+        sqlite3_finalize(stmt);
+
+        if (!search || scan) {
+            std::cout << "Page query doesn't seek: " << query << plan << std::endl;
+            failed++;
+        }
+    }
+    sqlite3_close(db);
+
+    std::cout << "Query plans: " << keysetQueries.size() << " page queries checked" << (failed == 0 ? "" : " FAILED") << std::endl;
+    return failed;
+}
+
+// Words used to generate names (few, so that names are often repeated)
+static const std::vector<std::string> words = {
+    "love", "Night", "heart", "The", "Café", "Élan", "blue", "Zoë"
+};
+
+// Returns a name made from 1 to 2 random words
+static std::string randomName(std::mt19937 & rng) {
+    std::string name = words[rng() % words.size()];
+    if (rng() % 2 == 0) {
+        name += " " + words[rng() % words.size()];
+    }
+    return name;
+}
+
+// Fill the database with random songs and a playlist containing some of them (twice for a few)
+static bool fillDatabase(Database * db, const size_t songs) {
+    std::mt19937 rng(42);
+    bool ok = db->openReadWrite();
+    for (size_t i = 0; ok && i < songs; i++) {
+        Metadata::Song m;
+        m.title = randomName(rng);
+        m.artist = randomName(rng) + " " + std::to_string(rng() % (songs/20 + 1));
+        m.album = randomName(rng) + " " + std::to_string(rng() % (songs/10 + 1));
+        m.trackNumber = 0;
+        m.discNumber = 0;
+        m.duration = 60 + rng() % 10;
+        m.path = "/music/" + std::to_string(i) + ".mp3";
+        m.format = AudioFormat::MP3;
+        m.modified = 0;
+        ok = db->addSong(m);
+    }
+
+    Metadata::Playlist playlist;
+    playlist.name = "Playlist";
+    playlist.description = "";
+    playlist.imagePath = "";
+    ok = ok && db->addPlaylist(playlist);
+    for (size_t i = 0; ok && i < songs; i += 1 + rng() % 3) {
+        ok = db->addSongToPlaylist(1, 1 + i);
+        if (ok && i % 7 == 0) {
+            ok = db->addSongToPlaylist(1, 1 + i);
+        }
+    }
+    db->close();
+    return ok;
+}
+
+// Read every page using the given function, and check the IDs against those expected
+// Returns the number of failures (zero or one)
+static size_t checkPages(const std::string & name, const std::vector<int> & expected, const std::function<std::vector<int>(Database::Cursor &)> & page, const Database::SortBy sort) {
+    Database::Cursor cursor(sort);
+    std::vector<int> ids;
+    size_t pages = 0;
+    while (!cursor.done) {
+        std::vector<int> v = page(cursor);
+        ids.insert(ids.end(), v.begin(), v.end());
+
+        // Stop if the listing never ends (i.e. a page is repeated)
+        pages++;
+        if (ids.size() > expected.size() + 1) {
+            break;
+        }
+    }
+
+    std::set<int> unique(ids.begin(), ids.end());
+    std::string error = "";
+    if (unique.size() != ids.size()) {
+        error = std::to_string(ids.size() - unique.size()) + " rows were repeated";
+    } else if (ids.size() != expected.size()) {
+        error = std::to_string(ids.size()) + " rows returned instead of " + std::to_string(expected.size());
+    } else if (unique != std::set<int>(expected.begin(), expected.end())) {
+        error = "rows are different to the full listing";
+    }
+
+    std::cout << name << ": " << ids.size() << " rows in " << pages << " pages" << (error.empty() ? "" : " FAILED (" + error + ")") << std::endl;
+    return (error.empty() ? 0 : 1);
+}
+
+int main(int argc, char * argv[]) {
+    size_t songs = (argc > 1 ? std::stoul(argv[1]) : 2000);
+    size_t pageSize = (argc > 2 ? std::stoul(argv[2]) : 60);
+
+    // Start with a copy of the template
+    Utils::Fs::createPath(Path::Common::SwitchFolder);
+    std::remove(Path::Common::DatabaseFile.c_str());
+    if (!Utils::Fs::copyFile("../../Application/romfs/db/template.sqlite3", Path::Common::DatabaseFile)) {
+        std::cout << "Unable to copy the template database" << std::endl;
+        return 1;
+    }
+    sqlite3_auto_extension(reinterpret_cast<void (*)(void)>(traceConnection));
+    Database * db = new Database();
+    if (!db->migrate() || !fillDatabase(db, songs) || !db->openReadOnly()) {
+        std::cout << "Unable to create the database: " << db->error() << std::endl;
+        return 1;
+    }
+
+    size_t failed = 0;
+    std::vector<std::pair<std::string, Database::SortBy>> songSorts = {
+        {"TitleAsc", Database::SortBy::TitleAsc}, {"TitleDsc", Database::SortBy::TitleDsc},
+        {"ArtistAsc", Database::SortBy::ArtistAsc}, {"ArtistDsc", Database::SortBy::ArtistDsc},
+        {"AlbumAsc", Database::SortBy::AlbumAsc}, {"AlbumDsc", Database::SortBy::AlbumDsc},
+        {"LengthAsc", Database::SortBy::LengthAsc}, {"LengthDsc", Database::SortBy::LengthDsc}
+    };
+    for (const std::pair<std::string, Database::SortBy> & sort : songSorts) {
+        std::vector<int> expected;
+        for (const Metadata::Song & m : db->getAllSongMetadata(sort.second)) {
+            expected.push_back(m.ID);
+        }
+        failed += checkPages("Songs " + sort.first, expected, [&](Database::Cursor & cursor) {
+            std::vector<int> ids;
+            for (const Metadata::Song & m : db->getSongMetadataPage(cursor, pageSize)) {
+                ids.push_back(m.ID);
+            }
+            return ids;
+        }, sort.second);
+
+        expected.clear();
+        for (const Metadata::PlaylistSong & m : db->getSongMetadataForPlaylist(1, sort.second)) {
+            expected.push_back(m.ID);
+        }
+        failed += checkPages("Playlist " + sort.first, expected, [&](Database::Cursor & cursor) {
+            std::vector<int> ids;
+            for (const Metadata::PlaylistSong & m : db->getSongMetadataForPlaylistPage(1, cursor, pageSize)) {
+                ids.push_back(m.ID);
+            }
+            return ids;
+        }, sort.second);
+    }
+
+    std::vector<std::pair<std::string, Database::SortBy>> albumSorts = {
+        {"AlbumAsc", Database::SortBy::AlbumAsc}, {"AlbumDsc", Database::SortBy::AlbumDsc},
+        {"ArtistAsc", Database::SortBy::ArtistAsc}, {"ArtistDsc", Database::SortBy::ArtistDsc},
+        {"SongsAsc", Database::SortBy::SongsAsc}, {"SongsDsc", Database::SortBy::SongsDsc}
+    };
+    for (const std::pair<std::string, Database::SortBy> & sort : albumSorts) {
+        std::vector<int> expected;
+        for (const Metadata::Album & m : db->getAllAlbumMetadata(sort.second)) {
+            expected.push_back(m.ID);
+        }
+        if (static_cast<int>(expected.size()) != db->getAlbumCount()) {
+            std::cout << "Albums " << sort.first << ": getAlbumCount() doesn't match the full listing" << std::endl;
+            failed++;
+        }
+        failed += checkPages("Albums " + sort.first, expected, [&](Database::Cursor & cursor) {
+            std::vector<int> ids;
+            for (const Metadata::Album & m : db->getAlbumMetadataPage(cursor, pageSize)) {
+                ids.push_back(m.ID);
+            }
+            return ids;
+        }, sort.second);
+    }
+
+    std::vector<std::pair<std::string, Database::SortBy>> artistSorts = {
+        {"ArtistAsc", Database::SortBy::ArtistAsc}, {"ArtistDsc", Database::SortBy::ArtistDsc},
+        {"AlbumsAsc", Database::SortBy::AlbumsAsc}, {"AlbumsDsc", Database::SortBy::AlbumsDsc},
+        {"SongsAsc", Database::SortBy::SongsAsc}, {"SongsDsc", Database::SortBy::SongsDsc}
+    };
+    for (const std::pair<std::string, Database::SortBy> & sort : artistSorts) {
+        std::vector<int> expected;
+        for (const Metadata::Artist & m : db->getAllArtistMetadata(sort.second)) {
+            expected.push_back(m.ID);
+        }
+        if (static_cast<int>(expected.size()) != db->getArtistCount()) {
+            std::cout << "Artists " << sort.first << ": getArtistCount() doesn't match the full listing" << std::endl;
+            failed++;
+        }
+        failed += checkPages("Artists " + sort.first, expected, [&](Database::Cursor & cursor) {
+            std::vector<int> ids;
+            for (const Metadata::Artist & m : db->getArtistMetadataPage(cursor, pageSize)) {
+                ids.push_back(m.ID);
+            }
+            return ids;
+        }, sort.second);
+    }
+
+    db->close();
+    delete db;
+    failed += checkPlans();
+    if (failed > 0) {
+        std::cout << std::endl << failed << " listings failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
\ No newline at end of file
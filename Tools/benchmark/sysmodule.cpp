@@ -0,0 +1,131 @@
+// Benchmarks the host build of the sysmodule through the same client functions used by the application
+// and overlay. Reports the round trip time of a few IPC commands, and the time from asking to play a
+// song until its first samples are played. The given files are written to the snapshot as songs to play
+// (the sysmodule is asked to release it first), so the sysmodule must be running.
+//
+// Build (from this directory, after 'make host' in the root of the repo):
+//   g++ -std=gnu++2a -O2 -I../../Sysmodule/host/include -I../../Common/include sysmodule.cpp
+//       ../../Sysmodule/build/host/libsys-triplayer.a -lmpg123 -pthread -o sysmodule
+//
+// Usage: ../../Sysmodule/build/host/sys-triplayer & ./sysmodule <file> [file...]
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include "ipc/TriPlayer.hpp"
+#include "Paths.hpp"
+#include "Snapshot.hpp"
+#include <string>
+#include <thread>
+#include <vector>
+
+// Number of times each command is sent
+constexpr size_t ipcRounds = 20000;
+// Number of times each song is played
+constexpr size_t songRounds = 5;
+// Milliseconds to play a song for before changing
+constexpr size_t playTime = 300;
+
+// Prints the mean and 99th percentile of the given times (in microseconds)
+static void printTimes(const std::string & name, std::vector<double> & times) {
+    std::sort(times.begin(), times.end());
+    double total = 0;
+    for (double t : times) {
+        total += t;
+    }
+    std::cout << name << ": mean " << total / times.size() << " us, p99 " << times[times.size() * 99 / 100] << " us" << std::endl;
+}
+
+// Times a command the given number of times, stopping on a failure
+static bool timeCommand(const std::string & name, const size_t rounds, const std::function<bool()> & func) {
+    std::vector<double> times;
+    times.reserve(rounds);
+    for (size_t i = 0; i < rounds; i++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        if (!func()) {
+            std::cout << name << " failed" << std::endl;
+            return false;
+        }
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    printTimes(name, times);
+    return true;
+}
+
+int main(int argc, char * argv[]) {
+    if (argc < 2) {
+        std::cout << "Usage: " << argv[0] << " <file> [file...]" << std::endl;
+        return 1;
+    }
+    if (!TriPlayer::initialize()) {
+        std::cout << "Unable to connect, is the sysmodule running?" << std::endl;
+        return 1;
+    }
+
+    // Write a snapshot containing the given files (IDs start at 1)
+    std::vector<Snapshot::Entry> entries;
+    std::vector<int> ids;
+    for (int i = 1; i < argc; i++) {
+        char path[PATH_MAX];
+        if (realpath(argv[i], path) == nullptr) {
+            std::cout << argv[i] << " doesn't exist" << std::endl;
+            return 1;
+        }
+        entries.push_back(Snapshot::Entry{i, 0, "", "", "", path});
+        ids.push_back(i);
+    }
+    TriPlayer::requestDatabaseLock();
+    bool written = Snapshot::write(Path::Common::SnapshotFile, entries);
+    TriPlayer::releaseDatabaseLock();
+    if (!written) {
+        std::cout << "Unable to write " << Path::Common::SnapshotFile << std::endl;
+        return 1;
+    }
+    TriPlayer::setQueue(ids);
+
+    // Round trip times
+    std::string version;
+    double volume;
+    std::vector<int> queue;
+    const std::string from = "A playlist with quite a long name, so it doesn't fit in a small string";
+    bool ok = timeCommand("getVersion", ipcRounds, [&]() { return TriPlayer::getVersion(version); });
+    ok = ok && timeCommand("getVolume", ipcRounds, [&]() { return TriPlayer::getVolume(volume); });
+    ok = ok && timeCommand("getQueue", ipcRounds, [&]() { return TriPlayer::getQueue(queue); });
+    ok = ok && timeCommand("setPlayingFromText", ipcRounds, [&]() { return TriPlayer::setPlayingFromText(from); });
+
+    // Song changes: wait for the position to drop (new song) and then move (samples played)
+    std::vector<double> times;
+    for (size_t i = 0; ok && i < songRounds * ids.size(); i++) {
+        double before = 0;
+        TriPlayer::getPosition(before);
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        TriPlayer::setQueueIdx(i % ids.size());
+        bool changed = false;
+        double pos = before;
+        while (std::chrono::steady_clock::now() - start < std::chrono::seconds(5)) {
+            TriPlayer::getPosition(pos);
+            changed = changed || pos < before || before == 0;
+            if (changed && pos > 0) {
+                break;
+            }
+        }
+        if (!changed || pos <= 0) {
+            std::cout << "Song " << ids[i % ids.size()] << " didn't start playing" << std::endl;
+            ok = false;
+            break;
+        }
+        times.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        std::this_thread::sleep_for(std::chrono::milliseconds(playTime));
+    }
+    if (ok) {
+        printTimes("Song change", times);
+    }
+
+    TriPlayer::reset();
+    TriPlayer::exit();
+    return (ok ? 0 : 1);
+}
\ No newline at end of file
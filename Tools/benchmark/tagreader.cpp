@@ -0,0 +1,312 @@
+// Benchmarks Metadata::TagReader against TagLib on Linux using a generated corpus
+// of MP3 (ID3v2.3/2.4 + ID3v1, CBR and Xing), FLAC and WAV files with embedded art.
+//
+// Build (from this directory):
+//   g++ -std=gnu++2a -O2 -I../../Application/include -I../../Common/include tagreader.cpp
+//       ../../Application/source/meta/TagReader.cpp ../../Common/source/utils/MP3.cpp -o tagreader
+// Add '-DWITH_TAGLIB $(pkg-config --cflags --libs taglib)' to also time TagLib.
+//
+// Usage: ./tagreader [directory] [files per format] [art size (KB)]
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include "meta/TagReader.hpp"
+#include <string>
+#include <vector>
+
+#ifdef WITH_TAGLIB
+#include <flacfile.h>
+#include <mpegfile.h>
+#include <wavfile.h>
+#endif
+
+typedef std::vector<unsigned char> Bytes;
+
+static void putBE32(Bytes & b, uint32_t v) {
+    b.push_back(v >> 24); b.push_back(v >> 16); b.push_back(v >> 8); b.push_back(v);
+}
+
+static void putLE32(Bytes & b, uint32_t v) {
+    b.push_back(v); b.push_back(v >> 8); b.push_back(v >> 16); b.push_back(v >> 24);
+}
+
+static void putLE16(Bytes & b, uint16_t v) {
+    b.push_back(v); b.push_back(v >> 8);
+}
+
+static void putSyncsafe(Bytes & b, uint32_t v) {
+    b.push_back((v >> 21) & 0x7F); b.push_back((v >> 14) & 0x7F); b.push_back((v >> 7) & 0x7F); b.push_back(v & 0x7F);
+}
+
+static void putString(Bytes & b, const std::string & s) {
+    b.insert(b.end(), s.begin(), s.end());
+}
+
+// Create an ID3v2 frame of the given version
+static void putID3v2Frame(Bytes & b, int major, const std::string & id, const Bytes & data) {
+    putString(b, id);
+    if (major == 4) {
+        putSyncsafe(b, data.size());
+    } else {
+        putBE32(b, data.size());
+    }
+    b.push_back(0);
+    b.push_back(0);
+    b.insert(b.end(), data.begin(), data.end());
+}
+
+static Bytes textFrame(const std::string & s, bool utf16) {
+    Bytes b;
+    if (utf16) {
+        b.push_back(1);
+        b.push_back(0xFF);
+        b.push_back(0xFE);
+        for (char c : s) {
+            putLE16(b, static_cast<unsigned char>(c));
+        }
+        putLE16(b, 0);
+    } else {
+        b.push_back(3);
+        putString(b, s);
+    }
+    return b;
+}
+
+// Create an ID3v2 tag with an image at the front (the worst case for a streaming reader)
+static Bytes makeID3v2(int major, int i, size_t artSize) {
+    Bytes frames;
+    Bytes apic = {0};
+    putString(apic, "image/jpeg");
+    apic.push_back(0);
+    apic.push_back(3);
+    apic.push_back(0);
+    apic.insert(apic.end(), artSize, 0xAB);
+    putID3v2Frame(frames, major, "APIC", apic);
+    putID3v2Frame(frames, major, "TIT2", textFrame("Title " + std::to_string(i), i % 2));
+    putID3v2Frame(frames, major, "TPE1", textFrame("Artist " + std::to_string(i % 50), i % 2));
+    putID3v2Frame(frames, major, "TALB", textFrame("Album " + std::to_string(i % 200), false));
+    putID3v2Frame(frames, major, "TRCK", textFrame(std::to_string(i % 20 + 1) + "/20", false));
+    putID3v2Frame(frames, major, "TPOS", textFrame("1/2", false));
+    frames.insert(frames.end(), 1024, 0);
+
+    Bytes b;
+    putString(b, "ID3");
+    b.push_back(major);
+    b.push_back(0);
+    b.push_back(0);
+    putSyncsafe(b, frames.size());
+    b.insert(b.end(), frames.begin(), frames.end());
+    return b;
+}
+
+static Bytes makeMP3(int i, size_t artSize) {
+    Bytes b = makeID3v2(i % 2 ? 3 : 4, i, artSize);
+
+    // MPEG1 Layer III, 128kbps, 44.1kHz, stereo (417 byte frames)
+    const unsigned char header[4] = {0xFF, 0xFB, 0x90, 0x00};
+    size_t frames = 2000 + (i % 1000);
+    for (size_t f = 0; f < frames; f++) {
+        size_t start = b.size();
+        b.insert(b.end(), header, header + 4);
+        b.insert(b.end(), 413, 0);
+        if (f == 0 && i % 3 == 0) {
+            std::memcpy(&b[start + 36], "Xing", 4);
+            b[start + 43] = 0x1;
+            b[start + 44] = frames >> 24; b[start + 45] = frames >> 16; b[start + 46] = frames >> 8; b[start + 47] = frames;
+        }
+    }
+
+    Bytes v1(128, 0);
+    std::memcpy(&v1[0], "TAG", 3);
+    std::memcpy(&v1[3], "ID3v1 title", 11);
+    b.insert(b.end(), v1.begin(), v1.end());
+    return b;
+}
+
+static Bytes makeFLAC(int i, size_t artSize) {
+    Bytes b;
+    putString(b, "fLaC");
+
+    // STREAMINFO (44.1kHz, 2ch, 16bit, i minutes long)
+    uint64_t samples = 44100ull * 60 * (i % 5 + 1);
+    b.push_back(0); b.push_back(0); b.push_back(0); b.push_back(34);
+    Bytes info(34, 0);
+    info[10] = (44100 >> 12) & 0xFF;
+    info[11] = (44100 >> 4) & 0xFF;
+    info[12] = ((44100 & 0xF) << 4) | (1 << 1);
+    info[13] = (15 << 4) | ((samples >> 32) & 0xF);
+    info[14] = samples >> 24; info[15] = samples >> 16; info[16] = samples >> 8; info[17] = samples;
+    b.insert(b.end(), info.begin(), info.end());
+
+    // PICTURE
+    b.push_back(6);
+    Bytes pic;
+    putBE32(pic, 3);
+    putBE32(pic, 10);
+    putString(pic, "image/jpeg");
+    putBE32(pic, 0);
+    for (int j = 0; j < 4; j++) {
+        putBE32(pic, 0);
+    }
+    putBE32(pic, artSize);
+    pic.insert(pic.end(), artSize, 0xCD);
+    b.push_back(pic.size() >> 16); b.push_back(pic.size() >> 8); b.push_back(pic.size());
+    b.insert(b.end(), pic.begin(), pic.end());
+
+    // VORBIS_COMMENT
+    Bytes vc;
+    putLE32(vc, 4);
+    putString(vc, "test");
+    std::vector<std::string> fields = {"TITLE=Title " + std::to_string(i), "ARTIST=Artist " + std::to_string(i % 50),
+                                       "ALBUM=Album " + std::to_string(i % 200), "TRACKNUMBER=" + std::to_string(i % 20 + 1), "DISCNUMBER=1"};
+    putLE32(vc, fields.size());
+    for (const std::string & f : fields) {
+        putLE32(vc, f.size());
+        putString(vc, f);
+    }
+    b.push_back(0x80 | 4);
+    b.push_back(vc.size() >> 16); b.push_back(vc.size() >> 8); b.push_back(vc.size());
+    b.insert(b.end(), vc.begin(), vc.end());
+
+    // Some (invalid) audio data
+    b.insert(b.end(), 256 * 1024, 0);
+    return b;
+}
+
+static Bytes makeWAV(int i) {
+    Bytes fmt;
+    putLE16(fmt, 1);
+    putLE16(fmt, 2);
+    putLE32(fmt, 44100);
+    putLE32(fmt, 44100 * 4);
+    putLE16(fmt, 4);
+    putLE16(fmt, 16);
+
+    Bytes list;
+    putString(list, "INFO");
+    auto addInfo = [&list](const std::string & id, std::string v) {
+        v.push_back('\0');
+        if (v.size() & 1) {
+            v.push_back('\0');
+        }
+        putString(list, id);
+        putLE32(list, v.size());
+        putString(list, v);
+    };
+    addInfo("INAM", "Title " + std::to_string(i));
+    addInfo("IART", "Artist " + std::to_string(i % 50));
+    addInfo("IPRD", "Album " + std::to_string(i % 200));
+    addInfo("IPRT", std::to_string(i % 20 + 1));
+
+    size_t dataSize = 44100 * 4 * (i % 3 + 1);
+    Bytes b;
+    putString(b, "RIFF");
+    putLE32(b, 4 + 8 + fmt.size() + 8 + list.size() + 8 + dataSize);
+    putString(b, "WAVE");
+    putString(b, "fmt ");
+    putLE32(b, fmt.size());
+    b.insert(b.end(), fmt.begin(), fmt.end());
+    putString(b, "LIST");
+    putLE32(b, list.size());
+    b.insert(b.end(), list.begin(), list.end());
+    putString(b, "data");
+    putLE32(b, dataSize);
+    b.insert(b.end(), dataSize, 0);
+    return b;
+}
+
+struct Entry {
+    std::string path;
+    AudioFormat format;
+};
+
+static Metadata::Song blankSong() {
+    Metadata::Song m;
+    m.trackNumber = -1;
+    m.discNumber = -1;
+    m.duration = 0;
+    return m;
+}
+
+template <typename Func>
+static double timeAll(const std::vector<Entry> & files, Func func) {
+    auto start = std::chrono::steady_clock::now();
+    for (const Entry & e : files) {
+        func(e);
+    }
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char * argv[]) {
+    std::filesystem::path dir = (argc > 1 ? argv[1] : "tagreader-corpus");
+    int count = (argc > 2 ? std::stoi(argv[2]) : 200);
+    size_t artSize = (argc > 3 ? std::stoul(argv[3]) : 300) * 1024;
+
+    // Generate the corpus
+    std::filesystem::create_directories(dir);
+    std::vector<Entry> files;
+    for (int i = 0; i < count; i++) {
+        std::vector<std::pair<std::string, Bytes> > out = {
+            {"song" + std::to_string(i) + ".mp3", makeMP3(i, artSize)},
+            {"song" + std::to_string(i) + ".flac", makeFLAC(i, artSize)},
+            {"song" + std::to_string(i) + ".wav", makeWAV(i)}
+        };
+        for (size_t j = 0; j < out.size(); j++) {
+            std::string path = (dir / out[j].first).string();
+            std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char *>(out[j].second.data()), out[j].second.size());
+            files.push_back(Entry{path, j == 0 ? AudioFormat::MP3 : j == 1 ? AudioFormat::FLAC : AudioFormat::WAV});
+        }
+    }
+    std::cout << "Generated " << files.size() << " files in " << dir << std::endl;
+
+    // Time the TagReader (also checks the tags were found)
+    Metadata::TagReader reader;
+    std::vector<Metadata::Song> results;
+    size_t failed = 0;
+    double tagReaderMs = timeAll(files, [&](const Entry & e) {
+        Metadata::Song m = blankSong();
+        if (reader.read(e.path, e.format, m) != Metadata::TagReader::Result::Ok || m.title.rfind("Title ", 0) != 0 || m.artist.empty() || m.album.empty() || m.trackNumber <= 0 || m.duration == 0) {
+            std::cout << "Unexpected result for " << e.path << std::endl;
+            failed++;
+        }
+        results.push_back(m);
+    });
+    std::cout << "TagReader: " << tagReaderMs << " ms (" << tagReaderMs / files.size() << " ms/file, " << failed << " failed)" << std::endl;
+
+#ifdef WITH_TAGLIB
+    // Time TagLib, opening files the same way as Metadata::readFromFile's fallback
+    std::vector< std::pair<std::string, unsigned int> > tagLibResults;
+    double tagLibMs = timeAll(files, [&](const Entry & e) {
+        TagLib::String title;
+        unsigned int duration = 0;
+        if (e.format == AudioFormat::MP3) {
+            TagLib::MPEG::File file(e.path.c_str(), true, TagLib::AudioProperties::Accurate);
+            title = file.tag()->title();
+            duration = file.audioProperties()->lengthInSeconds();
+        } else if (e.format == AudioFormat::FLAC) {
+            TagLib::FLAC::File file(e.path.c_str(), true, TagLib::AudioProperties::Accurate);
+            title = file.tag()->title();
+            duration = file.audioProperties()->lengthInSeconds();
+        } else {
+            TagLib::RIFF::WAV::File file(e.path.c_str(), true, TagLib::AudioProperties::Accurate);
+            title = file.tag()->title();
+            duration = file.audioProperties()->lengthInSeconds();
+        }
+        tagLibResults.push_back(std::make_pair(title.to8Bit(true), duration));
+    });
+
+    size_t mismatched = 0;
+    for (size_t i = 0; i < files.size(); i++) {
+        if (tagLibResults[i].first != results[i].title || tagLibResults[i].second != results[i].duration) {
+            mismatched++;
+        }
+    }
+    std::cout << "TagLib: " << tagLibMs << " ms (" << tagLibMs / files.size() << " ms/file, " << mismatched << " differ from TagReader)" << std::endl;
+    std::cout << "Speedup: " << tagLibMs / tagReaderMs << "x" << std::endl;
+#endif
+
+    return (failed == 0 ? 0 : 1);
+}
\ No newline at end of file